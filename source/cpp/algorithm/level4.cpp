@@ -113,6 +113,7 @@ void demo_is_sorted() {
 
 // ============================================================
 // 4.6 综合示例：对结构体按多字段排序
+//   每个字段单独成列存放（只扫一个字段时不拖着其它字段）的版本见 container/level23_soa_vector.cpp
 // ============================================================
 void demo_struct_sort() {
     std::cout << "\n=== 4.6 结构体多字段排序 ===" << std::endl;
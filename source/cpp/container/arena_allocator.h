@@ -0,0 +1,252 @@
+#pragma once
+
+// arena_allocator.h: 线性分配器（Arena）与定长节点池（NodePool）
+//
+// std::list / std::map / std::set 每个元素单独 new 一个节点，构建和销毁一个"只活一次请求"
+// 的结构时，时间大部分花在 malloc / free 上。这里提供两种专用分配器：
+//
+//   Arena    ：从大块内存（chunk）里顺序切分，分配只是移动指针；deallocate 什么也不做，
+//              reset() 一次性回收全部内存并复用已申请的 chunk，下一轮请求不再向系统要内存
+//   NodePool ：按 16 字节分级（<= 256 字节）的空闲链表，释放的节点可以立即被复用，
+//              适合"边插边删"、生命周期不整齐的节点；同样支持 reset()
+//
+// 两者都继承 std::pmr::memory_resource，可以直接用于 std::pmr::list / std::pmr::map；
+// 也可以通过 arena_allocator<T, Resource> 作为经典的 Allocator 模板参数使用。
+// 两者都不是线程安全的：多线程时每个线程用自己的实例（thread_resource<R>() / thread_arena()）。
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// ============================================================
+// Arena：bump-pointer 分配
+// ============================================================
+class Arena final : public std::pmr::memory_resource {
+public:
+    explicit Arena(size_t initialChunk = 64 * 1024,
+                   std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : mNextChunkSize(std::max<size_t>(initialChunk, 256)), mUpstream(upstream) {}
+    ~Arena() override { release(); }
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // 回到第一个 chunk 的起点。之前分配出去的内存全部失效（不会调用析构函数），
+    // 已申请的 chunk 保留下来供后续分配复用
+    void reset() noexcept {
+        mCurrent = mFirst;
+        if (mCurrent) {
+            mPtr = mCurrent->data();
+            mEnd = mCurrent->end();
+        }
+        mUsed = 0;
+    }
+
+    // 把所有 chunk 还给上游
+    void release() noexcept {
+        for (Chunk* c = mFirst; c;) {
+            Chunk* next = c->next;
+            mUpstream->deallocate(c, c->size, alignof(Chunk));
+            c = next;
+        }
+        mFirst = mCurrent = nullptr;
+        mPtr = mEnd = nullptr;
+        mUsed = 0;
+        mReserved = 0;
+    }
+
+    size_t bytes_used() const noexcept { return mUsed; }          // 本轮已分配出去的字节
+    size_t bytes_reserved() const noexcept { return mReserved; }  // 向上游申请的 chunk 总字节
+
+private:
+    struct alignas(std::max_align_t) Chunk {
+        Chunk* next;
+        size_t size;  // 包括本头部
+        std::byte* data() { return reinterpret_cast<std::byte*>(this + 1); }
+        std::byte* end() { return reinterpret_cast<std::byte*>(this) + size; }
+    };
+
+    static constexpr size_t kMaxChunk = 16 * 1024 * 1024;
+
+    void* do_allocate(size_t bytes, size_t align) override {
+        auto p = alignUp(mPtr, align);
+        if (p && p <= mEnd && bytes <= size_t(mEnd - p)) {
+            mPtr = p + bytes;
+            mUsed += bytes;
+            return p;
+        }
+        return allocateSlow(bytes, align);
+    }
+
+    void do_deallocate(void*, size_t, size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    static std::byte* alignUp(std::byte* p, size_t align) {
+        auto v = reinterpret_cast<uintptr_t>(p);
+        return reinterpret_cast<std::byte*>((v + align - 1) & ~uintptr_t(align - 1));
+    }
+
+    // 当前 chunk 放不下：先尝试 reset 前留下的后续 chunk，都不够再向上游申请新的
+    void* allocateSlow(size_t bytes, size_t align) {
+        size_t need = bytes + align + sizeof(Chunk);
+        Chunk* next = mCurrent ? mCurrent->next : nullptr;
+        while (next && next->size < need) next = next->next;
+        if (!next) {
+            size_t size = std::max(need, mNextChunkSize);
+            mNextChunkSize = std::min(mNextChunkSize * 2, kMaxChunk);
+            next = static_cast<Chunk*>(mUpstream->allocate(size, alignof(Chunk)));
+            next->size = size;
+            mReserved += size;
+            // 挂在当前 chunk 之后，保证 reset 后按同样顺序复用
+            if (mCurrent) {
+                next->next = mCurrent->next;
+                mCurrent->next = next;
+            } else {
+                next->next = mFirst;
+                mFirst = next;
+            }
+        }
+        mCurrent = next;
+        std::byte* p = alignUp(next->data(), align);
+        mPtr = p + bytes;
+        mEnd = next->end();
+        mUsed += bytes;
+        return p;
+    }
+
+    std::byte* mPtr = nullptr;
+    std::byte* mEnd = nullptr;
+    Chunk* mFirst = nullptr;
+    Chunk* mCurrent = nullptr;
+    size_t mNextChunkSize;
+    size_t mUsed = 0;
+    size_t mReserved = 0;
+    std::pmr::memory_resource* mUpstream;
+};
+
+// ============================================================
+// NodePool：分级空闲链表
+//   请求大小向上取整到 16 的倍数，每一级一条单链表；空链表时从内部 Arena 切一块。
+//   超过 kMaxPooled 或对齐要求超过 16 的请求直接转发给上游（需要正常释放）
+// ============================================================
+class NodePool final : public std::pmr::memory_resource {
+public:
+    static constexpr size_t kGranularity = 16;
+    static constexpr size_t kMaxPooled = 256;
+
+    explicit NodePool(size_t chunkBytes = 64 * 1024,
+                      std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : mArena(chunkBytes, upstream), mUpstream(upstream) {}
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    // 一次性回收所有池化节点（不调用析构函数），chunk 保留复用
+    void reset() noexcept {
+        std::fill(std::begin(mFree), std::end(mFree), nullptr);
+        mArena.reset();
+    }
+
+    size_t bytes_reserved() const noexcept { return mArena.bytes_reserved(); }
+
+private:
+    struct FreeNode {
+        FreeNode* next;
+    };
+    static constexpr size_t kClasses = kMaxPooled / kGranularity;
+
+    static size_t classOf(size_t bytes) { return (std::max<size_t>(bytes, 1) - 1) / kGranularity; }
+
+    void* do_allocate(size_t bytes, size_t align) override {
+        if (bytes > kMaxPooled || align > kGranularity) return mUpstream->allocate(bytes, align);
+        size_t c = classOf(bytes);
+        if (FreeNode* n = mFree[c]) {
+            mFree[c] = n->next;
+            return n;
+        }
+        return mArena.allocate((c + 1) * kGranularity, kGranularity);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t align) override {
+        if (bytes > kMaxPooled || align > kGranularity) {
+            mUpstream->deallocate(p, bytes, align);
+            return;
+        }
+        size_t c = classOf(bytes);
+        mFree[c] = ::new (p) FreeNode{mFree[c]};
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    FreeNode* mFree[kClasses] = {};
+    Arena mArena;
+    std::pmr::memory_resource* mUpstream;
+};
+
+// ============================================================
+// 线程局部实例：每个线程一个，无需加锁
+// ============================================================
+template <typename Resource>
+Resource& thread_resource() {
+    thread_local Resource r;
+    return r;
+}
+
+inline Arena& thread_arena() { return thread_resource<Arena>(); }
+
+// 作用域结束时 reset 资源：一次请求里分配的所有节点一并回收
+// （容器必须先于 ArenaScope 析构，或者其内存不再被访问）
+template <typename Resource = Arena>
+class ArenaScope {
+public:
+    explicit ArenaScope(Resource& r = thread_resource<Resource>()) : mRes(r) {}
+    ~ArenaScope() { mRes.reset(); }
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+    Resource& resource() const { return mRes; }
+
+private:
+    Resource& mRes;
+};
+
+// ============================================================
+// arena_allocator：经典 Allocator 接口
+//   std::list<int, arena_allocator<int>> l(arena_allocator<int>(arena));
+//   默认构造时使用当前线程的 thread_resource<Resource>()
+//   Resource 是 final 类，allocate 调用可以去虚化，没有 pmr 的虚函数开销
+// ============================================================
+template <typename T, typename Resource = Arena>
+class arena_allocator {
+public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    arena_allocator() noexcept : mRes(&thread_resource<Resource>()) {}
+    explicit arena_allocator(Resource& r) noexcept : mRes(&r) {}
+    template <typename U>
+    arena_allocator(const arena_allocator<U, Resource>& o) noexcept : mRes(o.resource()) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(mRes->allocate(n * sizeof(T), alignof(T))); }
+    void deallocate(T* p, size_t n) noexcept { mRes->deallocate(p, n * sizeof(T), alignof(T)); }
+
+    Resource* resource() const noexcept { return mRes; }
+
+    friend bool operator==(const arena_allocator& a, const arena_allocator& b) noexcept {
+        return a.mRes == b.mRes;
+    }
+
+private:
+    Resource* mRes;
+};
+
+template <typename T>
+using pool_allocator = arena_allocator<T, NodePool>;
@@ -0,0 +1,180 @@
+#pragma once
+
+// bench_utils.h: 容器 benchmark 共用的小工具
+// 计时、防止编译器优化掉结果、随机数据生成、堆分配统计
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+// ============================================================
+// 计时
+// ============================================================
+class BenchTimer {
+public:
+    BenchTimer() : mStart(std::chrono::steady_clock::now()) {}
+
+    void reset() { mStart = std::chrono::steady_clock::now(); }
+
+    double ns() const {
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - mStart)
+            .count();
+    }
+    double ms() const { return ns() / 1e6; }
+
+private:
+    std::chrono::steady_clock::time_point mStart;
+};
+
+// 让编译器认为 value 被"使用"了，防止整个被测循环被优化掉
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+// ============================================================
+// 随机数据
+// ============================================================
+
+// n 个互不相同的 64 位随机 key（随机排列的 splitmix64 序列）
+inline std::vector<uint64_t> uniqueRandomKeys(size_t n, uint64_t seed = 42) {
+    std::vector<uint64_t> keys(n);
+    uint64_t x = seed;
+    for (auto& k : keys) {
+        // splitmix64 是 2^64 上的双射，不同输入一定得到不同输出
+        uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        k = z ^ (z >> 31);
+    }
+    return keys;
+}
+
+// n 个服从 Zipf(s) 分布的排名，取值 [0, universe)，0 最常见：P(rank = r) ∝ 1 / (r + 1)^s。
+// 预先算出累积分布再二分查找（universe 个 double 的表）
+inline std::vector<uint64_t> zipfRanks(size_t n, size_t universe, double s, uint64_t seed = 42) {
+    std::vector<double> cdf(universe);
+    double sum = 0;
+    for (size_t r = 0; r < universe; ++r) {
+        sum += std::pow(static_cast<double>(r + 1), -s);
+        cdf[r] = sum;
+    }
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> u(0, sum);
+    std::vector<uint64_t> ranks(n);
+    for (auto& r : ranks) {
+        auto pos = std::upper_bound(cdf.begin(), cdf.end(), u(rng)) - cdf.begin();
+        r = std::min(static_cast<uint64_t>(pos), static_cast<uint64_t>(universe - 1));
+    }
+    return ranks;
+}
+
+// 10^lo, 10^(lo+1), ..., 不超过 maxN
+inline std::vector<size_t> decadeSizes(size_t lo, size_t maxN) {
+    std::vector<size_t> sizes;
+    size_t n = 1;
+    for (size_t i = 0; i < lo; ++i) n *= 10;
+    for (; n <= maxN; n *= 10) sizes.push_back(n);
+    return sizes;
+}
+
+// ============================================================
+// 堆分配统计
+//   在 #include 之前定义 BENCH_COUNT_ALLOCATIONS，本头文件会替换全局
+//   operator new/delete（每个可执行文件只能有一个翻译单元这样做）
+// ============================================================
+struct AllocStats {
+    size_t count = 0;      // 累计分配次数
+    size_t bytes = 0;      // 累计分配字节
+    size_t liveBytes = 0;  // 当前未释放字节
+};
+
+inline std::atomic<size_t> gAllocCount{0};
+inline std::atomic<size_t> gAllocBytes{0};
+inline std::atomic<size_t> gLiveBytes{0};
+
+inline AllocStats allocSnapshot() {
+    return {gAllocCount.load(std::memory_order_relaxed), gAllocBytes.load(std::memory_order_relaxed),
+            gLiveBytes.load(std::memory_order_relaxed)};
+}
+
+inline AllocStats operator-(const AllocStats& a, const AllocStats& b) {
+    return {a.count - b.count, a.bytes - b.bytes, a.liveBytes - b.liveBytes};
+}
+
+#ifdef BENCH_COUNT_ALLOCATIONS
+// 禁止内联：否则 GCC 会把 new/delete 配对展开，对 "p - 16" 误报越界
+#if defined(__GNUC__) || defined(__clang__)
+#define BENCH_NOINLINE __attribute__((noinline))
+#else
+#define BENCH_NOINLINE
+#endif
+
+// 在每块内存前面放 16 字节记录大小，delete 时才能知道释放了多少
+BENCH_NOINLINE void* operator new(std::size_t size) {
+    void* p = std::malloc(size + 16);
+    if (!p) throw std::bad_alloc();
+    *static_cast<std::size_t*>(p) = size;
+    gAllocCount.fetch_add(1, std::memory_order_relaxed);
+    gAllocBytes.fetch_add(size, std::memory_order_relaxed);
+    gLiveBytes.fetch_add(size, std::memory_order_relaxed);
+    return static_cast<char*>(p) + 16;
+}
+
+BENCH_NOINLINE void operator delete(void* p) noexcept {
+    if (!p) return;
+    void* base = static_cast<char*>(p) - 16;
+    gLiveBytes.fetch_sub(*static_cast<std::size_t*>(base), std::memory_order_relaxed);
+    std::free(base);
+}
+
+void* operator new[](std::size_t size) { return ::operator new(size); }
+void operator delete[](void* p) noexcept { ::operator delete(p); }
+void operator delete(void* p, std::size_t) noexcept { ::operator delete(p); }
+void operator delete[](void* p, std::size_t) noexcept { ::operator delete(p); }
+
+// 对齐版本（std::pmr::new_delete_resource 等会用到）：
+// 多申请 align + 16 字节，对齐后的地址前 16 字节记录原始指针和大小
+BENCH_NOINLINE void* operator new(std::size_t size, std::align_val_t al) {
+    std::size_t align = std::max<std::size_t>(static_cast<std::size_t>(al), 16);
+    void* raw = std::malloc(size + align + 16);
+    if (!raw) throw std::bad_alloc();
+    auto addr = (reinterpret_cast<std::uintptr_t>(raw) + 16 + align - 1) & ~std::uintptr_t(align - 1);
+    auto* header = reinterpret_cast<std::size_t*>(addr) - 2;
+    header[0] = reinterpret_cast<std::uintptr_t>(raw);
+    header[1] = size;
+    gAllocCount.fetch_add(1, std::memory_order_relaxed);
+    gAllocBytes.fetch_add(size, std::memory_order_relaxed);
+    gLiveBytes.fetch_add(size, std::memory_order_relaxed);
+    return reinterpret_cast<void*>(addr);
+}
+
+BENCH_NOINLINE void operator delete(void* p, std::align_val_t) noexcept {
+    if (!p) return;
+    auto* header = static_cast<std::size_t*>(p) - 2;
+    gLiveBytes.fetch_sub(header[1], std::memory_order_relaxed);
+    std::free(reinterpret_cast<void*>(header[0]));
+}
+
+void* operator new[](std::size_t size, std::align_val_t al) { return ::operator new(size, al); }
+void operator delete[](void* p, std::align_val_t al) noexcept { ::operator delete(p, al); }
+void operator delete(void* p, std::size_t, std::align_val_t al) noexcept { ::operator delete(p, al); }
+void operator delete[](void* p, std::size_t, std::align_val_t al) noexcept { ::operator delete(p, al); }
+#endif
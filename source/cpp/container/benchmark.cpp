@@ -0,0 +1,568 @@
+// Container benchmark —— level 1~7 所有标准容器的参数化负载测试
+// 涵盖：vector / deque / list / forward_list / array、stack / queue / priority_queue、
+//        set / multiset / map / multimap、unordered_set / unordered_map，
+//        元素类型 int、64 字节结构体、std::string（32 字符，超过 SSO），
+//        负载：顺序插入、随机插入、查找命中 / 未命中、删除、遍历、范围查询
+// 每个用例输出 ns/op、每次操作的堆分配次数与字节数、峰值常驻内存（RSS），格式为 CSV 或 JSON。
+//
+// 用法：./container_benchmark [n] [csv|json] [容器名过滤]
+//   ./container_benchmark 1000000 json map > result.json   只测名字里含 "map" 的容器
+// level7.cpp 的 demo_selection_guide 里的选型建议可以用它验证。
+//
+// 各负载的含义：
+//   insert_seq    ：按 key 升序逐个插入 n 个元素（序列容器是 push_back）
+//   insert_random ：关联容器按随机顺序插入 n 个；序列容器在已有 n 个元素的容器中随机位置插入
+//   lookup_hit    ：查找存在的 key；lookup_miss：查找不存在的 key（序列容器是 std::find 线性查找）
+//   erase         ：关联容器按随机顺序删除全部 key；序列容器删除随机位置；适配器 pop 到空
+//   iterate       ：遍历全部元素（ns / 元素）
+//   range         ：lower_bound 后顺序读 100 个元素（有序关联容器和有序的 vector / deque / array）
+// 序列容器上的随机位置插删、线性查找每次 O(n)，次数按 n 缩减，保证每个用例在秒级完成。
+// 不适用的组合（如 stack 的查找、unordered_map 的范围查询）不输出。
+
+#define BENCH_COUNT_ALLOCATIONS
+#include "bench_utils.h"
+#include "hash_utils.h"
+
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <forward_list>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <map>
+#include <memory>
+#include <queue>
+#include <random>
+#include <set>
+#include <stack>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+// ============================================================
+// 元素类型
+// ============================================================
+
+// 64 字节：key 之外是填充，拷贝 / 移动的代价与一个小结构体相当
+struct Blob64 {
+    uint64_t key = 0;
+    char payload[56] = {};
+
+    bool operator==(const Blob64& o) const { return key == o.key; }
+    bool operator<(const Blob64& o) const { return key < o.key; }
+};
+static_assert(sizeof(Blob64) == 64);
+
+template <>
+struct std::hash<Blob64> {
+    size_t operator()(const Blob64& b) const noexcept { return size_t(hash_mix(b.key)); }
+};
+
+// key 为 k 的元素；string 定宽补零，字典序与数值顺序一致
+template <typename T>
+T make_element(uint64_t k) {
+    if constexpr (std::is_same_v<T, int>) {
+        return int(k);
+    } else if constexpr (std::is_same_v<T, Blob64>) {
+        Blob64 b;
+        b.key = k;
+        return b;
+    } else {
+        char buf[40];
+        std::snprintf(buf, sizeof(buf), "key-%028llu", static_cast<unsigned long long>(k));
+        return std::string(buf);
+    }
+}
+
+// 遍历时读到的值，防止循环被优化掉
+inline uint64_t touch(int v) { return uint64_t(v); }
+inline uint64_t touch(const Blob64& b) { return b.key; }
+inline uint64_t touch(const std::string& s) { return uint64_t(s.size()) + uint8_t(s.back()); }
+template <typename K, typename V>
+uint64_t touch(const std::pair<const K, V>& kv) {
+    return touch(kv.first) + uint64_t(kv.second);
+}
+
+template <typename T>
+const char* element_name() {
+    if constexpr (std::is_same_v<T, int>) return "int";
+    else if constexpr (std::is_same_v<T, Blob64>) return "blob64";
+    else return "string";
+}
+
+// 一组 key：偶数 0, 2, ..., 2(n-1) 存在，奇数都不存在
+template <typename T>
+struct KeySet {
+    std::vector<T> sorted;          // 升序
+    std::vector<T> shuffled;        // 同一组 key 的随机排列
+    std::vector<T> misses;          // n 个不存在的 key，随机顺序
+    std::vector<uint64_t> randoms;  // 随机位置用的随机数
+
+    explicit KeySet(size_t n) {
+        std::mt19937_64 rng(n);
+        std::vector<uint64_t> order(n);
+        for (size_t i = 0; i < n; i++) order[i] = i;
+        std::shuffle(order.begin(), order.end(), rng);
+        sorted.reserve(n);
+        shuffled.reserve(n);
+        misses.reserve(n);
+        for (size_t i = 0; i < n; i++) {
+            sorted.push_back(make_element<T>(2 * i));
+            shuffled.push_back(make_element<T>(2 * order[i]));
+            misses.push_back(make_element<T>(2 * order[i] + 1));
+        }
+        randoms.resize(n);
+        for (auto& r : randoms) r = rng();
+    }
+};
+
+// ============================================================
+// 峰值常驻内存（KB）
+//   Linux：每个用例开始前往 /proc/self/clear_refs 写 5，把 VmHWM 重置为当前 RSS，再读
+//          /proc/self/status，得到的是这个用例（含输入数据）的峰值；之前先 malloc_trim，
+//          否则上一个用例释放的内存留在 glibc 的堆里，仍然算在 RSS 中。
+//          没有权限时退回 getrusage，是进程启动以来的峰值
+//   Windows：PeakWorkingSetSize，无法清零；macOS 等：getrusage
+// ============================================================
+class PeakRss {
+public:
+    // 返回 false 表示无法清零，之后读到的是进程级峰值
+    static bool reset() {
+#if defined(__linux__)
+#if defined(__GLIBC__)
+        malloc_trim(0);
+#endif
+        std::ofstream f("/proc/self/clear_refs");
+        return bool(f << "5" << std::flush);
+#else
+        return false;
+#endif
+    }
+
+    static size_t kb() {
+#if defined(_WIN32)
+        PROCESS_MEMORY_COUNTERS pmc;
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) return 0;
+        return size_t(pmc.PeakWorkingSetSize / 1024);
+#else
+#if defined(__linux__)
+        std::ifstream status("/proc/self/status");
+        for (std::string line; std::getline(status, line);)
+            if (line.compare(0, 6, "VmHWM:") == 0)
+                return size_t(std::strtoull(line.c_str() + 6, nullptr, 10));
+#endif
+        rusage ru{};
+        if (getrusage(RUSAGE_SELF, &ru) != 0) return 0;
+#if defined(__APPLE__)
+        return size_t(ru.ru_maxrss / 1024);  // macOS 的单位是字节
+#else
+        return size_t(ru.ru_maxrss);
+#endif
+#endif
+    }
+};
+
+// ============================================================
+// 结果收集与输出
+// ============================================================
+struct Row {
+    std::string container, element, workload;
+    size_t n, ops;
+    double nsPerOp, allocsPerOp, allocBytesPerOp;
+    size_t peakRssKb;
+};
+
+class Report {
+public:
+    explicit Report(std::string filter) : mFilter(std::move(filter)) {}
+
+    bool wants(const std::string& container) const {
+        return mFilter.empty() || container.find(mFilter) != std::string::npos;
+    }
+
+    // 一个用例：reset 在准备数据之前调用（峰值要包含容器本身），计时只包住 run
+    class Case {
+    public:
+        Case(Report& r, std::string container, const char* element, size_t n)
+            : mReport(r), mContainer(std::move(container)), mElement(element), mN(n) {}
+
+        template <typename Setup, typename Run>
+        void measure(const char* workload, size_t ops, Setup&& setup, Run&& run) {
+            if (!PeakRss::reset()) mReport.mRssPerCase = false;
+            auto state = setup();
+            auto before = allocSnapshot();
+            BenchTimer t;
+            run(state);
+            double ns = t.ns();
+            AllocStats a = allocSnapshot() - before;
+            size_t rss = PeakRss::kb();
+            doNotOptimize(state);
+            double d = double(std::max<size_t>(ops, 1));
+            mReport.mRows.push_back({mContainer, mElement, workload, mN, ops, ns / d,
+                                     double(a.count) / d, double(a.bytes) / d, rss});
+        }
+
+    private:
+        Report& mReport;
+        std::string mContainer;
+        const char* mElement;
+        size_t mN;
+    };
+
+    void print_csv(std::ostream& os) const {
+        os << "container,element,workload,n,ops,ns_per_op,allocs_per_op,alloc_bytes_per_op,"
+              "peak_rss_kb\n";
+        for (auto& r : mRows)
+            os << '"' << r.container << "\"," << r.element << ',' << r.workload << ',' << r.n << ','
+               << r.ops << ',' << std::fixed << std::setprecision(2) << r.nsPerOp << ','
+               << std::setprecision(3) << r.allocsPerOp << ',' << std::setprecision(1)
+               << r.allocBytesPerOp << ',' << r.peakRssKb << '\n';
+    }
+
+    void print_json(std::ostream& os) const {
+        os << "{\n  \"peak_rss_per_case\": " << (mRssPerCase ? "true" : "false")
+           << ",\n  \"results\": [\n";
+        for (size_t i = 0; i < mRows.size(); i++) {
+            auto& r = mRows[i];
+            os << "    {\"container\": \"" << r.container << "\", \"element\": \"" << r.element
+               << "\", \"workload\": \"" << r.workload << "\", \"n\": " << r.n
+               << ", \"ops\": " << r.ops << std::fixed << std::setprecision(2)
+               << ", \"ns_per_op\": " << r.nsPerOp << std::setprecision(3)
+               << ", \"allocs_per_op\": " << r.allocsPerOp << std::setprecision(1)
+               << ", \"alloc_bytes_per_op\": " << r.allocBytesPerOp
+               << ", \"peak_rss_kb\": " << r.peakRssKb << "}" << (i + 1 < mRows.size() ? "," : "")
+               << "\n";
+        }
+        os << "  ]\n}\n";
+    }
+
+    bool rss_per_case() const { return mRssPerCase; }
+
+private:
+    std::string mFilter;
+    std::vector<Row> mRows;
+    bool mRssPerCase = true;
+};
+
+// 每次 O(n) 的操作（线性查找、随机位置插删）的次数：总共访问约 2*10^7 个元素，最多 1000 次，
+// 也不超过 n（要用 n 个 key 里的前若干个）
+inline size_t linear_ops(size_t n) {
+    return std::min(n, std::clamp<size_t>(20000000 / std::max<size_t>(n, 1), 1, 1000));
+}
+
+constexpr size_t kRangeLength = 100;
+
+// 有序区间上的范围查询：[first, last) 升序；lower_bound 之后顺序读 kRangeLength 个
+template <typename It, typename T>
+uint64_t range_scan(It first, It last, const std::vector<T>& probes, size_t queries) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < queries; i++) {
+        auto it = std::lower_bound(first, last, probes[i]);
+        for (size_t j = 0; j < kRangeLength && it != last; j++, ++it) sum += touch(*it);
+    }
+    return sum;
+}
+
+// ============================================================
+// 序列容器：vector / deque / list
+// ============================================================
+template <typename C>
+void bench_sequence(Report& report, const char* name, const KeySet<typename C::value_type>& keys) {
+    using T = typename C::value_type;
+    constexpr bool kRandomAccess =
+        std::is_base_of_v<std::random_access_iterator_tag,
+                          typename std::iterator_traits<typename C::iterator>::iterator_category>;
+    size_t n = keys.sorted.size(), m = linear_ops(n);
+    Report::Case c(report, name, element_name<T>(), n);
+    auto build = [&] { return C(keys.sorted.begin(), keys.sorted.end()); };
+
+    c.measure("insert_seq", n, [] { return C(); }, [&](C& v) {
+        for (auto& k : keys.sorted) v.push_back(k);
+    });
+    c.measure("insert_random", m, build, [&](C& v) {
+        for (size_t i = 0; i < m; i++)
+            v.insert(std::next(v.begin(), ptrdiff_t(keys.randoms[i] % (v.size() + 1))),
+                     keys.shuffled[i]);
+    });
+    c.measure("lookup_hit", m, build, [&](C& v) {
+        size_t found = 0;
+        for (size_t i = 0; i < m; i++)
+            found += std::find(v.begin(), v.end(), keys.shuffled[i]) != v.end();
+        doNotOptimize(found);
+    });
+    c.measure("lookup_miss", m, build, [&](C& v) {
+        size_t found = 0;
+        for (size_t i = 0; i < m; i++)
+            found += std::find(v.begin(), v.end(), keys.misses[i]) != v.end();
+        doNotOptimize(found);
+    });
+    c.measure("erase", m, build, [&](C& v) {
+        for (size_t i = 0; i < m && !v.empty(); i++)
+            v.erase(std::next(v.begin(), ptrdiff_t(keys.randoms[i] % v.size())));
+    });
+    c.measure("iterate", n, build, [&](C& v) {
+        uint64_t sum = 0;
+        for (auto& x : v) sum += touch(x);
+        doNotOptimize(sum);
+    });
+    if constexpr (kRandomAccess) {
+        size_t q = std::min<size_t>(n, 100000);
+        c.measure("range", q, build, [&](C& v) {
+            doNotOptimize(range_scan(v.begin(), v.end(), keys.shuffled, q));
+        });
+    }
+}
+
+// forward_list 没有 push_back / size，插删都在给定位置"之后"
+template <typename T>
+void bench_forward_list(Report& report, const KeySet<T>& keys) {
+    using C = std::forward_list<T>;
+    size_t n = keys.sorted.size(), m = linear_ops(n);
+    Report::Case c(report, "std::forward_list", element_name<T>(), n);
+    auto build = [&] { return C(keys.sorted.begin(), keys.sorted.end()); };
+
+    c.measure("insert_seq", n, [] { return C(); }, [&](C& l) {
+        auto tail = l.before_begin();
+        for (auto& k : keys.sorted) tail = l.insert_after(tail, k);
+    });
+    c.measure("insert_random", m, build, [&](C& l) {
+        size_t size = n;
+        for (size_t i = 0; i < m; i++, size++)
+            l.insert_after(std::next(l.before_begin(), ptrdiff_t(keys.randoms[i] % (size + 1))),
+                           keys.shuffled[i]);
+    });
+    c.measure("lookup_hit", m, build, [&](C& l) {
+        size_t found = 0;
+        for (size_t i = 0; i < m; i++)
+            found += std::find(l.begin(), l.end(), keys.shuffled[i]) != l.end();
+        doNotOptimize(found);
+    });
+    c.measure("lookup_miss", m, build, [&](C& l) {
+        size_t found = 0;
+        for (size_t i = 0; i < m; i++)
+            found += std::find(l.begin(), l.end(), keys.misses[i]) != l.end();
+        doNotOptimize(found);
+    });
+    c.measure("erase", m, build, [&](C& l) {
+        size_t size = n;
+        for (size_t i = 0; i < m && size > 0; i++, size--)
+            l.erase_after(std::next(l.before_begin(), ptrdiff_t(keys.randoms[i] % size)));
+    });
+    c.measure("iterate", n, build, [&](C& l) {
+        uint64_t sum = 0;
+        for (auto& x : l) sum += touch(x);
+        doNotOptimize(sum);
+    });
+}
+
+// std::array 的大小是编译期常量，只测固定的 kArraySize 个元素（取 key 的前 kArraySize 个）
+constexpr size_t kArraySize = 4096;
+
+template <typename T>
+void bench_array(Report& report, const KeySet<T>& keys) {
+    using C = std::array<T, kArraySize>;
+    if (keys.sorted.size() < kArraySize) return;
+    size_t m = linear_ops(kArraySize);
+    Report::Case c(report, "std::array", element_name<T>(), kArraySize);
+    // 放在堆上：string / blob64 的数组有几百 KB
+    auto build = [&] {
+        auto a = std::make_unique<C>();
+        std::copy_n(keys.sorted.begin(), kArraySize, a->begin());
+        return a;
+    };
+    // 查找的 key 从前 kArraySize 个里随机挑（key 是 2i，i < kArraySize）
+    std::vector<T> hits, misses;
+    for (size_t i = 0; i < m; i++) {
+        hits.push_back(keys.sorted[keys.randoms[i] % kArraySize]);
+        misses.push_back(make_element<T>(2 * (keys.randoms[i] % kArraySize) + 1));
+    }
+
+    c.measure("insert_seq", kArraySize, [] { return std::make_unique<C>(); },
+              [&](std::unique_ptr<C>& a) {
+                  std::copy_n(keys.sorted.begin(), kArraySize, a->begin());
+              });
+    c.measure("lookup_hit", m, build, [&](std::unique_ptr<C>& a) {
+        size_t found = 0;
+        for (auto& k : hits) found += std::find(a->begin(), a->end(), k) != a->end();
+        doNotOptimize(found);
+    });
+    c.measure("lookup_miss", m, build, [&](std::unique_ptr<C>& a) {
+        size_t found = 0;
+        for (auto& k : misses) found += std::find(a->begin(), a->end(), k) != a->end();
+        doNotOptimize(found);
+    });
+    c.measure("iterate", kArraySize, build, [&](std::unique_ptr<C>& a) {
+        uint64_t sum = 0;
+        for (auto& x : *a) sum += touch(x);
+        doNotOptimize(sum);
+    });
+    c.measure("range", m, build, [&](std::unique_ptr<C>& a) {
+        doNotOptimize(range_scan(a->begin(), a->end(), hits, m));
+    });
+}
+
+// ============================================================
+// 容器适配器：stack / queue / priority_queue
+//   只有 push / pop：insert_seq 压入升序 key，insert_random 压入随机顺序的 key，erase 弹出到空
+// ============================================================
+template <typename C>
+void bench_adapter(Report& report, const char* name, const KeySet<typename C::value_type>& keys) {
+    using T = typename C::value_type;
+    size_t n = keys.sorted.size();
+    Report::Case c(report, name, element_name<T>(), n);
+
+    c.measure("insert_seq", n, [] { return C(); }, [&](C& s) {
+        for (auto& k : keys.sorted) s.push(k);
+    });
+    c.measure("insert_random", n, [] { return C(); }, [&](C& s) {
+        for (auto& k : keys.shuffled) s.push(k);
+    });
+    auto build = [&] {
+        C s;
+        for (auto& k : keys.shuffled) s.push(k);
+        return s;
+    };
+    c.measure("erase", n, build, [&](C& s) {
+        uint64_t sum = 0;
+        while (!s.empty()) {
+            if constexpr (requires { s.top(); }) sum += touch(s.top());
+            else sum += touch(s.front());
+            s.pop();
+        }
+        doNotOptimize(sum);
+    });
+}
+
+// ============================================================
+// 关联容器：set / multiset / map / multimap / unordered_set / unordered_map
+// ============================================================
+template <typename C>
+void bench_associative(Report& report, const char* name, const KeySet<typename C::key_type>& keys) {
+    using K = typename C::key_type;
+    constexpr bool kMap = requires { typename C::mapped_type; };
+    constexpr bool kOrdered = requires { typename C::key_compare; };
+    size_t n = keys.sorted.size();
+    Report::Case c(report, name, element_name<K>(), n);
+
+    auto insert = [](C& m, const K& k) {
+        if constexpr (kMap) m.emplace(k, 1);
+        else m.insert(k);
+    };
+    auto build = [&] {
+        C m;
+        for (auto& k : keys.shuffled) insert(m, k);
+        return m;
+    };
+
+    c.measure("insert_seq", n, [] { return C(); }, [&](C& m) {
+        for (auto& k : keys.sorted) insert(m, k);
+    });
+    c.measure("insert_random", n, [] { return C(); }, [&](C& m) {
+        for (auto& k : keys.shuffled) insert(m, k);
+    });
+    c.measure("lookup_hit", n, build, [&](C& m) {
+        size_t found = 0;
+        for (auto& k : keys.sorted) found += m.find(k) != m.end();
+        doNotOptimize(found);
+    });
+    c.measure("lookup_miss", n, build, [&](C& m) {
+        size_t found = 0;
+        for (auto& k : keys.misses) found += m.find(k) != m.end();
+        doNotOptimize(found);
+    });
+    c.measure("erase", n, build, [&](C& m) {
+        for (auto& k : keys.shuffled) m.erase(k);
+    });
+    c.measure("iterate", n, build, [&](C& m) {
+        uint64_t sum = 0;
+        for (auto& x : m) sum += touch(x);
+        doNotOptimize(sum);
+    });
+    if constexpr (kOrdered) {
+        size_t q = std::min<size_t>(n, 100000);
+        c.measure("range", q, build, [&](C& m) {
+            uint64_t sum = 0;
+            for (size_t i = 0; i < q; i++) {
+                auto it = m.lower_bound(keys.shuffled[i]);
+                for (size_t j = 0; j < kRangeLength && it != m.end(); j++, ++it) sum += touch(*it);
+            }
+            doNotOptimize(sum);
+        });
+    }
+}
+
+// ============================================================
+// 一种元素类型的全部容器
+// ============================================================
+template <typename T>
+void bench_element(Report& report, size_t n) {
+    KeySet<T> keys(n);
+    auto run = [&](const char* name, auto&& f) {
+        if (report.wants(name)) f(name);
+    };
+
+    run("std::vector", [&](const char* s) { bench_sequence<std::vector<T>>(report, s, keys); });
+    run("std::deque", [&](const char* s) { bench_sequence<std::deque<T>>(report, s, keys); });
+    run("std::list", [&](const char* s) { bench_sequence<std::list<T>>(report, s, keys); });
+    run("std::forward_list", [&](const char*) { bench_forward_list(report, keys); });
+    run("std::array", [&](const char*) { bench_array(report, keys); });
+
+    run("std::stack", [&](const char* s) { bench_adapter<std::stack<T>>(report, s, keys); });
+    run("std::queue", [&](const char* s) { bench_adapter<std::queue<T>>(report, s, keys); });
+    run("std::priority_queue",
+        [&](const char* s) { bench_adapter<std::priority_queue<T>>(report, s, keys); });
+
+    run("std::set", [&](const char* s) { bench_associative<std::set<T>>(report, s, keys); });
+    run("std::multiset",
+        [&](const char* s) { bench_associative<std::multiset<T>>(report, s, keys); });
+    run("std::map", [&](const char* s) { bench_associative<std::map<T, int>>(report, s, keys); });
+    run("std::multimap",
+        [&](const char* s) { bench_associative<std::multimap<T, int>>(report, s, keys); });
+    run("std::unordered_set",
+        [&](const char* s) { bench_associative<std::unordered_set<T>>(report, s, keys); });
+    run("std::unordered_map",
+        [&](const char* s) { bench_associative<std::unordered_map<T, int>>(report, s, keys); });
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+    std::string format = argc > 2 ? argv[2] : "csv";
+    Report report(argc > 3 ? argv[3] : "");
+    if (n == 0 || (format != "csv" && format != "json")) {
+        std::cerr << "usage: " << argv[0] << " [n] [csv|json] [container filter]\n";
+        return 1;
+    }
+
+    bench_element<int>(report, n);
+    bench_element<Blob64>(report, n);
+    bench_element<std::string>(report, n);
+
+    if (format == "json") report.print_json(std::cout);
+    else report.print_csv(std::cout);
+    if (!report.rss_per_case())
+        std::cerr << "note: peak_rss_kb 无法按用例清零，是进程启动以来的峰值\n";
+    return 0;
+}
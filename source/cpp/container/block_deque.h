@@ -0,0 +1,402 @@
+#pragma once
+
+// block_deque.h: 块大小可配置、可按连续段访问的双端队列
+//
+// std::deque 的内部也是"一组定长块 + 块指针表"，但有两个限制：
+//   - 块大小由实现决定：libstdc++ 固定 512 字节（元素超过 512 字节时每块只放 1 个），
+//     MSVC 更小（16 字节或 1 个元素）。大记录的 deque 几乎退化成"每个元素一次分配"的链表
+//   - 不暴露内部的连续段：没有 data()，想用 SIMD / std::span 批量处理只能逐个元素走迭代器
+//
+// block_deque<T, BlockSize> 的做法：
+//   - BlockSize 为每块的元素个数（2 的幂，下标换算只用移位和掩码），
+//     默认取 >= 4KB 且至少 16 个元素
+//   - 块指针表是环形数组：push_front 只需把起点往前挪一格，不会像 std::deque 那样把整张表居中重排；
+//     表满时容量翻倍
+//   - 队头 / 队尾空出的块保留一个作为备用，队列式的"尾进头出"稳定后不再分配内存
+//   - segments() 按顺序给出每一段连续元素的 std::span<T>（首尾两段可能不满），
+//     可以直接交给接受 span 的函数或向量化的循环
+//
+// 接口是 std::deque 的两端操作子集：push / emplace / pop 两端、operator[] / at、随机访问迭代器、
+// resize / clear / swap；不提供中间的 insert / erase（需要时用 std::deque 或 vector）。
+// 失效规则与 std::deque 相同：两端插删使所有迭代器失效，但已有元素的引用和指针保持有效
+// （块从不移动）；pop 只使被删元素的引用失效。
+
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+template <typename T>
+inline constexpr size_t block_deque_default_block =
+    std::bit_ceil(std::max<size_t>(16, (4096 + sizeof(T) - 1) / sizeof(T)));
+
+template <typename T, size_t BlockSize = block_deque_default_block<T>>
+class block_deque {
+    static_assert(std::has_single_bit(BlockSize), "block_deque 的块大小必须是 2 的幂");
+    static constexpr size_t kShift = size_t(std::countr_zero(BlockSize));
+    static constexpr size_t kOffsetMask = BlockSize - 1;
+
+    // 迭代器保存逻辑位置 mPos（从环形表第 0 块起算，不取模），并缓存当前元素的指针；
+    // 只在跨块时重新查表
+    template <bool Const>
+    class basic_iterator {
+        using Elem = std::conditional_t<Const, const T, T>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using iterator_concept = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using reference = Elem&;
+        using pointer = Elem*;
+
+        basic_iterator() = default;
+        basic_iterator(T* const* ring, size_t ringMask, size_t pos)
+            : mRing(ring), mRingMask(ringMask), mPos(pos) {
+            reload();
+        }
+        operator basic_iterator<true>() const
+            requires(!Const)
+        {
+            return basic_iterator<true>(mRing, mRingMask, mPos);
+        }
+
+        Elem& operator*() const { return *mCur; }
+        Elem* operator->() const { return mCur; }
+        Elem& operator[](difference_type n) const { return *(*this + n); }
+
+        basic_iterator& operator++() {
+            if ((++mPos & kOffsetMask) == 0) reload();
+            else ++mCur;
+            return *this;
+        }
+        basic_iterator operator++(int) {
+            auto t = *this;
+            ++*this;
+            return t;
+        }
+        basic_iterator& operator--() {
+            if ((mPos-- & kOffsetMask) == 0) reload();
+            else --mCur;
+            return *this;
+        }
+        basic_iterator operator--(int) {
+            auto t = *this;
+            --*this;
+            return t;
+        }
+        basic_iterator& operator+=(difference_type n) {
+            mPos += size_t(n);
+            reload();
+            return *this;
+        }
+        basic_iterator& operator-=(difference_type n) { return *this += -n; }
+        friend basic_iterator operator+(basic_iterator it, difference_type n) { return it += n; }
+        friend basic_iterator operator+(difference_type n, basic_iterator it) { return it += n; }
+        friend basic_iterator operator-(basic_iterator it, difference_type n) { return it -= n; }
+        friend difference_type operator-(const basic_iterator& a, const basic_iterator& b) {
+            return difference_type(a.mPos - b.mPos);
+        }
+        friend bool operator==(const basic_iterator& a, const basic_iterator& b) {
+            return a.mPos == b.mPos;
+        }
+        friend std::strong_ordering operator<=>(const basic_iterator& a, const basic_iterator& b) {
+            return a.mPos <=> b.mPos;
+        }
+
+    private:
+        // end() 可能落在还没分配的块上：那时 mCur 是空指针加偏移，只比较、不解引用
+        void reload() {
+            mCur = mRing ? mRing[(mPos >> kShift) & mRingMask] + (mPos & kOffsetMask) : nullptr;
+        }
+
+        T* const* mRing = nullptr;
+        size_t mRingMask = 0;
+        size_t mPos = 0;
+        T* mCur = nullptr;
+    };
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    static constexpr size_t block_size = BlockSize;
+
+    // ---------- 构造 / 析构 / 赋值 ----------
+    block_deque() noexcept = default;
+    explicit block_deque(size_t count) { resize(count); }
+    block_deque(size_t count, const T& value) { resize(count, value); }
+    template <typename It, typename = std::enable_if_t<!std::is_integral_v<It>>>
+    block_deque(It first, It last) {
+        for (; first != last; ++first) emplace_back(*first);
+    }
+    block_deque(std::initializer_list<T> init) : block_deque(init.begin(), init.end()) {}
+
+    block_deque(const block_deque& o) : block_deque(o.begin(), o.end()) {}
+    block_deque(block_deque&& o) noexcept
+        : mRing(std::move(o.mRing)),
+          mFirst(std::exchange(o.mFirst, 0)),
+          mBlocks(std::exchange(o.mBlocks, 0)),
+          mStart(std::exchange(o.mStart, 0)),
+          mSize(std::exchange(o.mSize, 0)),
+          mHead(std::exchange(o.mHead, nullptr)),
+          mTail(std::exchange(o.mTail, nullptr)),
+          mTailEnd(std::exchange(o.mTailEnd, nullptr)),
+          mSpare(std::exchange(o.mSpare, nullptr)) {
+        o.mRing.clear();
+    }
+    block_deque& operator=(block_deque o) noexcept {
+        swap(o);
+        return *this;
+    }
+    ~block_deque() {
+        clear();
+        freeBlock(mSpare);
+    }
+
+    // ---------- 元素访问 ----------
+    T& operator[](size_t i) {
+        size_t pos = mStart + i;
+        return block(pos >> kShift)[pos & kOffsetMask];
+    }
+    const T& operator[](size_t i) const { return const_cast<block_deque&>(*this)[i]; }
+    T& at(size_t i) {
+        if (i >= mSize) throw std::out_of_range("block_deque::at");
+        return (*this)[i];
+    }
+    const T& at(size_t i) const { return const_cast<block_deque&>(*this).at(i); }
+    T& front() { return mHead[mStart]; }
+    const T& front() const { return const_cast<block_deque&>(*this).front(); }
+    T& back() { return mTail[-1]; }
+    const T& back() const { return mTail[-1]; }
+
+    // ---------- 连续段 ----------
+    // 第 k 段是第 k 块里实际存放元素的部分；遍历所有段等价于按顺序遍历所有元素
+    size_t segment_count() const noexcept {
+        return mSize == 0 ? 0 : ((mStart + mSize - 1) >> kShift) + 1;
+    }
+    std::span<T> segment(size_t k) {
+        size_t lo = k == 0 ? mStart : 0;
+        size_t hi = k + 1 == segment_count() ? ((mStart + mSize - 1) & kOffsetMask) + 1 : BlockSize;
+        return {block(k) + lo, hi - lo};
+    }
+    std::span<const T> segment(size_t k) const { return const_cast<block_deque&>(*this).segment(k); }
+
+    // for (std::span<T> s : dq.segments()) ...
+    auto segments() {
+        return std::views::iota(size_t(0), segment_count()) |
+               std::views::transform([this](size_t k) { return segment(k); });
+    }
+    auto segments() const {
+        return std::views::iota(size_t(0), segment_count()) |
+               std::views::transform([this](size_t k) { return segment(k); });
+    }
+
+    // ---------- 迭代器 ----------
+    iterator begin() noexcept { return {mRing.data(), ringMask(), mFirst * BlockSize + mStart}; }
+    iterator end() noexcept { return begin() + difference_type(mSize); }
+    const_iterator begin() const noexcept { return const_cast<block_deque&>(*this).begin(); }
+    const_iterator end() const noexcept { return const_cast<block_deque&>(*this).end(); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+    // ---------- 容量 ----------
+    bool empty() const noexcept { return mSize == 0; }
+    size_t size() const noexcept { return mSize; }
+    size_t max_size() const noexcept { return size_t(PTRDIFF_MAX) / sizeof(T); }
+    // 块（含备用块）+ 块指针表占用的字节
+    size_t memory_usage() const noexcept {
+        return (mBlocks + (mSpare != nullptr)) * BlockSize * sizeof(T) + mRing.capacity() * sizeof(T*);
+    }
+
+    // 释放备用块，把块指针表缩到刚好够用
+    void shrink_to_fit() {
+        freeBlock(std::exchange(mSpare, nullptr));
+        size_t cap = mBlocks == 0 ? 0 : std::bit_ceil(mBlocks);
+        if (cap < mRing.size()) rebuildRing(cap);
+    }
+
+    // ---------- 修改 ----------
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        bool attached = mTail == mTailEnd;  // 最后一块已满（或还没有块）：在尾部接一块
+        if (attached) [[unlikely]]
+            attachBack();
+        try {
+            std::construct_at(mTail, std::forward<Args>(args)...);
+        } catch (...) {
+            if (attached) detachBack();
+            throw;
+        }
+        mSize++;
+        return *mTail++;
+    }
+
+    template <typename... Args>
+    T& emplace_front(Args&&... args) {
+        bool attached = mStart == 0;  // 第一块的头部已用完：在环形表里往前挪一格，接一块新的
+        if (attached) [[unlikely]]
+            attachFront();
+        try {
+            std::construct_at(mHead + mStart - 1, std::forward<Args>(args)...);
+        } catch (...) {
+            if (attached) detachFront();
+            throw;
+        }
+        mStart--;
+        mSize++;
+        return mHead[mStart];
+    }
+
+    void push_back(const T& v) { emplace_back(v); }
+    void push_back(T&& v) { emplace_back(std::move(v)); }
+    void push_front(const T& v) { emplace_front(v); }
+    void push_front(T&& v) { emplace_front(std::move(v)); }
+
+    void pop_back() {
+        std::destroy_at(--mTail);
+        mSize--;
+        if (mTail == mTailEnd - BlockSize) detachBack();  // 最后一块空了
+    }
+
+    void pop_front() {
+        std::destroy_at(mHead + mStart);
+        mSize--;
+        if (++mStart == BlockSize) detachFront();  // 第一块空了
+    }
+
+    void resize(size_t count) {
+        while (mSize > count) pop_back();
+        while (mSize < count) emplace_back();
+    }
+    void resize(size_t count, const T& value) {
+        while (mSize > count) pop_back();
+        while (mSize < count) emplace_back(value);
+    }
+
+    // 析构所有元素；块归还（保留一个备用），块指针表保留
+    void clear() noexcept {
+        for (auto s : segments()) std::destroy(s.begin(), s.end());
+        for (size_t k = 0; k < mBlocks; k++) releaseBlock(std::exchange(block(k), nullptr));
+        mFirst = mBlocks = mStart = mSize = 0;
+        syncCursors();
+    }
+
+    void swap(block_deque& o) noexcept {
+        mRing.swap(o.mRing);
+        std::swap(mFirst, o.mFirst);
+        std::swap(mBlocks, o.mBlocks);
+        std::swap(mStart, o.mStart);
+        std::swap(mSize, o.mSize);
+        std::swap(mHead, o.mHead);
+        std::swap(mTail, o.mTail);
+        std::swap(mTailEnd, o.mTailEnd);
+        std::swap(mSpare, o.mSpare);
+    }
+    friend void swap(block_deque& a, block_deque& b) noexcept { a.swap(b); }
+
+    // ---------- 比较 ----------
+    friend bool operator==(const block_deque& a, const block_deque& b) {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end());
+    }
+    friend auto operator<=>(const block_deque& a, const block_deque& b) {
+        return std::lexicographical_compare_three_way(a.begin(), a.end(), b.begin(), b.end());
+    }
+
+private:
+    size_t ringMask() const noexcept { return mRing.empty() ? 0 : mRing.size() - 1; }
+    // 第 k 个块（从第一个元素所在的块起算）在环形表里的槽位
+    T*& block(size_t k) noexcept { return mRing[(mFirst + k) & ringMask()]; }
+
+    // 把块按顺序搬到容量为 cap 的新表的开头
+    void rebuildRing(size_t cap) {
+        std::vector<T*> ring(cap, nullptr);
+        for (size_t k = 0; k < mBlocks; k++) ring[k] = block(k);
+        mRing.swap(ring);
+        mFirst = 0;
+    }
+
+    void attachBack() {
+        if (mBlocks == mRing.size()) rebuildRing(std::max<size_t>(8, mRing.size() * 2));
+        block(mBlocks) = acquireBlock();
+        mBlocks++;
+        syncCursors();
+    }
+    void detachBack() noexcept {
+        mBlocks--;
+        releaseBlock(std::exchange(block(mBlocks), nullptr));
+        if (mBlocks == 0) mStart = 0;
+        syncCursors();
+    }
+    // 新块挂在最前面，mStart 指向它的末尾之后
+    void attachFront() {
+        if (mBlocks == mRing.size()) rebuildRing(std::max<size_t>(8, mRing.size() * 2));
+        mFirst = (mFirst - 1) & ringMask();
+        block(0) = acquireBlock();
+        mBlocks++;
+        mStart = BlockSize;
+        syncCursors();
+    }
+    void detachFront() noexcept {
+        releaseBlock(std::exchange(block(0), nullptr));
+        mFirst = (mFirst + 1) & ringMask();
+        mBlocks--;
+        mStart = 0;
+        syncCursors();
+    }
+
+    // 块结构变化后重新计算首块指针和尾部游标（每 BlockSize 次插删才发生一次）
+    void syncCursors() noexcept {
+        if (mBlocks == 0) {
+            mHead = mTail = mTailEnd = nullptr;
+            return;
+        }
+        mHead = block(0);
+        T* last = block(mBlocks - 1);
+        mTail = last + (mStart + mSize - (mBlocks - 1) * BlockSize);
+        mTailEnd = last + BlockSize;
+    }
+
+    T* acquireBlock() {
+        if (mSpare) return std::exchange(mSpare, nullptr);
+        return std::allocator<T>().allocate(BlockSize);
+    }
+    void releaseBlock(T* b) noexcept {
+        if (!mSpare) mSpare = b;
+        else freeBlock(b);
+    }
+    static void freeBlock(T* b) noexcept {
+        if (b) std::allocator<T>().deallocate(b, BlockSize);
+    }
+
+    std::vector<T*> mRing;  // 环形块指针表，容量为 2 的幂
+    size_t mFirst = 0;      // 第一个块在 mRing 里的槽位
+    size_t mBlocks = 0;     // 已挂上的块数
+    size_t mStart = 0;      // 第一个元素在第一个块内的偏移，< BlockSize
+    size_t mSize = 0;
+    T* mHead = nullptr;     // 第一个块（== block(0)）
+    T* mTail = nullptr;     // 下一个 push_back 的位置
+    T* mTailEnd = nullptr;  // 最后一个块的末尾
+    T* mSpare = nullptr;    // 备用块
+};
@@ -0,0 +1,648 @@
+#pragma once
+
+// btree_map.h: 内存 B+ 树有序映射
+//
+// 与 std::map（红黑树，每元素一个节点、每次比较一次 cache miss）相比：
+//   - 每个节点存几十个 key，key 数组按 cache line 对齐，整个数组占 NodeBytes 字节；
+//     树高只有 log_{几十}(n)，一次查找只碰 3~5 个节点
+//   - 节点内查找：整数 key 用 SIMD 一次比较 4 个（SSE2，32 位 key；64 位 key 需要
+//     SSE4.2 / AVX2），统计"比 k 小的 key 个数"即得到位置，没有难以预测的分支
+//   - 所有元素都在叶子里，叶子之间双向链接：lower_bound 定位后顺着链表扫描，
+//     范围查询接近顺序读数组
+//   - bulk_load：从有序输入自底向上直接填满叶子并逐层建索引，O(n)
+//
+// 内部节点的第 i 个 key 是 children[i+1] 子树里的最小 key（的下界），等于 key 的查找走右边。
+// 删除时节点不足半满会向兄弟借或与兄弟合并，保证所有节点（根除外）至少半满。
+// 任何插入/删除都可能使迭代器失效。Key 和 Value 需要可默认构造。
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BTREE_SSE2 1
+#else
+#define BTREE_SSE2 0
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define BTREE_AVX2 1
+#else
+#define BTREE_AVX2 0
+#endif
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#define BTREE_SSE42 1
+#else
+#define BTREE_SSE42 0
+#endif
+
+// ============================================================
+// 节点内查找：返回 keys[0..n) 中 < k（或 <= k）的个数
+// ============================================================
+template <typename Key>
+constexpr bool btree_simd_key =
+    std::is_integral_v<Key> && !std::is_same_v<Key, bool> &&
+    (sizeof(Key) == 4 ? BTREE_SSE2 : sizeof(Key) == 8 ? (BTREE_SSE42 || BTREE_AVX2) : false);
+
+// OrEqual=false：count(key < k)，即 lower_bound 位置
+// OrEqual=true ：count(key <= k)，即 upper_bound 位置
+// 每轮比较一个向量宽度的 key，movemask + popcount 累加，尾部不足一个向量的部分逐个比较
+template <bool OrEqual, typename Key>
+inline int btree_simd_count(const Key* keys, int n, Key k) {
+    // SSE / AVX 只有有符号比较：无符号数先翻转符号位
+    using S = std::make_signed_t<Key>;
+    constexpr Key kFlip = std::is_unsigned_v<Key> ? Key(Key(1) << (sizeof(Key) * 8 - 1)) : Key(0);
+    const S sk = static_cast<S>(k ^ kFlip);
+    int hits = 0;  // 向量部分：OrEqual ? count(key > k) : count(key < k)
+    int i = 0;
+    if constexpr (sizeof(Key) == 4) {
+#if BTREE_SSE2
+        const __m128i flip = _mm_set1_epi32(static_cast<int>(kFlip));
+        const __m128i vk = _mm_set1_epi32(sk);
+        for (; i + 4 <= n; i += 4) {
+            __m128i v = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i)), flip);
+            __m128i m = OrEqual ? _mm_cmpgt_epi32(v, vk) : _mm_cmplt_epi32(v, vk);
+            hits += std::popcount(static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(m))));
+        }
+#endif
+    } else {
+#if BTREE_AVX2
+        const __m256i flip = _mm256_set1_epi64x(static_cast<long long>(kFlip));
+        const __m256i vk = _mm256_set1_epi64x(sk);
+        for (; i + 4 <= n; i += 4) {
+            __m256i v = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i)), flip);
+            __m256i m = OrEqual ? _mm256_cmpgt_epi64(v, vk) : _mm256_cmpgt_epi64(vk, v);
+            hits += std::popcount(static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(m))));
+        }
+#elif BTREE_SSE42
+        const __m128i flip = _mm_set1_epi64x(static_cast<long long>(kFlip));
+        const __m128i vk = _mm_set1_epi64x(sk);
+        for (; i + 2 <= n; i += 2) {
+            __m128i v = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i)), flip);
+            __m128i m = OrEqual ? _mm_cmpgt_epi64(v, vk) : _mm_cmpgt_epi64(vk, v);
+            hits += std::popcount(static_cast<unsigned>(_mm_movemask_pd(_mm_castsi128_pd(m))));
+        }
+#endif
+    }
+    int cnt = OrEqual ? i - hits : hits;
+    for (; i < n; ++i) {
+        S v = static_cast<S>(keys[i] ^ kFlip);
+        cnt += OrEqual ? (v <= sk) : (v < sk);
+    }
+    return cnt;
+}
+
+// ============================================================
+// btree_map
+// ============================================================
+template <typename Key, typename Value, typename Compare = std::less<Key>, size_t NodeBytes = 256>
+class btree_map {
+    static_assert(std::is_default_constructible_v<Key> && std::is_default_constructible_v<Value>,
+                  "btree_map 的节点用定长数组存放 key / value");
+
+    static constexpr int kLeafCap = int(NodeBytes / sizeof(Key)) < 4 ? 4 : int(NodeBytes / sizeof(Key));
+    static constexpr int kInnerCap = kLeafCap;
+    static constexpr int kLeafMin = kLeafCap / 2;
+    static constexpr int kInnerMin = kInnerCap / 2;
+    static constexpr bool kSimd = btree_simd_key<Key> && std::is_same_v<Compare, std::less<Key>>;
+
+    struct alignas(64) Node {
+        Key keys[kLeafCap];
+        int count = 0;
+        bool leaf;
+        explicit Node(bool isLeaf) : leaf(isLeaf) {}
+    };
+    struct Leaf : Node {
+        Leaf() : Node(true) {}
+        Value values[kLeafCap];
+        Leaf* prev = nullptr;
+        Leaf* next = nullptr;
+    };
+    struct Inner : Node {
+        Inner() : Node(false) {}
+        Node* children[kInnerCap + 1];
+    };
+
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using size_type = size_t;
+
+    // 前向迭代器：(叶子, 下标)，解引用得到 pair<const Key&, Value&>
+    template <bool Const>
+    class basic_iterator {
+        friend class btree_map;
+        using LeafPtr = std::conditional_t<Const, const Leaf*, Leaf*>;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = std::pair<Key, Value>;
+        using reference = std::pair<const Key&, std::conditional_t<Const, const Value&, Value&>>;
+        struct pointer {
+            reference ref;
+            reference* operator->() { return &ref; }
+        };
+
+        basic_iterator() = default;
+        template <bool C = Const, typename = std::enable_if_t<C>>
+        basic_iterator(const basic_iterator<false>& o) : mLeaf(o.mLeaf), mIdx(o.mIdx) {}
+
+        reference operator*() const { return {mLeaf->keys[mIdx], mLeaf->values[mIdx]}; }
+        pointer operator->() const { return {**this}; }
+
+        basic_iterator& operator++() {
+            if (++mIdx == mLeaf->count) {
+                mLeaf = mLeaf->next;
+                mIdx = 0;
+            }
+            return *this;
+        }
+        basic_iterator operator++(int) {
+            auto t = *this;
+            ++*this;
+            return t;
+        }
+        friend bool operator==(const basic_iterator& a, const basic_iterator& b) {
+            return a.mLeaf == b.mLeaf && a.mIdx == b.mIdx;
+        }
+        friend bool operator!=(const basic_iterator& a, const basic_iterator& b) { return !(a == b); }
+
+    private:
+        template <bool>
+        friend class basic_iterator;
+        basic_iterator(LeafPtr leaf, int idx) : mLeaf(leaf), mIdx(idx) {}
+
+        LeafPtr mLeaf = nullptr;
+        int mIdx = 0;
+    };
+
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    btree_map() = default;
+    ~btree_map() { clear(); }
+    btree_map(const btree_map&) = delete;
+    btree_map& operator=(const btree_map&) = delete;
+    btree_map(btree_map&& o) noexcept
+        : mRoot(std::exchange(o.mRoot, nullptr)),
+          mHead(std::exchange(o.mHead, nullptr)),
+          mSize(std::exchange(o.mSize, 0)),
+          mHeight(std::exchange(o.mHeight, 0)) {}
+    btree_map& operator=(btree_map&& o) noexcept {
+        if (this != &o) {
+            clear();
+            mRoot = std::exchange(o.mRoot, nullptr);
+            mHead = std::exchange(o.mHead, nullptr);
+            mSize = std::exchange(o.mSize, 0);
+            mHeight = std::exchange(o.mHeight, 0);
+        }
+        return *this;
+    }
+
+    size_t size() const { return mSize; }
+    bool empty() const { return mSize == 0; }
+    int height() const { return mHeight; }
+    static constexpr int leaf_capacity() { return kLeafCap; }
+
+    iterator begin() { return mSize ? iterator(mHead, 0) : end(); }
+    iterator end() { return iterator(nullptr, 0); }
+    const_iterator begin() const { return const_cast<btree_map*>(this)->begin(); }
+    const_iterator end() const { return const_iterator(nullptr, 0); }
+
+    void clear() {
+        if (mRoot) destroy(mRoot);
+        mRoot = nullptr;
+        mHead = nullptr;
+        mSize = 0;
+        mHeight = 0;
+    }
+
+    // ---------- 查找 ----------
+    iterator lower_bound(const Key& k) {
+        if (!mRoot) return end();
+        Leaf* leaf = findLeaf(k);
+        int i = lowerIn(leaf, k);
+        if (i == leaf->count) {
+            // 本叶子所有 key 都 < k，答案是下一个叶子的第一个元素
+            leaf = leaf->next;
+            i = 0;
+        }
+        return iterator(leaf, i);
+    }
+    const_iterator lower_bound(const Key& k) const { return const_cast<btree_map*>(this)->lower_bound(k); }
+
+    iterator find(const Key& k) {
+        if (!mRoot) return end();
+        Leaf* leaf = findLeaf(k);
+        int i = lowerIn(leaf, k);
+        if (i < leaf->count && !mComp(k, leaf->keys[i])) return iterator(leaf, i);
+        return end();
+    }
+    const_iterator find(const Key& k) const { return const_cast<btree_map*>(this)->find(k); }
+    bool contains(const Key& k) const { return find(k) != end(); }
+    size_t count(const Key& k) const { return contains(k) ? 1 : 0; }
+
+    Value& at(const Key& k) {
+        auto it = find(k);
+        if (it == end()) throw std::out_of_range("btree_map::at");
+        return it.mLeaf->values[it.mIdx];
+    }
+    Value& operator[](const Key& k) {
+        auto [it, inserted] = insert(k, Value());
+        return it.mLeaf->values[it.mIdx];
+    }
+
+    // ---------- 插入 ----------
+    // key 已存在时不修改，返回 {已有元素, false}
+    std::pair<iterator, bool> insert(const Key& k, const Value& v) { return insertImpl(k, v, false); }
+    std::pair<iterator, bool> insert_or_assign(const Key& k, const Value& v) {
+        return insertImpl(k, v, true);
+    }
+
+    // ---------- 删除 ----------
+    size_t erase(const Key& k) {
+        if (!mRoot) return 0;
+        if (!eraseRec(mRoot, k)) return 0;
+        --mSize;
+        // 根收缩：内部根只剩一个孩子时降低树高；叶子根空了就释放
+        if (!mRoot->leaf && mRoot->count == 0) {
+            Node* child = static_cast<Inner*>(mRoot)->children[0];
+            delete static_cast<Inner*>(mRoot);
+            mRoot = child;
+            --mHeight;
+        } else if (mRoot->leaf && mRoot->count == 0) {
+            clear();
+        }
+        return 1;
+    }
+
+    // ---------- 批量构建 ----------
+    // [first, last) 必须按 key 严格递增（(key, value) pair）；原有内容被清空。
+    // fill 为叶子填充率：只读索引用 1.0；之后还要插入的可以留些空位（如 0.7）
+    template <typename It>
+    void bulk_load(It first, It last, double fill = 1.0) {
+        clear();
+        int perLeaf = std::clamp(int(kLeafCap * fill), kLeafMin, kLeafCap);
+        size_t n = static_cast<size_t>(std::distance(first, last));
+        if (n == 0) return;
+
+        // 1) 叶子：叶子数取 n / perLeaf（且不让任何叶子超过容量），元素在叶子间均分，
+        //    这样每个叶子都落在 [半满, 满] 之间
+        size_t leafCount = std::max<size_t>({1, n / perLeaf, (n + kLeafCap - 1) / kLeafCap});
+        std::vector<Node*> level;
+        std::vector<Key> mins;  // 每个节点子树的最小 key，作为上一层的分隔 key
+        level.reserve(leafCount);
+        mins.reserve(leafCount);
+        Leaf* prev = nullptr;
+        for (size_t li = 0; li < leafCount; ++li) {
+            int take = int(n / leafCount + (li < n % leafCount ? 1 : 0));
+            auto* leaf = new Leaf;
+            for (int j = 0; j < take; ++j, ++first) {
+                leaf->keys[j] = first->first;
+                leaf->values[j] = first->second;
+            }
+            leaf->count = take;
+            leaf->prev = prev;
+            if (prev) prev->next = leaf;
+            else mHead = leaf;
+            prev = leaf;
+            level.push_back(leaf);
+            mins.push_back(leaf->keys[0]);
+        }
+        mSize = n;
+        mHeight = 1;
+
+        // 2) 逐层向上建内部节点，每个最多 kInnerCap+1 个孩子
+        while (level.size() > 1) {
+            std::vector<Node*> upper;
+            std::vector<Key> upperMins;
+            size_t groups = (level.size() + kInnerCap) / (kInnerCap + 1);
+            size_t base = level.size() / groups, extra = level.size() % groups;
+            size_t pos = 0;
+            for (size_t g = 0; g < groups; ++g) {
+                size_t take = base + (g < extra ? 1 : 0);  // 均分，保证都不低于半满
+                auto* inner = new Inner;
+                for (size_t j = 0; j < take; ++j) {
+                    inner->children[j] = level[pos + j];
+                    if (j > 0) inner->keys[j - 1] = mins[pos + j];
+                }
+                inner->count = int(take) - 1;
+                upper.push_back(inner);
+                upperMins.push_back(mins[pos]);
+                pos += take;
+            }
+            level = std::move(upper);
+            mins = std::move(upperMins);
+            ++mHeight;
+        }
+        mRoot = level[0];
+    }
+
+    // 调试用：检查有序性、节点填充和叶子链表
+    bool validate() const {
+        if (!mRoot) return mSize == 0;
+        size_t counted = 0;
+        const Key* prevKey = nullptr;
+        for (const Leaf* l = mHead; l; l = l->next) {
+            for (int i = 0; i < l->count; ++i) {
+                if (prevKey && !mComp(*prevKey, l->keys[i])) return false;
+                prevKey = &l->keys[i];
+            }
+            counted += l->count;
+        }
+        return counted == mSize && validateNode(mRoot, nullptr, nullptr, 1);
+    }
+
+private:
+    struct SplitResult {
+        Key sep;
+        Node* right = nullptr;
+    };
+
+    // ---------- 节点内查找 ----------
+    int lowerIn(const Node* n, const Key& k) const {
+        if constexpr (kSimd) return btree_simd_count<false>(n->keys, n->count, k);
+        else return int(std::lower_bound(n->keys, n->keys + n->count, k, mComp) - n->keys);
+    }
+    int upperIn(const Node* n, const Key& k) const {
+        if constexpr (kSimd) return btree_simd_count<true>(n->keys, n->count, k);
+        else return int(std::upper_bound(n->keys, n->keys + n->count, k, mComp) - n->keys);
+    }
+
+    Leaf* findLeaf(const Key& k) const {
+        Node* n = mRoot;
+        while (!n->leaf) n = static_cast<Inner*>(n)->children[upperIn(n, k)];
+        return static_cast<Leaf*>(n);
+    }
+
+    // ---------- 插入 ----------
+    std::pair<iterator, bool> insertImpl(const Key& k, const Value& v, bool assign) {
+        if (!mRoot) {
+            mHead = new Leaf;
+            mRoot = mHead;
+            mHeight = 1;
+        }
+        Leaf* outLeaf = nullptr;
+        int outIdx = 0;
+        bool inserted = false;
+        SplitResult split = insertRec(mRoot, k, v, assign, outLeaf, outIdx, inserted);
+        if (split.right) {
+            auto* root = new Inner;
+            root->keys[0] = split.sep;
+            root->children[0] = mRoot;
+            root->children[1] = split.right;
+            root->count = 1;
+            mRoot = root;
+            ++mHeight;
+        }
+        if (inserted) ++mSize;
+        return {iterator(outLeaf, outIdx), inserted};
+    }
+
+    SplitResult insertRec(Node* node, const Key& k, const Value& v, bool assign, Leaf*& outLeaf,
+                          int& outIdx, bool& inserted) {
+        if (node->leaf) return insertLeaf(static_cast<Leaf*>(node), k, v, assign, outLeaf, outIdx, inserted);
+
+        auto* inner = static_cast<Inner*>(node);
+        int ci = upperIn(inner, k);
+        SplitResult child = insertRec(inner->children[ci], k, v, assign, outLeaf, outIdx, inserted);
+        if (!child.right) return {};
+
+        // 孩子分裂了：把 (sep, right) 插到 ci 位置；本节点已满就连同新 key 一起对半分裂
+        if (inner->count < kInnerCap) {
+            insertSeparator(inner, ci, child.sep, child.right);
+            return {};
+        }
+        // 先在临时数组里插入（kInnerCap+1 个 key），再从中间切开，中位 key 上移给父节点
+        Key keys[kInnerCap + 1];
+        Node* children[kInnerCap + 2];
+        std::move(inner->keys, inner->keys + ci, keys);
+        keys[ci] = child.sep;
+        std::move(inner->keys + ci, inner->keys + kInnerCap, keys + ci + 1);
+        std::copy(inner->children, inner->children + ci + 1, children);
+        children[ci + 1] = child.right;
+        std::copy(inner->children + ci + 1, inner->children + kInnerCap + 1, children + ci + 2);
+
+        constexpr int half = (kInnerCap + 1) / 2;
+        auto* right = new Inner;
+        std::move(keys, keys + half, inner->keys);
+        std::copy(children, children + half + 1, inner->children);
+        inner->count = half;
+        std::move(keys + half + 1, keys + kInnerCap + 1, right->keys);
+        std::copy(children + half + 1, children + kInnerCap + 2, right->children);
+        right->count = kInnerCap - half;
+        return {std::move(keys[half]), right};
+    }
+
+    static void insertSeparator(Inner* inner, int pos, const Key& sep, Node* right) {
+        std::move_backward(inner->keys + pos, inner->keys + inner->count, inner->keys + inner->count + 1);
+        std::copy_backward(inner->children + pos + 1, inner->children + inner->count + 1,
+                           inner->children + inner->count + 2);
+        inner->keys[pos] = sep;
+        inner->children[pos + 1] = right;
+        ++inner->count;
+    }
+
+    SplitResult insertLeaf(Leaf* leaf, const Key& k, const Value& v, bool assign, Leaf*& outLeaf,
+                           int& outIdx, bool& inserted) {
+        int pos = lowerIn(leaf, k);
+        if (pos < leaf->count && !mComp(k, leaf->keys[pos])) {
+            if (assign) leaf->values[pos] = v;
+            outLeaf = leaf;
+            outIdx = pos;
+            return {};
+        }
+        inserted = true;
+        if (leaf->count < kLeafCap) {
+            insertIntoLeaf(leaf, pos, k, v);
+            outLeaf = leaf;
+            outIdx = pos;
+            return {};
+        }
+        // 分裂：右半边搬到新叶子，再把新元素放进对应的一半
+        int mid = kLeafCap / 2;
+        auto* right = new Leaf;
+        right->count = leaf->count - mid;
+        std::move(leaf->keys + mid, leaf->keys + leaf->count, right->keys);
+        std::move(leaf->values + mid, leaf->values + leaf->count, right->values);
+        leaf->count = mid;
+        right->next = leaf->next;
+        right->prev = leaf;
+        if (leaf->next) leaf->next->prev = right;
+        leaf->next = right;
+        if (pos <= mid) {
+            insertIntoLeaf(leaf, pos, k, v);
+            outLeaf = leaf;
+            outIdx = pos;
+        } else {
+            insertIntoLeaf(right, pos - mid, k, v);
+            outLeaf = right;
+            outIdx = pos - mid;
+        }
+        return {right->keys[0], right};
+    }
+
+    static void insertIntoLeaf(Leaf* leaf, int pos, const Key& k, const Value& v) {
+        std::move_backward(leaf->keys + pos, leaf->keys + leaf->count, leaf->keys + leaf->count + 1);
+        std::move_backward(leaf->values + pos, leaf->values + leaf->count, leaf->values + leaf->count + 1);
+        leaf->keys[pos] = k;
+        leaf->values[pos] = v;
+        ++leaf->count;
+    }
+
+    // ---------- 删除 ----------
+    bool eraseRec(Node* node, const Key& k) {
+        if (node->leaf) {
+            auto* leaf = static_cast<Leaf*>(node);
+            int pos = lowerIn(leaf, k);
+            if (pos == leaf->count || mComp(k, leaf->keys[pos])) return false;
+            std::move(leaf->keys + pos + 1, leaf->keys + leaf->count, leaf->keys + pos);
+            std::move(leaf->values + pos + 1, leaf->values + leaf->count, leaf->values + pos);
+            --leaf->count;
+            return true;
+        }
+        auto* inner = static_cast<Inner*>(node);
+        int ci = upperIn(inner, k);
+        if (!eraseRec(inner->children[ci], k)) return false;
+        Node* child = inner->children[ci];
+        if (child->count < (child->leaf ? kLeafMin : kInnerMin)) rebalance(inner, ci);
+        return true;
+    }
+
+    // 孩子 ci 低于半满：先尝试从左/右兄弟借一个，借不到就和兄弟合并
+    void rebalance(Inner* parent, int ci) {
+        Node* child = parent->children[ci];
+        Node* left = ci > 0 ? parent->children[ci - 1] : nullptr;
+        Node* right = ci < parent->count ? parent->children[ci + 1] : nullptr;
+        int minCount = child->leaf ? kLeafMin : kInnerMin;
+
+        if (left && left->count > minCount) {
+            borrowFromLeft(parent, ci);
+        } else if (right && right->count > minCount) {
+            borrowFromRight(parent, ci);
+        } else if (left) {
+            merge(parent, ci - 1);
+        } else if (right) {
+            merge(parent, ci);
+        }
+    }
+
+    void borrowFromLeft(Inner* parent, int ci) {
+        Node* child = parent->children[ci];
+        Node* left = parent->children[ci - 1];
+        if (child->leaf) {
+            auto* c = static_cast<Leaf*>(child);
+            auto* l = static_cast<Leaf*>(left);
+            insertIntoLeaf(c, 0, l->keys[l->count - 1], l->values[l->count - 1]);
+            --l->count;
+            parent->keys[ci - 1] = c->keys[0];
+        } else {
+            auto* c = static_cast<Inner*>(child);
+            auto* l = static_cast<Inner*>(left);
+            // 父节点的分隔 key 下移到 child 最前，left 的最后一个 key 上移
+            std::move_backward(c->keys, c->keys + c->count, c->keys + c->count + 1);
+            std::copy_backward(c->children, c->children + c->count + 1, c->children + c->count + 2);
+            c->keys[0] = parent->keys[ci - 1];
+            c->children[0] = l->children[l->count];
+            ++c->count;
+            parent->keys[ci - 1] = l->keys[l->count - 1];
+            --l->count;
+        }
+    }
+
+    void borrowFromRight(Inner* parent, int ci) {
+        Node* child = parent->children[ci];
+        Node* right = parent->children[ci + 1];
+        if (child->leaf) {
+            auto* c = static_cast<Leaf*>(child);
+            auto* r = static_cast<Leaf*>(right);
+            c->keys[c->count] = r->keys[0];
+            c->values[c->count] = std::move(r->values[0]);
+            ++c->count;
+            std::move(r->keys + 1, r->keys + r->count, r->keys);
+            std::move(r->values + 1, r->values + r->count, r->values);
+            --r->count;
+            parent->keys[ci] = r->keys[0];
+        } else {
+            auto* c = static_cast<Inner*>(child);
+            auto* r = static_cast<Inner*>(right);
+            c->keys[c->count] = parent->keys[ci];
+            c->children[c->count + 1] = r->children[0];
+            ++c->count;
+            parent->keys[ci] = r->keys[0];
+            std::move(r->keys + 1, r->keys + r->count, r->keys);
+            std::copy(r->children + 1, r->children + r->count + 1, r->children);
+            --r->count;
+        }
+    }
+
+    // 把 children[i+1] 合并进 children[i]，删除父节点的 keys[i]
+    void merge(Inner* parent, int i) {
+        Node* a = parent->children[i];
+        Node* b = parent->children[i + 1];
+        if (a->leaf) {
+            auto* la = static_cast<Leaf*>(a);
+            auto* lb = static_cast<Leaf*>(b);
+            std::move(lb->keys, lb->keys + lb->count, la->keys + la->count);
+            std::move(lb->values, lb->values + lb->count, la->values + la->count);
+            la->count += lb->count;
+            la->next = lb->next;
+            if (lb->next) lb->next->prev = la;
+            delete lb;
+        } else {
+            auto* ia = static_cast<Inner*>(a);
+            auto* ib = static_cast<Inner*>(b);
+            ia->keys[ia->count] = parent->keys[i];
+            std::move(ib->keys, ib->keys + ib->count, ia->keys + ia->count + 1);
+            std::copy(ib->children, ib->children + ib->count + 1, ia->children + ia->count + 1);
+            ia->count += ib->count + 1;
+            delete ib;
+        }
+        std::move(parent->keys + i + 1, parent->keys + parent->count, parent->keys + i);
+        std::copy(parent->children + i + 2, parent->children + parent->count + 1, parent->children + i + 1);
+        --parent->count;
+    }
+
+    void destroy(Node* n) {
+        if (n->leaf) {
+            delete static_cast<Leaf*>(n);
+            return;
+        }
+        auto* inner = static_cast<Inner*>(n);
+        for (int i = 0; i <= inner->count; ++i) destroy(inner->children[i]);
+        delete inner;
+    }
+
+    // 子树内所有 key 都在 [lo, hi) 内，非根节点至少半满，所有叶子同一深度
+    bool validateNode(const Node* n, const Key* lo, const Key* hi, int depth) const {
+        if (n != mRoot && n->count < (n->leaf ? kLeafMin : kInnerMin)) return false;
+        for (int i = 0; i < n->count; ++i) {
+            if (lo && mComp(n->keys[i], *lo)) return false;
+            if (hi && !mComp(n->keys[i], *hi)) return false;
+        }
+        if (n->leaf) return depth == mHeight;
+        auto* inner = static_cast<const Inner*>(n);
+        for (int i = 0; i <= inner->count; ++i) {
+            const Key* clo = i == 0 ? lo : &inner->keys[i - 1];
+            const Key* chi = i == inner->count ? hi : &inner->keys[i];
+            if (!validateNode(inner->children[i], clo, chi, depth + 1)) return false;
+        }
+        return true;
+    }
+
+    Node* mRoot = nullptr;
+    Leaf* mHead = nullptr;  // 最左叶子，begin() 从这里开始
+    size_t mSize = 0;
+    int mHeight = 0;
+    [[no_unique_address]] Compare mComp;
+};
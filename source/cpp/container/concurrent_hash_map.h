@@ -0,0 +1,445 @@
+#pragma once
+
+// concurrent_hash_map.h: 分片（lock striping）+ 无锁读的并发哈希表
+//
+// 结构：
+//   - 按哈希高位分成 kShards 个分片，每个分片一把 mutex，只有写操作加锁
+//   - 每个分片是一张线性探测的开放寻址表，slot 里存 std::atomic<Node*>
+//   - Node {hash, key, value} 构造后 key 不再修改：
+//       insert_or_assign 已有 key → Value 能放进无锁 std::atomic（如整数、指针）时原地
+//                                   原子写；否则新建 Node 替换指针，旧 Node 延迟释放
+//       erase                    → slot 写成墓碑指针，旧 Node 延迟释放
+//       扩容                     → 建新表拷贝 Node 指针，发布新表，旧表延迟释放
+//   - 读操作（find/contains/for_each）不加锁，只做 acquire load
+//
+// 延迟释放用 epoch-based reclamation（EBR）：
+//   读者进入临界区时把自己的 epoch 标成当前全局 epoch；被摘下的对象记录"退休"时的
+//   全局 epoch r。全局 epoch 只有在所有活跃读者都追上时才能 +1，因此当全局 epoch
+//   >= r + 2 时，不可能还有读者持有该对象的指针，可以安全 delete。
+//
+// 一致性：单个 key 的读写是原子的；size() 和 for_each 是弱一致的——遍历期间并发
+// 的插入/删除可能看到也可能看不到，但遍历期间一直存在且未被修改的 key 恰好出现一次。
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// ============================================================
+// EpochDomain：进程级 EBR
+// ============================================================
+class EpochDomain {
+public:
+    static constexpr size_t kMaxThreads = 256;
+    static constexpr size_t kScanEvery = 64;  // 每退休多少个对象尝试推进 epoch 并回收
+
+    static EpochDomain& instance() {
+        static EpochDomain domain;
+        return domain;
+    }
+
+    ~EpochDomain() {
+        // 进程退出时已经没有读者，全部释放
+        for (auto& rec : mRecords) freeAll(rec.retired);
+        freeAll(mOrphans);
+    }
+
+    void enter() {
+        ThreadRecord& rec = localRecord();
+        if (rec.nesting++ != 0) return;
+        // 发布 epoch 之后再确认全局 epoch 没变：否则在"读到 e"和"发布 e"之间
+        // 全局 epoch 可能已经前进了两步，e 时刻退休的对象会被提前释放
+        uint64_t e = mGlobalEpoch.load(std::memory_order_seq_cst);
+        for (;;) {
+            rec.epoch.store(e, std::memory_order_seq_cst);
+            uint64_t now = mGlobalEpoch.load(std::memory_order_seq_cst);
+            if (now == e) break;
+            e = now;
+        }
+    }
+
+    void leave() {
+        ThreadRecord& rec = localRecord();
+        if (--rec.nesting == 0) rec.epoch.store(0, std::memory_order_release);
+    }
+
+    // 对象已经从数据结构中摘下（新读者不可能再看到它），等所有老读者离开后再释放
+    template <typename T>
+    void retire(T* p) {
+        ThreadRecord& rec = localRecord();
+        rec.retired.push_back({p, [](void* q) { delete static_cast<T*>(q); },
+                               mGlobalEpoch.load(std::memory_order_seq_cst)});
+        if (rec.retired.size() % kScanEvery == 0) {
+            tryAdvance();
+            // epoch 没前进就不可能有新的可释放对象，避免反复扫描越来越长的列表
+            uint64_t e = mGlobalEpoch.load(std::memory_order_seq_cst);
+            if (e != rec.reclaimedAt) {
+                reclaim(rec.retired);
+                rec.reclaimedAt = e;
+            }
+        }
+    }
+
+private:
+    struct Retired {
+        void* ptr;
+        void (*deleter)(void*);
+        uint64_t epoch;
+    };
+
+    struct alignas(64) ThreadRecord {
+        std::atomic<uint64_t> epoch{0};  // 0 = 不在读临界区
+        std::atomic<bool> inUse{false};
+        unsigned nesting = 0;
+        uint64_t reclaimedAt = 0;
+        std::vector<Retired> retired;
+    };
+
+    // 线程退出时归还记录；没来得及释放的对象交给孤儿列表
+    struct ThreadHandle {
+        ThreadRecord* rec = nullptr;
+        ~ThreadHandle() {
+            if (!rec) return;
+            EpochDomain& d = instance();
+            {
+                std::lock_guard<std::mutex> lock(d.mOrphanMutex);
+                d.mOrphans.insert(d.mOrphans.end(), rec->retired.begin(), rec->retired.end());
+                d.reclaim(d.mOrphans);
+            }
+            rec->retired.clear();
+            rec->inUse.store(false, std::memory_order_release);
+        }
+    };
+
+    EpochDomain() = default;
+
+    ThreadRecord& localRecord() {
+        thread_local ThreadHandle handle;
+        if (!handle.rec) {
+            for (auto& rec : mRecords) {
+                bool expected = false;
+                if (!rec.inUse.load(std::memory_order_relaxed) &&
+                    rec.inUse.compare_exchange_strong(expected, true)) {
+                    handle.rec = &rec;
+                    break;
+                }
+            }
+            if (!handle.rec) throw std::runtime_error("EpochDomain: too many threads");
+        }
+        return *handle.rec;
+    }
+
+    // 所有活跃读者都已进入当前 epoch 时，全局 epoch +1
+    void tryAdvance() {
+        uint64_t e = mGlobalEpoch.load(std::memory_order_seq_cst);
+        for (auto& rec : mRecords) {
+            if (!rec.inUse.load(std::memory_order_acquire)) continue;
+            uint64_t local = rec.epoch.load(std::memory_order_seq_cst);
+            if (local != 0 && local != e) return;
+        }
+        mGlobalEpoch.compare_exchange_strong(e, e + 1, std::memory_order_seq_cst);
+    }
+
+    void reclaim(std::vector<Retired>& list) {
+        uint64_t e = mGlobalEpoch.load(std::memory_order_seq_cst);
+        size_t keep = 0;
+        for (auto& r : list) {
+            if (r.epoch + 2 <= e) r.deleter(r.ptr);
+            else list[keep++] = r;
+        }
+        list.resize(keep);
+    }
+
+    static void freeAll(std::vector<Retired>& list) {
+        for (auto& r : list) r.deleter(r.ptr);
+        list.clear();
+    }
+
+    std::atomic<uint64_t> mGlobalEpoch{1};
+    ThreadRecord mRecords[kMaxThreads];
+    std::mutex mOrphanMutex;
+    std::vector<Retired> mOrphans;
+};
+
+// RAII 读临界区，可嵌套
+class EpochGuard {
+public:
+    EpochGuard() { EpochDomain::instance().enter(); }
+    ~EpochGuard() { EpochDomain::instance().leave(); }
+    EpochGuard(const EpochGuard&) = delete;
+    EpochGuard& operator=(const EpochGuard&) = delete;
+};
+
+// ============================================================
+// concurrent_hash_map
+// ============================================================
+template <typename Key, typename Value, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class concurrent_hash_map {
+    // 小的平凡类型直接原子读写，覆盖写不需要分配新节点
+    // （先判断 trivially copyable，否则实例化 std::atomic<std::string> 就会编译失败）
+    template <typename T, bool = std::is_trivially_copyable_v<T>>
+    struct lock_free_atomic : std::false_type {};
+    template <typename T>
+    struct lock_free_atomic<T, true> : std::bool_constant<std::atomic<T>::is_always_lock_free> {};
+
+    static constexpr bool kAtomicValue = lock_free_atomic<Value>::value;
+    using StoredValue = std::conditional_t<kAtomicValue, std::atomic<Value>, Value>;
+
+    struct Node {
+        uint64_t hash;
+        Key key;
+        StoredValue value;
+    };
+
+    static Value loadValue(const Node* n) {
+        if constexpr (kAtomicValue) return n->value.load(std::memory_order_acquire);
+        else return n->value;
+    }
+
+    struct Table {
+        explicit Table(size_t capacity)
+            : mask(capacity - 1), slots(new std::atomic<Node*>[capacity]) {
+            for (size_t i = 0; i < capacity; ++i) slots[i].store(nullptr, std::memory_order_relaxed);
+        }
+        size_t capacity() const { return mask + 1; }
+
+        size_t mask;
+        std::unique_ptr<std::atomic<Node*>[]> slots;
+    };
+
+    // 每个分片独占 cache line，避免相邻分片的锁互相伪共享
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        std::atomic<Table*> table{nullptr};
+        std::atomic<size_t> size{0};
+        size_t used = 0;  // 非空 slot 数（含墓碑），只在持锁时访问
+    };
+
+public:
+    static constexpr size_t kShards = 64;
+
+    concurrent_hash_map() {
+        for (auto& s : mShards) s.table.store(new Table(kInitialCapacity), std::memory_order_relaxed);
+    }
+
+    // 析构时调用方必须保证没有其它线程还在访问
+    ~concurrent_hash_map() {
+        for (auto& s : mShards) {
+            Table* t = s.table.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < t->capacity(); ++i) {
+                Node* n = t->slots[i].load(std::memory_order_relaxed);
+                if (isNode(n)) delete n;
+            }
+            delete t;
+        }
+    }
+
+    concurrent_hash_map(const concurrent_hash_map&) = delete;
+    concurrent_hash_map& operator=(const concurrent_hash_map&) = delete;
+
+    // ---------- 无锁读 ----------
+    std::optional<Value> find(const Key& key) const {
+        uint64_t h = hashOf(key);
+        const Shard& s = shardOf(h);
+        EpochGuard guard;
+        for (;;) {
+            Table* t = s.table.load(std::memory_order_acquire);
+            const Node* n = findNode(t, key, h);
+            // 读的过程中分片扩容了：旧表不再更新，重新在新表上查一遍
+            if (s.table.load(std::memory_order_acquire) != t) continue;
+            if (!n) return std::nullopt;
+            return loadValue(n);
+        }
+    }
+
+    bool contains(const Key& key) const { return find(key).has_value(); }
+
+    // 弱一致遍历：f(const Key&, const Value&)
+    template <typename F>
+    void for_each(F&& f) const {
+        EpochGuard guard;
+        for (const auto& s : mShards) {
+            Table* t = s.table.load(std::memory_order_acquire);
+            for (size_t i = 0; i < t->capacity(); ++i) {
+                const Node* n = t->slots[i].load(std::memory_order_acquire);
+                if (isNode(n)) f(n->key, loadValue(n));
+            }
+        }
+    }
+
+    // 弱一致：并发修改时只是一个近似值
+    size_t size() const {
+        size_t total = 0;
+        for (const auto& s : mShards) total += s.size.load(std::memory_order_relaxed);
+        return total;
+    }
+    bool empty() const { return size() == 0; }
+
+    // ---------- 加锁写 ----------
+    // 返回 true 表示新插入，false 表示覆盖了已有值
+    // 写者持有分片锁，本分片的节点不会被别人释放，所以写路径不需要 EpochGuard
+    template <typename V>
+    bool insert_or_assign(const Key& key, V&& value) {
+        uint64_t h = hashOf(key);
+        Shard& s = shardOf(h);
+        if constexpr (kAtomicValue) {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            Table* t = s.table.load(std::memory_order_relaxed);
+            size_t idx = findSlot(t, key, h);
+            if (idx != kNotFound) {
+                t->slots[idx].load(std::memory_order_relaxed)->value.store(value, std::memory_order_release);
+                return false;
+            }
+            insertNew(s, new Node{h, key, value});
+            return true;
+        } else {
+            // 在锁外构造新节点，缩短临界区
+            Node* fresh = new Node{h, key, std::forward<V>(value)};
+            std::lock_guard<std::mutex> lock(s.mutex);
+            Table* t = s.table.load(std::memory_order_relaxed);
+            size_t idx = findSlot(t, key, h);
+            if (idx != kNotFound) {
+                Node* old = t->slots[idx].load(std::memory_order_relaxed);
+                t->slots[idx].store(fresh, std::memory_order_release);
+                EpochDomain::instance().retire(old);
+                return false;
+            }
+            insertNew(s, fresh);
+            return true;
+        }
+    }
+
+    // key 不存在时才插入；已存在返回 false，不修改
+    template <typename V>
+    bool insert(const Key& key, V&& value) {
+        bool inserted = false;
+        compute_if_absent(key, [&](const Key&) {
+            inserted = true;
+            return Value(std::forward<V>(value));
+        });
+        return inserted;
+    }
+
+    // key 存在时直接返回现值（无锁）；否则在分片锁内调用 f(key) 计算并插入。
+    // 同一个 key 的 f 最多只会被调用一次；f 在持锁时执行，不要在 f 里访问本 map
+    template <typename F>
+    Value compute_if_absent(const Key& key, F&& f) {
+        if (auto v = find(key)) return *v;
+
+        uint64_t h = hashOf(key);
+        Shard& s = shardOf(h);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        Table* t = s.table.load(std::memory_order_relaxed);
+        size_t idx = findSlot(t, key, h);
+        if (idx != kNotFound) return loadValue(t->slots[idx].load(std::memory_order_relaxed));
+
+        Value value = std::forward<F>(f)(key);
+        insertNew(s, new Node{h, key, value});
+        return value;
+    }
+
+    bool erase(const Key& key) {
+        uint64_t h = hashOf(key);
+        Shard& s = shardOf(h);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        Table* t = s.table.load(std::memory_order_relaxed);
+        size_t idx = findSlot(t, key, h);
+        if (idx == kNotFound) return false;
+        Node* old = t->slots[idx].load(std::memory_order_relaxed);
+        t->slots[idx].store(tombstone(), std::memory_order_release);
+        s.size.fetch_sub(1, std::memory_order_relaxed);
+        EpochDomain::instance().retire(old);
+        return true;
+    }
+
+private:
+    static constexpr size_t kInitialCapacity = 16;
+    static constexpr size_t kNotFound = ~size_t(0);
+
+    // 墓碑：一个不会被解引用的固定地址
+    static Node* tombstone() {
+        static char sentinel;
+        return reinterpret_cast<Node*>(&sentinel);
+    }
+    static bool isNode(const Node* n) { return n != nullptr && n != tombstone(); }
+
+    uint64_t hashOf(const Key& key) const {
+        uint64_t h = static_cast<uint64_t>(mHash(key));
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ull;
+        h ^= h >> 33;
+        return h;
+    }
+
+    // 高 6 位选分片，低位在分片内做探测起点，两者互不相关
+    Shard& shardOf(uint64_t h) { return mShards[h >> (64 - 6)]; }
+    const Shard& shardOf(uint64_t h) const { return mShards[h >> (64 - 6)]; }
+    static_assert(kShards == 64, "shardOf 假设 64 个分片");
+
+    const Node* findNode(const Table* t, const Key& key, uint64_t h) const {
+        for (size_t i = h & t->mask;; i = (i + 1) & t->mask) {
+            const Node* n = t->slots[i].load(std::memory_order_acquire);
+            if (n == nullptr) return nullptr;
+            if (n != tombstone() && n->hash == h && mEq(n->key, key)) return n;
+        }
+    }
+
+    // 持锁调用
+    size_t findSlot(const Table* t, const Key& key, uint64_t h) const {
+        for (size_t i = h & t->mask;; i = (i + 1) & t->mask) {
+            const Node* n = t->slots[i].load(std::memory_order_relaxed);
+            if (n == nullptr) return kNotFound;
+            if (n != tombstone() && n->hash == h && mEq(n->key, key)) return i;
+        }
+    }
+
+    // 持锁调用，且已确认 key 不存在
+    void insertNew(Shard& s, Node* fresh) {
+        Table* t = s.table.load(std::memory_order_relaxed);
+        // 线性探测在负载超过 1/2（含墓碑）后探测长度急剧上升
+        if ((s.used + 1) * 2 > t->capacity()) t = grow(s, t);
+        for (size_t i = fresh->hash & t->mask;; i = (i + 1) & t->mask) {
+            Node* n = t->slots[i].load(std::memory_order_relaxed);
+            if (n == nullptr || n == tombstone()) {
+                if (n == nullptr) ++s.used;
+                t->slots[i].store(fresh, std::memory_order_release);
+                break;
+            }
+        }
+        s.size.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // 把存活节点搬到新表（只拷指针），顺便清掉墓碑；新表容量使负载约为 1/4
+    Table* grow(Shard& s, Table* old) {
+        size_t live = s.size.load(std::memory_order_relaxed) + 1;
+        size_t capacity = std::max(kInitialCapacity, std::bit_ceil(live * 4));
+        auto* t = new Table(capacity);
+        for (size_t i = 0; i < old->capacity(); ++i) {
+            Node* n = old->slots[i].load(std::memory_order_relaxed);
+            if (!isNode(n)) continue;
+            size_t j = n->hash & t->mask;
+            while (t->slots[j].load(std::memory_order_relaxed)) j = (j + 1) & t->mask;
+            t->slots[j].store(n, std::memory_order_relaxed);
+        }
+        s.used = s.size.load(std::memory_order_relaxed);
+        s.table.store(t, std::memory_order_release);
+        EpochDomain::instance().retire(old);
+        return t;
+    }
+
+    Shard mShards[kShards];
+    [[no_unique_address]] Hash mHash;
+    [[no_unique_address]] KeyEqual mEq;
+};
@@ -0,0 +1,333 @@
+#pragma once
+
+// csr_graph.h: 压缩稀疏行（CSR）图与方向优化的并行 BFS
+//
+// 邻接表写成 vector<vector<int>> 时，每个顶点一次分配，遍历邻居要先跳到各自的堆块上；
+// level3 的 BFS 更是一个节点一个指针。CSR 把整张图压成两个数组：
+//   offsets[v] .. offsets[v + 1]  是顶点 v 的邻居在 targets 里的区间
+//   targets                       所有邻居首尾相接（每个区间内升序、去重，不含自环）
+// 顶点编号 uint32_t，边下标 uint64_t：上亿条边也只占 4 字节 / 条。
+//
+// bfs_parallel 是按层同步的并行 BFS（Beamer 等人的 direction-optimizing BFS）：
+//   top-down  ：扫描当前层的顶点队列，对未访问的邻居用 CAS 抢占 parent。适合前沿很小的层
+//   bottom-up ：扫描所有未访问顶点，在邻居里找一个属于当前层（前沿位图中置位）的顶点，找到即停。
+//               前沿占了大半条边时，这比 top-down 少检查大量边，而且不需要原子操作
+// 每层结束时按 m_f > m_u / alpha 切到 bottom-up、按 n_f < n / beta 切回 top-down
+// （m_f：前沿顶点的度数和，m_u：未访问顶点的度数和，n_f：前沿顶点数）。
+// bottom-up 在 v 自己的邻居里找父节点，要求图是对称的（无向图）；有向图只用 top-down。
+// 线程在整个 BFS 期间常驻，层与层之间用 std::barrier 同步；工作按小块动态领取，应对度数倾斜。
+//
+// rmat_edges 生成 Graph500 风格的 R-MAT 随机图（幂律度分布），用来做基准测试。
+
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// ============================================================
+// csr_graph
+// ============================================================
+class csr_graph {
+public:
+    using vertex_type = uint32_t;
+    using edge_type = std::pair<vertex_type, vertex_type>;
+    static constexpr vertex_type npos = UINT32_MAX;
+
+    csr_graph() : mOffsets(1, 0) {}
+
+    // 由边表构建：两遍计数排序，再对每个邻居区间排序去重。
+    // undirected 为 true 时每条边两个方向各存一份（BFS 通常用这种对称图）
+    static csr_graph from_edges(size_t n, std::span<const edge_type> edges, bool undirected = true) {
+        if (n >= npos) throw std::length_error("csr_graph: too many vertices");
+        csr_graph g;
+        std::vector<uint64_t> offsets(n + 1, 0);
+        for (auto [u, v] : edges) {
+            if (u >= n || v >= n) throw std::out_of_range("csr_graph: vertex id out of range");
+            if (u == v) continue;
+            offsets[u + 1]++;
+            if (undirected) offsets[v + 1]++;
+        }
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+        std::vector<vertex_type> targets(offsets[n]);
+        std::vector<uint64_t> pos(offsets.begin(), offsets.end() - 1);
+        for (auto [u, v] : edges) {
+            if (u == v) continue;
+            targets[pos[u]++] = v;
+            if (undirected) targets[pos[v]++] = u;
+        }
+
+        // 排序去重，同时就地压缩
+        uint64_t out = 0;
+        for (size_t v = 0; v < n; v++) {
+            auto first = targets.begin() + ptrdiff_t(offsets[v]);
+            auto last = targets.begin() + ptrdiff_t(offsets[v + 1]);
+            std::sort(first, last);
+            last = std::unique(first, last);
+            offsets[v] = out;
+            out = uint64_t(std::copy(first, last, targets.begin() + ptrdiff_t(out)) - targets.begin());
+        }
+        offsets[n] = out;
+        targets.resize(out);
+        targets.shrink_to_fit();
+        g.mOffsets = std::move(offsets);
+        g.mTargets = std::move(targets);
+        g.mSymmetric = undirected;
+        return g;
+    }
+
+    size_t vertex_count() const noexcept { return mOffsets.size() - 1; }
+    bool symmetric() const noexcept { return mSymmetric; }  // 每条边两个方向都存在
+    uint64_t edge_count() const noexcept { return mTargets.size(); }  // 无向图每条边计两次
+    uint64_t degree(vertex_type v) const noexcept { return mOffsets[v + 1] - mOffsets[v]; }
+    std::span<const vertex_type> neighbors(vertex_type v) const noexcept {
+        return {mTargets.data() + mOffsets[v], size_t(degree(v))};
+    }
+    bool has_edge(vertex_type u, vertex_type v) const {
+        auto nb = neighbors(u);
+        return std::binary_search(nb.begin(), nb.end(), v);
+    }
+
+    std::span<const uint64_t> offsets() const noexcept { return mOffsets; }
+    std::span<const vertex_type> targets() const noexcept { return mTargets; }
+    size_t memory_usage() const noexcept {
+        return mOffsets.capacity() * sizeof(uint64_t) + mTargets.capacity() * sizeof(vertex_type);
+    }
+
+private:
+    std::vector<uint64_t> mOffsets;
+    std::vector<vertex_type> mTargets;
+    bool mSymmetric = true;
+};
+
+// ============================================================
+// R-MAT 生成器：每条边递归地在邻接矩阵的四个象限里选一个（概率 a / b / c / d），
+// 选 scale 次得到 2^scale 个顶点中的一对。最后随机重排顶点编号，避免编号小的顶点度数都大
+// ============================================================
+inline std::vector<csr_graph::edge_type> rmat_edges(unsigned scale, size_t edgeFactor,
+                                                    uint64_t seed = 1, double a = 0.57,
+                                                    double b = 0.19, double c = 0.19) {
+    using V = csr_graph::vertex_type;
+    if (scale >= 32) throw std::length_error("rmat_edges: scale must be < 32");
+    size_t n = size_t(1) << scale;
+    std::mt19937_64 rng(seed);
+    // 每一层用两个 16 位随机数（共 32 位）和阈值比较，一个 64 位随机数够 2 层用
+    auto ab = uint32_t((a + b) * 65536), aOfAb = uint32_t(a / (a + b) * 65536),
+         cOfCd = uint32_t(c / (1 - a - b) * 65536);
+    std::vector<csr_graph::edge_type> edges(n * edgeFactor);
+    for (auto& e : edges) {
+        V u = 0, v = 0;
+        uint64_t bits = 0;
+        for (unsigned i = 0; i < scale; i++) {
+            if (i % 2 == 0) bits = rng();
+            auto r1 = uint32_t(bits & 0xffff), r2 = uint32_t((bits >> 16) & 0xffff);
+            bits >>= 32;
+            bool down = r1 >= ab;  // 下半部分（c 或 d）
+            bool right = down ? r2 >= cOfCd : r2 >= aOfAb;
+            u = (u << 1) | V(down);
+            v = (v << 1) | V(right);
+        }
+        e = {u, v};
+    }
+    std::vector<V> perm(n);
+    std::iota(perm.begin(), perm.end(), V(0));
+    std::shuffle(perm.begin(), perm.end(), rng);
+    for (auto& [u, v] : edges) {
+        u = perm[u];
+        v = perm[v];
+    }
+    return edges;
+}
+
+// ============================================================
+// BFS
+//   结果是 BFS 树：parent[source] == source，未到达的顶点为 csr_graph::npos
+// ============================================================
+struct bfs_result {
+    std::vector<csr_graph::vertex_type> parent;
+    size_t levels = 0;
+    size_t bottom_up_levels = 0;
+    size_t reached = 0;
+};
+
+// 串行参照实现：std::queue，一次处理一个顶点
+inline bfs_result bfs_queue(const csr_graph& g, csr_graph::vertex_type source) {
+    bfs_result r;
+    r.parent.assign(g.vertex_count(), csr_graph::npos);
+    if (source >= g.vertex_count()) return r;
+    std::queue<csr_graph::vertex_type> q;
+    r.parent[source] = source;
+    q.push(source);
+    while (!q.empty()) {
+        r.levels++;
+        for (size_t sz = q.size(); sz > 0; sz--) {
+            auto u = q.front();
+            q.pop();
+            r.reached++;
+            for (auto v : g.neighbors(u)) {
+                if (r.parent[v] != csr_graph::npos) continue;
+                r.parent[v] = u;
+                q.push(v);
+            }
+        }
+    }
+    return r;
+}
+
+struct bfs_options {
+    size_t threads = 1;
+    bool direction_optimizing = true;  // false 或有向图：每层都用 top-down
+    double alpha = 14;                 // m_f > m_u / alpha 时切到 bottom-up
+    double beta = 24;                  // n_f < n / beta 时切回 top-down
+};
+
+inline bfs_result bfs_parallel(const csr_graph& g, csr_graph::vertex_type source,
+                               const bfs_options& opt = {}) {
+    using V = csr_graph::vertex_type;
+    constexpr V npos = csr_graph::npos;
+    constexpr size_t kQueueChunk = 64;   // top-down 每次领取的前沿顶点数
+    constexpr size_t kWordChunk = 16;    // bottom-up 每次领取的位图字数（1024 个顶点）
+    constexpr size_t kFlush = 1024;      // 线程本地的下一层缓冲满了再写进共享队列
+
+    const size_t n = g.vertex_count();
+    const size_t threads = std::max<size_t>(opt.threads, 1);
+    const size_t words = (n + 63) / 64;
+    bfs_result r;
+    r.parent.assign(n, npos);
+    if (source >= n) return r;
+    r.parent[source] = source;
+
+    // 前沿同时有两种表示：顶点队列（top-down 用）和位图（bottom-up 用）
+    std::vector<V> queue(n), nextQueue(n);
+    std::vector<uint64_t> front(words), next(words);
+    queue[0] = source;
+    size_t queueSize = 1;
+    uint64_t frontierEdges = g.degree(source);
+    uint64_t unexploredEdges = g.edge_count() - frontierEdges;
+    bool bottomUp = false, convert = false, done = false;
+    const bool directionOptimizing = opt.direction_optimizing && g.symmetric();
+
+    std::atomic<size_t> cursor{0}, nextTail{0};
+    std::atomic<uint64_t> nextEdges{0};
+    V* parent = r.parent.data();
+
+    // 领取 [lo, hi) 小块直到做完
+    auto forChunks = [&](size_t total, size_t chunk, auto&& f) {
+        for (size_t lo; (lo = cursor.fetch_add(chunk, std::memory_order_relaxed)) < total;)
+            f(lo, std::min(total, lo + chunk));
+    };
+
+    std::barrier sync(ptrdiff_t(threads), [&]() noexcept {
+        cursor.store(0, std::memory_order_relaxed);
+        convert = false;
+    });
+    // 每层结束：交换前沿，决定下一层的方向
+    std::barrier levelEnd(ptrdiff_t(threads), [&]() noexcept {
+        cursor.store(0, std::memory_order_relaxed);
+        r.levels++;
+        r.bottom_up_levels += bottomUp;
+        r.reached += queueSize;
+        size_t prevSize = queueSize;
+        queue.swap(nextQueue);
+        queueSize = nextTail.exchange(0, std::memory_order_relaxed);
+        if (bottomUp) front.swap(next);
+        frontierEdges = nextEdges.exchange(0, std::memory_order_relaxed);
+        unexploredEdges -= frontierEdges;
+        if (queueSize == 0) {
+            done = true;
+        } else if (directionOptimizing) {
+            if (!bottomUp && double(frontierEdges) > double(unexploredEdges) / opt.alpha &&
+                queueSize > prevSize) {
+                bottomUp = convert = true;
+            } else if (bottomUp && double(queueSize) < double(n) / opt.beta && queueSize < prevSize) {
+                bottomUp = false;
+            }
+        }
+    });
+
+    auto worker = [&] {
+        std::vector<V> local;
+        local.reserve(kFlush);
+        uint64_t localEdges = 0;
+        auto flush = [&] {
+            size_t base = nextTail.fetch_add(local.size(), std::memory_order_relaxed);
+            std::copy(local.begin(), local.end(), nextQueue.begin() + ptrdiff_t(base));
+            local.clear();
+        };
+        auto emit = [&](V v) {
+            local.push_back(v);
+            localEdges += g.degree(v);
+            if (local.size() == kFlush) flush();
+        };
+
+        while (!done) {
+            if (convert) {
+                // 刚切到 bottom-up：把队列形式的前沿写成位图
+                forChunks(words, 1024, [&](size_t lo, size_t hi) {
+                    std::fill(front.begin() + ptrdiff_t(lo), front.begin() + ptrdiff_t(hi), 0);
+                });
+                sync.arrive_and_wait();
+                forChunks(queueSize, kQueueChunk, [&](size_t lo, size_t hi) {
+                    for (size_t i = lo; i < hi; i++) {
+                        V v = queue[i];
+                        std::atomic_ref<uint64_t>(front[v / 64])
+                            .fetch_or(uint64_t(1) << (v % 64), std::memory_order_relaxed);
+                    }
+                });
+                sync.arrive_and_wait();
+            }
+
+            if (!bottomUp) {
+                forChunks(queueSize, kQueueChunk, [&](size_t lo, size_t hi) {
+                    for (size_t i = lo; i < hi; i++) {
+                        V u = queue[i];
+                        for (V v : g.neighbors(u)) {
+                            std::atomic_ref<V> p(parent[v]);
+                            if (p.load(std::memory_order_relaxed) != npos) continue;
+                            V expected = npos;
+                            if (p.compare_exchange_strong(expected, u, std::memory_order_relaxed))
+                                emit(v);
+                        }
+                    }
+                });
+            } else {
+                // 每个位图字只由领到它的线程写，parent[v] 也只由 v 所在字的线程写：不需要原子操作
+                forChunks(words, kWordChunk, [&](size_t lo, size_t hi) {
+                    for (size_t w = lo; w < hi; w++) {
+                        uint64_t bits = 0;
+                        V end = V(std::min(n, (w + 1) * 64));
+                        for (V v = V(w * 64); v < end; v++) {
+                            if (parent[v] != npos) continue;
+                            for (V u : g.neighbors(v)) {
+                                if (!(front[u / 64] >> (u % 64) & 1)) continue;
+                                parent[v] = u;
+                                bits |= uint64_t(1) << (v % 64);
+                                emit(v);
+                                break;
+                            }
+                        }
+                        next[w] = bits;
+                    }
+                });
+            }
+            if (!local.empty()) flush();
+            nextEdges.fetch_add(localEdges, std::memory_order_relaxed);
+            localEdges = 0;
+            levelEnd.arrive_and_wait();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (size_t i = 1; i < threads; i++) pool.emplace_back(worker);
+    worker();  // 当前线程也干活
+    for (auto& t : pool) t.join();
+    return r;
+}
@@ -0,0 +1,630 @@
+#pragma once
+
+// flat_hash_map.h: Swiss-table 风格的开放寻址哈希表
+//
+// 与 std::unordered_map（拉链法，每个元素一个堆节点）相比：
+//   - 元素直接存放在一整块连续的 slot 数组里，没有逐节点分配、没有指针追逐
+//   - 额外维护一个"控制字节"数组，每个 slot 对应 1 字节：
+//       kEmpty   (0x80) 空槽
+//       kDeleted (0xFE) 墓碑（被删除，但探测链不能在此断开）
+//       0..127         满槽，值是哈希的低 7 位（H2）
+//   - 查找时一次加载 16 个控制字节（一个 group），用 SSE2 一条比较指令
+//     同时和 H2 比较，得到一个 16 位掩码，只有掩码命中的 slot 才去比较 key
+//
+// 探测单位是按 16 对齐的 group：H1（哈希高位）选起始 group，之后按三角数
+// 序列 g, g+1, g+3, g+6, ... 跳 group（group 数是 2 的幂时能遍历全部 group）。
+// 查找在遇到含 kEmpty 的 group 时停止。
+//
+// 删除时尽量不留墓碑：如果被删元素所在 group 里还有 kEmpty，说明从来没有
+// 探测链"穿过"这个 group（插入只会在 group 没有空位时继续往后探测），
+// 直接标成 kEmpty 即可；只有 group 曾经被填满时才需要写 kDeleted。
+//
+// 注意：迭代器返回的是 std::pair<Key, Value>&（不是 pair<const Key, Value>），
+// 修改 key 是未定义行为；任何插入都可能触发 rehash，使所有迭代器失效。
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FLAT_HASH_SSE2 1
+#else
+#define FLAT_HASH_SSE2 0
+#endif
+
+// ============================================================
+// 默认哈希：字符串类 key 支持异构查找（string / string_view / const char*）
+// ============================================================
+template <typename T>
+struct flat_hash : std::hash<T> {};
+
+template <>
+struct flat_hash<std::string> {
+    using is_transparent = void;
+    size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+};
+
+template <>
+struct flat_hash<std::string_view> : flat_hash<std::string> {};
+
+// ============================================================
+// 控制字节与 group 探测
+// ============================================================
+enum : int8_t {
+    kCtrlEmpty = -128,  // 0x80
+    kCtrlDeleted = -2,  // 0xFE
+};
+
+constexpr size_t kGroupWidth = 16;
+
+// 一次处理 16 个控制字节，返回的掩码第 i 位对应 group 内第 i 个 slot
+class CtrlGroup {
+public:
+    explicit CtrlGroup(const int8_t* p) {
+#if FLAT_HASH_SSE2
+        mCtrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+#else
+        std::memcpy(mCtrl, p, kGroupWidth);
+#endif
+    }
+
+    uint32_t match(int8_t h2) const {
+#if FLAT_HASH_SSE2
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(mCtrl, _mm_set1_epi8(h2))));
+#else
+        return matchIf([h2](int8_t c) { return c == h2; });
+#endif
+    }
+
+    uint32_t matchEmpty() const {
+#if FLAT_HASH_SSE2
+        return static_cast<uint32_t>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(mCtrl, _mm_set1_epi8(kCtrlEmpty))));
+#else
+        return matchIf([](int8_t c) { return c == kCtrlEmpty; });
+#endif
+    }
+
+    // kEmpty 和 kDeleted 的最高位都是 1，满槽（0..127）最高位是 0：movemask 直接取符号位
+    uint32_t matchEmptyOrDeleted() const {
+#if FLAT_HASH_SSE2
+        return static_cast<uint32_t>(_mm_movemask_epi8(mCtrl));
+#else
+        return matchIf([](int8_t c) { return c < 0; });
+#endif
+    }
+
+private:
+#if FLAT_HASH_SSE2
+    __m128i mCtrl;
+#else
+    template <typename Pred>
+    uint32_t matchIf(Pred pred) const {
+        uint32_t mask = 0;
+        for (size_t i = 0; i < kGroupWidth; ++i)
+            if (pred(mCtrl[i])) mask |= 1u << i;
+        return mask;
+    }
+    int8_t mCtrl[kGroupWidth];
+#endif
+};
+
+// 异构查找的参数类型选择：flat_hash_key_arg<true>::type 直接展开为 K，K 仍可推导
+// （std::conditional_t<B, K, Key> 是嵌套的 ::type，会让 K 变成不可推导上下文）
+template <bool Transparent>
+struct flat_hash_key_arg {
+    template <typename K, typename KeyType>
+    using type = KeyType;
+};
+template <>
+struct flat_hash_key_arg<true> {
+    template <typename K, typename KeyType>
+    using type = K;
+};
+
+// ============================================================
+// flat_hash_table：map 和 set 共用的实现
+//   Slot 是实际存储的元素类型；KeyOf 从 Slot 中取出 key
+// ============================================================
+template <typename Key, typename Slot, typename KeyOf, typename Hash, typename KeyEqual>
+class flat_hash_table {
+    template <typename T, typename = void>
+    struct is_transparent_t : std::false_type {};
+    template <typename T>
+    struct is_transparent_t<T, std::void_t<typename T::is_transparent>> : std::true_type {};
+
+    static constexpr bool kTransparent =
+        is_transparent_t<Hash>::value && is_transparent_t<KeyEqual>::value;
+
+    // set 的元素就是 key，不允许通过迭代器修改
+    static constexpr bool kConstElements = std::is_same_v<Key, Slot>;
+
+protected:
+    // 异构查找：Hash 和 KeyEqual 都声明 is_transparent 时，find 等接口接受任意 K，
+    // 否则 K 处于不可推导上下文，退化为 Key（和 std::unordered_map 的 C++20 行为一致）
+    template <typename K>
+    using key_arg = typename flat_hash_key_arg<kTransparent>::template type<K, Key>;
+
+public:
+    using key_type = Key;
+    using value_type = Slot;
+    using size_type = size_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+
+    template <bool Const>
+    class basic_iterator {
+        friend class flat_hash_table;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Slot;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const || kConstElements, const Slot&, Slot&>;
+        using pointer = std::conditional_t<Const || kConstElements, const Slot*, Slot*>;
+
+        basic_iterator() = default;
+        // iterator → const_iterator 的隐式转换
+        template <bool C = Const, typename = std::enable_if_t<C>>
+        basic_iterator(const basic_iterator<false>& o) : mCtrl(o.mCtrl), mSlot(o.mSlot), mEnd(o.mEnd) {}
+
+        reference operator*() const { return *mSlot; }
+        pointer operator->() const { return mSlot; }
+
+        basic_iterator& operator++() {
+            ++mCtrl;
+            ++mSlot;
+            skipEmpty();
+            return *this;
+        }
+        basic_iterator operator++(int) {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend bool operator==(const basic_iterator& a, const basic_iterator& b) {
+            return a.mCtrl == b.mCtrl;
+        }
+        friend bool operator!=(const basic_iterator& a, const basic_iterator& b) {
+            return a.mCtrl != b.mCtrl;
+        }
+
+    private:
+        template <bool>
+        friend class basic_iterator;
+
+        basic_iterator(const int8_t* ctrl, Slot* slot, const int8_t* end)
+            : mCtrl(ctrl), mSlot(slot), mEnd(end) {}
+
+        void skipEmpty() {
+            while (mCtrl != mEnd && *mCtrl < 0) {
+                ++mCtrl;
+                ++mSlot;
+            }
+        }
+
+        const int8_t* mCtrl = nullptr;
+        Slot* mSlot = nullptr;
+        const int8_t* mEnd = nullptr;
+    };
+
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    // ---------- 构造 / 析构 ----------
+    flat_hash_table() = default;
+    explicit flat_hash_table(size_t bucketCount, const Hash& hash = Hash(),
+                             const KeyEqual& eq = KeyEqual())
+        : mHash(hash), mEq(eq) {
+        reserve(bucketCount);
+    }
+
+    flat_hash_table(const flat_hash_table& o) : mHash(o.mHash), mEq(o.mEq) {
+        reserve(o.mSize);
+        for (const auto& s : o) insertUnique(hashOf(KeyOf{}(s)), s);
+    }
+
+    flat_hash_table(flat_hash_table&& o) noexcept
+        : mCtrl(std::exchange(o.mCtrl, nullptr)),
+          mSlots(std::exchange(o.mSlots, nullptr)),
+          mCapacity(std::exchange(o.mCapacity, 0)),
+          mSize(std::exchange(o.mSize, 0)),
+          mGrowthLeft(std::exchange(o.mGrowthLeft, 0)),
+          mHash(std::move(o.mHash)),
+          mEq(std::move(o.mEq)) {}
+
+    flat_hash_table& operator=(flat_hash_table o) noexcept {
+        swap(o);
+        return *this;
+    }
+
+    ~flat_hash_table() { destroyAll(); }
+
+    void swap(flat_hash_table& o) noexcept {
+        std::swap(mCtrl, o.mCtrl);
+        std::swap(mSlots, o.mSlots);
+        std::swap(mCapacity, o.mCapacity);
+        std::swap(mSize, o.mSize);
+        std::swap(mGrowthLeft, o.mGrowthLeft);
+        std::swap(mHash, o.mHash);
+        std::swap(mEq, o.mEq);
+    }
+
+    // ---------- 容量 ----------
+    size_t size() const { return mSize; }
+    bool empty() const { return mSize == 0; }
+    size_t bucket_count() const { return mCapacity; }
+    float load_factor() const { return mCapacity ? float(mSize) / float(mCapacity) : 0.0f; }
+    float max_load_factor() const { return 7.0f / 8.0f; }
+
+    // 保证能放下 n 个元素而不再 rehash
+    void reserve(size_t n) {
+        if (n > capacityToGrowth(mCapacity)) rehash(growthToCapacity(n));
+    }
+
+    // 把 slot 数设为 >= n 的 2 的幂（至少能容纳当前元素）；同时清理所有墓碑
+    void rehash(size_t n) {
+        size_t want = std::max(n, growthToCapacity(mSize));
+        if (want == 0) {
+            if (mSize == 0) {
+                destroyAll();
+                mCtrl = nullptr;
+                mSlots = nullptr;
+                mCapacity = mGrowthLeft = 0;
+            }
+            return;
+        }
+        resize(std::bit_ceil(std::max(want, kGroupWidth)));
+    }
+
+    // ---------- 迭代 ----------
+    iterator begin() {
+        iterator it(mCtrl, mSlots, mCtrl + mCapacity);
+        it.skipEmpty();
+        return it;
+    }
+    iterator end() { return iterator(mCtrl + mCapacity, mSlots + mCapacity, mCtrl + mCapacity); }
+    const_iterator begin() const { return const_cast<flat_hash_table*>(this)->begin(); }
+    const_iterator end() const { return const_cast<flat_hash_table*>(this)->end(); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    // ---------- 查找 ----------
+    template <typename K = Key>
+    iterator find(const key_arg<K>& key) {
+        if (mSize == 0) return end();
+        size_t idx = findIndex(key, hashOf(key));
+        return idx == kNotFound ? end() : iteratorAt(idx);
+    }
+    template <typename K = Key>
+    const_iterator find(const key_arg<K>& key) const {
+        return const_cast<flat_hash_table*>(this)->template find<K>(key);
+    }
+
+    template <typename K = Key>
+    bool contains(const key_arg<K>& key) const {
+        return mSize != 0 && findIndex(key, hashOf(key)) != kNotFound;
+    }
+    template <typename K = Key>
+    size_t count(const key_arg<K>& key) const {
+        return contains<K>(key) ? 1 : 0;
+    }
+
+    // ---------- 插入 ----------
+    std::pair<iterator, bool> insert(const Slot& value) { return emplaceSlot(value); }
+    std::pair<iterator, bool> insert(Slot&& value) { return emplaceSlot(std::move(value)); }
+
+    template <typename InputIt>
+    void insert(InputIt first, InputIt last) {
+        for (; first != last; ++first) insert(*first);
+    }
+
+    // 先构造元素再查找 key；key 已存在时这次构造被浪费（同 std::unordered_map）
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        return emplaceSlot(Slot(std::forward<Args>(args)...));
+    }
+
+    // ---------- 删除 ----------
+    template <typename K = Key>
+    size_t erase(const key_arg<K>& key) {
+        if (mSize == 0) return 0;
+        size_t idx = findIndex(key, hashOf(key));
+        if (idx == kNotFound) return 0;
+        eraseAt(idx);
+        return 1;
+    }
+
+    iterator erase(const_iterator pos) {
+        size_t idx = static_cast<size_t>(pos.mCtrl - mCtrl);
+        eraseAt(idx);
+        iterator it = iteratorAt(idx);
+        it.skipEmpty();
+        return it;
+    }
+    iterator erase(iterator pos) { return erase(const_iterator(pos)); }
+
+    void clear() {
+        if (mCapacity == 0) return;
+        for (size_t i = 0; i < mCapacity; ++i)
+            if (mCtrl[i] >= 0) std::destroy_at(mSlots + i);
+        std::memset(mCtrl, static_cast<unsigned char>(kCtrlEmpty), mCapacity);
+        mSize = 0;
+        mGrowthLeft = capacityToGrowth(mCapacity);
+    }
+
+    hasher hash_function() const { return mHash; }
+    key_equal key_eq() const { return mEq; }
+
+    // 控制字节 + slot 数组占用的字节数（不含元素自身持有的堆内存，如 std::string 的缓冲区）
+    size_t memory_usage() const { return mCapacity * (sizeof(Slot) + 1); }
+
+protected:
+    static constexpr size_t kNotFound = ~size_t(0);
+
+    // 把 std::hash 的结果再混合一次：std::hash<int> 等通常是恒等函数，
+    // 低 7 位和高位都必须"随机"，H1/H2 才能均匀
+    template <typename K>
+    size_t hashOf(const K& key) const {
+        uint64_t h = static_cast<uint64_t>(mHash(key));
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ull;
+        h ^= h >> 33;
+        return static_cast<size_t>(h);
+    }
+    static int8_t h2Of(size_t hash) { return static_cast<int8_t>(hash & 0x7F); }
+    size_t firstGroup(size_t hash) const { return (hash >> 7) & (mCapacity / kGroupWidth - 1); }
+
+    template <typename K>
+    size_t findIndex(const K& key, size_t hash) const {
+        const size_t groupMask = mCapacity / kGroupWidth - 1;
+        const int8_t h2 = h2Of(hash);
+        size_t g = firstGroup(hash);
+        for (size_t step = 1;; ++step) {
+            CtrlGroup grp(mCtrl + g * kGroupWidth);
+            for (uint32_t m = grp.match(h2); m; m &= m - 1) {
+                size_t idx = g * kGroupWidth + std::countr_zero(m);
+                if (mEq(KeyOf{}(mSlots[idx]), key)) return idx;
+            }
+            if (grp.matchEmpty()) return kNotFound;
+            g = (g + step) & groupMask;  // 三角数探测
+        }
+    }
+
+    // 探测序列上第一个空槽或墓碑
+    size_t findFirstNonFull(size_t hash) const {
+        const size_t groupMask = mCapacity / kGroupWidth - 1;
+        size_t g = firstGroup(hash);
+        for (size_t step = 1;; ++step) {
+            uint32_t m = CtrlGroup(mCtrl + g * kGroupWidth).matchEmptyOrDeleted();
+            if (m) return g * kGroupWidth + std::countr_zero(m);
+            g = (g + step) & groupMask;
+        }
+    }
+
+    // 查找 key；不存在时预留一个 slot 并写好控制字节（调用方负责构造元素）
+    template <typename K>
+    std::pair<size_t, bool> findOrPrepareInsert(const K& key) {
+        size_t hash = hashOf(key);
+        if (mSize != 0) {
+            size_t idx = findIndex(key, hash);
+            if (idx != kNotFound) return {idx, false};
+        }
+        return {prepareInsert(hash), true};
+    }
+
+    size_t prepareInsert(size_t hash) {
+        if (mCapacity == 0) resize(kGroupWidth);
+        size_t idx = findFirstNonFull(hash);
+        // 复用墓碑不消耗增长额度；占用空槽才可能触发扩容
+        if (mGrowthLeft == 0 && mCtrl[idx] != kCtrlDeleted) {
+            growOrPurge();
+            idx = findFirstNonFull(hash);
+        }
+        if (mCtrl[idx] == kCtrlEmpty) --mGrowthLeft;
+        mCtrl[idx] = h2Of(hash);
+        ++mSize;
+        return idx;
+    }
+
+    template <typename S>
+    std::pair<iterator, bool> emplaceSlot(S&& value) {
+        auto [idx, inserted] = findOrPrepareInsert(KeyOf{}(value));
+        if (inserted) constructAt(idx, std::forward<S>(value));
+        return {iteratorAt(idx), inserted};
+    }
+
+    template <typename... Args>
+    void constructAt(size_t idx, Args&&... args) {
+        try {
+            ::new (static_cast<void*>(mSlots + idx)) Slot(std::forward<Args>(args)...);
+        } catch (...) {
+            // 撤销 prepareInsert 写入的控制字节
+            setEmptyOrDeleted(idx);
+            --mSize;
+            throw;
+        }
+    }
+
+    void eraseAt(size_t idx) {
+        std::destroy_at(mSlots + idx);
+        setEmptyOrDeleted(idx);
+        --mSize;
+    }
+
+    void setEmptyOrDeleted(size_t idx) {
+        const int8_t* groupStart = mCtrl + (idx & ~(kGroupWidth - 1));
+        if (CtrlGroup(groupStart).matchEmpty()) {
+            mCtrl[idx] = kCtrlEmpty;  // group 从未满过，不需要墓碑
+            ++mGrowthLeft;
+        } else {
+            mCtrl[idx] = kCtrlDeleted;
+        }
+    }
+
+    iterator iteratorAt(size_t idx) {
+        return iterator(mCtrl + idx, mSlots + idx, mCtrl + mCapacity);
+    }
+
+    // 已知 key 不存在时的插入（拷贝 / rehash 用），跳过比较
+    template <typename S>
+    void insertUnique(size_t hash, S&& value) {
+        size_t idx = findFirstNonFull(hash);
+        ::new (static_cast<void*>(mSlots + idx)) Slot(std::forward<S>(value));
+        mCtrl[idx] = h2Of(hash);
+        --mGrowthLeft;
+        ++mSize;
+    }
+
+    // 增长额度用完：墓碑多就原地重建，否则容量翻倍
+    void growOrPurge() {
+        if (mSize <= capacityToGrowth(mCapacity) / 2) resize(mCapacity);
+        else resize(mCapacity * 2);
+    }
+
+    void resize(size_t newCapacity) {
+        int8_t* oldCtrl = mCtrl;
+        Slot* oldSlots = mSlots;
+        size_t oldCapacity = mCapacity;
+
+        mCtrl = new int8_t[newCapacity];
+        std::memset(mCtrl, static_cast<unsigned char>(kCtrlEmpty), newCapacity);
+        mSlots = std::allocator<Slot>().allocate(newCapacity);
+        mCapacity = newCapacity;
+        mGrowthLeft = capacityToGrowth(newCapacity);
+        mSize = 0;
+
+        for (size_t i = 0; i < oldCapacity; ++i) {
+            if (oldCtrl[i] < 0) continue;
+            insertUnique(hashOf(KeyOf{}(oldSlots[i])), std::move_if_noexcept(oldSlots[i]));
+            std::destroy_at(oldSlots + i);
+        }
+        if (oldCapacity) {
+            delete[] oldCtrl;
+            std::allocator<Slot>().deallocate(oldSlots, oldCapacity);
+        }
+    }
+
+    void destroyAll() {
+        if (mCapacity == 0) return;
+        for (size_t i = 0; i < mCapacity; ++i)
+            if (mCtrl[i] >= 0) std::destroy_at(mSlots + i);
+        delete[] mCtrl;
+        std::allocator<Slot>().deallocate(mSlots, mCapacity);
+    }
+
+    // 最大负载因子 7/8
+    static size_t capacityToGrowth(size_t capacity) { return capacity - capacity / 8; }
+    static size_t growthToCapacity(size_t n) { return n == 0 ? 0 : n + (n - 1) / 7 + 1; }
+
+    int8_t* mCtrl = nullptr;
+    Slot* mSlots = nullptr;
+    size_t mCapacity = 0;    // slot 总数，0 或 16 的倍数（2 的幂）
+    size_t mSize = 0;
+    size_t mGrowthLeft = 0;  // 还能占用多少个空槽（墓碑不计入）
+    [[no_unique_address]] Hash mHash;
+    [[no_unique_address]] KeyEqual mEq;
+};
+
+// ============================================================
+// flat_hash_map
+// ============================================================
+struct flat_map_key_of {
+    template <typename P>
+    const auto& operator()(const P& p) const {
+        return p.first;
+    }
+};
+
+template <typename Key, typename Value, typename Hash = flat_hash<Key>,
+          typename KeyEqual = std::equal_to<>>
+class flat_hash_map
+    : public flat_hash_table<Key, std::pair<Key, Value>, flat_map_key_of, Hash, KeyEqual> {
+    using Base = flat_hash_table<Key, std::pair<Key, Value>, flat_map_key_of, Hash, KeyEqual>;
+    template <typename K>
+    using key_arg = typename Base::template key_arg<K>;
+
+public:
+    using mapped_type = Value;
+    using typename Base::const_iterator;
+    using typename Base::iterator;
+
+    using Base::Base;
+    flat_hash_map() = default;
+
+    flat_hash_map(std::initializer_list<std::pair<Key, Value>> init) {
+        this->reserve(init.size());
+        this->insert(init.begin(), init.end());
+    }
+
+    // 只有 key 不存在时才构造 value
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+        auto [idx, inserted] = this->findOrPrepareInsert(key);
+        if (inserted)
+            this->constructAt(idx, std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+                              std::forward_as_tuple(std::forward<Args>(args)...));
+        return {this->iteratorAt(idx), inserted};
+    }
+
+    template <typename K, typename V>
+    std::pair<iterator, bool> insert_or_assign(K&& key, V&& value) {
+        auto [it, inserted] = try_emplace(std::forward<K>(key), std::forward<V>(value));
+        if (!inserted) it->second = std::forward<V>(value);
+        return {it, inserted};
+    }
+
+    template <typename K = Key>
+    Value& operator[](K&& key) {
+        return try_emplace(std::forward<K>(key)).first->second;
+    }
+
+    template <typename K = Key>
+    Value& at(const key_arg<K>& key) {
+        auto it = this->template find<K>(key);
+        if (it == this->end()) throw std::out_of_range("flat_hash_map::at");
+        return it->second;
+    }
+    template <typename K = Key>
+    const Value& at(const key_arg<K>& key) const {
+        return const_cast<flat_hash_map*>(this)->template at<K>(key);
+    }
+};
+
+// ============================================================
+// flat_hash_set
+// ============================================================
+struct flat_set_key_of {
+    template <typename T>
+    const T& operator()(const T& v) const {
+        return v;
+    }
+};
+
+template <typename Key, typename Hash = flat_hash<Key>, typename KeyEqual = std::equal_to<>>
+class flat_hash_set : public flat_hash_table<Key, Key, flat_set_key_of, Hash, KeyEqual> {
+    using Base = flat_hash_table<Key, Key, flat_set_key_of, Hash, KeyEqual>;
+
+public:
+    using Base::Base;
+    flat_hash_set() = default;
+
+    flat_hash_set(std::initializer_list<Key> init) {
+        this->reserve(init.size());
+        this->insert(init.begin(), init.end());
+    }
+};
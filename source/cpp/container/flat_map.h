@@ -0,0 +1,422 @@
+#pragma once
+
+// flat_map.h: 有序向量实现的 flat_set / flat_map / flat_multimap（接口参考 C++23 <flat_map>）
+//
+// 与 std::set / std::map（红黑树，每元素一个节点）相比：
+//   - key 存在一个有序 std::vector 里，value 存在另一个等长 vector 里（"结构数组"），
+//     二分查找只访问 key 数组，遍历和范围扫描是纯顺序内存访问
+//   - 查找 O(log n) 但常数小得多；单个插入/删除 O(n)（要挪动后面的元素）
+//   - 批量插入：先对新元素排序去重，再与已有序列线性归并，O(n + m log m)，
+//     而不是 m 次 O(n) 的单个插入
+//
+// 适合"一次建好、大量读、偶尔批量更新"的数据。任何插入/删除都会使所有迭代器失效。
+// flat_map 的迭代器解引用得到 std::pair<const Key&, Value&>（代理对象），
+// 所以 for (auto [k, v] : m) 里的 v 是引用，可以直接修改。
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// 构造时声明输入"已经有序"，跳过排序（和 C++23 的同名标签含义相同）
+struct sorted_unique_t {
+    explicit sorted_unique_t() = default;
+};
+inline constexpr sorted_unique_t sorted_unique{};
+
+struct sorted_equivalent_t {
+    explicit sorted_equivalent_t() = default;
+};
+inline constexpr sorted_equivalent_t sorted_equivalent{};
+
+// ============================================================
+// flat_set
+// ============================================================
+template <typename Key, typename Compare = std::less<Key>>
+class flat_set {
+public:
+    using key_type = Key;
+    using value_type = Key;
+    using size_type = size_t;
+    using key_compare = Compare;
+    using container_type = std::vector<Key>;
+    using iterator = typename container_type::const_iterator;  // 元素不可修改
+    using const_iterator = iterator;
+
+    flat_set() = default;
+
+    // 从无序输入构造：排序一次 + 去重
+    template <typename InputIt>
+    flat_set(InputIt first, InputIt last, const Compare& comp = Compare())
+        : mKeys(first, last), mComp(comp) {
+        sortAndUnique(mKeys.begin());
+    }
+    flat_set(std::initializer_list<Key> init, const Compare& comp = Compare())
+        : flat_set(init.begin(), init.end(), comp) {}
+    explicit flat_set(container_type keys, const Compare& comp = Compare())
+        : mKeys(std::move(keys)), mComp(comp) {
+        sortAndUnique(mKeys.begin());
+    }
+    flat_set(sorted_unique_t, container_type keys, const Compare& comp = Compare())
+        : mKeys(std::move(keys)), mComp(comp) {}
+
+    iterator begin() const { return mKeys.begin(); }
+    iterator end() const { return mKeys.end(); }
+    size_t size() const { return mKeys.size(); }
+    bool empty() const { return mKeys.empty(); }
+    void reserve(size_t n) { mKeys.reserve(n); }
+    void clear() { mKeys.clear(); }
+    const container_type& keys() const { return mKeys; }
+
+    // ---------- 查找 ----------
+    iterator lower_bound(const Key& k) const { return std::lower_bound(begin(), end(), k, mComp); }
+    iterator upper_bound(const Key& k) const { return std::upper_bound(begin(), end(), k, mComp); }
+    std::pair<iterator, iterator> equal_range(const Key& k) const {
+        return std::equal_range(begin(), end(), k, mComp);
+    }
+    iterator find(const Key& k) const {
+        auto it = lower_bound(k);
+        return (it != end() && !mComp(k, *it)) ? it : end();
+    }
+    bool contains(const Key& k) const { return find(k) != end(); }
+    size_t count(const Key& k) const { return contains(k) ? 1 : 0; }
+
+    // ---------- 修改 ----------
+    std::pair<iterator, bool> insert(const Key& k) { return emplace(k); }
+    std::pair<iterator, bool> insert(Key&& k) { return emplace(std::move(k)); }
+
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        Key k(std::forward<Args>(args)...);
+        auto it = lower_bound(k);
+        if (it != end() && !mComp(k, *it)) return {it, false};
+        return {mKeys.insert(it, std::move(k)), true};
+    }
+
+    // 批量插入：追加到尾部 → 只排序新的部分 → 与原有部分原地归并 → 去重
+    template <typename InputIt>
+    void insert(InputIt first, InputIt last) {
+        size_t oldSize = mKeys.size();
+        mKeys.insert(mKeys.end(), first, last);
+        sortAndUnique(mKeys.begin() + oldSize);
+    }
+    void insert(std::initializer_list<Key> init) { insert(init.begin(), init.end()); }
+
+    size_t erase(const Key& k) {
+        auto it = find(k);
+        if (it == end()) return 0;
+        mKeys.erase(it);
+        return 1;
+    }
+    iterator erase(iterator pos) { return mKeys.erase(pos); }
+    iterator erase(iterator first, iterator last) { return mKeys.erase(first, last); }
+
+private:
+    // [begin, mid) 已有序且唯一；把 [mid, end) 排序后归并进来并去重
+    void sortAndUnique(typename container_type::iterator mid) {
+        // 稳定排序 + 稳定归并：相等元素保留最先出现的那个（已有元素优先）
+        std::stable_sort(mid, mKeys.end(), mComp);
+        std::inplace_merge(mKeys.begin(), mid, mKeys.end(), mComp);
+        auto equiv = [this](const Key& a, const Key& b) { return !mComp(a, b) && !mComp(b, a); };
+        mKeys.erase(std::unique(mKeys.begin(), mKeys.end(), equiv), mKeys.end());
+    }
+
+    container_type mKeys;
+    [[no_unique_address]] Compare mComp;
+};
+
+// ============================================================
+// flat_map_base：flat_map / flat_multimap 共用，Multi 表示是否允许重复 key
+// ============================================================
+template <typename Key, typename Value, typename Compare, bool Multi>
+class flat_map_base {
+    static_assert(!std::is_same_v<Value, bool>, "std::vector<bool> 没有 data()，请用 char 之类代替");
+
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<Key, Value>;
+    using size_type = size_t;
+    using key_compare = Compare;
+    using key_container_type = std::vector<Key>;
+    using mapped_container_type = std::vector<Value>;
+
+    // 迭代器同时持有 key 指针和 value 指针，二者同步移动
+    template <bool Const>
+    class basic_iterator {
+        using ValuePtr = std::conditional_t<Const, const Value*, Value*>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = std::pair<Key, Value>;
+        using reference = std::pair<const Key&, std::conditional_t<Const, const Value&, Value&>>;
+
+        // operator-> 需要返回指针，代理对象借助一个小包装实现 it->first / it->second
+        struct pointer {
+            reference ref;
+            reference* operator->() { return &ref; }
+        };
+
+        basic_iterator() = default;
+        basic_iterator(const Key* k, ValuePtr v) : mKey(k), mValue(v) {}
+        template <bool C = Const, typename = std::enable_if_t<C>>
+        basic_iterator(const basic_iterator<false>& o) : mKey(o.key_ptr()), mValue(o.value_ptr()) {}
+
+        reference operator*() const { return {*mKey, *mValue}; }
+        pointer operator->() const { return {**this}; }
+        reference operator[](difference_type n) const { return *(*this + n); }
+
+        basic_iterator& operator++() { ++mKey, ++mValue; return *this; }
+        basic_iterator& operator--() { --mKey, --mValue; return *this; }
+        basic_iterator operator++(int) { auto t = *this; ++*this; return t; }
+        basic_iterator operator--(int) { auto t = *this; --*this; return t; }
+        basic_iterator& operator+=(difference_type n) { mKey += n, mValue += n; return *this; }
+        basic_iterator& operator-=(difference_type n) { mKey -= n, mValue -= n; return *this; }
+        friend basic_iterator operator+(basic_iterator it, difference_type n) { return it += n; }
+        friend basic_iterator operator+(difference_type n, basic_iterator it) { return it += n; }
+        friend basic_iterator operator-(basic_iterator it, difference_type n) { return it -= n; }
+        friend difference_type operator-(const basic_iterator& a, const basic_iterator& b) {
+            return a.mKey - b.mKey;
+        }
+        friend bool operator==(const basic_iterator& a, const basic_iterator& b) { return a.mKey == b.mKey; }
+        friend bool operator!=(const basic_iterator& a, const basic_iterator& b) { return a.mKey != b.mKey; }
+        friend bool operator<(const basic_iterator& a, const basic_iterator& b) { return a.mKey < b.mKey; }
+        friend bool operator>(const basic_iterator& a, const basic_iterator& b) { return a.mKey > b.mKey; }
+        friend bool operator<=(const basic_iterator& a, const basic_iterator& b) { return a.mKey <= b.mKey; }
+        friend bool operator>=(const basic_iterator& a, const basic_iterator& b) { return a.mKey >= b.mKey; }
+
+        const Key* key_ptr() const { return mKey; }
+        ValuePtr value_ptr() const { return mValue; }
+
+    private:
+        const Key* mKey = nullptr;
+        ValuePtr mValue = nullptr;
+    };
+
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    flat_map_base() = default;
+
+    // 从无序 (key, value) 序列构造：稳定排序一次；flat_map 对重复 key 保留第一个
+    template <typename InputIt>
+    flat_map_base(InputIt first, InputIt last, const Compare& comp = Compare()) : mComp(comp) {
+        insert(first, last);
+    }
+    flat_map_base(std::initializer_list<value_type> init, const Compare& comp = Compare())
+        : flat_map_base(init.begin(), init.end(), comp) {}
+
+    // 直接接管两个已有序的数组（不检查）
+    template <typename Tag, typename = std::enable_if_t<std::is_same_v<Tag, sorted_unique_t> ||
+                                                        std::is_same_v<Tag, sorted_equivalent_t>>>
+    flat_map_base(Tag, key_container_type keys, mapped_container_type values,
+                  const Compare& comp = Compare())
+        : mKeys(std::move(keys)), mValues(std::move(values)), mComp(comp) {
+        if (mKeys.size() != mValues.size()) throw std::invalid_argument("flat_map: size mismatch");
+    }
+
+    // ---------- 迭代 / 容量 ----------
+    iterator begin() { return {mKeys.data(), mValues.data()}; }
+    iterator end() { return {mKeys.data() + mKeys.size(), mValues.data() + mValues.size()}; }
+    const_iterator begin() const { return {mKeys.data(), mValues.data()}; }
+    const_iterator end() const {
+        return {mKeys.data() + mKeys.size(), mValues.data() + mValues.size()};
+    }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    size_t size() const { return mKeys.size(); }
+    bool empty() const { return mKeys.empty(); }
+    void reserve(size_t n) {
+        mKeys.reserve(n);
+        mValues.reserve(n);
+    }
+    void clear() {
+        mKeys.clear();
+        mValues.clear();
+    }
+    const key_container_type& keys() const { return mKeys; }
+    const mapped_container_type& values() const { return mValues; }
+
+    // ---------- 查找（只访问 key 数组） ----------
+    iterator lower_bound(const Key& k) { return at_index(lowerIndex(k)); }
+    const_iterator lower_bound(const Key& k) const { return at_index(lowerIndex(k)); }
+    iterator upper_bound(const Key& k) { return at_index(upperIndex(k)); }
+    const_iterator upper_bound(const Key& k) const { return at_index(upperIndex(k)); }
+    std::pair<iterator, iterator> equal_range(const Key& k) {
+        return {lower_bound(k), upper_bound(k)};
+    }
+    std::pair<const_iterator, const_iterator> equal_range(const Key& k) const {
+        return {lower_bound(k), upper_bound(k)};
+    }
+
+    iterator find(const Key& k) {
+        size_t i = lowerIndex(k);
+        return (i < size() && !mComp(k, mKeys[i])) ? at_index(i) : end();
+    }
+    const_iterator find(const Key& k) const { return const_cast<flat_map_base*>(this)->find(k); }
+    bool contains(const Key& k) const { return find(k) != end(); }
+    size_t count(const Key& k) const {
+        if constexpr (Multi) return upperIndex(k) - lowerIndex(k);
+        else return contains(k) ? 1 : 0;
+    }
+
+    // ---------- 单个插入 O(n) ----------
+    std::pair<iterator, bool> insert(const value_type& kv) { return emplace(kv.first, kv.second); }
+    std::pair<iterator, bool> insert(value_type&& kv) {
+        return emplace(std::move(kv.first), std::move(kv.second));
+    }
+
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> emplace(K&& key, Args&&... args) {
+        if constexpr (Multi) {
+            // multimap：插在等值区间末尾，保持插入顺序
+            size_t i = upperIndex(key);
+            insertAt(i, std::forward<K>(key), std::forward<Args>(args)...);
+            return {at_index(i), true};
+        } else {
+            size_t i = lowerIndex(key);
+            if (i < size() && !mComp(key, mKeys[i])) return {at_index(i), false};
+            insertAt(i, std::forward<K>(key), std::forward<Args>(args)...);
+            return {at_index(i), true};
+        }
+    }
+
+    // ---------- 批量插入：排序新元素后线性归并 ----------
+    template <typename InputIt>
+    void insert(InputIt first, InputIt last) {
+        std::vector<value_type> batch(first, last);
+        if (batch.empty()) return;
+        auto byKey = [this](const value_type& a, const value_type& b) { return mComp(a.first, b.first); };
+        std::stable_sort(batch.begin(), batch.end(), byKey);
+        if constexpr (!Multi) {
+            // 批内重复 key 只保留第一个
+            auto equiv = [this](const value_type& a, const value_type& b) {
+                return !mComp(a.first, b.first) && !mComp(b.first, a.first);
+            };
+            batch.erase(std::unique(batch.begin(), batch.end(), equiv), batch.end());
+        }
+
+        key_container_type keys;
+        mapped_container_type values;
+        keys.reserve(mKeys.size() + batch.size());
+        values.reserve(mKeys.size() + batch.size());
+        size_t i = 0, j = 0;
+        while (i < mKeys.size() || j < batch.size()) {
+            // 相等时已有元素在前：flat_map 丢弃新元素，flat_multimap 新元素排在后面
+            bool takeOld = j == batch.size() ||
+                           (i < mKeys.size() && !mComp(batch[j].first, mKeys[i]));
+            if (takeOld) {
+                if constexpr (!Multi) {
+                    if (j < batch.size() && !mComp(mKeys[i], batch[j].first)) ++j;  // 重复，丢弃新的
+                }
+                keys.push_back(std::move(mKeys[i]));
+                values.push_back(std::move(mValues[i]));
+                ++i;
+            } else {
+                keys.push_back(std::move(batch[j].first));
+                values.push_back(std::move(batch[j].second));
+                ++j;
+            }
+        }
+        mKeys = std::move(keys);
+        mValues = std::move(values);
+    }
+    void insert(std::initializer_list<value_type> init) { insert(init.begin(), init.end()); }
+
+    // ---------- 删除 ----------
+    iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+    iterator erase(iterator pos) { return erase(const_iterator(pos)); }
+    iterator erase(const_iterator first, const_iterator last) {
+        size_t a = first.key_ptr() - mKeys.data(), b = last.key_ptr() - mKeys.data();
+        mKeys.erase(mKeys.begin() + a, mKeys.begin() + b);
+        mValues.erase(mValues.begin() + a, mValues.begin() + b);
+        return at_index(a);
+    }
+    size_t erase(const Key& k) {
+        size_t a = lowerIndex(k), b = upperIndex(k);
+        erase(at_index(a), at_index(b));
+        return b - a;
+    }
+
+protected:
+    size_t lowerIndex(const Key& k) const {
+        return std::lower_bound(mKeys.begin(), mKeys.end(), k, mComp) - mKeys.begin();
+    }
+    size_t upperIndex(const Key& k) const {
+        return std::upper_bound(mKeys.begin(), mKeys.end(), k, mComp) - mKeys.begin();
+    }
+    iterator at_index(size_t i) { return {mKeys.data() + i, mValues.data() + i}; }
+    const_iterator at_index(size_t i) const { return {mKeys.data() + i, mValues.data() + i}; }
+
+    template <typename K, typename... Args>
+    void insertAt(size_t i, K&& key, Args&&... args) {
+        mKeys.insert(mKeys.begin() + i, Key(std::forward<K>(key)));
+        try {
+            mValues.insert(mValues.begin() + i, Value(std::forward<Args>(args)...));
+        } catch (...) {
+            mKeys.erase(mKeys.begin() + i);  // 保持两个数组等长
+            throw;
+        }
+    }
+
+    key_container_type mKeys;
+    mapped_container_type mValues;
+    [[no_unique_address]] Compare mComp;
+};
+
+// ============================================================
+// flat_map：key 唯一，额外提供 operator[] / at / try_emplace / insert_or_assign
+// ============================================================
+template <typename Key, typename Value, typename Compare = std::less<Key>>
+class flat_map : public flat_map_base<Key, Value, Compare, false> {
+    using Base = flat_map_base<Key, Value, Compare, false>;
+
+public:
+    using typename Base::iterator;
+    using Base::Base;
+    flat_map() = default;
+
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+        return this->emplace(std::forward<K>(key), std::forward<Args>(args)...);
+    }
+
+    template <typename K, typename V>
+    std::pair<iterator, bool> insert_or_assign(K&& key, V&& value) {
+        size_t i = this->lowerIndex(key);
+        if (i < this->size() && !this->mComp(key, this->mKeys[i])) {
+            this->mValues[i] = std::forward<V>(value);
+            return {this->at_index(i), false};
+        }
+        this->insertAt(i, std::forward<K>(key), std::forward<V>(value));
+        return {this->at_index(i), true};
+    }
+
+    Value& operator[](const Key& key) { return (*try_emplace(key).first).second; }
+
+    Value& at(const Key& key) {
+        auto it = this->find(key);
+        if (it == this->end()) throw std::out_of_range("flat_map::at");
+        return (*it).second;
+    }
+    const Value& at(const Key& key) const { return const_cast<flat_map*>(this)->at(key); }
+};
+
+// ============================================================
+// flat_multimap：允许重复 key，同 key 元素保持插入顺序
+// ============================================================
+template <typename Key, typename Value, typename Compare = std::less<Key>>
+class flat_multimap : public flat_map_base<Key, Value, Compare, true> {
+    using Base = flat_map_base<Key, Value, Compare, true>;
+
+public:
+    using Base::Base;
+    flat_multimap() = default;
+};
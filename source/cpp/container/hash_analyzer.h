@@ -0,0 +1,134 @@
+#pragma once
+
+// hash_analyzer.h: 用一组样本数据评估哈希函数的质量
+//
+// 报告三类指标：
+//   1. 冲突：完全相同的哈希值个数（任何哈希表都无法区分它们）
+//   2. 分布：把样本放进 2 的幂个桶（用低位选桶，负载因子 ~1）后的
+//      桶占用直方图、最长链、拉链法成功查找的平均比较次数，
+//      以及线性探测表（负载 ~0.5）的平均探测次数；并给出理想随机哈希的期望值
+//   3. 雪崩：翻转输入的任意 1 位，每个输出位应当以 50% 的概率翻转。
+//      偏差 = |P(翻转) - 0.5| × 2，0 为理想，1 表示该输出位完全不受该输入位影响。
+//      只对平凡可拷贝类型按字节翻转（类型里的填充字节会被计为"完全不影响"）
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
+struct HashReport {
+    size_t samples = 0;
+    size_t distinctHashes = 0;
+    size_t buckets = 0;
+    std::vector<size_t> occupancy;  // occupancy[k]：恰好装了 k 个元素的桶数，最后一格为 ">= k"
+    size_t longestChain = 0;
+    double avgChainProbe = 0;       // 拉链法成功查找平均比较次数
+    double idealChainProbe = 0;     // 理想随机哈希：1 + α/2
+    double avgLinearProbe = 0;      // 线性探测成功查找平均探测次数
+    double idealLinearProbe = 0;    // 理想随机哈希：(1 + 1/(1-α)) / 2
+    double avalancheBias = -1;      // 平均偏差；-1 表示未测（非平凡可拷贝类型）
+    double worstAvalancheBias = -1;
+};
+
+constexpr size_t kOccupancyBins = 8;
+constexpr size_t kLinearProbeSampleCap = 1 << 15;  // 坏哈希下线性探测模拟是 O(n²)，限制样本数
+constexpr size_t kAvalancheSampleCap = 256;
+
+template <typename T, typename Hash>
+HashReport analyze_hash(const std::vector<T>& samples, const Hash& hash = Hash{}) {
+    HashReport r;
+    r.samples = samples.size();
+    if (samples.empty()) return r;
+
+    std::vector<uint64_t> hashes;
+    hashes.reserve(samples.size());
+    for (const auto& s : samples) hashes.push_back(static_cast<uint64_t>(hash(s)));
+
+    r.distinctHashes = std::unordered_set<uint64_t>(hashes.begin(), hashes.end()).size();
+
+    // ---------- 拉链法：2 的幂个桶，低位选桶 ----------
+    r.buckets = std::bit_ceil(samples.size());
+    std::vector<uint32_t> chain(r.buckets, 0);
+    for (uint64_t h : hashes) chain[h & (r.buckets - 1)]++;
+
+    r.occupancy.assign(kOccupancyBins + 1, 0);
+    double probeSum = 0;
+    for (uint32_t len : chain) {
+        r.occupancy[std::min<size_t>(len, kOccupancyBins)]++;
+        r.longestChain = std::max<size_t>(r.longestChain, len);
+        probeSum += double(len) * (len + 1) / 2;  // 链上第 i 个元素需要比较 i 次
+    }
+    double alpha = double(samples.size()) / r.buckets;
+    r.avgChainProbe = probeSum / samples.size();
+    r.idealChainProbe = 1 + alpha / 2;
+
+    // ---------- 线性探测：容量 >= 2n ----------
+    size_t n = std::min(samples.size(), kLinearProbeSampleCap);
+    size_t cap = std::bit_ceil(2 * n);
+    std::vector<bool> used(cap, false);
+    double linearSum = 0;
+    for (size_t i = 0; i < n; ++i) {
+        size_t pos = hashes[i] & (cap - 1);
+        size_t probes = 1;
+        while (used[pos]) {
+            pos = (pos + 1) & (cap - 1);
+            ++probes;
+        }
+        used[pos] = true;
+        linearSum += double(probes);
+    }
+    double beta = double(n) / cap;
+    r.avgLinearProbe = linearSum / n;
+    r.idealLinearProbe = (1 + 1 / (1 - beta)) / 2;
+
+    // ---------- 雪崩 ----------
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        constexpr size_t inBits = sizeof(T) * 8;
+        constexpr size_t outBits = 64;
+        std::vector<uint32_t> flips(inBits * outBits, 0);
+        size_t m = std::min(samples.size(), kAvalancheSampleCap);
+        for (size_t i = 0; i < m; ++i) {
+            const T& s = samples[i * samples.size() / m];
+            uint64_t h0 = static_cast<uint64_t>(hash(s));
+            for (size_t b = 0; b < inBits; ++b) {
+                unsigned char bytes[sizeof(T)];
+                std::memcpy(bytes, &s, sizeof(T));
+                bytes[b / 8] ^= static_cast<unsigned char>(1u << (b % 8));
+                T flipped;
+                std::memcpy(&flipped, bytes, sizeof(T));
+                uint64_t diff = h0 ^ static_cast<uint64_t>(hash(flipped));
+                for (size_t o = 0; o < outBits; ++o) flips[b * outBits + o] += (diff >> o) & 1;
+            }
+        }
+        double sum = 0, worst = 0;
+        for (uint32_t f : flips) {
+            double bias = std::abs(double(f) / m - 0.5) * 2;
+            sum += bias;
+            worst = std::max(worst, bias);
+        }
+        r.avalancheBias = sum / flips.size();
+        r.worstAvalancheBias = worst;
+    }
+    return r;
+}
+
+inline void print_hash_report(const char* name, const HashReport& r) {
+    std::cout << "  [" << name << "]\n" << std::fixed << std::setprecision(2);
+    std::cout << "    样本 " << r.samples << "，不同哈希值 " << r.distinctHashes << "（完全冲突 "
+              << r.samples - r.distinctHashes << "）\n";
+    std::cout << "    " << r.buckets << " 个桶：最长链 " << r.longestChain << "，平均比较 "
+              << r.avgChainProbe << "（理想 " << r.idealChainProbe << "）；线性探测平均 "
+              << r.avgLinearProbe << "（理想 " << r.idealLinearProbe << "）\n";
+    std::cout << "    桶占用 [0,1,2,...," << kOccupancyBins << "+]:";
+    for (size_t c : r.occupancy) std::cout << " " << c;
+    std::cout << "\n";
+    if (r.avalancheBias >= 0)
+        std::cout << "    雪崩偏差：平均 " << r.avalancheBias << "，最差 " << r.worstAvalancheBias
+                  << "（0 理想，1 完全无影响）\n";
+}
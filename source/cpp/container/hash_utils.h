@@ -0,0 +1,166 @@
+#pragma once
+
+// hash_utils.h: 快速且混合充分的哈希组合工具
+//
+// std::hash<int> 在主流标准库里是恒等函数，自己用 XOR / 移位拼出来的组合哈希
+// 往往只是把坐标"摆"在不同的位上：只要哈希表用低位选桶（2 的幂个桶，MSVC 的
+// unordered_map 和大多数开放寻址表都是这样），有规律的 key 就会挤进少数几个桶。
+//
+// 这里的做法参考 wyhash：核心是 64×64→128 位乘法后把高低两半异或（"mum"），
+// 一次乘法就能让每个输入位影响到几乎所有输出位。
+//   hash_value(x)            单个值：整数/枚举/指针、字符串、pair/tuple，其它类型走 std::hash 再混合
+//   hash_values(a, b, ...)   多个值组合成一个哈希（推荐写法，比逐个 hash_combine 快）
+//   hash_combine(seed, v)    boost 风格的增量组合
+//   mixed_hash<T>            可以直接作为容器模板参数的哈希函数对象
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+// wyhash 使用的常数（奇数、位分布均匀）
+constexpr uint64_t kHashP0 = 0xa0761d6478bd642full;
+constexpr uint64_t kHashP1 = 0xe7037ed1a0b428dbull;
+constexpr uint64_t kHashP2 = 0x8ebc6af09c88c6e3ull;
+
+// 64×64 → 128 位乘法
+inline void hash_mul128(uint64_t a, uint64_t b, uint64_t& lo, uint64_t& hi) {
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = static_cast<__uint128_t>(a) * b;
+    lo = static_cast<uint64_t>(r);
+    hi = static_cast<uint64_t>(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    lo = _umul128(a, b, &hi);
+#else
+    // 可移植的 32 位分段乘法
+    uint64_t ha = a >> 32, la = uint32_t(a), hb = b >> 32, lb = uint32_t(b);
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32);
+    uint64_t c = t < rl;
+    lo = t + (rm1 << 32);
+    c += lo < t;
+    hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+// 128 位乘积的高 64 位 XOR 低 64 位
+inline uint64_t hash_mum(uint64_t a, uint64_t b) {
+    uint64_t lo, hi;
+    hash_mul128(a, b, lo, hi);
+    return lo ^ hi;
+}
+
+// 单个 64 位整数的混合（wyhash 处理 8 字节输入的做法）：
+// 乘数是常数时乘法近似线性，低位只受低位影响；两个乘数都随 x 变化才能充分雪崩
+inline uint64_t hash_mix(uint64_t x) {
+    uint64_t lo, hi;
+    hash_mul128(x ^ kHashP0, x ^ kHashP1, lo, hi);
+    return hash_mum(lo ^ kHashP0, hi ^ kHashP1);
+}
+
+// 任意字节串：每次吃 16 字节做一次 mum，尾部不足 8 字节的部分拼成整数
+inline uint64_t hash_bytes(const void* data, size_t len, uint64_t seed = 0) {
+    const auto* p = static_cast<const unsigned char*>(data);
+    auto read64 = [](const unsigned char* q) {
+        uint64_t v;
+        std::memcpy(&v, q, 8);
+        return v;
+    };
+    auto readSmall = [](const unsigned char* q, size_t k) {  // 1 <= k <= 8
+        uint64_t v = 0;
+        std::memcpy(&v, q, k);
+        return v;
+    };
+
+    seed ^= hash_mum(seed ^ kHashP0, kHashP1);
+    uint64_t a = 0, b = 0;
+    size_t i = len;
+    if (len <= 16) {
+        if (len > 8) {
+            a = read64(p);
+            b = readSmall(p + 8, len - 8);
+        } else if (len > 0) {
+            a = readSmall(p, len);
+        }
+    } else {
+        for (; i > 16; i -= 16, p += 16) seed = hash_mum(read64(p) ^ kHashP1, read64(p + 8) ^ seed);
+        a = read64(p + i - 16);  // 最后 16 字节（可能与上一段重叠）
+        b = read64(p + i - 8);
+    }
+    return hash_mum(kHashP1 ^ len, hash_mum(a ^ kHashP1, b ^ seed));
+}
+
+// ============================================================
+// hash_value：按类型分派
+// ============================================================
+template <typename T>
+size_t hash_value(const T& v);
+
+template <typename... Ts>
+size_t hash_values(const Ts&... vs);
+
+template <typename T>
+struct hash_is_string_like
+    : std::bool_constant<std::is_convertible_v<const T&, std::string_view> &&
+                         !std::is_same_v<std::decay_t<T>, std::nullptr_t>> {};
+
+template <typename T>
+struct hash_is_tuple_like : std::false_type {};
+template <typename A, typename B>
+struct hash_is_tuple_like<std::pair<A, B>> : std::true_type {};
+template <typename... Ts>
+struct hash_is_tuple_like<std::tuple<Ts...>> : std::true_type {};
+
+template <typename T>
+size_t hash_value(const T& v) {
+    if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+        return static_cast<size_t>(hash_mix(static_cast<uint64_t>(v)));
+    } else if constexpr (std::is_pointer_v<T>) {
+        return static_cast<size_t>(hash_mix(reinterpret_cast<uintptr_t>(v)));
+    } else if constexpr (hash_is_string_like<T>::value) {
+        std::string_view s(v);
+        return static_cast<size_t>(hash_bytes(s.data(), s.size()));
+    } else if constexpr (hash_is_tuple_like<T>::value) {
+        return std::apply([](const auto&... e) { return hash_values(e...); }, v);
+    } else {
+        // 用户类型：信任 std::hash<T> 的唯一性，再补一次混合
+        return static_cast<size_t>(hash_mix(static_cast<uint64_t>(std::hash<T>{}(v))));
+    }
+}
+
+// boost::hash_combine 的接口，但每一步都是一次完整的 mum 混合，
+// 而不是 seed ^= h + 0x9e3779b9 + (seed << 6) + (seed >> 2)
+template <typename T>
+void hash_combine(size_t& seed, const T& v) {
+    seed = static_cast<size_t>(hash_mum(seed ^ kHashP2, static_cast<uint64_t>(hash_value(v)) ^ kHashP1));
+}
+
+// 一次组合多个字段：整数字段不单独混合，每个字段只做一次 mum，最后统一混合一次
+// （比逐个 hash_combine 少一半乘法，分布和雪崩质量相同，见 level10 的分析）
+template <typename T>
+uint64_t hash_fold_arg(const T& v) {
+    if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) return static_cast<uint64_t>(v);
+    else return static_cast<uint64_t>(hash_value(v));
+}
+
+template <typename... Ts>
+size_t hash_values(const Ts&... vs) {
+    uint64_t seed = kHashP0 ^ sizeof...(Ts);
+    ((seed = hash_mum(seed ^ kHashP2, hash_fold_arg(vs) ^ kHashP1)), ...);
+    return static_cast<size_t>(hash_mum(seed ^ kHashP2, seed ^ kHashP0));
+}
+
+// 可直接作为 std::unordered_map / flat_hash_map 模板参数
+template <typename T>
+struct mixed_hash {
+    size_t operator()(const T& v) const { return hash_value(v); }
+};
@@ -0,0 +1,224 @@
+#pragma once
+
+// intrusive_list.h: 侵入式双向链表
+//
+// std::list<T> 为每个元素单独分配一个节点，元素被拷贝 / 移动进节点里。
+// 侵入式链表反过来：链表指针（hook）直接嵌在用户对象里，链表只是把已有的对象串起来：
+//   - push / insert / erase 都不分配内存，也不拷贝对象
+//   - 拿到对象引用就能 O(1) 定位并摘下（不需要像 list + unordered_map 那样保存迭代器）
+//   - 一个对象可以继承多个带不同 Tag 的 hook，同时挂在多条链表上
+// 代价：链表不拥有对象，对象的生命周期由调用方管理；对象被销毁前必须先从链表上摘下。
+//
+// 用法：
+//   struct Job : intrusive_list_hook<> { int id; };
+//   intrusive_list<Job> q;  q.push_back(job);  q.remove(job);
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+template <typename T, typename Tag>
+class intrusive_list;
+
+template <typename Tag = void>
+class intrusive_list_hook {
+public:
+    intrusive_list_hook() = default;
+    // 拷贝对象不拷贝链接关系：副本总是处于未链接状态
+    intrusive_list_hook(const intrusive_list_hook&) noexcept {}
+    intrusive_list_hook& operator=(const intrusive_list_hook&) noexcept { return *this; }
+    ~intrusive_list_hook() { assert(!is_linked() && "对象销毁前必须先从 intrusive_list 上摘下"); }
+
+    bool is_linked() const noexcept { return mNext != nullptr; }
+
+private:
+    template <typename, typename>
+    friend class intrusive_list;
+
+    intrusive_list_hook* mPrev = nullptr;
+    intrusive_list_hook* mNext = nullptr;
+};
+
+// 环形链表，表头是一个不属于任何对象的哨兵 hook
+template <typename T, typename Tag = void>
+class intrusive_list {
+    using Hook = intrusive_list_hook<Tag>;
+    static_assert(std::is_base_of_v<Hook, T>, "T 需要继承 intrusive_list_hook<Tag>");
+
+public:
+    template <bool Const>
+    class basic_iterator {
+        friend class intrusive_list;
+        using HookPtr = std::conditional_t<Const, const Hook*, Hook*>;
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const T*, T*>;
+        using reference = std::conditional_t<Const, const T&, T&>;
+
+        basic_iterator() = default;
+        template <bool C = Const, typename = std::enable_if_t<C>>
+        basic_iterator(const basic_iterator<false>& o) : mNode(o.mNode) {}
+
+        reference operator*() const { return static_cast<reference>(*mNode); }
+        pointer operator->() const { return &**this; }
+        basic_iterator& operator++() {
+            mNode = mNode->mNext;
+            return *this;
+        }
+        basic_iterator operator++(int) {
+            auto t = *this;
+            ++*this;
+            return t;
+        }
+        basic_iterator& operator--() {
+            mNode = mNode->mPrev;
+            return *this;
+        }
+        basic_iterator operator--(int) {
+            auto t = *this;
+            --*this;
+            return t;
+        }
+        friend bool operator==(const basic_iterator& a, const basic_iterator& b) {
+            return a.mNode == b.mNode;
+        }
+        friend bool operator!=(const basic_iterator& a, const basic_iterator& b) { return !(a == b); }
+
+    private:
+        template <bool>
+        friend class basic_iterator;
+        explicit basic_iterator(HookPtr n) : mNode(n) {}
+        HookPtr mNode = nullptr;
+    };
+
+    using value_type = T;
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    intrusive_list() noexcept { mHead.mPrev = mHead.mNext = &mHead; }
+    ~intrusive_list() {
+        clear();
+        mHead.mPrev = mHead.mNext = nullptr;  // 哨兵也视为"未链接"，通过 hook 析构里的检查
+    }
+    intrusive_list(const intrusive_list&) = delete;
+    intrusive_list& operator=(const intrusive_list&) = delete;
+    intrusive_list(intrusive_list&& o) noexcept : intrusive_list() { splice(end(), o); }
+    intrusive_list& operator=(intrusive_list&& o) noexcept {
+        if (this != &o) {
+            clear();
+            splice(end(), o);
+        }
+        return *this;
+    }
+
+    // ---------- 访问 ----------
+    bool empty() const noexcept { return mHead.mNext == &mHead; }
+    size_t size() const noexcept { return mSize; }
+    T& front() { return static_cast<T&>(*mHead.mNext); }
+    T& back() { return static_cast<T&>(*mHead.mPrev); }
+    const T& front() const { return static_cast<const T&>(*mHead.mNext); }
+    const T& back() const { return static_cast<const T&>(*mHead.mPrev); }
+
+    iterator begin() noexcept { return iterator(mHead.mNext); }
+    iterator end() noexcept { return iterator(&mHead); }
+    const_iterator begin() const noexcept { return const_iterator(mHead.mNext); }
+    const_iterator end() const noexcept { return const_iterator(&mHead); }
+
+    // 由对象引用得到迭代器：O(1)
+    iterator iterator_to(T& value) noexcept { return iterator(static_cast<Hook*>(&value)); }
+    const_iterator iterator_to(const T& value) const noexcept {
+        return const_iterator(static_cast<const Hook*>(&value));
+    }
+
+    // ---------- 修改（均为 O(1)，不分配内存） ----------
+    void push_front(T& value) noexcept { linkBefore(mHead.mNext, &value); }
+    void push_back(T& value) noexcept { linkBefore(&mHead, &value); }
+    void pop_front() noexcept { unlink(mHead.mNext); }
+    void pop_back() noexcept { unlink(mHead.mPrev); }
+
+    iterator insert(const_iterator pos, T& value) noexcept {
+        linkBefore(const_cast<Hook*>(pos.mNode), &value);
+        return iterator_to(value);
+    }
+
+    // 摘下 pos 指向的对象（对象本身不受影响），返回下一个位置
+    iterator erase(const_iterator pos) noexcept {
+        Hook* next = pos.mNode->mNext;
+        unlink(const_cast<Hook*>(pos.mNode));
+        return iterator(next);
+    }
+
+    // value 必须在本链表上
+    void remove(T& value) noexcept { unlink(&value); }
+
+    // 挪到表头：LRU 的"最近使用"操作
+    void move_to_front(T& value) noexcept {
+        Hook* h = &value;
+        if (mHead.mNext == h) return;
+        h->mPrev->mNext = h->mNext;
+        h->mNext->mPrev = h->mPrev;
+        h->mPrev = &mHead;
+        h->mNext = mHead.mNext;
+        mHead.mNext->mPrev = h;
+        mHead.mNext = h;
+    }
+
+    // 把 other 中 it 指向的对象移到 pos 之前
+    void splice(const_iterator pos, intrusive_list& other, const_iterator it) noexcept {
+        Hook* h = const_cast<Hook*>(it.mNode);
+        other.unlink(h);
+        linkBefore(const_cast<Hook*>(pos.mNode), static_cast<T*>(h));
+    }
+
+    // 把 other 整条链表移到 pos 之前
+    void splice(const_iterator pos, intrusive_list& other) noexcept {
+        if (other.empty()) return;
+        Hook* p = const_cast<Hook*>(pos.mNode);
+        Hook* first = other.mHead.mNext;
+        Hook* last = other.mHead.mPrev;
+        first->mPrev = p->mPrev;
+        p->mPrev->mNext = first;
+        last->mNext = p;
+        p->mPrev = last;
+        mSize += other.mSize;
+        other.mHead.mPrev = other.mHead.mNext = &other.mHead;
+        other.mSize = 0;
+    }
+
+    // 摘下全部对象（不销毁它们）
+    void clear() noexcept {
+        Hook* h = mHead.mNext;
+        while (h != &mHead) {
+            Hook* next = h->mNext;
+            h->mPrev = h->mNext = nullptr;
+            h = next;
+        }
+        mHead.mPrev = mHead.mNext = &mHead;
+        mSize = 0;
+    }
+
+private:
+    void linkBefore(Hook* pos, Hook* h) noexcept {
+        assert(!h->is_linked() && "对象已经在某条链表上");
+        h->mNext = pos;
+        h->mPrev = pos->mPrev;
+        pos->mPrev->mNext = h;
+        pos->mPrev = h;
+        ++mSize;
+    }
+
+    void unlink(Hook* h) noexcept {
+        h->mPrev->mNext = h->mNext;
+        h->mNext->mPrev = h->mPrev;
+        h->mPrev = h->mNext = nullptr;
+        --mSize;
+    }
+
+    Hook mHead;
+    size_t mSize = 0;
+};
@@ -16,6 +16,7 @@ void print(const std::vector<int>& v, const std::string& label = "") {
 
 // ============================================================
 // 1.1 构造方式
+//   拷贝构造要复制全部元素；O(1) 拷贝、修改只复制一条路径的持久化版本见 level25_persistent.cpp
 // ============================================================
 void demo_construct() {
     std::cout << "=== 1.1 构造方式 ===\n";
@@ -158,6 +159,7 @@ void demo_iterator() {
 
 // ============================================================
 // 1.6 容量管理
+//   扩容时逐个搬迁元素；按字节 memcpy / realloc 搬家的版本见 level24_relocatable_vector.cpp
 // ============================================================
 void demo_capacity() {
     std::cout << "\n=== 1.6 容量管理 ===\n";
@@ -195,6 +197,7 @@ void demo_capacity() {
 
 // ============================================================
 // 1.7 二维 vector
+//   每一行单独分配，行与行不相邻；大矩阵用一块连续内存更快，见 level16_matrix.cpp
 // ============================================================
 void demo_2d() {
     std::cout << "\n=== 1.7 二维 vector ===\n";
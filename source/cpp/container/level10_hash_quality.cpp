@@ -0,0 +1,221 @@
+// Level 10: 哈希函数质量 —— hash_combine 与哈希分析器
+// 涵盖：为什么 XOR / 移位拼出来的哈希会让哈希表退化、wyhash 风格的混合、
+//        hash_values / hash_combine / mixed_hash 用法、冲突链 / 桶占用 / 雪崩分析，
+//        以及坐标聚集的 Point 在各种哈希下的探测长度与查找速度
+//
+// 工具见 hash_utils.h（组合哈希）和 hash_analyzer.h（质量分析）
+
+#include "bench_utils.h"
+#include "hash_analyzer.h"
+#include "hash_utils.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <tuple>
+#include <unordered_set>
+#include <vector>
+
+// level6.cpp 里的 Point 和它的 std::hash 特化（XOR + 位旋转）
+struct Point {
+    int x, y;
+    bool operator==(const Point& o) const { return x == o.x && y == o.y; }
+};
+
+namespace std {
+template <>
+struct hash<Point> {
+    size_t operator()(const Point& p) const {
+        size_t hx = std::hash<int>{}(p.x);
+        size_t hy = std::hash<int>{}(p.y);
+        return hx ^ (hy << 32 | hy >> 32);  // XOR + 位旋转
+    }
+};
+}  // namespace std
+
+// 网上最常见的 boost 风格组合
+struct BoostPointHash {
+    size_t operator()(const Point& p) const {
+        size_t seed = std::hash<int>{}(p.x);
+        seed ^= std::hash<int>{}(p.y) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        return seed;
+    }
+};
+
+// 推荐写法：一行 hash_values
+struct MixedPointHash {
+    size_t operator()(const Point& p) const { return hash_values(p.x, p.y); }
+};
+
+// ============================================================
+// 10.1 hash_values / hash_combine / mixed_hash
+// ============================================================
+void demo_hash_combine() {
+    std::cout << "=== 10.1 hash_values / hash_combine ===\n";
+
+    // 多个字段一次组合（顺序有关：(1,2) 和 (2,1) 不同）
+    std::cout << std::hex;
+    std::cout << "hash_values(1, 2)      = " << hash_values(1, 2) << "\n";
+    std::cout << "hash_values(2, 1)      = " << hash_values(2, 1) << "\n";
+    std::cout << "hash_values(\"id\", 42)  = " << hash_values("id", 42) << "\n";
+
+    // 字符串、tuple、pair 都能直接哈希；std::string 和 const char* 结果一致
+    std::cout << "hash_value(\"abc\")      = " << hash_value("abc") << "\n";
+    std::cout << "hash_value(string abc) = " << hash_value(std::string("abc")) << "\n";
+    std::cout << "hash_value(tuple)      = " << hash_value(std::make_tuple(1, 2.5f, std::string("x")))
+              << "\n";
+
+    // 增量组合：适合循环里逐个加入字段
+    size_t seed = 0;
+    for (int v : {3, 1, 4, 1, 5}) hash_combine(seed, v);
+    std::cout << "hash_combine 3,1,4,1,5 = " << seed << std::dec << "\n";
+
+    // mixed_hash<T> 直接作为容器参数；自定义类型会先调 std::hash<T> 再做一次混合
+    std::unordered_set<Point, mixed_hash<Point>> ps = {{0, 0}, {1, 2}, {1, 2}};
+    std::cout << "unordered_set<Point, mixed_hash<Point>> size=" << ps.size() << "\n";
+}
+
+// ============================================================
+// 10.2 恒等哈希："分布好"不等于"质量好"
+//   连续整数用 std::hash<int>（恒等函数）放进 2 的幂个桶，恰好每桶一个，看起来完美；
+//   但雪崩偏差接近 1：高位输入完全不影响低位输出，
+//   一旦 key 变成"步长为 2 的幂"的序列，所有 key 就会落进同一批桶里
+// ============================================================
+void demo_identity_hash() {
+    std::cout << "\n=== 10.2 恒等哈希 vs 混合哈希 ===\n";
+
+    std::vector<int> sequential(1 << 14), strided(1 << 14);
+    for (int i = 0; i < (1 << 14); i++) {
+        sequential[i] = i;
+        strided[i] = i << 10;  // 例如按 1024 对齐的 ID、地址
+    }
+
+    std::cout << "连续整数 0..16383:\n";
+    print_hash_report("std::hash<int>", analyze_hash(sequential, std::hash<int>{}));
+    print_hash_report("mixed_hash<int>", analyze_hash(sequential, mixed_hash<int>{}));
+    std::cout << "步长 1024 的整数:\n";
+    print_hash_report("std::hash<int>", analyze_hash(strided, std::hash<int>{}));
+    print_hash_report("mixed_hash<int>", analyze_hash(strided, mixed_hash<int>{}));
+}
+
+// ============================================================
+// 10.3 坐标聚集的 Point
+//   模拟地图瓦片：64 个瓦片原点按 4096 对齐，每个瓦片内 16×16 个点
+//   XOR 旋转哈希的低 32 位几乎就是 x，而同一瓦片里 x 只有 16 种取值
+// ============================================================
+std::vector<Point> clustered_points(size_t tiles, int side) {
+    std::mt19937 rng(2024);
+    std::uniform_int_distribution<int> origin(-256, 255);
+    std::vector<Point> pts;
+    std::unordered_set<Point, MixedPointHash> seen;
+    while (seen.size() < tiles) {
+        Point o{origin(rng) * 4096, origin(rng) * 4096};
+        if (!seen.insert(o).second) continue;
+        for (int dx = 0; dx < side; dx++)
+            for (int dy = 0; dy < side; dy++) pts.push_back({o.x + dx, o.y + dy});
+    }
+    return pts;
+}
+
+void demo_point_analysis() {
+    std::cout << "\n=== 10.3 聚集坐标 Point 的哈希分析 ===\n";
+    auto pts = clustered_points(64, 16);
+    print_hash_report("std::hash<Point>（XOR + 旋转）", analyze_hash(pts, std::hash<Point>{}));
+    print_hash_report("boost 风格 hash_combine", analyze_hash(pts, BoostPointHash{}));
+    print_hash_report("hash_values(x, y)", analyze_hash(pts, MixedPointHash{}));
+}
+
+// ============================================================
+// 10.4 Benchmark：探测长度与查找速度
+//   linear probe：2 的幂容量、低位选桶的线性探测表（大多数开放寻址表的做法）
+//   unordered_set：libstdc++ 用质数个桶取模，对坏哈希不敏感；
+//                  MSVC 用 2 的幂个桶，结果接近 linear probe 一列
+// ============================================================
+template <typename Hash>
+class LinearProbePointSet {
+public:
+    explicit LinearProbePointSet(size_t n)
+        : mMask(std::bit_ceil(2 * n) - 1), mSlots(mMask + 1), mUsed(mMask + 1, 0) {}
+
+    void insert(const Point& p) {
+        size_t i = Hash{}(p) & mMask;
+        while (mUsed[i]) {
+            if (mSlots[i] == p) return;
+            i = (i + 1) & mMask;
+        }
+        mSlots[i] = p;
+        mUsed[i] = 1;
+    }
+
+    bool contains(const Point& p) const {
+        for (size_t i = Hash{}(p) & mMask; mUsed[i]; i = (i + 1) & mMask)
+            if (mSlots[i] == p) return true;
+        return false;
+    }
+
+private:
+    size_t mMask;
+    std::vector<Point> mSlots;
+    std::vector<uint8_t> mUsed;
+};
+
+template <typename Hash>
+void bench_point_hash(const char* name, const std::vector<Point>& pts,
+                      const std::vector<Point>& queries) {
+    HashReport r = analyze_hash(pts, Hash{});
+
+    LinearProbePointSet<Hash> lp(pts.size());
+    for (const auto& p : pts) lp.insert(p);
+    BenchTimer t;
+    size_t found = 0;
+    for (const auto& q : queries) found += lp.contains(q);
+    double lpNs = t.ns() / queries.size();
+    doNotOptimize(found);
+
+    std::unordered_set<Point, Hash> us(pts.begin(), pts.end());
+    t.reset();
+    found = 0;
+    for (const auto& q : queries) found += us.count(q);
+    double usNs = t.ns() / queries.size();
+    doNotOptimize(found);
+
+    t.reset();
+    size_t acc = 0;
+    for (const auto& q : queries) acc += Hash{}(q);
+    double hashNs = t.ns() / queries.size();
+    doNotOptimize(acc);
+
+    std::cout << "  " << std::left << std::setw(24) << name << std::right << std::fixed
+              << std::setprecision(2) << std::setw(10) << r.avgLinearProbe << std::setw(10)
+              << r.longestChain << std::setw(14) << lpNs << std::setw(16) << usNs << std::setw(10)
+              << hashNs << "\n";
+}
+
+void bench_point_lookup(size_t tiles) {
+    std::cout << "\n=== 10.4 Benchmark：聚集 Point 的探测长度与查找耗时 ===\n";
+    auto pts = clustered_points(tiles, 16);
+    std::vector<Point> queries = pts;
+    std::shuffle(queries.begin(), queries.end(), std::mt19937(1));
+    std::cout << "  " << pts.size() << " 个点（" << tiles << " 个 16×16 瓦片），单位 ns/查找\n";
+    std::cout << "  （avg probe / max chain 来自分析器；hash 列是单独计算哈希的耗时）\n";
+    std::cout << "  " << std::left << std::setw(24) << "hash" << std::right << std::setw(10)
+              << "avg probe" << std::setw(10) << "max chain" << std::setw(14) << "linear probe"
+              << std::setw(16) << "unordered_set" << std::setw(10) << "hash" << "\n";
+    bench_point_hash<std::hash<Point>>("std::hash (xor+rotate)", pts, queries);
+    bench_point_hash<BoostPointHash>("boost hash_combine", pts, queries);
+    bench_point_hash<MixedPointHash>("hash_values(x, y)", pts, queries);
+}
+
+int main(int argc, char** argv) {
+    // 瓦片数（每个 256 个点）；坏哈希下线性探测是 O(n²)，调大时注意耗时
+    size_t tiles = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 64;
+
+    demo_hash_combine();
+    demo_identity_hash();
+    demo_point_analysis();
+    bench_point_lookup(tiles);
+    return 0;
+}
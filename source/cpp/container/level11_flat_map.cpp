@@ -0,0 +1,205 @@
+// Level 11: flat_set / flat_map / flat_multimap —— 有序向量代替红黑树
+// 涵盖：key / value 分开存放的有序数组、lower_bound / upper_bound / equal_range、
+//        无序输入一次排序去重建表、批量插入用归并代替逐个插入，以及与 std::map 的对比
+//
+// 实现见 flat_map.h；对应的树结构容器见 level4.cpp / level5.cpp
+
+#include "bench_utils.h"
+#include "flat_map.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+// ============================================================
+// 11.1 flat_map 基础：接口与 std::map 一致
+// ============================================================
+void demo_flat_map_basic() {
+    std::cout << "=== 11.1 flat_map 基础 ===\n";
+
+    flat_map<std::string, int> scores;
+    scores["Alice"] = 90;
+    scores.insert({"Bob", 85});
+    scores.emplace("Diana", 88);
+    scores.try_emplace("Charlie", 92);
+    scores.insert_or_assign("Bob", 87);
+
+    try {
+        std::cout << "at(Alice)=" << scores.at("Alice") << "\n";
+        scores.at("Zoe");
+    } catch (const std::out_of_range& e) {
+        std::cout << "at() 异常: " << e.what() << "\n";
+    }
+
+    // 解引用得到 pair<const Key&, Value&>：按值绑定也能修改 value
+    for (auto [name, score] : scores) score += 1;
+    std::cout << "按 key 有序遍历（每人 +1）:\n";
+    for (const auto& [name, score] : scores)
+        std::cout << "  " << name << " -> " << score << "\n";
+
+    // key / value 是两个独立的连续数组
+    std::cout << "keys().size()=" << scores.keys().size()
+              << "  values().front()=" << scores.values().front() << "\n";
+}
+
+// ============================================================
+// 11.2 范围查询：二分只访问 key 数组，区间内是连续内存
+// ============================================================
+void demo_range_query() {
+    std::cout << "\n=== 11.2 范围查询 ===\n";
+
+    flat_set<int> s = {50, 10, 40, 20, 30, 20, 10};  // 无序 + 重复，构造时排序去重
+    std::cout << "flat_set:";
+    for (int v : s) std::cout << " " << v;
+    std::cout << "\n";
+
+    auto lo = s.lower_bound(15), hi = s.upper_bound(40);
+    std::cout << "[15, 40] 内的元素:";
+    for (auto it = lo; it != hi; ++it) std::cout << " " << *it;
+    std::cout << "（共 " << hi - lo << " 个，迭代器相减 O(1)）\n";
+
+    flat_map<int, std::string> m = {{3, "c"}, {1, "a"}, {2, "b"}, {5, "e"}};
+    auto [first, last] = m.equal_range(2);
+    std::cout << "equal_range(2): " << (first != last ? first->second : "无") << "\n";
+    if (auto it = m.lower_bound(4); it != m.end())
+        std::cout << "lower_bound(4) -> " << it->first << "=" << it->second << "\n";
+}
+
+// ============================================================
+// 11.3 批量构建与批量插入
+//   逐个 insert 每次都要挪动后半段数组：m 个元素 O(n·m)
+//   批量 insert(first, last)：新元素排序去重后与原序列归并，O(n + m log m)
+// ============================================================
+void demo_bulk_insert() {
+    std::cout << "\n=== 11.3 批量构建与批量插入 ===\n";
+
+    std::vector<std::pair<int, int>> raw = {{5, 50}, {1, 10}, {3, 30}, {1, 11}, {4, 40}};
+    flat_map<int, int> m(raw.begin(), raw.end());  // 重复 key 1 保留先出现的 10
+    std::cout << "从无序输入构建:";
+    for (const auto& [k, v] : m) std::cout << " " << k << ":" << v;
+    std::cout << "\n";
+
+    std::vector<std::pair<int, int>> batch = {{2, 20}, {6, 60}, {3, 99}};
+    m.insert(batch.begin(), batch.end());  // 已有的 3 不被覆盖
+    std::cout << "批量插入后:";
+    for (const auto& [k, v] : m) std::cout << " " << k << ":" << v;
+    std::cout << "\n";
+
+    // 已经有序的数据可以直接接管，不做任何排序
+    flat_map<int, int> sorted(sorted_unique, {1, 2, 3}, {10, 20, 30});
+    std::cout << "sorted_unique 构造 size=" << sorted.size() << "\n";
+
+    // 逐个插入 vs 批量插入
+    const int n = 20000;
+    auto keys = uniqueRandomKeys(n);
+    std::vector<std::pair<uint64_t, int>> items;
+    for (int i = 0; i < n; i++) items.push_back({keys[i], i});
+
+    BenchTimer t;
+    flat_map<uint64_t, int> one;
+    for (const auto& kv : items) one.insert(kv);
+    double oneMs = t.ms();
+    t.reset();
+    flat_map<uint64_t, int> bulk;
+    bulk.insert(items.begin(), items.end());
+    double bulkMs = t.ms();
+    std::cout << n << " 个随机 key：逐个插入 " << oneMs << " ms，批量插入 " << bulkMs << " ms\n";
+}
+
+// ============================================================
+// 11.4 flat_multimap：同 key 多值，保持插入顺序
+// ============================================================
+void demo_flat_multimap() {
+    std::cout << "\n=== 11.4 flat_multimap ===\n";
+
+    flat_multimap<std::string, std::string> courses = {
+        {"Alice", "Math"}, {"Bob", "Art"}, {"Alice", "Physics"}};
+    courses.emplace("Alice", "Chemistry");
+
+    std::cout << "Alice 的课程（count=" << courses.count("Alice") << "）:";
+    auto [first, last] = courses.equal_range("Alice");
+    for (auto it = first; it != last; ++it) std::cout << " " << it->second;
+    std::cout << "\n";
+
+    courses.erase("Alice");  // 删除该 key 的全部元素
+    std::cout << "erase(Alice) 后 size=" << courses.size() << "\n";
+}
+
+// ============================================================
+// 11.5 Benchmark：flat_map vs std::map
+//   build ：从无序 (key, value) 构建（map 逐个插入；flat_map 一次排序）
+//   lookup：随机顺序查找全部 key
+//   range ：随机起点 lower_bound 后向后扫描 100 个元素求和
+//   iterate：完整遍历一次
+// ============================================================
+void bench_flat_map_vs_map(size_t maxN) {
+    std::cout << "\n=== 11.5 Benchmark：flat_map vs std::map ===\n";
+    std::cout << "  build 为总耗时 ms，其余为 ns/op（range 为每次 100 元素扫描）\n";
+    std::cout << "  " << std::setw(10) << "n" << std::setw(10) << "" << std::setw(12) << "build"
+              << std::setw(12) << "lookup" << std::setw(12) << "range" << std::setw(14)
+              << "iterate/elem" << "\n";
+
+    constexpr size_t kScan = 100;
+    for (size_t n : decadeSizes(3, maxN)) {
+        auto keys = uniqueRandomKeys(n, n);
+        std::vector<std::pair<uint64_t, uint64_t>> items;
+        items.reserve(n);
+        for (uint64_t k : keys) items.push_back({k, k});
+        std::vector<uint64_t> queries = keys;
+        std::shuffle(queries.begin(), queries.end(), std::mt19937_64(3));
+        size_t rangeQueries = std::min<size_t>(n, 100000);
+
+        auto report = [&](const char* name, double buildMs, auto& m) {
+            BenchTimer t;
+            uint64_t sum = 0;
+            for (uint64_t q : queries) sum += m.find(q)->second;
+            double lookupNs = t.ns() / n;
+
+            t.reset();
+            for (size_t i = 0; i < rangeQueries; i++) {
+                auto it = m.lower_bound(queries[i]);
+                for (size_t j = 0; j < kScan && it != m.end(); j++, ++it) sum += it->second;
+            }
+            double rangeNs = t.ns() / rangeQueries;
+
+            t.reset();
+            for (const auto& [k, v] : m) sum += v;
+            double iterNs = t.ns() / n;
+            doNotOptimize(sum);
+
+            std::cout << "  " << std::setw(10) << n << std::setw(10) << name << std::fixed
+                      << std::setprecision(2) << std::setw(12) << buildMs << std::setw(12)
+                      << lookupNs << std::setw(12) << rangeNs << std::setw(14) << iterNs << "\n";
+        };
+
+        {
+            BenchTimer t;
+            std::map<uint64_t, uint64_t> m;
+            for (const auto& kv : items) m.insert(kv);
+            double buildMs = t.ms();
+            report("std::map", buildMs, m);
+        }
+        {
+            BenchTimer t;
+            flat_map<uint64_t, uint64_t> m(items.begin(), items.end());
+            double buildMs = t.ms();
+            report("flat_map", buildMs, m);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    // 默认测到 10^6；./container_level11_flat_map 10000000 测到 10^7
+    size_t maxN = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    demo_flat_map_basic();
+    demo_range_query();
+    demo_bulk_insert();
+    demo_flat_multimap();
+    bench_flat_map_vs_map(maxN);
+    return 0;
+}
@@ -0,0 +1,251 @@
+// Level 12: btree_map —— cache 友好的 B+ 树
+// 涵盖：多 key 宽节点降低树高、SIMD 节点内查找、叶子链表上的范围扫描、
+//        自底向上 bulk_load、删除时的借位与合并，以及与 std::map / 有序 vector 的对比
+//
+// 实现见 btree_map.h；红黑树见 level4.cpp，有序向量见 level11_flat_map.cpp
+
+#include "bench_utils.h"
+#include "btree_map.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+// ============================================================
+// 12.1 btree_map 基础：接口与 std::map 相近
+// ============================================================
+void demo_btree_basic() {
+    std::cout << "=== 12.1 btree_map 基础 ===\n";
+
+    btree_map<std::string, int> scores;
+    scores["Alice"] = 90;
+    scores.insert("Bob", 85);
+    scores.insert("Charlie", 92);
+    scores.insert_or_assign("Bob", 87);
+    auto [it, inserted] = scores.insert("Alice", 0);  // 已存在，不覆盖
+    std::cout << "insert(Alice) inserted=" << inserted << " value=" << it->second << "\n";
+
+    try {
+        scores.at("Zoe");
+    } catch (const std::out_of_range& e) {
+        std::cout << "at() 异常: " << e.what() << "\n";
+    }
+    for (const auto& [name, score] : scores) std::cout << "  " << name << " -> " << score << "\n";
+    scores.erase("Charlie");
+    std::cout << "erase(Charlie) 后 size=" << scores.size()
+              << " contains(Charlie)=" << scores.contains("Charlie") << "\n";
+}
+
+// ============================================================
+// 12.2 节点与树高
+//   每个节点的 key 数组占 256 字节（4 条 cache line）：uint32 key 一个节点 64 个，
+//   100 万个 key 只需 4 层；std::map 的红黑树约 20~40 层，每层一次 cache miss
+// ============================================================
+void demo_btree_shape() {
+    std::cout << "\n=== 12.2 节点与树高 ===\n";
+
+    btree_map<uint32_t, uint32_t> t;
+    std::cout << "uint32 key 每节点 " << t.leaf_capacity() << " 个；uint64 key 每节点 "
+              << btree_map<uint64_t, uint64_t>::leaf_capacity() << " 个\n";
+    std::cout << "SIMD 节点内查找：uint32 " << (btree_simd_key<uint32_t> ? "开" : "关") << "，uint64 "
+              << (btree_simd_key<uint64_t> ? "开" : "关（需 -msse4.2 或 -mavx2）") << "\n";
+
+    auto keys = uniqueRandomKeys(1000000);
+    for (uint64_t k : keys) t.insert(uint32_t(k), 0);
+    std::cout << "随机插入 " << t.size() << " 个 key 后树高 " << t.height()
+              << "，validate=" << t.validate() << "\n";
+
+    // 删掉大部分元素，节点通过借位 / 合并保持半满，树高随之下降
+    size_t erased = 0;
+    for (size_t i = 0; i < keys.size(); i++)
+        if (i % 100 != 0) erased += t.erase(uint32_t(keys[i]));
+    std::cout << "删除 " << erased << " 个后 size=" << t.size() << " 树高 " << t.height()
+              << "，validate=" << t.validate() << "\n";
+}
+
+// ============================================================
+// 12.3 范围扫描：lower_bound 定位到叶子，然后沿叶子链表顺序读
+// ============================================================
+void demo_range_scan() {
+    std::cout << "\n=== 12.3 范围扫描 ===\n";
+
+    btree_map<int, int> t;
+    for (int i = 0; i < 1000; i += 7) t.insert(i, i * i);
+    std::cout << "[100, 150) 内的元素:";
+    for (auto it = t.lower_bound(100); it != t.end() && it->first < 150; ++it)
+        std::cout << " " << it->first;
+    std::cout << "\n";
+    auto it = t.lower_bound(995);
+    std::cout << "lower_bound(995) == end(): " << (it == t.end()) << "\n";
+}
+
+// ============================================================
+// 12.4 bulk_load：有序输入直接填叶子、逐层建索引
+//   逐个插入每次都要从根走到叶子，叶子只有半满到满；bulk_load 一遍 O(n)，叶子按 fill 填满
+// ============================================================
+void demo_bulk_load() {
+    std::cout << "\n=== 12.4 bulk_load ===\n";
+
+    const size_t n = 1000000;
+    std::vector<std::pair<uint32_t, uint32_t>> items;
+    items.reserve(n);
+    for (size_t i = 0; i < n; i++) items.push_back({uint32_t(i * 3), uint32_t(i)});
+
+    BenchTimer t;
+    btree_map<uint32_t, uint32_t> one;
+    for (const auto& [k, v] : items) one.insert(k, v);
+    double oneMs = t.ms();
+
+    t.reset();
+    btree_map<uint32_t, uint32_t> bulk;
+    bulk.bulk_load(items.begin(), items.end());
+    double bulkMs = t.ms();
+
+    std::cout << n << " 个有序 key：逐个插入 " << oneMs << " ms（树高 " << one.height()
+              << "），bulk_load " << bulkMs << " ms（树高 " << bulk.height() << "）\n";
+
+    // 之后还要插入的话留些空位，避免一开始就连续分裂
+    btree_map<uint32_t, uint32_t> sparse;
+    sparse.bulk_load(items.begin(), items.end(), 0.7);
+    std::cout << "fill=0.7 时树高 " << sparse.height() << "，validate=" << sparse.validate() << "\n";
+}
+
+// ============================================================
+// 12.5 Benchmark：btree_map vs std::map vs 有序 vector
+//   key 为不重复的随机 uint32（走 SSE2 节点内查找），value 为 uint32
+//   build ：随机顺序逐个插入（vector 为一次排序，btree 另列 bulk_load）
+//   lookup：随机顺序查找全部 key
+//   insert/erase：插入再删除 kUpdates 个新 key（有序 vector 每次挪动 O(n)，只测 1000 次）
+//   range ：随机起点 lower_bound 后扫描 100 个元素
+// ============================================================
+struct SortedVectorMap {
+    std::vector<std::pair<uint32_t, uint32_t>> data;
+
+    auto lower_bound(uint32_t k) {
+        return std::lower_bound(data.begin(), data.end(), k,
+                                [](const auto& e, uint32_t x) { return e.first < x; });
+    }
+    auto find(uint32_t k) { return lower_bound(k); }  // 测试里只查存在的 key
+    auto end() { return data.end(); }
+    void insert(uint32_t k, uint32_t v) { data.insert(lower_bound(k), {k, v}); }
+    void erase(uint32_t k) { data.erase(lower_bound(k)); }
+};
+
+void bench_btree(size_t maxN) {
+    std::cout << "\n=== 12.5 Benchmark：btree_map vs std::map vs 有序 vector ===\n";
+    std::cout << "  build 为总耗时 ms，其余为 ns/op（range 为每次 100 元素扫描）\n";
+    std::cout << "  " << std::setw(11) << "n" << std::setw(12) << "" << std::setw(11) << "build"
+              << std::setw(10) << "lookup" << std::setw(10) << "insert" << std::setw(10) << "erase"
+              << std::setw(10) << "range" << "\n";
+
+    constexpr size_t kScan = 100;
+    constexpr size_t kMapLimit = 20000000;  // std::map 每元素约 48 字节，更大时跳过
+    for (size_t n : decadeSizes(5, maxN)) {
+        // 随机 uint64 截成 uint32 后去重，多生成的部分留作"新 key"测插入
+        size_t updates = std::min<size_t>(n / 10, 100000);
+        std::vector<uint32_t> keys;
+        {
+            auto raw = uniqueRandomKeys(n + updates + n / 50 + 1000, n);
+            keys.reserve(raw.size());
+            for (uint64_t k : raw) keys.push_back(uint32_t(k));
+            std::sort(keys.begin(), keys.end());
+            keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+            std::shuffle(keys.begin(), keys.end(), std::mt19937_64(n));
+        }
+        std::vector<uint32_t> fresh(keys.begin() + n, keys.begin() + n + updates);
+        keys.resize(n);
+        std::vector<uint32_t> queries = keys;
+        std::shuffle(queries.begin(), queries.end(), std::mt19937_64(3));
+        size_t rangeQueries = std::min<size_t>(n, 100000);
+
+        auto report = [&](const char* name, double buildMs, auto& m, size_t updateOps) {
+            BenchTimer t;
+            uint64_t sum = 0;
+            for (uint32_t q : queries) sum += m.find(q)->second;
+            double lookupNs = t.ns() / n;
+
+            t.reset();
+            for (size_t i = 0; i < updateOps; i++) m.insert(fresh[i], 1);
+            double insertNs = t.ns() / updateOps;
+            t.reset();
+            for (size_t i = 0; i < updateOps; i++) m.erase(fresh[i]);
+            double eraseNs = t.ns() / updateOps;
+
+            t.reset();
+            for (size_t i = 0; i < rangeQueries; i++) {
+                auto it = m.lower_bound(queries[i]);
+                for (size_t j = 0; j < kScan && it != m.end(); j++, ++it) sum += it->second;
+            }
+            double rangeNs = t.ns() / rangeQueries;
+            doNotOptimize(sum);
+
+            std::cout << "  " << std::setw(11) << n << std::setw(12) << name << std::fixed
+                      << std::setprecision(2) << std::setw(11) << buildMs << std::setw(10) << lookupNs
+                      << std::setw(10) << insertNs << std::setw(10) << eraseNs << std::setw(10)
+                      << rangeNs << "\n";
+        };
+
+        if (n <= kMapLimit) {
+            BenchTimer t;
+            std::map<uint32_t, uint32_t> m;
+            for (uint32_t k : keys) m.emplace(k, k);
+            double buildMs = t.ms();
+            struct MapAdapter {
+                std::map<uint32_t, uint32_t>& m;
+                auto find(uint32_t k) { return m.find(k); }
+                auto lower_bound(uint32_t k) { return m.lower_bound(k); }
+                auto end() { return m.end(); }
+                void insert(uint32_t k, uint32_t v) { m.emplace(k, v); }
+                void erase(uint32_t k) { m.erase(k); }
+            } adapter{m};
+            report("std::map", buildMs, adapter, updates);
+        } else {
+            std::cout << "  " << std::setw(11) << n << std::setw(12) << "std::map"
+                      << "  （跳过：约 " << n * 48 / 1000000 << " MB）\n";
+        }
+        {
+            BenchTimer t;
+            btree_map<uint32_t, uint32_t> m;
+            for (uint32_t k : keys) m.insert(k, k);
+            double buildMs = t.ms();
+            report("btree", buildMs, m, updates);
+        }
+        {
+            // bulk_load 的输入需要有序，排序时间计入
+            BenchTimer t;
+            std::vector<std::pair<uint32_t, uint32_t>> sorted;
+            sorted.reserve(n);
+            for (uint32_t k : keys) sorted.push_back({k, k});
+            std::sort(sorted.begin(), sorted.end());
+            btree_map<uint32_t, uint32_t> m;
+            m.bulk_load(sorted.begin(), sorted.end(), 0.9);
+            double buildMs = t.ms();
+            report("btree bulk", buildMs, m, updates);
+        }
+        {
+            BenchTimer t;
+            SortedVectorMap m;
+            m.data.reserve(n + updates);
+            for (uint32_t k : keys) m.data.push_back({k, k});
+            std::sort(m.data.begin(), m.data.end());
+            double buildMs = t.ms();
+            report("sorted vec", buildMs, m, std::min<size_t>(updates, 1000));
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    // 默认测 10^5、10^6；./container_level12_btree_map 100000000 测到 10^8（需要数 GB 内存）
+    size_t maxN = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    demo_btree_basic();
+    demo_btree_shape();
+    demo_range_scan();
+    demo_bulk_load();
+    bench_btree(maxN);
+    return 0;
+}
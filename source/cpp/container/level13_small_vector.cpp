@@ -0,0 +1,199 @@
+// Level 13: small_vector —— 内联存储的小数组
+// 涵盖：N 个元素以内零堆分配、超出后溢出到堆、与 std::vector 相同的接口和迭代器失效规则、
+//        移动内联 small_vector 的代价，以及典型长度下分配次数与构造/追加/析构吞吐量对比
+//
+// 实现见 small_vector.h；std::vector 本身见 level1.cpp
+
+#define BENCH_COUNT_ALLOCATIONS
+#include "bench_utils.h"
+#include "small_vector.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+template <typename Vec>
+void print(const Vec& v, const std::string& label) {
+    std::cout << label << ":";
+    for (const auto& x : v) std::cout << " " << x;
+    std::cout << "  (size=" << v.size() << " cap=" << v.capacity() << ")\n";
+}
+
+// ============================================================
+// 13.1 与 std::vector 相同的接口
+// ============================================================
+void demo_small_vector_basic() {
+    std::cout << "=== 13.1 small_vector 基础 ===\n";
+
+    small_vector<int, 8> v = {1, 2, 3, 4, 5};
+    v.push_back(6);
+    v.emplace_back(7);
+    v.insert(v.begin() + 1, 10);
+    v.erase(v.begin() + 3);
+    print(v, "增删后");
+
+    v.insert(v.end(), {20, 21});
+    v.erase(v.begin(), v.begin() + 2);
+    v.resize(4);
+    print(v, "区间插删 + resize(4)");
+
+    std::cout << "front=" << v.front() << " back=" << v.back() << " at(1)=" << v.at(1) << "\n";
+    try {
+        v.at(100);
+    } catch (const std::out_of_range& e) {
+        std::cout << "at() 异常: " << e.what() << "\n";
+    }
+
+    // 反向迭代、算法、比较运算都照常工作
+    std::cout << "反向:";
+    for (auto it = v.rbegin(); it != v.rend(); ++it) std::cout << " " << *it;
+    small_vector<int, 8> copy = v;
+    std::cout << "\ncopy == v: " << (copy == v) << "\n";
+}
+
+// ============================================================
+// 13.2 内联存储与溢出到堆
+//   元素不超过 N 个时数据就在对象内部；第 N+1 个元素触发一次"扩容"，搬到堆上
+// ============================================================
+void demo_inline_and_spill() {
+    std::cout << "\n=== 13.2 内联存储与溢出 ===\n";
+
+    std::cout << "sizeof(std::vector<int>)=" << sizeof(std::vector<int>)
+              << "  sizeof(small_vector<int, 4>)=" << sizeof(small_vector<int, 4>)
+              << "  sizeof(small_vector<int, 16>)=" << sizeof(small_vector<int, 16>) << "\n";
+
+    small_vector<int, 4> v;
+    auto before = allocSnapshot();
+    for (int i = 0; i < 6; i++) {
+        v.push_back(i);
+        std::cout << "  push_back(" << i << ") size=" << v.size() << " cap=" << v.capacity()
+                  << (v.is_inline() ? "  内联" : "  堆") << "\n";
+    }
+    std::cout << "6 次 push_back 共分配 " << (allocSnapshot() - before).count << " 次\n";
+
+    // 元素减少后不会自动搬回，shrink_to_fit 才会
+    v.resize(3);
+    v.shrink_to_fit();
+    std::cout << "resize(3) + shrink_to_fit 后 cap=" << v.capacity() << " is_inline=" << v.is_inline()
+              << "\n";
+}
+
+// ============================================================
+// 13.3 迭代器失效
+//   与 std::vector 相同：不扩容的追加不使已有迭代器失效；扩容（包括溢出到堆）使全部失效
+//   不同之处：移动内联的 small_vector 是逐个移动元素，指针不会转移到新对象
+// ============================================================
+void demo_invalidation() {
+    std::cout << "\n=== 13.3 迭代器失效 ===\n";
+
+    small_vector<int, 4> v = {1, 2, 3};
+    const int* p = v.data();
+    v.push_back(4);
+    std::cout << "未超过 N 的 push_back 后 data 不变: " << (p == v.data()) << "\n";
+    v.push_back(5);
+    std::cout << "溢出到堆后 data 改变（旧迭代器全部失效）: " << (p != v.data()) << "\n";
+
+    // 堆上的 small_vector 移动是 O(1) 的指针接管，与 std::vector 一样
+    const int* heap = v.data();
+    small_vector<int, 4> moved = std::move(v);
+    std::cout << "移动堆上的 small_vector，data 随之转移: " << (moved.data() == heap) << "\n";
+
+    // 内联的 small_vector 移动要逐个移动元素
+    small_vector<int, 4> small = {7, 8};
+    const int* inl = small.data();
+    small_vector<int, 4> moved2 = std::move(small);
+    std::cout << "移动内联的 small_vector，data 不会转移: " << (moved2.data() != inl) << "\n";
+}
+
+// ============================================================
+// 13.4 典型用法：map 的 value 是短列表
+//   level5.cpp 里"每个学生的课程"这类数据通常只有几项，
+//   用 std::vector 每个 key 至少一次堆分配，用 small_vector 则为零
+// ============================================================
+void demo_map_of_small_vectors() {
+    std::cout << "\n=== 13.4 map<string, small_vector> ===\n";
+
+    const char* names[] = {"Alice", "Bob", "Charlie", "Diana"};
+    const char* courses[] = {"Math", "Art", "Physics", "History", "Chemistry"};
+
+    auto build = [&](auto& m) {
+        for (int i = 0; i < 1000; i++) {
+            std::string key = std::string(names[i % 4]) + std::to_string(i / 4);
+            for (int c = 0; c <= i % 4; c++) m[key].push_back(courses[c]);
+        }
+    };
+
+    auto before = allocSnapshot();
+    {
+        std::map<std::string, std::vector<std::string>> m;
+        build(m);
+    }
+    size_t vecAllocs = (allocSnapshot() - before).count;
+    before = allocSnapshot();
+    {
+        std::map<std::string, small_vector<std::string, 4>> m;
+        build(m);
+    }
+    size_t svAllocs = (allocSnapshot() - before).count;
+    std::cout << "1000 个 key、每个 1~4 门课：std::vector " << vecAllocs << " 次分配，small_vector<.., 4> "
+              << svAllocs << " 次分配（只剩 map 节点本身）\n";
+}
+
+// ============================================================
+// 13.5 Benchmark：构造 + push_back k 个元素 + 遍历 + 析构
+//   vector         ：不预留，按 1,2,4,8... 扩容
+//   vector+reserve ：先 reserve(k)，每次至少 1 次分配
+//   small_vector<16>：k <= 16 时零分配；k > 16 时溢出，比 vector 多一次搬迁
+// ============================================================
+template <typename Vec, typename Make>
+void bench_one(const char* name, size_t k, size_t iters, bool reserve, Make make) {
+    auto before = allocSnapshot();
+    BenchTimer t;
+    size_t acc = 0;
+    for (size_t it = 0; it < iters; it++) {
+        Vec v;
+        if (reserve) v.reserve(k);
+        for (size_t i = 0; i < k; i++) v.push_back(make(i));
+        for (const auto& x : v) acc += sizeof(x);
+        doNotOptimize(v.data());
+    }
+    double ns = t.ns() / iters;
+    doNotOptimize(acc);
+    double allocs = double((allocSnapshot() - before).count) / iters;
+    std::cout << "  " << std::setw(6) << k << std::setw(18) << name << std::fixed << std::setprecision(1)
+              << std::setw(12) << ns << std::setw(12) << std::setprecision(2) << allocs << "\n";
+}
+
+template <typename T, typename Make>
+void bench_element(const char* typeName, size_t iters, Make make) {
+    std::cout << "  元素类型 " << typeName << "（" << iters << " 轮；ns/轮，allocs/轮）\n";
+    std::cout << "  " << std::setw(6) << "k" << std::setw(18) << "container" << std::setw(12) << "ns"
+              << std::setw(12) << "allocs" << "\n";
+    for (size_t k : {4, 8, 16, 32, 64}) {
+        bench_one<std::vector<T>>("vector", k, iters, false, make);
+        bench_one<std::vector<T>>("vector+reserve", k, iters, true, make);
+        bench_one<small_vector<T, 16>>("small_vector<16>", k, iters, false, make);
+    }
+}
+
+void bench_small_vector(size_t iters) {
+    std::cout << "\n=== 13.5 Benchmark：small_vector vs std::vector ===\n";
+    bench_element<int>("int", iters, [](size_t i) { return int(i); });
+    // 短字符串走 SSO，本身不分配，测的只是容器的分配
+    bench_element<std::string>("std::string（短）", iters / 4,
+                               [](size_t i) { return std::string(1 + i % 8, 'x'); });
+}
+
+int main(int argc, char** argv) {
+    // 每种长度的轮数（string 为其 1/4）；./container_level13_small_vector 10000000 测得更稳
+    size_t iters = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    demo_small_vector_basic();
+    demo_inline_and_spill();
+    demo_invalidation();
+    demo_map_of_small_vectors();
+    bench_small_vector(iters);
+    return 0;
+}
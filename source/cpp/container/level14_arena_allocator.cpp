@@ -0,0 +1,248 @@
+// Level 14: Arena / NodePool 分配器 —— 给节点式容器换内存来源
+// 涵盖：bump-pointer 分配与整体 reset、分级空闲链表节点池、std::pmr 容器、
+//        经典 Allocator 模板参数、按请求回收的 ArenaScope、线程局部 arena，
+//        以及每轮构建 + 销毁 10 万节点 list / map 的分配器对比
+//
+// 实现见 arena_allocator.h；list / set / map 本身见 level2.cpp / level4.cpp / level5.cpp
+
+#define BENCH_COUNT_ALLOCATIONS
+#include "arena_allocator.h"
+#include "bench_utils.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <list>
+#include <map>
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ============================================================
+// 14.1 Arena：分配只是移动指针，reset 后复用同一批 chunk
+// ============================================================
+void demo_arena_basic() {
+    std::cout << "=== 14.1 Arena 基础 ===\n";
+
+    Arena arena(4096);
+    for (int round = 1; round <= 3; round++) {
+        auto before = allocSnapshot();
+        {
+            std::pmr::list<int> l(&arena);
+            for (int i = 0; i < 10000; i++) l.push_back(i);
+        }
+        std::cout << "第 " << round << " 轮：used=" << arena.bytes_used()
+                  << " reserved=" << arena.bytes_reserved()
+                  << " 全局 new 次数=" << (allocSnapshot() - before).count << "\n";
+        arena.reset();  // 第 2 轮起不再向系统申请内存
+    }
+}
+
+// ============================================================
+// 14.2 std::pmr 容器：同一个 Arena 供多个容器、嵌套容器共享
+//   pmr::map<int, pmr::string> 里的 string 也会自动使用同一个资源
+// ============================================================
+void demo_pmr_containers() {
+    std::cout << "\n=== 14.2 std::pmr 容器 ===\n";
+
+    Arena arena;
+    auto before = allocSnapshot();
+    {
+        std::pmr::map<int, std::pmr::string> m(&arena);
+        // 超出 SSO 的长字符串；就地 assign 才会用 map 传下来的 arena（赋值临时 pmr::string 会用默认资源）
+        for (int i = 0; i < 100; i++) m[i].assign(40, char('a' + i % 26));
+        std::pmr::vector<int> v({1, 2, 3}, &arena);
+        std::cout << "m[3]=" << m[3].substr(0, 5) << "...  string 的分配器资源是同一个 arena: "
+                  << (m[3].get_allocator().resource() == &arena) << "\n";
+    }
+    std::cout << "100 个节点 + 100 个长字符串：全局 new " << (allocSnapshot() - before).count
+              << " 次（只有 chunk）\n";
+
+    // NodePool：释放的节点立即复用，适合边插边删
+    NodePool pool;
+    std::pmr::map<int, int> churn(&pool);
+    for (int i = 0; i < 100000; i++) {
+        churn[i] = i;
+        if (i >= 100) churn.erase(i - 100);  // 始终只有 100 个活跃节点
+    }
+    std::cout << "NodePool 上 10 万次插入 + 删除，活跃 100 个节点：reserved=" << pool.bytes_reserved()
+              << " 字节\n";
+}
+
+// ============================================================
+// 14.3 经典 Allocator 模板参数
+//   不想改成 pmr 类型时，arena_allocator<T> 直接作为 std::list / std::map 的第二 / 四个参数；
+//   Arena 是 final 类，调用会被去虚化
+// ============================================================
+void demo_classic_allocator() {
+    std::cout << "\n=== 14.3 经典 Allocator 参数 ===\n";
+
+    Arena arena;
+    using Alloc = arena_allocator<std::pair<const std::string, int>>;
+    std::map<std::string, int, std::less<>, Alloc> scores{Alloc(arena)};
+    scores["Alice"] = 90;
+    scores["Bob"] = 85;
+    for (const auto& [name, score] : scores) std::cout << "  " << name << " -> " << score << "\n";
+
+    // 节点池版本
+    NodePool pool;
+    std::list<int, pool_allocator<int>> l{pool_allocator<int>(pool)};
+    for (int i = 0; i < 5; i++) l.push_back(i * i);
+    l.remove(4);
+    std::cout << "pool_allocator list:";
+    for (int x : l) std::cout << " " << x;
+    std::cout << "\n";
+}
+
+// ============================================================
+// 14.4 按请求回收 + 线程局部 arena
+//   每个线程用 thread_arena()，默认构造的 arena_allocator 自动使用它；
+//   ArenaScope 在请求结束时 reset，请求里的所有节点一次性回收，线程之间不需要任何锁
+// ============================================================
+std::map<std::string, int> handle_request(int id) {
+    ArenaScope<> scope;  // 容器在 scope 之后声明，先于 scope 析构
+    std::map<int, std::string, std::less<>, arena_allocator<std::pair<const int, std::string>>> tmp;
+    std::list<int, arena_allocator<int>> work;
+    for (int i = 0; i < 1000; i++) {
+        work.push_back(i * id);
+        tmp[i % 97] = "req";
+    }
+    // 结果要活过请求，用普通分配器返回
+    return {{"id", id}, {"keys", int(tmp.size())}, {"items", int(work.size())}};
+}
+
+void demo_thread_local_arena() {
+    std::cout << "\n=== 14.4 按请求 reset + 线程局部 arena ===\n";
+
+    std::vector<std::thread> workers;
+    std::vector<int> keys(4);
+    std::vector<size_t> reserved(4);
+    for (int t = 0; t < 4; t++) {
+        workers.emplace_back([t, &keys, &reserved] {
+            for (int r = 0; r < 100; r++) keys[t] = handle_request(t * 100 + r)["keys"];
+            reserved[t] = thread_arena().bytes_reserved();
+        });
+    }
+    for (auto& w : workers) w.join();
+    for (int t = 0; t < 4; t++)
+        std::cout << "  线程 " << t << "：处理 100 个请求，keys=" << keys[t]
+                  << "，该线程 arena 只保留 " << reserved[t] << " 字节\n";
+}
+
+// ============================================================
+// 14.5 Benchmark：每轮构建并销毁 10 万节点的 list<int> / map<int, int>
+//   std::allocator      ：每节点一次 new / delete
+//   pmr::monotonic      ：标准库的 monotonic_buffer_resource，每轮 release
+//   pmr::unsync_pool    ：标准库的 unsynchronized_pool_resource
+//   Arena (pmr)         ：std::pmr 容器 + Arena，每轮 reset
+//   arena_allocator     ：经典 Allocator 参数 + Arena（去虚化），每轮 reset
+//   pool_allocator      ：经典 Allocator 参数 + NodePool，每轮 reset
+//   build / destroy 为每轮 ms（destroy 含 reset / release），allocs 为每轮全局 new 次数
+// ============================================================
+template <typename Container, typename MakeContainer, typename Fill, typename Reset>
+void bench_case(const char* name, size_t rounds, MakeContainer make, Fill fill, Reset reset) {
+    double buildMs = 0, destroyMs = 0;
+    auto before = allocSnapshot();
+    for (size_t r = 0; r < rounds; r++) {
+        BenchTimer t;
+        auto* c = new Container(make());
+        fill(*c);
+        buildMs += t.ms();
+        doNotOptimize(c);
+
+        t.reset();
+        delete c;
+        reset();
+        destroyMs += t.ms();
+    }
+    // 减去 new Container 本身的那一次
+    double allocs = double((allocSnapshot() - before).count) / rounds - 1;
+    std::cout << "  " << std::left << std::setw(20) << name << std::right << std::fixed
+              << std::setprecision(2) << std::setw(10) << buildMs / rounds << std::setw(10)
+              << destroyMs / rounds << std::setw(12) << std::setprecision(1) << allocs << "\n";
+}
+
+template <template <typename> class Bench>
+void bench_all(const char* title, size_t rounds) {
+    std::cout << "  [" << title << "]\n";
+    std::cout << "  " << std::left << std::setw(20) << "allocator" << std::right << std::setw(10)
+              << "build" << std::setw(10) << "destroy" << std::setw(12) << "allocs" << "\n";
+    using Pmr = std::pmr::polymorphic_allocator<int>;
+    auto none = [] {};
+
+    Bench<std::allocator<int>>::run("std::allocator", rounds, {}, none);
+    {
+        std::pmr::monotonic_buffer_resource mono;
+        Bench<Pmr>::run("pmr::monotonic", rounds, Pmr(&mono), [&] { mono.release(); });
+    }
+    {
+        std::pmr::unsynchronized_pool_resource pool;
+        Bench<Pmr>::run("pmr::unsync_pool", rounds, Pmr(&pool), none);
+    }
+    {
+        Arena arena;
+        Bench<Pmr>::run("Arena (pmr)", rounds, Pmr(&arena), [&] { arena.reset(); });
+    }
+    {
+        Arena arena;
+        Bench<arena_allocator<int>>::run("arena_allocator", rounds, arena_allocator<int>(arena),
+                                         [&] { arena.reset(); });
+    }
+    {
+        NodePool pool;
+        Bench<pool_allocator<int>>::run("pool_allocator", rounds, pool_allocator<int>(pool),
+                                        [&] { pool.reset(); });
+    }
+}
+
+constexpr size_t kBenchNodes = 100000;
+
+// 分配器 A 以 int 为 value_type，容器内部会 rebind 到节点类型
+template <typename A>
+struct ListBench {
+    template <typename Reset>
+    static void run(const char* name, size_t rounds, A alloc, Reset reset) {
+        using L = std::list<int, A>;
+        bench_case<L>(
+            name, rounds, [&] { return L(alloc); },
+            [](L& l) {
+                for (size_t i = 0; i < kBenchNodes; i++) l.push_back(int(i));
+            },
+            reset);
+    }
+};
+
+template <typename A>
+struct MapBench {
+    using PA = typename std::allocator_traits<A>::template rebind_alloc<std::pair<const int, int>>;
+    template <typename Reset>
+    static void run(const char* name, size_t rounds, A alloc, Reset reset) {
+        using M = std::map<int, int, std::less<int>, PA>;
+        static const std::vector<uint64_t> keys = uniqueRandomKeys(kBenchNodes);
+        bench_case<M>(
+            name, rounds, [&] { return M(PA(alloc)); },
+            [](M& m) {
+                for (uint64_t k : keys) m.emplace(int(k), int(k));
+            },
+            reset);
+    }
+};
+
+void bench_allocators(size_t rounds) {
+    std::cout << "\n=== 14.5 Benchmark：10 万节点 list / map 每轮构建 + 销毁（" << rounds
+              << " 轮平均，ms） ===\n";
+    bench_all<ListBench>("list<int>", rounds);
+    bench_all<MapBench>("map<int, int>", rounds);
+}
+
+int main(int argc, char** argv) {
+    // 每种分配器的轮数；./container_level14_arena_allocator 200 测得更稳
+    size_t rounds = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20;
+
+    demo_arena_basic();
+    demo_pmr_containers();
+    demo_classic_allocator();
+    demo_thread_local_arena();
+    bench_allocators(rounds);
+    return 0;
+}
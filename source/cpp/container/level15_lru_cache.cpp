@@ -0,0 +1,228 @@
+// Level 15: 侵入式链表与 LRU 缓存
+// 涵盖：hook 嵌在对象里的 intrusive_list（零分配、O(1) 摘除、一个对象挂多条链表）、
+//        intrusive_list + 开放寻址索引的 lru_cache（按条目数 / 字节数淘汰），
+//        以及与 std::list + std::unordered_map 写法的吞吐量和每条目内存对比
+//
+// 实现见 intrusive_list.h / lru_cache.h；std::list 的 splice 见 level2.cpp
+
+#define BENCH_COUNT_ALLOCATIONS
+#include "bench_utils.h"
+#include "intrusive_list.h"
+#include "lru_cache.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <list>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ============================================================
+// 15.1 intrusive_list：链表指针嵌在对象里
+// ============================================================
+struct ByPriority {};  // 第二条链表的 Tag
+
+struct Task : intrusive_list_hook<>, intrusive_list_hook<ByPriority> {
+    int id;
+    int priority;
+    Task(int i, int p) : id(i), priority(p) {}
+};
+
+void demo_intrusive_list() {
+    std::cout << "=== 15.1 intrusive_list ===\n";
+
+    std::vector<Task> tasks;
+    for (int i = 0; i < 5; i++) tasks.emplace_back(i, i % 2);
+
+    intrusive_list<Task> all;                   // 默认 hook
+    intrusive_list<Task, ByPriority> urgent;    // 第二个 hook：同一对象同时挂在两条链表上
+    auto before = allocSnapshot();
+    for (auto& t : tasks) {
+        all.push_back(t);
+        if (t.priority == 1) urgent.push_front(t);
+    }
+    std::cout << "挂链表分配次数: " << (allocSnapshot() - before).count << "\n";
+
+    // 拿到对象就能 O(1) 摘下，不需要查找，也不需要保存迭代器
+    all.remove(tasks[2]);
+    all.move_to_front(tasks[4]);
+    std::cout << "all:";
+    for (const auto& t : all) std::cout << " " << t.id;
+    std::cout << "  urgent:";
+    for (const auto& t : urgent) std::cout << " " << t.id;
+    std::cout << "\ntasks[2] 在 all 上: " << static_cast<intrusive_list_hook<>&>(tasks[2]).is_linked()
+              << "\n";
+
+    // 对象销毁前必须摘下（这里链表先于 tasks 析构，会自动摘下全部对象）
+}
+
+// ============================================================
+// 15.2 lru_cache 基础
+// ============================================================
+void demo_lru_basic() {
+    std::cout << "\n=== 15.2 lru_cache 基础 ===\n";
+
+    lru_cache<std::string, int> cache(3);
+    cache.put("a", 1);
+    cache.put("b", 2);
+    cache.put("c", 3);
+    cache.get("a");     // a 变为最近使用
+    cache.put("d", 4);  // 容量 3：淘汰最久未用的 b
+
+    std::cout << "从新到旧:";
+    cache.for_each([](const std::string& k, int v) { std::cout << " " << k << "=" << v; });
+    std::cout << "\nget(b)=" << (cache.get("b") ? "命中" : "未命中") << "  peek(c)=" << *cache.peek("c")
+              << "\n";
+
+    cache.put("c", 30);  // 覆盖并标记为最近使用
+    cache.erase("a");
+    std::cout << "覆盖 c、删除 a 后 size=" << cache.size() << "  hits=" << cache.hits()
+              << " misses=" << cache.misses() << " evictions=" << cache.evictions() << "\n";
+}
+
+// ============================================================
+// 15.3 按字节淘汰
+//   value 大小差异很大时，按条目数限制不能约束内存；按估算字节数限制更合适
+// ============================================================
+void demo_lru_bytes() {
+    std::cout << "\n=== 15.3 按字节淘汰 ===\n";
+
+    // 条目数不限，总字节不超过 4 KB
+    lru_cache<int, std::string> cache(SIZE_MAX, 4096);
+    for (int i = 0; i < 20; i++) cache.put(i, std::string(i % 2 ? 1000 : 100, 'x'));
+    std::cout << "20 个 100 / 1000 字节的 value，4KB 上限：保留 " << cache.size() << " 个，估算 "
+              << cache.bytes() << " 字节，淘汰 " << cache.evictions() << " 个\n";
+
+    cache.put(100, std::string(10000, 'y'));  // 单个条目超过上限：不缓存，也不影响其他条目
+    std::cout << "放入 10000 字节的 value：contains=" << cache.contains(100) << " size=" << cache.size()
+              << "\n";
+
+    // 自定义 Weigher：例如只按 value 长度计费
+    struct ValueLength {
+        size_t operator()(int, const std::string& v) const { return v.size(); }
+    };
+    lru_cache<int, std::string, flat_hash<int>, std::equal_to<>, ValueLength> byLen(SIZE_MAX, 2500);
+    for (int i = 0; i < 10; i++) byLen.put(i, std::string(1000, 'z'));
+    std::cout << "按 value 长度计费、上限 2500：保留 " << byLen.size() << " 个\n";
+}
+
+// ============================================================
+// 15.4 Benchmark：lru_cache vs std::list + std::unordered_map
+//   访问序列服从近似 Zipf(1) 分布（key 空间为容量的 10 倍），每次 get，未命中则 put
+//   内存：填满缓存后的堆上活跃字节 / 条目数，allocs 为填充时每条目的全局 new 次数
+//   （活跃字节不含 malloc 自身的头部，glibc 上每次分配另有约 16 字节）
+// ============================================================
+template <typename Key, typename Value>
+class StdLru {
+public:
+    explicit StdLru(size_t cap) : mCap(cap) { mIndex.reserve(cap); }
+
+    Value* get(const Key& k) {
+        auto it = mIndex.find(k);
+        if (it == mIndex.end()) return nullptr;
+        mOrder.splice(mOrder.begin(), mOrder, it->second);
+        return &it->second->second;
+    }
+
+    void put(const Key& k, const Value& v) {
+        auto it = mIndex.find(k);
+        if (it != mIndex.end()) {
+            it->second->second = v;
+            mOrder.splice(mOrder.begin(), mOrder, it->second);
+            return;
+        }
+        mOrder.emplace_front(k, v);
+        mIndex.emplace(k, mOrder.begin());
+        if (mOrder.size() > mCap) {
+            mIndex.erase(mOrder.back().first);
+            mOrder.pop_back();
+        }
+    }
+
+    size_t size() const { return mOrder.size(); }
+
+private:
+    size_t mCap;
+    std::list<std::pair<Key, Value>> mOrder;
+    std::unordered_map<Key, typename std::list<std::pair<Key, Value>>::iterator> mIndex;
+};
+
+// rank = floor(U^u)：P(rank <= r) ≈ ln r / ln U，即 Zipf(s=1) 的连续近似
+std::vector<uint64_t> zipf_ranks(size_t n, size_t universe, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> u(0, 1);
+    std::vector<uint64_t> ranks(n);
+    double logU = std::log(double(universe));
+    for (auto& r : ranks) r = std::min<uint64_t>(uint64_t(std::exp(u(rng) * logU)) - 1, universe - 1);
+    return ranks;
+}
+
+template <typename Cache, typename MakeKey, typename MakeValue>
+void bench_lru(const char* name, size_t capacity, const std::vector<uint64_t>& ranks, MakeKey makeKey,
+               MakeValue makeValue) {
+    auto before = allocSnapshot();
+    Cache cache(capacity);
+    // 先用顺序 key 填满，测量每条目内存
+    for (size_t i = 0; i < capacity; i++) cache.put(makeKey(1000000000 + i), makeValue(i));
+    auto filled = allocSnapshot() - before;
+    double bytesPerEntry = double(filled.liveBytes) / cache.size();
+    double allocsPerEntry = double(filled.count) / cache.size();
+
+    std::vector<decltype(makeKey(0))> keys;
+    keys.reserve(ranks.size());
+    for (uint64_t r : ranks) keys.push_back(makeKey(r));
+    auto value = makeValue(0);
+
+    BenchTimer t;
+    size_t hits = 0;
+    for (const auto& k : keys) {
+        if (cache.get(k)) {
+            ++hits;
+        } else {
+            cache.put(k, value);
+        }
+    }
+    double ns = t.ns() / keys.size();
+    std::cout << "  " << std::left << std::setw(22) << name << std::right << std::fixed
+              << std::setprecision(2) << std::setw(10) << 1e3 / ns << std::setw(10)
+              << std::setprecision(1) << 100.0 * hits / keys.size() << "%" << std::setw(12)
+              << bytesPerEntry << std::setw(10) << std::setprecision(2) << allocsPerEntry << "\n";
+}
+
+void bench_lru_all(size_t capacity, size_t ops) {
+    std::cout << "\n=== 15.4 Benchmark：lru_cache vs list + unordered_map ===\n";
+    std::cout << "  容量 " << capacity << "，" << ops << " 次访问，key 空间 " << capacity * 10 << "\n";
+    auto ranks = zipf_ranks(ops, capacity * 10, 7);
+    auto header = [] {
+        std::cout << "  " << std::left << std::setw(22) << "cache" << std::right << std::setw(10)
+                  << "Mops/s" << std::setw(11) << "hit" << std::setw(12) << "B/entry" << std::setw(10) << "allocs" << "\n";
+    };
+
+    std::cout << "  [uint64 -> uint64]\n";
+    header();
+    auto intKey = [](uint64_t r) { return r * 0x9E3779B97F4A7C15ull; };  // 打散 rank
+    auto intValue = [](uint64_t i) { return i; };
+    bench_lru<StdLru<uint64_t, uint64_t>>("list + unordered_map", capacity, ranks, intKey, intValue);
+    bench_lru<lru_cache<uint64_t, uint64_t>>("lru_cache", capacity, ranks, intKey, intValue);
+
+    std::cout << "  [string(~20B) -> string(48B)]\n";
+    header();
+    auto strKey = [](uint64_t r) { return "user:session:" + std::to_string(r); };
+    auto strValue = [](uint64_t i) { return std::string(48, char('a' + i % 26)); };
+    bench_lru<StdLru<std::string, std::string>>("list + unordered_map", capacity, ranks, strKey,
+                                                strValue);
+    bench_lru<lru_cache<std::string, std::string>>("lru_cache", capacity, ranks, strKey, strValue);
+}
+
+int main(int argc, char** argv) {
+    // 缓存容量；访问次数为容量的 20 倍。./container_level15_lru_cache 1000000
+    size_t capacity = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+
+    demo_intrusive_list();
+    demo_lru_basic();
+    demo_lru_bytes();
+    bench_lru_all(capacity, capacity * 20);
+    return 0;
+}
@@ -0,0 +1,247 @@
+// Level 16: 连续存储的矩阵 / N 维数组 —— 代替 vector<vector<T>>
+// 涵盖：一次分配的行主序 / 列主序存储、基于 std::span 的行 / 列 / 子块 / 转置视图、
+//        64 字节对齐与行填充、N 维数组与切片、按块遍历与分块转置，
+//        以及大矩阵按行 / 按列遍历和转置与嵌套 vector 的对比
+//
+// 实现见 matrix.h；vector<vector<T>> 的写法见 level1.cpp 的 demo_2d
+
+#define BENCH_COUNT_ALLOCATIONS
+#include "bench_utils.h"
+#include "matrix.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+template <typename View>
+void print(const View& m, const char* label) {
+    std::cout << label << " (" << m.rows() << "x" << m.cols() << "):\n";
+    for (size_t r = 0; r < m.rows(); r++) {
+        std::cout << " ";
+        for (size_t c = 0; c < m.cols(); c++) std::cout << "\t" << m(r, c);
+        std::cout << "\n";
+    }
+}
+
+// ============================================================
+// 16.1 一块连续内存 vs vector<vector<T>>
+// ============================================================
+void demo_matrix_basic() {
+    std::cout << "=== 16.1 matrix 基础 ===\n";
+
+    auto before = allocSnapshot();
+    std::vector<std::vector<int>> nested(100, std::vector<int>(100));
+    std::cout << "vector<vector<int>> 100x100 分配次数: " << (allocSnapshot() - before).count << "\n";
+
+    before = allocSnapshot();
+    matrix<int> m(100, 100);
+    std::cout << "matrix<int> 100x100 分配次数: " << (allocSnapshot() - before).count << "\n";
+
+    // 行尾与下一行行首在内存里相邻
+    std::cout << "nested: &[1][0] - &[0][99] = " << (&nested[1][0] - &nested[0][99])
+              << " 个 int；matrix: &(1,0) - &(0,99) = " << (&m(1, 0) - &m(0, 99)) << "\n";
+
+    matrix<int> small(3, 4);
+    std::iota(small.flat().begin(), small.flat().end(), 0);  // 按内存顺序填 0..11
+    print(small, "small");
+    std::cout << "small.at(2, 3)=" << small.at(2, 3) << "  stride(0)=" << small.stride(0)
+              << " stride(1)=" << small.stride(1) << "\n";
+    try {
+        small.at(3, 0);
+    } catch (const std::out_of_range& e) {
+        std::cout << "at() 异常: " << e.what() << "\n";
+    }
+}
+
+// ============================================================
+// 16.2 视图：行 / 列 / 子块 / 转置都不拷贝数据
+//   行主序里行是连续的 std::span，列是步长为 cols 的 strided_span；列主序相反
+// ============================================================
+void demo_views() {
+    std::cout << "\n=== 16.2 行 / 列 / 子块视图 ===\n";
+
+    matrix<int> m(4, 5);
+    for (size_t r = 0; r < m.rows(); r++)
+        for (size_t c = 0; c < m.cols(); c++) m(r, c) = int(r * 10 + c);
+
+    std::span<int> row2 = m.row(2).as_span();  // 连续，可直接交给接受 span 的接口
+    std::cout << "row(2) 连续=" << m.row(2).is_contiguous()
+              << "，和=" << std::accumulate(row2.begin(), row2.end(), 0) << "\n";
+    auto col1 = m.col(1);
+    std::cout << "col(1) 步长=" << col1.stride() << "：";
+    for (int x : col1) std::cout << " " << x;
+    std::cout << "\n";
+
+    // strided_span 的迭代器是随机访问迭代器，可以直接用于标准算法
+    std::sort(col1.begin(), col1.end(), std::greater<>());
+    std::cout << "对 col(1) 降序排序后 m(0,1)=" << m(0, 1) << "\n";
+
+    auto blk = m.block(1, 1, 2, 3);
+    for_each_element(blk, [](int& x) { x = -x; });
+    print(m, "子块 (1,1) 2x3 取负后");
+    print(m.view().transposed(), "转置视图");
+
+    matrix<int, matrix_layout::col_major> cm(3, 4);
+    std::cout << "列主序：stride(0)=" << cm.stride(0) << " stride(1)=" << cm.stride(1)
+              << "，col(2) 连续=" << cm.col(2).is_contiguous()
+              << "，row(2) 连续=" << cm.row(2).is_contiguous() << "\n";
+}
+
+// ============================================================
+// 16.3 对齐与行填充
+//   数据起点按 64 字节对齐；aligned_rows 再把每行补齐到 64 字节，每行起点都可以用对齐的 SIMD 加载
+// ============================================================
+void demo_alignment() {
+    std::cout << "\n=== 16.3 对齐存储 ===\n";
+
+    matrix<float> plain(5, 13);
+    matrix<float> padded({5, 13}, aligned_rows);
+    auto misaligned = [](const float* p) { return reinterpret_cast<uintptr_t>(p) % kMatrixAlign; };
+
+    std::cout << "plain : stride(0)=" << plain.stride(0) << " storage=" << plain.storage_size()
+              << " 第 1 行起点 %64=" << misaligned(plain.line(1).data()) << "\n";
+    std::cout << "padded: stride(0)=" << padded.stride(0) << " storage=" << padded.storage_size()
+              << " 每行起点 %64:";
+    for (size_t i = 0; i < padded.line_count(); i++) std::cout << " " << misaligned(padded.line(i).data());
+    std::cout << "\n有填充时 is_contiguous=" << padded.is_contiguous()
+              << "，按 line(i) 遍历，每条都是长度 " << padded.line(0).size() << " 的 std::span\n";
+}
+
+// ============================================================
+// 16.4 N 维数组
+// ============================================================
+void demo_ndarray() {
+    std::cout << "\n=== 16.4 ndarray<T, 3> ===\n";
+
+    ndarray<int, 3> t(2, 3, 4);  // 2 个 3x4 的切片
+    std::iota(t.flat().begin(), t.flat().end(), 0);
+    std::cout << "extents=(" << t.extent(0) << "," << t.extent(1) << "," << t.extent(2) << ") strides=("
+              << t.stride(0) << "," << t.stride(1) << "," << t.stride(2) << ")  t(1,2,3)=" << t(1, 2, 3)
+              << "\n";
+    print(t.slice(1), "slice(1)");
+
+    ndarray<int, 3, matrix_layout::col_major> tc(2, 3, 4);
+    std::cout << "列主序 strides=(" << tc.stride(0) << "," << tc.stride(1) << "," << tc.stride(2) << ")\n";
+}
+
+// ============================================================
+// 16.5 按块遍历与转置
+//   朴素转置写目标矩阵的一整列：每个元素落在不同的缓存行上，矩阵大时几乎每次写都缺失；
+//   分块后源块和目标块都留在 L1 里
+// ============================================================
+void demo_tiles() {
+    std::cout << "\n=== 16.5 按块遍历与分块转置 ===\n";
+
+    matrix<int> m(5, 7);
+    for_each_tile(m.view(), 2, 3, [](size_t r0, size_t c0, matrix_view<int> tile) {
+        for_each_element(tile, [&](int& x) { x = int(r0 / 2 * 3 + c0 / 3); });  // 块编号
+    });
+    print(m, "按 2x3 分块编号");
+
+    matrix<int> t(7, 5);
+    matrix_transpose(m.view(), t.view(), 4);
+    std::cout << "分块转置后 t(6,4)=" << t(6, 4) << " == m(4,6)=" << m(4, 6) << "\n";
+}
+
+// ============================================================
+// 16.6 Benchmark：n x n 的 int 矩阵，vector<vector<int>> vs matrix<int>
+//   按行求和 / 按列求和 / 转置，各跑 reps 次取平均（ms）
+//   默认 n=2000：n 为 2 的幂时，一列上的元素间距恰好是 4KB 的倍数，全部映射到同一组缓存组，
+//   跨步访问会额外变慢（可以用 2048 对比看看）
+// ============================================================
+using Nested = std::vector<std::vector<int>>;
+
+template <typename F>
+double time_ms(size_t reps, F&& f) {
+    BenchTimer t;
+    for (size_t i = 0; i < reps; i++) f();
+    return t.ms() / reps;
+}
+
+void report(const char* name, double ms) {
+    std::cout << "  " << std::left << std::setw(36) << name << std::right << std::fixed
+              << std::setprecision(2) << std::setw(10) << ms << "\n";
+}
+
+void bench_matrix(size_t n, size_t reps) {
+    std::cout << "\n=== 16.6 Benchmark：" << n << "x" << n << " int 矩阵（" << reps
+              << " 次平均，ms） ===\n";
+
+    Nested nested(n, std::vector<int>(n));
+    matrix<int> rm(n, n);
+    matrix<int, matrix_layout::col_major> cm(n, n);
+    for (size_t r = 0; r < n; r++)
+        for (size_t c = 0; c < n; c++) nested[r][c] = rm(r, c) = cm(r, c) = int(r ^ c);
+
+    std::cout << "  [按行求和]\n";
+    report("vector<vector>", time_ms(reps, [&] {
+               long long s = 0;
+               for (size_t r = 0; r < n; r++)
+                   for (size_t c = 0; c < n; c++) s += nested[r][c];
+               doNotOptimize(s);
+           }));
+    report("matrix row-major", time_ms(reps, [&] {
+               long long s = 0;
+               for (size_t r = 0; r < n; r++)
+                   for (int x : rm.row(r).as_span()) s += x;
+               doNotOptimize(s);
+           }));
+
+    std::cout << "  [按列求和]\n";
+    report("vector<vector>", time_ms(reps, [&] {
+               long long s = 0;
+               for (size_t c = 0; c < n; c++)
+                   for (size_t r = 0; r < n; r++) s += nested[r][c];
+               doNotOptimize(s);
+           }));
+    report("matrix row-major, strided col", time_ms(reps, [&] {
+               long long s = 0;
+               for (size_t c = 0; c < n; c++)
+                   for (int x : rm.col(c)) s += x;
+               doNotOptimize(s);
+           }));
+    report("matrix col-major, contiguous", time_ms(reps, [&] {
+               long long s = 0;
+               for (size_t c = 0; c < n; c++)
+                   for (int x : cm.col(c).as_span()) s += x;
+               doNotOptimize(s);
+           }));
+    report("matrix row-major, for_each_element", time_ms(reps, [&] {
+               long long s = 0;
+               for_each_element(rm.view().transposed(), [&](int x) { s += x; });  // 按内存顺序访问
+               doNotOptimize(s);
+           }));
+
+    std::cout << "  [转置]\n";
+    Nested nestedT(n, std::vector<int>(n));
+    report("vector<vector> naive", time_ms(reps, [&] {
+               for (size_t r = 0; r < n; r++)
+                   for (size_t c = 0; c < n; c++) nestedT[c][r] = nested[r][c];
+               doNotOptimize(nestedT[n - 1][0]);
+           }));
+    matrix<int> rmT(n, n);
+    report("matrix naive", time_ms(reps, [&] {
+               for (size_t r = 0; r < n; r++)
+                   for (size_t c = 0; c < n; c++) rmT(c, r) = rm(r, c);
+               doNotOptimize(rmT(n - 1, 0));
+           }));
+    report("matrix_transpose tile=32", time_ms(reps, [&] {
+               matrix_transpose(rm.view(), rmT.view(), 32);
+               doNotOptimize(rmT(n - 1, 0));
+           }));
+}
+
+int main(int argc, char** argv) {
+    // 矩阵边长；./container_level16_matrix 8192 看更大矩阵的差距
+    size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000;
+
+    demo_matrix_basic();
+    demo_views();
+    demo_alignment();
+    demo_ndarray();
+    demo_tiles();
+    bench_matrix(n, 5);
+    return 0;
+}
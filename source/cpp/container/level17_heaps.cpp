@@ -0,0 +1,327 @@
+// Level 17: 优先队列家族 —— d 叉堆、基数堆、索引堆
+// 涵盖：与 std::priority_queue 相同接口的 D 叉堆（建堆、replace_top）、单调整数 key 的 radix_heap、
+//        支持 decrease_key 的 indexed_heap 与 Dijkstra，
+//        以及 push / pop / decrease-key 吞吐量与 std::priority_queue 的对比
+//
+// 实现见 heaps.h；std::priority_queue 本身见 level3.cpp，push_heap / pop_heap 见 algorithm/level6.cpp
+
+#include "bench_utils.h"
+#include "heaps.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+static_assert(heap_queue<d_ary_heap<int>>);
+static_assert(heap_queue<radix_heap<uint32_t, int>>);
+static_assert(heap_queue<indexed_heap<int>>);
+static_assert(heap_queue<std::priority_queue<int>>);
+
+// ============================================================
+// 17.1 d_ary_heap：接口同 std::priority_queue
+// ============================================================
+void demo_dary_heap() {
+    std::cout << "=== 17.1 d_ary_heap ===\n";
+
+    d_ary_heap<int> maxh;  // 默认 4 叉、最大堆
+    for (int x : {3, 1, 4, 1, 5, 9, 2, 6}) maxh.push(x);
+    std::cout << "4 叉最大堆，依次弹出:";
+    while (!maxh.empty()) {
+        std::cout << " " << maxh.top();
+        maxh.pop();
+    }
+
+    // 8 叉最小堆，从区间 O(n) 建堆
+    std::vector<int> v = {3, 1, 4, 1, 5, 9, 2, 6};
+    d_ary_heap<int, 8, std::greater<int>> minh(v.begin(), v.end());
+    std::cout << "\n8 叉最小堆，依次弹出:";
+    while (!minh.empty()) {
+        std::cout << " " << minh.top();
+        minh.pop();
+    }
+
+    // Top-K：replace_top 代替 pop + push，只做一次下滤
+    std::vector<int> nums = {3, 1, 4, 1, 5, 9, 2, 6, 5, 3};
+    d_ary_heap<int, 4, std::greater<int>> window(nums.begin(), nums.begin() + 3);
+    for (size_t i = 3; i < nums.size(); i++)
+        if (nums[i] > window.top()) window.replace_top(nums[i]);
+    std::cout << "\n前 3 大（堆顶为第 3 大）: " << window.top() << "\n";
+}
+
+// ============================================================
+// 17.2 radix_heap：单调的整数 key
+//   定时器 / 离散事件模拟：新事件的时间总是不早于当前时间
+// ============================================================
+void demo_radix_heap() {
+    std::cout << "\n=== 17.2 radix_heap ===\n";
+
+    radix_heap<uint32_t, std::string> events;
+    events.push(30, "超时检查");
+    events.push(10, "收到请求");
+    events.push(20, "写日志");
+    while (!events.empty()) {
+        auto [time, name] = events.top();
+        events.pop();
+        std::cout << "  t=" << time << " " << name << "\n";
+        if (name == "收到请求") events.push(time + 5, "发送响应");  // 不早于当前时间即可
+    }
+    std::cout << "last_key=" << events.last_key() << "（之后 push 的 key 不能比它小）\n";
+}
+
+// ============================================================
+// 17.3 indexed_heap：Dijkstra 的 decrease_key
+//   std::priority_queue 不能修改元素，只能重复 push 新距离，弹出时跳过过期的（懒删除）；
+//   indexed_heap 里每个顶点最多一份，堆的大小不超过顶点数
+// ============================================================
+struct Edge {
+    uint32_t to;
+    uint32_t w;
+};
+using Graph = std::vector<std::vector<Edge>>;
+
+std::vector<uint32_t> dijkstra_indexed(const Graph& g, uint32_t src, size_t* maxHeap = nullptr) {
+    std::vector<uint32_t> dist(g.size(), UINT32_MAX);
+    indexed_heap<uint32_t, std::greater<>> pq(g.size());
+    dist[src] = 0;
+    pq.push(src, 0);
+    while (!pq.empty()) {
+        if (maxHeap) *maxHeap = std::max(*maxHeap, pq.size());
+        auto [u, d] = pq.top();
+        pq.pop();
+        for (const Edge& e : g[u]) {
+            uint32_t nd = d + e.w;
+            if (nd >= dist[e.to]) continue;
+            dist[e.to] = nd;
+            if (pq.contains(e.to))
+                pq.decrease_key(e.to, nd);
+            else
+                pq.push(e.to, nd);
+        }
+    }
+    return dist;
+}
+
+std::vector<uint32_t> dijkstra_lazy(const Graph& g, uint32_t src, size_t* maxHeap = nullptr) {
+    std::vector<uint32_t> dist(g.size(), UINT32_MAX);
+    using Item = std::pair<uint32_t, uint32_t>;  // (距离, 顶点)
+    std::priority_queue<Item, std::vector<Item>, std::greater<>> pq;
+    dist[src] = 0;
+    pq.push({0, src});
+    while (!pq.empty()) {
+        if (maxHeap) *maxHeap = std::max(*maxHeap, pq.size());
+        auto [d, u] = pq.top();
+        pq.pop();
+        if (d != dist[u]) continue;  // 过期条目
+        for (const Edge& e : g[u]) {
+            uint32_t nd = d + e.w;
+            if (nd >= dist[e.to]) continue;
+            dist[e.to] = nd;
+            pq.push({nd, e.to});
+        }
+    }
+    return dist;
+}
+
+// Dijkstra 弹出的距离单调不减，也可以直接用 radix_heap（同样懒删除）
+std::vector<uint32_t> dijkstra_radix(const Graph& g, uint32_t src) {
+    std::vector<uint32_t> dist(g.size(), UINT32_MAX);
+    radix_heap<uint32_t, uint32_t> pq;
+    dist[src] = 0;
+    pq.push(0, src);
+    while (!pq.empty()) {
+        auto [d, u] = pq.top();
+        pq.pop();
+        if (d != dist[u]) continue;
+        for (const Edge& e : g[u]) {
+            uint32_t nd = d + e.w;
+            if (nd >= dist[e.to]) continue;
+            dist[e.to] = nd;
+            pq.push(nd, e.to);
+        }
+    }
+    return dist;
+}
+
+Graph random_graph(size_t n, size_t degree, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    Graph g(n);
+    for (size_t u = 0; u < n; u++)
+        for (size_t k = 0; k < degree; k++)
+            g[u].push_back({uint32_t(rng() % n), uint32_t(rng() % 1000 + 1)});
+    return g;
+}
+
+void demo_indexed_heap() {
+    std::cout << "\n=== 17.3 indexed_heap 与 Dijkstra ===\n";
+
+    indexed_heap<int, std::greater<>> h;
+    h.push(0, 50);
+    h.push(1, 30);
+    h.push(2, 40);
+    h.decrease_key(0, 10);  // id 0：50 -> 10，成为堆顶
+    h.update(1, 60);        // 任意方向修改
+    h.erase(2);
+    std::cout << "堆顶 id=" << h.top_id() << " prio=" << h.top_priority() << "，size=" << h.size()
+              << "，priority(1)=" << h.priority(1) << "\n";
+
+    Graph g = random_graph(100000, 8, 1);
+    size_t maxIndexed = 0, maxLazy = 0;
+    auto d1 = dijkstra_indexed(g, 0, &maxIndexed);
+    auto d2 = dijkstra_lazy(g, 0, &maxLazy);
+    auto d3 = dijkstra_radix(g, 0);
+    std::cout << "10 万顶点、80 万条边：三种实现结果一致=" << (d1 == d2 && d2 == d3)
+              << "，堆的峰值大小 indexed=" << maxIndexed << " lazy=" << maxLazy << "\n";
+}
+
+// ============================================================
+// 17.4 Benchmark
+//   push+pop：压入 n 个随机 uint32，再全部弹出，ns / (push + pop)
+//   hold    ：堆中保持 n 个元素，反复弹出最小的 t 并压入 t + 随机增量（离散事件模拟），ns / 次
+//   decrease：n 个 id 入堆，再做 n 次随机 decrease-key，最后全部弹出，ns / 操作；
+//             std::priority_queue 用懒删除（重复 push + 弹出时跳过）
+// ============================================================
+using StdMinPQ = std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<>>;
+
+template <typename H>
+void push_key(H& h, uint32_t k) {
+    if constexpr (requires { h.push(k, k); })
+        h.push(k, k);
+    else
+        h.push(k);
+}
+
+template <typename H>
+uint32_t top_key(const H& h) {
+    if constexpr (requires { h.top().first; })
+        return h.top().first;
+    else
+        return h.top();
+}
+
+template <typename H>
+double bench_push_pop(const std::vector<uint32_t>& keys) {
+    H h;
+    BenchTimer t;
+    for (uint32_t k : keys) push_key(h, k);
+    uint64_t sum = 0;
+    while (!h.empty()) {
+        sum += top_key(h);
+        h.pop();
+    }
+    doNotOptimize(sum);
+    return t.ns() / keys.size();
+}
+
+template <typename H>
+double bench_hold(const std::vector<uint32_t>& keys, const std::vector<uint32_t>& incs) {
+    H h;
+    for (uint32_t k : keys) push_key(h, k >> 8);
+    BenchTimer t;
+    uint64_t sum = 0;
+    for (uint32_t inc : incs) {
+        uint32_t k = top_key(h);
+        h.pop();
+        push_key(h, k + inc);
+        sum += k;
+    }
+    doNotOptimize(sum);
+    return t.ns() / incs.size();
+}
+
+double bench_decrease_indexed(const std::vector<uint32_t>& keys, const std::vector<uint32_t>& ids) {
+    size_t n = keys.size();
+    BenchTimer t;
+    indexed_heap<uint32_t, std::greater<>> h(n);
+    for (size_t i = 0; i < n; i++) h.push(uint32_t(i), keys[i] | 0x80000000u);
+    for (uint32_t id : ids) {
+        if (!h.contains(id)) continue;
+        h.decrease_key(id, h.priority(id) - (h.priority(id) >> 4));
+    }
+    uint64_t sum = 0;
+    while (!h.empty()) {
+        sum += h.top_priority();
+        h.pop();
+    }
+    doNotOptimize(sum);
+    return t.ns() / (3 * n);
+}
+
+double bench_decrease_lazy(const std::vector<uint32_t>& keys, const std::vector<uint32_t>& ids) {
+    size_t n = keys.size();
+    BenchTimer t;
+    using Item = std::pair<uint32_t, uint32_t>;
+    std::priority_queue<Item, std::vector<Item>, std::greater<>> h;
+    std::vector<uint32_t> prio(n);
+    for (size_t i = 0; i < n; i++) {
+        prio[i] = keys[i] | 0x80000000u;
+        h.push({prio[i], uint32_t(i)});
+    }
+    for (uint32_t id : ids) {
+        prio[id] -= prio[id] >> 4;
+        h.push({prio[id], id});
+    }
+    uint64_t sum = 0;
+    while (!h.empty()) {
+        auto [p, id] = h.top();
+        h.pop();
+        if (p != prio[id]) continue;
+        sum += p;
+    }
+    doNotOptimize(sum);
+    return t.ns() / (3 * n);
+}
+
+void bench_heaps(size_t maxN) {
+    std::cout << "\n=== 17.4 Benchmark：ns/op，uint32 key，最小堆 ===\n";
+    std::cout << "  " << std::setw(11) << "n" << std::setw(14) << "" << std::setw(11) << "push+pop"
+              << std::setw(10) << "hold" << "\n";
+
+    for (size_t n : decadeSizes(4, maxN)) {
+        std::vector<uint32_t> keys(n), incs(std::max<size_t>(n, 1000000));
+        std::mt19937 rng{uint32_t(n)};
+        for (auto& k : keys) k = rng();
+        for (auto& x : incs) x = rng() % (1u << 16);
+
+        auto row = [&](const char* name, double pushPop, double hold) {
+            std::cout << "  " << std::setw(11) << n << std::setw(14) << name << std::fixed
+                      << std::setprecision(2) << std::setw(11) << pushPop << std::setw(10) << hold
+                      << "\n";
+        };
+        row("std::pq", bench_push_pop<StdMinPQ>(keys), bench_hold<StdMinPQ>(keys, incs));
+        using H2 = d_ary_heap<uint32_t, 2, std::greater<>>;
+        using H4 = d_ary_heap<uint32_t, 4, std::greater<>>;
+        using H8 = d_ary_heap<uint32_t, 8, std::greater<>>;
+        using R = radix_heap<uint32_t, uint32_t>;
+        row("d_ary<2>", bench_push_pop<H2>(keys), bench_hold<H2>(keys, incs));
+        row("d_ary<4>", bench_push_pop<H4>(keys), bench_hold<H4>(keys, incs));
+        row("d_ary<8>", bench_push_pop<H8>(keys), bench_hold<H8>(keys, incs));
+        row("radix_heap", bench_push_pop<R>(keys), bench_hold<R>(keys, incs));
+    }
+
+    std::cout << "  [decrease-key：n 次 push + n 次 decrease + 弹出全部]\n";
+    std::cout << "  " << std::setw(11) << "n" << std::setw(14) << "std::pq lazy" << std::setw(14)
+              << "indexed_heap" << "\n";
+    for (size_t n : decadeSizes(4, maxN)) {
+        std::vector<uint32_t> keys(n), ids(n);
+        std::mt19937 rng{uint32_t(n) + 1};
+        for (auto& k : keys) k = rng();
+        for (auto& id : ids) id = uint32_t(rng() % n);
+        std::cout << "  " << std::setw(11) << n << std::fixed << std::setprecision(2) << std::setw(14)
+                  << bench_decrease_lazy(keys, ids) << std::setw(14) << bench_decrease_indexed(keys, ids)
+                  << "\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    // 最大规模；./container_level17_heaps 100000000 测到 10^8
+    size_t maxN = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    demo_dary_heap();
+    demo_radix_heap();
+    demo_indexed_heap();
+    bench_heaps(maxN);
+    return 0;
+}
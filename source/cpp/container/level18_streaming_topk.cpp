@@ -0,0 +1,181 @@
+// Level 18: 数据流 Top-K 与频繁项
+// 涵盖：精确计数 + 最小堆选 Top-K 且可跨线程合并、固定内存的 Space-Saving（带误差界）、
+//        Count-Min Sketch 与保守更新、sketch + 候选堆的流式 Top-K，
+//        以及 Zipf 数据流上"各线程统计再合并"的吞吐量、内存与准确率对比
+//
+// 实现见 streaming_topk.h；内存里的 Top-K 见 level3.cpp，std::map 词频统计见 level5.cpp
+
+#include "bench_utils.h"
+#include "streaming_topk.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+template <typename Entries>
+void print_top(const Entries& top, const char* label) {
+    std::cout << label << ":";
+    for (const auto& e : top) {
+        std::cout << " " << e.key << "=" << e.count;
+        if (e.error) std::cout << "(±" << e.error << ")";
+    }
+    std::cout << "\n";
+}
+
+// ============================================================
+// 18.1 exact_topk：精确计数，可合并
+// ============================================================
+void demo_exact() {
+    std::cout << "=== 18.1 exact_topk ===\n";
+
+    const char* text =
+        "the quick brown fox jumps over the lazy dog the fox barks and the dog runs "
+        "a quick fox and a lazy dog meet the brown dog";
+    std::istringstream in(text);
+    std::vector<std::string> words;
+    for (std::string w; in >> w;) words.push_back(w);
+
+    // 两个"线程"各统计一半，最后合并
+    exact_topk<std::string> a, b;
+    for (size_t i = 0; i < words.size(); i++) (i < words.size() / 2 ? a : b).add(words[i]);
+    a.merge(b);
+    print_top(a.top(3), "前 3 个词");
+    std::cout << "共 " << a.total() << " 个词，" << a.distinct() << " 个不同的词，count(\"fox\")="
+              << a.count("fox") << "\n";
+}
+
+// ============================================================
+// 18.2 space_saving：m 个计数器，误差 <= N / m
+// ============================================================
+void demo_space_saving() {
+    std::cout << "\n=== 18.2 space_saving ===\n";
+
+    // 3 个高频 key 混在大量只出现一次的 key 里
+    space_saving<int> ss(8);
+    exact_topk<int> exact;
+    for (int i = 0; i < 1000; i++) {
+        int key = i % 4 == 0 ? 1 : i % 4 == 1 ? 2 : i % 8 == 2 ? 3 : 1000 + i;
+        ss.add(key);
+        exact.add(key);
+    }
+    print_top(ss.top(3), "space_saving(8) 前 3");
+    print_top(exact.top(3), "精确结果    前 3");
+    std::cout << "误差上界 N/m=" << ss.total() / ss.capacity() << "，表外 key 的计数不超过 min_count="
+              << ss.min_count() << "，内存 " << ss.memory_usage() << " 字节（与数据量无关）\n";
+}
+
+// ============================================================
+// 18.3 count_min_sketch 与 cms_topk
+// ============================================================
+void demo_count_min() {
+    std::cout << "\n=== 18.3 count_min_sketch ===\n";
+
+    auto stream = zipfRanks(200000, 100000, 1.1, 7);
+    auto cms = count_min_sketch<uint64_t>::with_error(0.001, 0.01);  // 误差 <= 0.1% N，概率 99%
+    count_min_sketch<uint64_t> plain(cms.width(), cms.depth(), false);
+    exact_topk<uint64_t> exact;
+    cms_topk<uint64_t> top(5, cms.width(), cms.depth());
+    for (uint64_t x : stream) {
+        cms.add(x);
+        plain.add(x);
+        exact.add(x);
+        top.add(x);
+    }
+    std::cout << "width=" << cms.width() << " depth=" << cms.depth() << " 内存=" << cms.memory_usage()
+              << " 字节，误差上界=" << cms.error_bound() << "\n";
+    for (uint64_t key : {0, 10, 1000, 50000})
+        std::cout << "  key " << key << "：真实 " << exact.count(key) << "，保守更新 " << cms.estimate(key)
+                  << "，普通更新 " << plain.estimate(key) << "\n";
+    print_top(top.top(5), "cms_topk 前 5");
+    print_top(exact.top(5), "精确结果 前 5");
+}
+
+// ============================================================
+// 18.4 Benchmark：Zipf 数据流，各线程独立统计后合并
+//   Mitems/s 含合并时间；内存为各线程结构之和；
+//   recall 为报告的前 K 个中属于真实前 K 的比例，relerr 为报告计数相对真实计数的平均误差
+// ============================================================
+constexpr size_t kTopK = 100;
+
+template <typename Make>
+void bench_engine(const char* name, const std::vector<uint64_t>& stream, size_t threads, Make make,
+                  const exact_topk<uint64_t>& truth) {
+    using Engine = decltype(make());
+    BenchTimer t;
+    std::vector<Engine> parts;
+    for (size_t i = 0; i < threads; i++) parts.push_back(make());
+    std::vector<std::thread> workers;
+    size_t chunk = (stream.size() + threads - 1) / threads;
+    for (size_t i = 0; i < threads; i++) {
+        workers.emplace_back([&, i] {
+            size_t lo = std::min(stream.size(), i * chunk), hi = std::min(stream.size(), lo + chunk);
+            for (size_t j = lo; j < hi; j++) parts[i].add(stream[j]);
+        });
+    }
+    for (auto& w : workers) w.join();
+    size_t memory = 0;
+    for (const auto& p : parts) memory += p.memory_usage();
+    for (size_t i = 1; i < threads; i++) parts[0].merge(parts[i]);
+    double sec = t.ns() / 1e9;
+
+    auto reported = parts[0].top(kTopK);
+    auto expected = truth.top(kTopK);
+    flat_hash_set<uint64_t> trueKeys;
+    for (const auto& e : expected) trueKeys.insert(e.key);
+    size_t hit = 0;
+    double relErr = 0;
+    for (const auto& e : reported) {
+        hit += trueKeys.contains(e.key);
+        double real = double(truth.count(e.key));
+        relErr += std::abs(double(e.count) - real) / std::max(real, 1.0);
+    }
+    std::cout << "  " << std::left << std::setw(24) << name << std::right << std::fixed
+              << std::setprecision(2) << std::setw(10) << stream.size() / sec / 1e6 << std::setw(12)
+              << std::setprecision(1) << memory / 1024.0 << std::setw(9) << std::setprecision(2)
+              << double(hit) / kTopK << std::setw(10) << std::setprecision(4)
+              << relErr / std::max<size_t>(reported.size(), 1) << "\n";
+}
+
+void bench_topk(size_t n, size_t threads) {
+    const size_t universe = 1000000;
+    std::cout << "\n=== 18.4 Benchmark：" << n << " 个元素的 Zipf(1.0) 流，" << universe << " 个不同 key，"
+              << threads << " 线程，Top-" << kTopK << " ===\n";
+
+    // 把排名打散成 64 位 key（乘奇数是双射），热点 key 不再是 0, 1, 2 ...
+    auto stream = zipfRanks(n, universe, 1.0, 1);
+    for (auto& x : stream) x = (x + 1) * 0x9E3779B97F4A7C15ull;
+
+    exact_topk<uint64_t> truth;
+    for (uint64_t x : stream) truth.add(x);
+    std::cout << "  实际出现的不同 key：" << truth.distinct() << "\n";
+
+    std::cout << "  " << std::left << std::setw(24) << "engine" << std::right << std::setw(10)
+              << "Mitems/s" << std::setw(12) << "memory KB" << std::setw(9) << "recall" << std::setw(10)
+              << "relerr" << "\n";
+    bench_engine("exact (flat_hash_map)", stream, threads, [] { return exact_topk<uint64_t>(); }, truth);
+    bench_engine("space_saving m=1024", stream, threads, [] { return space_saving<uint64_t>(1024); },
+                 truth);
+    bench_engine("space_saving m=8192", stream, threads, [] { return space_saving<uint64_t>(8192); },
+                 truth);
+    bench_engine("cms_topk w=2^14 d=4", stream, threads,
+                 [] { return cms_topk<uint64_t>(kTopK, 1 << 14, 4); }, truth);
+    bench_engine("cms_topk w=2^16 d=4", stream, threads,
+                 [] { return cms_topk<uint64_t>(kTopK, 1 << 16, 4); }, truth);
+}
+
+int main(int argc, char** argv) {
+    // 数据流长度和线程数；./container_level18_streaming_topk 100000000 8
+    size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    size_t threads = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 4;
+
+    demo_exact();
+    demo_space_saving();
+    demo_count_min();
+    bench_topk(n, std::max<size_t>(threads, 1));
+    return 0;
+}
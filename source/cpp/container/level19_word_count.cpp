@@ -0,0 +1,225 @@
+// Level 19: 大文本并行词频统计 —— 内存映射 + 字符串驻留 + 每线程哈希表
+// 涵盖：按字节表切词与大小写折叠、Arena 上的字符串池（store / intern）、
+//        flat_hash_map<string_view, uint64_t> 计数与合并、按单词边界切块的多线程统计、
+//        mmap 读文件，以及与 std::map<std::string, int> 的 GB/s 对比
+//
+// 实现见 word_count.h；std::map 的写法见 level5.cpp 的 demo_word_count
+
+#define BENCH_COUNT_ALLOCATIONS
+#include "bench_utils.h"
+#include "word_count.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+void print_top(const std::vector<word_freq>& words, size_t k) {
+    for (size_t i = 0; i < std::min(k, words.size()); i++)
+        std::cout << " " << words[i].word << "=" << words[i].count;
+    std::cout << "\n";
+}
+
+// ============================================================
+// 19.1 切词与大小写折叠
+// ============================================================
+void demo_tokenize() {
+    std::cout << "=== 19.1 for_each_word ===\n";
+
+    std::string text = "The quick brown fox -- THE lazy dog; the fox's 2nd run, naïve café";
+    std::cout << "原文: " << text << "\n切词:";
+    for_each_word(text, [](std::string_view w) { std::cout << " [" << w << "]"; });
+    std::cout << "\n（非 ASCII 字节算单词字符，UTF-8 词保持完整；只折叠 ASCII 大写）\n";
+}
+
+// ============================================================
+// 19.2 string_pool：Arena 上的字符串
+//   std::string 超过 SSO 长度就单独分配一次；pool 里的字符串首尾相接地放在大块内存里
+// ============================================================
+void demo_string_pool() {
+    std::cout << "\n=== 19.2 string_pool ===\n";
+
+    std::vector<std::string> words = {"internationalization", "characterization", "internationalization",
+                                      "responsibilities", "characterization"};
+    auto before = allocSnapshot();
+    std::vector<std::string> copies(words.begin(), words.end());
+    std::cout << "拷贝成 5 个 std::string（超过 SSO 长度）分配次数: "
+              << (allocSnapshot() - before).count << "\n";
+
+    string_pool pool;
+    std::vector<std::string_view> views;
+    for (const auto& w : words) views.push_back(pool.intern(w));
+    std::cout << "intern 后不同的字符串 " << pool.interned() << " 个，占 " << pool.bytes_used()
+              << " 字节；相同内容地址相同: " << (views[0].data() == views[2].data()) << "\n";
+}
+
+// ============================================================
+// 19.3 word_counter 与并行统计
+// ============================================================
+void demo_word_counter() {
+    std::cout << "\n=== 19.3 word_counter ===\n";
+
+    std::string text;
+    for (int i = 0; i < 50; i++) text += "the fox and THE dog. The fox runs; a dog sleeps.\n";
+
+    word_counter single;
+    single.count_text(text);
+    std::cout << "单线程：" << single.total() << " 个词，" << single.distinct() << " 个不同，前 3:";
+    print_top(single.sorted(), 3);
+
+    // 切块只在分隔符处：每段开头和结尾都不会是半个单词
+    auto chunks = split_at_words(text, 4);
+    std::cout << "切成 " << chunks.size() << " 段，长度:";
+    for (auto c : chunks) std::cout << " " << c.size();
+    word_counter merged = count_words_parallel(text, 4);
+    std::cout << "\n4 线程合并：" << merged.total() << " 个词，前 3:";
+    print_top(merged.sorted(), 3);
+}
+
+// ============================================================
+// 19.4 mapped_file
+// ============================================================
+void demo_mapped_file() {
+    std::cout << "\n=== 19.4 mapped_file ===\n";
+
+    auto path = std::filesystem::temp_directory_path() / "level19_demo.txt";
+    std::ofstream(path, std::ios::binary) << "to be or not to be\nthat is the question\n";
+    {
+        mapped_file file(path.string());
+        word_counter wc;
+        wc.count_text(file.view());
+        std::cout << "文件 " << file.size() << " 字节，" << wc.total() << " 个词，前 3:";
+        print_top(wc.sorted(), 3);
+    }
+    std::filesystem::remove(path);
+
+    try {
+        mapped_file missing((path.string() + ".missing"));
+    } catch (const std::system_error& e) {
+        std::cout << "打开不存在的文件: " << e.code().message() << "\n";
+    }
+}
+
+// ============================================================
+// 19.5 Benchmark：合成语料，Zipf(1.0) 分布的 20 万个词表，约 10% 的词首字母大写
+//   先做一遍只切词不计数，把文件页读进页缓存，同时给出切词本身的上限；
+//   GB/s = 文件字节数 / 耗时（多线程含合并）
+// ============================================================
+void write_corpus(const std::filesystem::path& path, size_t bytes) {
+    const size_t vocabSize = 200000;
+    std::mt19937_64 rng(19);
+    std::vector<std::string> vocab(vocabSize);
+    for (auto& w : vocab) {
+        size_t len = 2 + rng() % 5 + rng() % 6;  // 2..11，中间长度更多
+        for (size_t i = 0; i < len; i++) w += char('a' + rng() % 26);
+    }
+
+    std::ofstream out(path, std::ios::binary);
+    std::string buf;
+    size_t written = 0;
+    while (written < bytes) {
+        buf.clear();
+        for (uint64_t r : zipfRanks(100000, vocabSize, 1.0, rng())) {
+            const std::string& w = vocab[r];
+            uint64_t x = rng();
+            buf += w;
+            if (x % 10 == 0) buf[buf.size() - w.size()] -= 'a' - 'A';
+            buf += x % 97 == 0 ? "\n" : x % 13 == 0 ? ", " : x % 17 == 0 ? ". " : " ";
+        }
+        out.write(buf.data(), std::streamsize(buf.size()));
+        written += buf.size();
+    }
+}
+
+template <typename F>
+void bench_row(const char* name, size_t bytes, F&& f) {
+    auto before = allocSnapshot();
+    BenchTimer t;
+    size_t distinct = f();
+    double sec = t.ns() / 1e9;
+    std::cout << "  " << std::left << std::setw(34) << name << std::right << std::fixed
+              << std::setprecision(3) << std::setw(8) << bytes / sec / 1e9 << std::setw(10)
+              << std::setprecision(0) << sec * 1000 << std::setw(10) << distinct << std::setw(12)
+              << (allocSnapshot() - before).count << "\n";
+}
+
+void bench_word_count(const std::string& path, size_t threads) {
+    mapped_file file(path);
+    std::string_view text = file.view();
+    std::cout << "\n=== 19.5 Benchmark：" << path << "，" << text.size() / (1024 * 1024) << " MB，"
+              << threads << " 线程 ===\n";
+    std::cout << "  " << std::left << std::setw(34) << "method" << std::right << std::setw(8) << "GB/s"
+              << std::setw(10) << "ms" << std::setw(10) << "distinct" << std::setw(12) << "allocs"
+              << "\n";
+
+    bench_row("tokenize only", text.size(), [&] {
+        size_t words = 0;
+        for_each_word(text, [&](std::string_view w) { words += w.size() > 0; });
+        doNotOptimize(words);
+        return size_t(0);
+    });
+
+    std::map<std::string, int> freq;
+    bench_row("std::map<string, int>", text.size(), [&] {
+        for_each_word(text, [&](std::string_view w) { freq[std::string(w)]++; });
+        return freq.size();
+    });
+
+    bench_row("std::unordered_map<string, int>", text.size(), [&] {
+        std::unordered_map<std::string, int> u;
+        for_each_word(text, [&](std::string_view w) { u[std::string(w)]++; });
+        return u.size();
+    });
+
+    bench_row("word_counter 1 thread", text.size(), [&] {
+        word_counter wc;
+        wc.count_text(text);
+        return wc.distinct();
+    });
+
+    word_counter parallel;
+    std::string name = "count_words_parallel x" + std::to_string(threads);
+    bench_row(name.c_str(), text.size(), [&] {
+        parallel = count_words_parallel(text, threads);
+        return parallel.distinct();
+    });
+
+    // 与 std::map 的结果逐项核对
+    bool same = parallel.distinct() == freq.size();
+    for (const auto& [w, c] : freq) same = same && parallel.count(w) == uint64_t(c);
+    auto top = parallel.sorted();
+    std::cout << "  结果与 std::map 一致: " << same << "，前 5:";
+    print_top(top, 5);
+}
+
+int main(int argc, char** argv) {
+    // 参数：文本文件路径或合成语料的 MB 数、线程数（默认为 CPU 核数）
+    //   ./container_level19_word_count 4096 8      生成 4 GB 的合成语料
+    //   ./container_level19_word_count enwik9 8    统计已有的文件
+    std::string arg = argc > 1 ? argv[1] : "64";
+    size_t threads =
+        argc > 2 ? std::strtoull(argv[2], nullptr, 10) : std::thread::hardware_concurrency();
+    threads = std::max<size_t>(threads, 1);
+
+    demo_tokenize();
+    demo_string_pool();
+    demo_word_counter();
+    demo_mapped_file();
+
+    if (std::filesystem::is_regular_file(arg)) {
+        bench_word_count(arg, threads);
+        return 0;
+    }
+    auto path = std::filesystem::temp_directory_path() / "level19_corpus.txt";
+    write_corpus(path, std::strtoull(arg.c_str(), nullptr, 10) * 1024 * 1024);
+    bench_word_count(path.string(), threads);
+    std::filesystem::remove(path);
+    return 0;
+}
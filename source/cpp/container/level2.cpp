@@ -21,6 +21,7 @@ void print(const Container& c, const std::string& label = "") {
 //   内部：分段连续内存（多个固定大小缓冲块）
 //   优点：头尾 O(1) 插删；随机访问 O(1)
 //   缺点：中间插删 O(n)；内存不连续（不能用 data() 指针）
+//   块大小可配置、能按连续段访问的版本见 level21_block_deque.cpp
 // ============================================================
 void demo_deque() {
     std::cout << "=== 2.1 std::deque ===\n";
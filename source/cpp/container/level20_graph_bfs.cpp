@@ -0,0 +1,215 @@
+// Level 20: CSR 图与并行 BFS —— 代替 vector<vector<int>> 邻接表 + std::queue
+// 涵盖：由边表构建 CSR（计数排序、去重、去自环）、R-MAT 幂律随机图、
+//        std::queue 串行 BFS、按层同步的并行 BFS（前沿队列 / 前沿位图）、
+//        top-down / bottom-up 方向切换，以及 1..N 线程的 TEPS（每秒遍历边数）对比
+//
+// 实现见 csr_graph.h；树上的 std::queue BFS 见 level3.cpp 的 bfs
+
+#include "bench_utils.h"
+#include "csr_graph.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using V = csr_graph::vertex_type;
+
+// 每个顶点到 source 的层数，未到达为 -1
+std::vector<int> bfs_depths(const csr_graph& g, V source) {
+    std::vector<int> depth(g.vertex_count(), -1);
+    std::queue<V> q;
+    depth[source] = 0;
+    q.push(source);
+    while (!q.empty()) {
+        V u = q.front();
+        q.pop();
+        for (V v : g.neighbors(u))
+            if (depth[v] < 0) {
+                depth[v] = depth[u] + 1;
+                q.push(v);
+            }
+    }
+    return depth;
+}
+
+// 校验 BFS 树（Graph500 的做法）：到达的顶点集合正确，每条树边都存在且恰好跨一层
+bool validate(const csr_graph& g, V source, const bfs_result& r, const std::vector<int>& depth) {
+    if (r.parent[source] != source) return false;
+    for (V v = 0; v < g.vertex_count(); v++) {
+        V p = r.parent[v];
+        if ((p == csr_graph::npos) != (depth[v] < 0)) return false;
+        if (p == csr_graph::npos || v == source) continue;
+        if (!g.has_edge(p, v) || depth[p] + 1 != depth[v]) return false;
+    }
+    return true;
+}
+
+// ============================================================
+// 20.1 csr_graph：两个数组表示整张图
+// ============================================================
+void demo_csr() {
+    std::cout << "=== 20.1 csr_graph ===\n";
+
+    //  0 - 1 - 2
+    //  |   |
+    //  3 - 4   5（孤立）
+    std::vector<csr_graph::edge_type> edges = {{0, 1}, {1, 2}, {0, 3}, {1, 4}, {3, 4}, {4, 3}, {2, 2}};
+    auto g = csr_graph::from_edges(6, edges);
+    std::cout << "顶点 " << g.vertex_count() << "，有向边 " << g.edge_count()
+              << "（重复边和自环已去掉，无向边存两次）\noffsets:";
+    for (auto o : g.offsets()) std::cout << " " << o;
+    std::cout << "\ntargets:";
+    for (auto t : g.targets()) std::cout << " " << t;
+    std::cout << "\nneighbors(1):";
+    for (V v : g.neighbors(1)) std::cout << " " << v;
+    std::cout << "  degree(5)=" << g.degree(5) << "  has_edge(3, 4)=" << g.has_edge(3, 4) << "\n";
+}
+
+// ============================================================
+// 20.2 串行与并行 BFS 得到的都是合法的 BFS 树
+//   同一层的顶点可能被不同的父节点抢到，parent 不一定相同，但层数一定相同
+// ============================================================
+void demo_bfs() {
+    std::cout << "\n=== 20.2 bfs_queue / bfs_parallel ===\n";
+
+    // 4x4 网格
+    std::vector<csr_graph::edge_type> edges;
+    for (V r = 0; r < 4; r++)
+        for (V c = 0; c < 4; c++) {
+            if (c + 1 < 4) edges.push_back({r * 4 + c, r * 4 + c + 1});
+            if (r + 1 < 4) edges.push_back({r * 4 + c, (r + 1) * 4 + c});
+        }
+    auto g = csr_graph::from_edges(16, edges);
+
+    auto seq = bfs_queue(g, 0);
+    auto par = bfs_parallel(g, 0, {.threads = 3});
+    auto depth = bfs_depths(g, 0);
+    std::cout << "4x4 网格从角上出发：层数 " << seq.levels << " / " << par.levels << "，到达 "
+              << seq.reached << " / " << par.reached << "，并行结果合法=" << validate(g, 0, par, depth)
+              << "\n";
+    std::cout << "parent(15)：串行 " << seq.parent[15] << "，并行 " << par.parent[15] << "\n";
+}
+
+// ============================================================
+// 20.3 方向切换
+//   幂律图直径小：两三层之后前沿就覆盖了大部分边，这时 bottom-up 每个顶点找到一个父节点就停，
+//   比 top-down 把前沿的每条边都试一遍省得多
+// ============================================================
+void demo_direction() {
+    std::cout << "\n=== 20.3 top-down / bottom-up 切换 ===\n";
+
+    auto edges = rmat_edges(14, 16, 3);
+    auto g = csr_graph::from_edges(size_t(1) << 14, edges);
+    V source = 0;
+    while (g.degree(source) == 0) source++;
+    auto depth = bfs_depths(g, source);
+    for (bool dirOpt : {false, true}) {
+        auto r = bfs_parallel(g, source, {.threads = 2, .direction_optimizing = dirOpt});
+        std::cout << (dirOpt ? "direction-optimizing" : "top-down only       ") << "：" << r.levels
+                  << " 层，其中 bottom-up " << r.bottom_up_levels << " 层，到达 " << r.reached
+                  << " 个顶点，合法=" << validate(g, source, r, depth) << "\n";
+    }
+}
+
+// ============================================================
+// 20.4 Benchmark：R-MAT 图（Graph500 参数 a=0.57 b=c=0.19，平均度 2 x edgeFactor）
+//   每种方法从同样的 8 个随机起点各跑一次；TEPS = 到达顶点的度数和 / 2 / 耗时（Graph500 口径）
+//   vector<vector> 行：同样的 std::queue BFS，但邻接表是每个顶点一个 vector
+// ============================================================
+template <typename F>
+void bench_row(const std::string& name, const std::vector<V>& sources, const csr_graph& g, F&& bfs) {
+    double sec = 0;
+    uint64_t edges = 0;
+    for (V s : sources) {
+        BenchTimer t;
+        bfs_result r = bfs(s);
+        sec += t.ns() / 1e9;
+        for (V v = 0; v < g.vertex_count(); v++)
+            if (r.parent[v] != csr_graph::npos) edges += g.degree(v);
+        doNotOptimize(r.parent.data());
+    }
+    edges /= 2;
+    std::cout << "  " << std::left << std::setw(30) << name << std::right << std::fixed
+              << std::setprecision(2) << std::setw(10) << sec / sources.size() * 1000 << std::setw(10)
+              << edges / sec / 1e6 << "\n";
+}
+
+void bench_bfs(unsigned scale, size_t edgeFactor, size_t maxThreads) {
+    size_t n = size_t(1) << scale;
+    std::cout << "\n=== 20.4 Benchmark：R-MAT scale " << scale << "（" << n << " 个顶点），edgeFactor "
+              << edgeFactor << " ===\n";
+
+    BenchTimer t;
+    auto edges = rmat_edges(scale, edgeFactor, 1);
+    auto g = csr_graph::from_edges(n, edges);
+    edges = {};
+    std::cout << "  构建 " << std::fixed << std::setprecision(0) << t.ms() << " ms，去重后有向边 "
+              << g.edge_count() << "，CSR " << g.memory_usage() / (1024 * 1024) << " MB\n";
+
+    std::vector<std::vector<V>> adj(n);
+    for (V v = 0; v < n; v++) adj[v].assign(g.neighbors(v).begin(), g.neighbors(v).end());
+
+    std::mt19937_64 rng(20);
+    std::vector<V> sources;
+    while (sources.size() < 8) {
+        V s = V(rng() % n);
+        if (g.degree(s) > 0) sources.push_back(s);
+    }
+    auto depth = bfs_depths(g, sources[0]);
+
+    std::cout << "  " << std::left << std::setw(30) << "method" << std::right << std::setw(10) << "ms"
+              << std::setw(10) << "MTEPS" << "\n";
+    bench_row("std::queue, vector<vector>", sources, g, [&](V s) {
+        bfs_result r;
+        r.parent.assign(n, csr_graph::npos);
+        std::queue<V> q;
+        r.parent[s] = s;
+        q.push(s);
+        while (!q.empty()) {
+            V u = q.front();
+            q.pop();
+            for (V v : adj[u])
+                if (r.parent[v] == csr_graph::npos) {
+                    r.parent[v] = u;
+                    q.push(v);
+                }
+        }
+        return r;
+    });
+    bench_row("std::queue, csr_graph", sources, g, [&](V s) { return bfs_queue(g, s); });
+
+    std::vector<size_t> threadCounts;
+    for (size_t th = 1; th < maxThreads; th *= 2) threadCounts.push_back(th);
+    threadCounts.push_back(maxThreads);
+    for (bool dirOpt : {false, true}) {
+        for (size_t th : threadCounts) {
+            bfs_options opt{.threads = th, .direction_optimizing = dirOpt};
+            std::string name =
+                std::string(dirOpt ? "direction-optimizing" : "top-down") + " x" + std::to_string(th);
+            bench_row(name, sources, g, [&](V s) { return bfs_parallel(g, s, opt); });
+        }
+    }
+
+    auto check = bfs_parallel(g, sources[0], {.threads = maxThreads});
+    std::cout << "  " << check.levels << " 层（bottom-up " << check.bottom_up_levels << " 层），到达 "
+              << check.reached << " 个顶点，结果合法=" << validate(g, sources[0], check, depth) << "\n";
+}
+
+int main(int argc, char** argv) {
+    // R-MAT 规模（2^scale 个顶点）、edgeFactor、最大线程数（默认 CPU 核数）
+    //   ./container_level20_graph_bfs 24 16 16    约 2.7 亿条有向边
+    unsigned scale = argc > 1 ? unsigned(std::strtoul(argv[1], nullptr, 10)) : 18;
+    size_t edgeFactor = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 16;
+    size_t threads =
+        argc > 3 ? std::strtoull(argv[3], nullptr, 10) : std::thread::hardware_concurrency();
+
+    demo_csr();
+    demo_bfs();
+    demo_direction();
+    bench_bfs(scale, edgeFactor, std::max<size_t>(threads, 1));
+    return 0;
+}
@@ -0,0 +1,208 @@
+// Level 21: block_deque —— 块大小可配置、可按连续段处理的双端队列
+// 涵盖：块大小与 std::deque 的对比、segments() 把内部的连续段交给 std::span 接口、
+//        环形块指针表与备用块（队列稳定后零分配）、引用稳定性，
+//        以及两端插删、按迭代器遍历、按段遍历与 std::deque / std::vector 的对比
+//
+// 实现见 block_deque.h；std::deque 的基本用法见 level2.cpp，std::span 见 level7.cpp
+
+#define BENCH_COUNT_ALLOCATIONS
+#include "bench_utils.h"
+#include "block_deque.h"
+
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <numeric>
+#include <span>
+#include <string>
+#include <vector>
+
+// 256 字节的记录：libstdc++ 的 std::deque 每个 512 字节的块只能放 2 个
+struct Record {
+    uint64_t id;
+    uint64_t payload[31];
+};
+
+// level7 风格的 span 消费者：只关心"一段连续的 int"
+long long sum_span(std::span<const int> s) { return std::accumulate(s.begin(), s.end(), 0LL); }
+
+// ============================================================
+// 21.1 基本操作与块大小
+// ============================================================
+void demo_basic() {
+    std::cout << "=== 21.1 block_deque 基础 ===\n";
+
+    block_deque<int> dq = {3, 4, 5};
+    dq.push_front(2);
+    dq.push_front(1);
+    dq.push_back(6);
+    dq.pop_back();
+    std::cout << "内容:";
+    for (int x : dq) std::cout << " " << x;
+    std::cout << "  front=" << dq.front() << " back=" << dq.back() << " dq[2]=" << dq[2] << "\n";
+
+    std::cout << "每块元素数：block_deque<int> " << block_deque<int>::block_size
+              << "，block_deque<Record> " << block_deque<Record>::block_size
+              << "；libstdc++ std::deque 固定 512 字节，即 int " << 512 / sizeof(int) << "、Record "
+              << std::max<size_t>(1, 512 / sizeof(Record)) << "\n";
+
+    block_deque<Record, 4> small;  // 也可以显式指定块大小
+    for (uint64_t i = 0; i < 10; i++) small.push_back({i, {}});
+    std::cout << "block_deque<Record, 4> 放 10 个：" << small.segment_count() << " 段，"
+              << small.memory_usage() << " 字节\n";
+}
+
+// ============================================================
+// 21.2 按连续段处理
+//   每段是一个 std::span：可以交给任何接受 span 的函数，循环体里是纯指针访问，编译器能向量化
+// ============================================================
+void demo_segments() {
+    std::cout << "\n=== 21.2 segments() ===\n";
+
+    block_deque<int, 8> dq;
+    for (int i = 0; i < 20; i++) dq.push_back(i);
+    for (int i = 1; i <= 5; i++) dq.push_front(-i);
+    std::cout << "25 个元素、每块 8 个，段长度:";
+    for (std::span<const int> s : dq.segments()) std::cout << " " << s.size();
+
+    long long total = 0;
+    for (auto s : dq.segments()) total += sum_span(s);
+    std::cout << "\n按段求和=" << total << "，逐个求和=" << std::accumulate(dq.begin(), dq.end(), 0LL)
+              << "\n";
+
+    for (std::span<int> s : dq.segments())
+        for (int& x : s) x *= 10;  // 可写
+    std::cout << "按段乘 10 后 dq[0]=" << dq[0] << " dq[24]=" << dq[24] << "\n";
+}
+
+// ============================================================
+// 21.3 引用稳定与零分配的队列
+//   块从不移动：两端插删后，已有元素的引用仍然有效（vector 扩容会让它们失效）
+//   "尾进头出"时，队头空出的块被留作备用，队尾要新块时直接拿来用
+// ============================================================
+void demo_queue() {
+    std::cout << "\n=== 21.3 引用稳定与备用块 ===\n";
+
+    block_deque<std::string> names;
+    names.push_back("alice");
+    std::string& first = names.front();
+    for (int i = 0; i < 1000; i++) names.push_front("user" + std::to_string(i));
+    std::cout << "两端插入 1000 个后，之前取得的引用仍指向: " << first << "\n";
+
+    auto run = [](auto& q, const char* name) {
+        for (int i = 0; i < 1000; i++) q.push_back(i);
+        auto before = allocSnapshot();
+        for (int i = 0; i < 100000; i++) {
+            q.push_back(i);
+            q.pop_front();
+        }
+        std::cout << "  " << name << "：长度 1000 的队列做 10 万次 push_back + pop_front，分配 "
+                  << (allocSnapshot() - before).count << " 次\n";
+    };
+    std::deque<int> sd;
+    block_deque<int> bd;
+    run(sd, "std::deque ");
+    run(bd, "block_deque");
+}
+
+// ============================================================
+// 21.4 Benchmark（ns / 元素）
+//   push_back / push_front：从空开始插入 n 个；pop_front：把 n 个全部从队头弹出
+//   iter scan：范围 for 求和；seg scan：按 segments() 求和（vector 即对 data() 的连续循环）
+// ============================================================
+template <typename T>
+uint64_t key(const T& x) {
+    if constexpr (std::is_same_v<T, Record>) return x.id;
+    else return uint64_t(x);
+}
+
+template <typename T>
+T make(size_t i) {
+    if constexpr (std::is_same_v<T, Record>) return Record{i, {}};
+    else return T(i);
+}
+
+void cell(double ns) {
+    if (ns < 0) std::cout << std::setw(12) << "-";
+    else std::cout << std::setw(12) << std::fixed << std::setprecision(2) << ns;
+}
+
+template <typename T, typename C>
+void bench_container(const char* name, size_t n, size_t reps) {
+    constexpr bool kHasFront = requires(C c) { c.push_front(T{}); };
+    double pushBack = 0, pushFront = -1, popFront = -1, iterScan = 0, segScan = -1;
+
+    for (size_t r = 0; r < reps; r++) {
+        C c;
+        BenchTimer t;
+        for (size_t i = 0; i < n; i++) c.push_back(make<T>(i));
+        pushBack += t.ns() / n;
+
+        t.reset();
+        uint64_t s = 0;
+        for (const auto& x : c) s += key(x);
+        iterScan += t.ns() / n;
+        doNotOptimize(s);
+
+        t.reset();
+        s = 0;
+        if constexpr (requires { c.segments(); }) {
+            for (auto seg : c.segments())
+                for (const auto& x : seg) s += key(x);
+            segScan = (segScan < 0 ? 0 : segScan) + t.ns() / n;
+        } else if constexpr (requires { c.data(); }) {
+            std::span<const T> all(c.data(), c.size());
+            for (const auto& x : all) s += key(x);
+            segScan = (segScan < 0 ? 0 : segScan) + t.ns() / n;
+        }
+        doNotOptimize(s);
+
+        if constexpr (kHasFront) {
+            t.reset();
+            while (!c.empty()) c.pop_front();
+            popFront = (popFront < 0 ? 0 : popFront) + t.ns() / n;
+
+            C f;
+            t.reset();
+            for (size_t i = 0; i < n; i++) f.push_front(make<T>(i));
+            pushFront = (pushFront < 0 ? 0 : pushFront) + t.ns() / n;
+        }
+    }
+
+    auto avg = [&](double v) { return v < 0 ? v : v / reps; };
+    std::cout << "  " << std::left << std::setw(22) << name << std::right;
+    cell(avg(pushBack));
+    cell(avg(pushFront));
+    cell(avg(popFront));
+    cell(avg(iterScan));
+    cell(avg(segScan));
+    std::cout << "\n";
+}
+
+template <typename T>
+void bench_type(const char* typeName, size_t n, size_t reps) {
+    std::cout << "  [" << typeName << "，n=" << n << "]\n";
+    bench_container<T, std::vector<T>>("std::vector", n, reps);
+    bench_container<T, std::deque<T>>("std::deque", n, reps);
+    bench_container<T, block_deque<T>>("block_deque", n, reps);
+}
+
+void bench_deque(size_t n) {
+    std::cout << "\n=== 21.4 Benchmark（ns / 元素）===\n";
+    std::cout << "  " << std::left << std::setw(22) << "container" << std::right << std::setw(12)
+              << "push_back" << std::setw(12) << "push_front" << std::setw(12) << "pop_front"
+              << std::setw(12) << "iter scan" << std::setw(12) << "seg scan" << "\n";
+    bench_type<int>("int", n, 5);
+    bench_type<Record>("Record 256B", n / 16, 5);
+}
+
+int main(int argc, char** argv) {
+    // 元素个数（Record 用 n / 16）；./container_level21_block_deque 10000000
+    size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    demo_basic();
+    demo_segments();
+    demo_queue();
+    bench_deque(std::max<size_t>(n, 16));
+    return 0;
+}
@@ -0,0 +1,291 @@
+// Level 22: roaring_bitmap —— 压缩位图表示的整数集合
+// 涵盖：按高 16 位分块、array / bitmap / run 三种块表示及自动切换、run_optimize、
+//        SIMD 的并 / 交 / 差与只计数的交集、rank / select，
+//        以及稀疏 / 稠密 / 成段三种 ID 分布下与 std::set、有序 vector + std::set_* 的内存和速度对比
+//
+// 实现见 roaring.h；std::set 见 level4.cpp，有序区间上的 set_union / set_intersection
+// 见 algorithm/level6.cpp
+
+#define BENCH_COUNT_ALLOCATIONS
+#include "bench_utils.h"
+#include "roaring.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+void print_stats(const char* name, const roaring_bitmap& r) {
+    roaring_stats s = r.chunk_stats();
+    std::cout << "  " << name << "：" << r.size() << " 个元素，array " << s.array_chunks
+              << " 块、bitmap " << s.bitmap_chunks << " 块、run " << s.run_chunks << " 块，"
+              << r.memory_usage() << " 字节\n";
+}
+
+// ============================================================
+// 22.1 基础操作
+// ============================================================
+void demo_basic() {
+    std::cout << "=== 22.1 roaring_bitmap 基础 ===\n";
+
+    roaring_bitmap r = {5, 1, 70000, 3, 1u << 31};
+    r.add(2);
+    r.remove(3);
+    std::cout << "内容:";
+    for (uint32_t x : r) std::cout << " " << x;
+    std::cout << "\nsize=" << r.size() << " contains(70000)=" << r.contains(70000)
+              << " contains(3)=" << r.contains(3) << " min=" << r.minimum()
+              << " max=" << r.maximum() << "\n";
+
+    // rank(x)：<= x 的元素个数；select(k)：第 k 小（从 0 开始）。两者互逆
+    std::cout << "rank(5)=" << r.rank(5) << " rank(69999)=" << r.rank(69999)
+              << " select(0)=" << r.select(0) << " select(3)=" << r.select(3) << "\n";
+    try {
+        r.select(r.size());
+    } catch (const std::out_of_range& e) {
+        std::cout << "select(size()) 抛出: " << e.what() << "\n";
+    }
+}
+
+// ============================================================
+// 22.2 三种块表示
+//   每块（高 16 位相同的 65536 个值）按元素分布选最省的表示：
+//   少量散点 -> array（2 字节 / 个），一半以上 -> bitmap（固定 8KB），连续段 -> run（4 字节 / 段）
+// ============================================================
+void demo_chunks() {
+    std::cout << "\n=== 22.2 array / bitmap / run ===\n";
+
+    roaring_bitmap sparse, dense, runs;
+    for (uint32_t i = 0; i < 1000; i++) sparse.add(i * 97);
+    for (uint32_t i = 0; i < 65536; i += 2) dense.add(i);
+    for (uint32_t i = 0; i < 65536; i++)
+        if (i % 10000 < 5000) runs.add(i);
+    print_stats("每隔 97 取一个", sparse);
+    print_stats("每隔 2 取一个 ", dense);
+    print_stats("5000 个一段  ", runs);
+    runs.run_optimize();
+    print_stats("run_optimize 后", runs);
+
+    // bitmap 块删到 4096 个以下自动转回 array
+    for (uint32_t i = 0; i < 65536 - 2 * 4000; i += 2) dense.remove(i);
+    print_stats("删到剩 4000 个", dense);
+
+    roaring_bitmap range;
+    range.add_range(100, 300000);
+    print_stats("add_range(100, 300000)", range);
+}
+
+// ============================================================
+// 22.3 集合运算
+//   与 algorithm/level6.cpp 的 std::set_union / set_intersection / set_difference 结果相同，
+//   但按块进行：bitmap 与 bitmap 一次处理 128 位，不用逐个元素比较
+// ============================================================
+void demo_set_ops() {
+    std::cout << "\n=== 22.3 集合运算 ===\n";
+
+    roaring_bitmap a = {1, 2, 3, 4, 5, 100000}, b = {4, 5, 6, 7, 100000, 200000};
+    auto show = [](const char* name, const roaring_bitmap& r) {
+        std::cout << "  " << name << ":";
+        for (uint32_t x : r) std::cout << " " << x;
+        std::cout << "\n";
+    };
+    show("A | B", a | b);
+    show("A & B", a & b);
+    show("A - B", a - b);
+    std::cout << "  |A & B| = " << a.intersection_cardinality(b) << "（只计数，不生成交集）\n";
+
+    roaring_bitmap evens, threes;
+    for (uint32_t i = 0; i < 1000000; i += 2) evens.add(i);
+    for (uint32_t i = 0; i < 1000000; i += 3) threes.add(i);
+    roaring_bitmap six = evens & threes;
+    std::cout << "  [0, 1e6) 中 2 的倍数 ∩ 3 的倍数：" << six.size() << " 个，第 1000 个是 "
+              << six.select(999) << "\n";
+}
+
+// ============================================================
+// 22.4 Benchmark：两个各 n 个元素的集合 A、B
+//   sparse   ：[0, 64n) 中均匀随机取（密度 1/64，全是 array 块）
+//   dense    ：[0, 2n) 中均匀随机取（密度 1/2，全是 bitmap 块）
+//   clustered：长度 1..2000 的连续段，段间空隙 1..2000（run_optimize 后是 run 块）
+//   B/elem：A 占用的字节数 / n；其余列为一次运算的毫秒数，contains 为每次查找的纳秒数
+//   std::set 的运算结果写进 std::set（inserter），有序 vector 的写进预留好的 vector；
+//   std::set 只跑一次，其余取 5 次中最快的一次
+// ============================================================
+std::vector<uint32_t> make_ids(const std::string& dist, size_t n, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<uint32_t> out;
+    if (dist == "clustered") {
+        uint32_t x = 0;
+        while (out.size() < n) {
+            x += uint32_t(1 + rng() % 2000);
+            for (uint32_t len = uint32_t(1 + rng() % 2000); len > 0 && out.size() < n; len--)
+                out.push_back(x++);
+        }
+        return out;
+    }
+    uint64_t universe = dist == "sparse" ? 64 * uint64_t(n) : 2 * uint64_t(n);
+    std::vector<uint8_t> seen(universe);
+    while (out.size() < n) {
+        uint64_t x = rng() % universe;
+        if (!seen[x]) {
+            seen[x] = 1;
+            out.push_back(uint32_t(x));
+        }
+    }
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+// 只数个数的输出迭代器：std::set_intersection 写到这里即为"只求交集大小"
+struct count_output {
+    using iterator_category = std::output_iterator_tag;
+    using value_type = void;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = void;
+
+    size_t* n;
+    count_output& operator*() { return *this; }
+    count_output& operator++() { return *this; }
+    count_output& operator++(int) { return *this; }
+    count_output& operator=(uint32_t) {
+        ++*n;
+        return *this;
+    }
+};
+
+// reps 次中最快的一次
+template <typename F>
+double time_ms(int reps, F&& f) {
+    double best = 1e300;
+    for (int r = 0; r < reps; r++) {
+        BenchTimer t;
+        f();
+        best = std::min(best, t.ms());
+    }
+    return best;
+}
+
+void print_row(const char* name, double bytesPerElem, double unionMs, double interMs, double diffMs,
+               double cardMs, double containsNs, size_t unionSize) {
+    std::cout << "  " << std::left << std::setw(16) << name << std::right << std::fixed
+              << std::setprecision(2) << std::setw(8) << bytesPerElem << std::setw(10) << unionMs
+              << std::setw(10) << interMs << std::setw(10) << diffMs << std::setw(10) << cardMs
+              << std::setw(10) << containsNs << std::setw(10) << unionSize << "\n";
+}
+
+void bench_distribution(const std::string& dist, size_t n) {
+    auto va = make_ids(dist, n, 1), vb = make_ids(dist, n, 2);
+    std::mt19937_64 rng(3);
+    std::vector<uint32_t> probes(1000000);
+    for (auto& p : probes) p = uint32_t(rng() % (uint64_t(va.back()) + 1));
+
+    std::cout << "  [" << dist << "，n=" << n << "]\n";
+
+    // std::set
+    {
+        auto before = allocSnapshot();
+        std::set<uint32_t> a(va.begin(), va.end());
+        double bytes = double((allocSnapshot() - before).liveBytes + sizeof(a)) / n;
+        std::set<uint32_t> b(vb.begin(), vb.end());
+        std::set<uint32_t> u, in, d;
+        size_t card = 0, hits = 0;
+        double mu = time_ms(1, [&] {
+            std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::inserter(u, u.end()));
+        });
+        double mi = time_ms(1, [&] {
+            std::set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                                  std::inserter(in, in.end()));
+        });
+        double md = time_ms(1, [&] {
+            std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::inserter(d, d.end()));
+        });
+        double mc = time_ms(1, [&] {
+            std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), count_output{&card});
+        });
+        double ns = time_ms(1, [&] {
+            for (uint32_t p : probes) hits += a.count(p);
+        }) * 1e6 / probes.size();
+        doNotOptimize(hits);
+        doNotOptimize(card);
+        print_row("std::set", bytes, mu, mi, md, mc, ns, u.size());
+    }
+
+    // 有序 vector + std::set_*
+    {
+        std::vector<uint32_t> u, in, d;
+        u.reserve(2 * n);
+        in.reserve(n);
+        d.reserve(n);
+        size_t card = 0, hits = 0;
+        double mu = time_ms(5, [&] {
+            u.clear();
+            std::set_union(va.begin(), va.end(), vb.begin(), vb.end(), std::back_inserter(u));
+        });
+        double mi = time_ms(5, [&] {
+            in.clear();
+            std::set_intersection(va.begin(), va.end(), vb.begin(), vb.end(),
+                                  std::back_inserter(in));
+        });
+        double md = time_ms(5, [&] {
+            d.clear();
+            std::set_difference(va.begin(), va.end(), vb.begin(), vb.end(), std::back_inserter(d));
+        });
+        double mc = time_ms(5, [&] {
+            card = 0;
+            std::set_intersection(va.begin(), va.end(), vb.begin(), vb.end(), count_output{&card});
+        });
+        double ns = time_ms(1, [&] {
+            for (uint32_t p : probes) hits += std::binary_search(va.begin(), va.end(), p);
+        }) * 1e6 / probes.size();
+        doNotOptimize(hits);
+        doNotOptimize(card);
+        print_row("sorted vector", 4.0, mu, mi, md, mc, ns, u.size());
+    }
+
+    // roaring_bitmap：run_optimize 只在成段的分布下会换成 run 块
+    {
+        roaring_bitmap a(va.begin(), va.end()), b(vb.begin(), vb.end());
+        a.run_optimize();
+        b.run_optimize();
+        roaring_bitmap u, in, d;
+        size_t card = 0, hits = 0;
+        double mu = time_ms(5, [&] { u = a | b; });
+        double mi = time_ms(5, [&] { in = a & b; });
+        double md = time_ms(5, [&] { d = a - b; });
+        double mc = time_ms(5, [&] { card = a.intersection_cardinality(b); });
+        double ns = time_ms(1, [&] {
+            for (uint32_t p : probes) hits += a.contains(p);
+        }) * 1e6 / probes.size();
+        doNotOptimize(hits);
+        doNotOptimize(card);
+        print_row("roaring_bitmap", double(a.memory_usage()) / n, mu, mi, md, mc, ns, u.size());
+        roaring_stats s = a.chunk_stats();
+        std::cout << "  " << std::setw(16) << "" << "（A：array " << s.array_chunks
+                  << " 块、bitmap " << s.bitmap_chunks << " 块、run " << s.run_chunks << " 块）\n";
+    }
+}
+
+void bench_roaring(size_t n) {
+    std::cout << "\n=== 22.4 Benchmark ===\n";
+    std::cout << "  " << std::left << std::setw(16) << "method" << std::right << std::setw(8)
+              << "B/elem" << std::setw(10) << "union" << std::setw(10) << "inter" << std::setw(10)
+              << "diff" << std::setw(10) << "inter cnt" << std::setw(10) << "contains"
+              << std::setw(10) << "|A u B|" << "\n";
+    for (const char* dist : {"sparse", "dense", "clustered"}) bench_distribution(dist, n);
+}
+
+int main(int argc, char** argv) {
+    // 每个集合的元素个数；./container_level22_roaring 10000000
+    size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    demo_basic();
+    demo_chunks();
+    demo_set_ops();
+    bench_roaring(std::max<size_t>(n, 16));
+    return 0;
+}
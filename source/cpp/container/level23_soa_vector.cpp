@@ -0,0 +1,228 @@
+// Level 23: soa_vector —— 按字段分列存储的 vector（结构数组，SoA）
+// 涵盖：AoS 与 SoA 的内存布局、field<I>() 按列取 std::span、代理引用与结构化绑定、
+//        std::sort / std::stable_sort / std::lower_bound 直接作用于 soa_vector、
+//        按下标排序再整列重排，
+//        以及单字段扫描、多字段排序、二分查找与 std::vector<struct> 的对比
+//
+// 实现见 soa_vector.h；vector<Student> 的排序见 algorithm/level4.cpp 的 demo_struct_sort，
+// 结构体上的二分查找见 algorithm/level5.cpp
+
+#include "bench_utils.h"
+#include "soa_vector.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+// algorithm/level4.cpp 里的 Student（AoS）
+struct Student {
+    std::string name;
+    int score;
+    int age;
+};
+
+// 同样的三个字段按列存放；枚举给列起名字
+enum StudentField { Name, Score, Age };
+using Students = soa_vector<std::string, int, int>;
+
+void print(const Students& s) {
+    for (auto [name, score, age] : s)
+        std::cout << "  " << name << " score=" << score << " age=" << age << "\n";
+}
+
+// level7 风格的 span 消费者：只关心"一段连续的 int"
+double average(std::span<const int> xs) {
+    return xs.empty() ? 0 : double(std::accumulate(xs.begin(), xs.end(), 0LL)) / double(xs.size());
+}
+
+// ============================================================
+// 23.1 基本用法
+// ============================================================
+void demo_basic() {
+    std::cout << "=== 23.1 soa_vector 基础 ===\n";
+
+    std::vector<Student> aos = {
+        {"Alice", 90, 20}, {"Bob", 85, 22}, {"Carol", 90, 19}, {"Dave", 85, 21}};
+    Students soa;
+    for (const auto& s : aos) soa.emplace_back(s.name, s.score, s.age);  // 每个字段一个参数
+    soa.push_back({"Eve", 95, 20});                                    // 或者一个 tuple
+
+    // 一行是代理引用：结构化绑定得到各字段的引用，可以直接修改
+    auto [name, score, age] = soa[1];
+    score += 3;
+    std::cout << "soa[1]: " << name << " 改分后 score=" << get<Score>(soa[1]) << "\n";
+
+    // 整列是 std::span
+    std::cout << "平均分 " << average(soa.field<Score>()) << "，平均年龄 "
+              << average(soa.field<Age>()) << "\n";
+    std::cout << "score 列相邻元素的地址差 "
+              << reinterpret_cast<const char*>(&soa.field<Score>()[1]) -
+                     reinterpret_cast<const char*>(&soa.field<Score>()[0])
+              << " 字节（vector<Student> 中是 sizeof(Student) = " << sizeof(Student) << "）\n";
+}
+
+// ============================================================
+// 23.2 标准算法照常可用
+//   比较器写成 const auto& 参数：算法有时拿代理行比，有时拿 std::tuple 的临时值比，
+//   get<I> 两者都支持
+// ============================================================
+void demo_algorithms() {
+    std::cout << "\n=== 23.2 std::stable_sort / std::lower_bound ===\n";
+
+    Students s = {{"Alice", 90, 20}, {"Bob", 85, 22}, {"Carol", 90, 19}, {"Dave", 85, 21}};
+
+    // 与 algorithm/level4.cpp 相同：先按分数降序，分数相同按年龄升序
+    auto byScoreThenAge = [](const auto& a, const auto& b) {
+        if (get<Score>(a) != get<Score>(b)) return get<Score>(a) > get<Score>(b);
+        return get<Age>(a) < get<Age>(b);
+    };
+    std::stable_sort(s.begin(), s.end(), byScoreThenAge);
+    std::cout << "std::stable_sort:\n";
+    print(s);
+
+    // 按年龄排序后二分查找：两种写法结果相同
+    s.sort([](const auto& a, const auto& b) { return get<Age>(a) < get<Age>(b); });
+    auto it = std::lower_bound(s.begin(), s.end(), 21,
+                               [](const auto& row, int age) { return get<Age>(row) < age; });
+    auto ages = s.field<Age>();
+    auto pos = std::lower_bound(ages.begin(), ages.end(), 21) - ages.begin();
+    std::cout << "第一个 age >= 21：" << get<Name>(*it) << "（下标 " << it - s.begin()
+              << "，只在 age 列上二分得到 " << pos << "）\n";
+}
+
+// ============================================================
+// 23.3 Benchmark（ns / 元素）
+//   Row 是 64 字节的记录；soa_vector 的五列与它一一对应
+//   sum score：对一个字段求和；filter：按两个字段计数；
+//   sort：按 (grade 升序, score 降序) 排序；lower_bound：按 id 有序后每次查找的 ns
+//   proxy 行：std::sort / std::lower_bound 直接用代理迭代器；sort/field 行：soa_vector::sort()
+//   与在 id 列上二分。扫描和二分只碰到需要的列，SoA 快得多；排序时一次比较要到两列里各取一次、
+//   一次移动要写五列，整行挨在一起的 AoS 反而更快——排序多于扫描的数据不适合拆成列
+// ============================================================
+struct Row {
+    uint64_t id;
+    int32_t score;
+    int32_t age;
+    int32_t grade;
+    std::array<char, 44> name;
+};
+static_assert(sizeof(Row) == 64);
+
+enum RowField { Id, RScore, RAge, RGrade, RName };
+using Rows = soa_vector<uint64_t, int32_t, int32_t, int32_t, std::array<char, 44>>;
+
+void cell(double ns) { std::cout << std::setw(12) << std::fixed << std::setprecision(2) << ns; }
+
+template <typename F>
+double per_elem(size_t n, F&& f) {
+    BenchTimer t;
+    f();
+    return t.ns() / double(n);
+}
+
+void bench_soa(size_t n) {
+    std::cout << "\n=== 23.3 Benchmark（n=" << n << "，ns / 元素）===\n";
+    std::cout << "  " << std::left << std::setw(30) << "method" << std::right << std::setw(12)
+              << "sum score" << std::setw(12) << "filter" << std::setw(12) << "sort"
+              << std::setw(12) << "lower_bound" << "\n";
+
+    std::mt19937_64 rng(23);
+    std::vector<Row> aos(n);
+    Rows soa;
+    soa.reserve(n);
+    for (auto& r : aos) {
+        r = {rng(), int32_t(rng() % 100), int32_t(16 + rng() % 10), int32_t(rng() % 12), {}};
+        soa.emplace_back(r.id, r.score, r.age, r.grade, r.name);
+    }
+    std::vector<uint64_t> probes(std::min<size_t>(n, 1000000));
+    for (auto& p : probes) p = aos[rng() % n].id;
+
+    auto aosCmp = [](const Row& a, const Row& b) {
+        return a.grade != b.grade ? a.grade < b.grade : a.score > b.score;
+    };
+    auto soaCmp = [](const auto& a, const auto& b) {
+        return get<RGrade>(a) != get<RGrade>(b) ? get<RGrade>(a) < get<RGrade>(b)
+                                                : get<RScore>(a) > get<RScore>(b);
+    };
+
+    // ---------- vector<Row> ----------
+    {
+        long long sum = 0;
+        size_t cnt = 0, found = 0;
+        std::vector<Row> v = aos;
+        double scan = per_elem(n, [&] {
+            for (const Row& r : v) sum += r.score;
+        });
+        double filter = per_elem(n, [&] {
+            for (const Row& r : v) cnt += (r.age >= 20) & (r.grade == 3);
+        });
+        double sort = per_elem(n, [&] { std::sort(v.begin(), v.end(), aosCmp); });
+        std::sort(v.begin(), v.end(), [](const Row& a, const Row& b) { return a.id < b.id; });
+        double search = per_elem(probes.size(), [&] {
+            for (uint64_t p : probes)
+                found += std::lower_bound(v.begin(), v.end(), p,
+                                          [](const Row& r, uint64_t id) { return r.id < id; })
+                             ->score;
+        });
+        doNotOptimize(sum + static_cast<long long>(cnt + found));
+        std::cout << "  " << std::left << std::setw(30) << "std::vector<Row>" << std::right;
+        cell(scan), cell(filter), cell(sort), cell(search);
+        std::cout << "\n";
+    }
+
+    // ---------- soa_vector ----------
+    auto runSoa = [&](const char* name, bool proxySort) {
+        long long sum = 0;
+        size_t cnt = 0, found = 0;
+        Rows v = soa;
+        double scan = per_elem(n, [&] {
+            for (int32_t s : v.field<RScore>()) sum += s;
+        });
+        double filter = per_elem(n, [&] {
+            auto age = v.field<RAge>();
+            auto grade = v.field<RGrade>();
+            for (size_t i = 0; i < age.size(); i++) cnt += (age[i] >= 20) & (grade[i] == 3);
+        });
+        double sort = per_elem(n, [&] {
+            if (proxySort) std::sort(v.begin(), v.end(), soaCmp);
+            else v.sort(soaCmp);
+        });
+        v.sort([](const auto& a, const auto& b) { return get<Id>(a) < get<Id>(b); });
+        double search = per_elem(probes.size(), [&] {
+            if (proxySort) {
+                auto less = [](const auto& r, uint64_t id) { return get<Id>(r) < id; };
+                for (uint64_t p : probes)
+                    found += get<RScore>(*std::lower_bound(v.begin(), v.end(), p, less));
+            } else {
+                auto ids = v.field<Id>();
+                auto scores = v.field<RScore>();
+                for (uint64_t p : probes) {
+                    auto at = std::lower_bound(ids.begin(), ids.end(), p);
+                    found += scores[size_t(at - ids.begin())];
+                }
+            }
+        });
+        doNotOptimize(sum + static_cast<long long>(cnt + found));
+        std::cout << "  " << std::left << std::setw(30) << name << std::right;
+        cell(scan), cell(filter), cell(sort), cell(search);
+        std::cout << "\n";
+    };
+    runSoa("soa_vector (std:: on proxy)", true);
+    runSoa("soa_vector (sort/field)", false);
+}
+
+int main(int argc, char** argv) {
+    // 记录条数；./container_level23_soa_vector 10000000
+    size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    demo_basic();
+    demo_algorithms();
+    bench_soa(std::max<size_t>(n, 16));
+    return 0;
+}
@@ -0,0 +1,199 @@
+// Level 24: relocatable_vector —— 按字节搬家的 vector
+// 涵盖：可平凡搬迁（trivially relocatable）的含义与 is_trivially_relocatable 特化、
+//        扩容 / 中间插入删除时 std::vector 逐个移动与 memcpy / memmove 的差别、
+//        realloc 原地扩容，以及 POD、Heavy、std::string 三种元素的增长与插删吞吐量对比
+//
+// 实现见 relocatable_vector.h；std::vector 的扩容见 level1.cpp 的 demo_capacity，
+// 扩容时的 copy / move 见 level7.cpp 的 demo_move
+
+#include "bench_utils.h"
+#include "relocatable_vector.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// level7.cpp 里的 Heavy 会打印每次拷贝 / 移动；这里改成计数
+struct Noisy {
+    static inline size_t moves = 0, copies = 0, destroys = 0;
+    std::vector<int> data;
+
+    explicit Noisy(int size) : data(size, 42) {}
+    Noisy(const Noisy& o) : data(o.data) { copies++; }
+    Noisy(Noisy&& o) noexcept : data(std::move(o.data)) { moves++; }
+    Noisy& operator=(Noisy&& o) noexcept {
+        data = std::move(o.data);
+        moves++;
+        return *this;
+    }
+    ~Noisy() { destroys++; }
+
+    static void reset() { moves = copies = destroys = 0; }
+};
+
+// Heavy 的成员只有 std::vector（libstdc++ 中是三个指针）和 int：按字节搬走后旧对象不再析构，
+// 等价于"移动 + 析构"。level7.cpp 的 Heavy 还有 std::string 成员，就不能这样声明
+struct Heavy {
+    std::vector<int> data;
+    int id = 0;
+};
+
+// 32 字节的 POD：std::is_trivially_copyable，默认就走快速路径
+struct Pod {
+    int64_t a, b, c, d;
+};
+
+template <>
+struct is_trivially_relocatable<Noisy> : std::true_type {};
+template <>
+struct is_trivially_relocatable<Heavy> : std::true_type {};
+
+// ============================================================
+// 24.1 搬迁次数
+//   std::vector 扩容时每个元素移动构造 + 析构一次；中间插入时插入点之后每个元素移动一次
+//   relocatable_vector 对可平凡搬迁的元素一次也不调用
+// ============================================================
+template <typename Vec>
+void count_relocations(const char* name) {
+    Noisy::reset();
+    {
+        Vec v;
+        for (int i = 0; i < 1000; i++) v.emplace_back(4);
+        std::cout << "  " << std::left << std::setw(28) << name << std::right
+                  << "1000 次 emplace_back：" << Noisy::moves << " 次移动，" << Noisy::destroys
+                  << " 次析构";
+        Noisy::reset();
+        v.emplace(v.begin(), 4);
+        v.erase(v.begin() + 500);
+        std::cout << "；头部插入 + 中间删除：" << Noisy::moves << " 次移动\n";
+    }
+}
+
+void demo_relocation_count() {
+    std::cout << "=== 24.1 扩容与插删时的搬迁 ===\n";
+
+    std::cout << std::boolalpha
+              << "is_trivially_relocatable_v: int=" << is_trivially_relocatable_v<int>
+              << " Pod=" << is_trivially_relocatable_v<Pod>
+              << " std::string=" << is_trivially_relocatable_v<std::string>
+              << " Heavy=" << is_trivially_relocatable_v<Heavy> << "（特化）\n"
+              << std::noboolalpha;
+
+    count_relocations<std::vector<Noisy>>("std::vector<Noisy>");
+    count_relocations<relocatable_vector<Noisy>>("relocatable_vector<Noisy>");
+}
+
+// ============================================================
+// 24.2 realloc 原地扩容
+//   operator new 没有"原地扩大"，std::vector 每次扩容都换一块新内存再搬过去；
+//   realloc 在后面恰好有空闲时原地扩大，大块内存（glibc 默认 >= 128 KiB 走 mmap）
+//   用 mremap 改页表，不复制数据
+// ============================================================
+template <typename Vec>
+void count_in_place_growth(const char* name, size_t n) {
+    Vec v;
+    size_t grows = 0, inPlace = 0;
+    for (size_t i = 0; i < n; i++) {
+        const int* before = v.data();
+        size_t cap = v.capacity();
+        v.push_back(int(i));
+        if (v.capacity() != cap && cap != 0) {
+            grows++;
+            inPlace += v.data() == before;
+        }
+    }
+    std::cout << "  " << std::left << std::setw(28) << name << std::right << n << " 次 push_back："
+              << grows << " 次扩容，其中 " << inPlace << " 次地址不变\n";
+}
+
+void demo_realloc_growth(size_t n) {
+    std::cout << "\n=== 24.2 realloc 原地扩容 ===\n";
+    count_in_place_growth<std::vector<int>>("std::vector<int>", n);
+    count_in_place_growth<relocatable_vector<int>>("relocatable_vector<int>", n);
+}
+
+// ============================================================
+// 24.3 Benchmark
+//   grow  ：不预留，push_back(std::move(x)) n 个元素（ns / 元素；元素事先构造好，不计入）
+//   insert：在 m 个元素的中间插入 k 次（ns / 次）
+//   erase ：再从中间删除 k 次（ns / 次）
+//   POD：std::vector 对 trivially copyable 元素本来就用 memmove，差别只在 realloc；
+//   Heavy：std::vector 逐个移动构造 / 移动赋值，relocatable_vector 按字节搬；
+//   std::string：libstdc++ 中不可平凡搬迁，relocatable_vector 退回与 std::vector 相同的做法
+// ============================================================
+template <typename F>
+double best_of_3(F&& f) {
+    double best = 1e300;
+    for (int r = 0; r < 3; r++) best = std::min(best, f());
+    return best;
+}
+
+template <typename Vec, typename Make>
+void bench_one(const char* name, size_t n, size_t m, size_t k, Make make) {
+    using T = typename Vec::value_type;
+    double grow = best_of_3([&] {
+        std::vector<T> src;
+        src.reserve(n);
+        for (size_t i = 0; i < n; i++) src.push_back(make(i));
+        BenchTimer t;
+        Vec v;
+        for (auto& x : src) v.push_back(std::move(x));
+        doNotOptimize(v.data());
+        return t.ns() / double(n);
+    });
+
+    double insert = 0, erase = 0;
+    for (int r = 0; r < 3; r++) {
+        Vec v;
+        v.reserve(m + k);
+        for (size_t i = 0; i < m; i++) v.push_back(make(i));
+        std::vector<T> src;
+        for (size_t i = 0; i < k; i++) src.push_back(make(i));
+        BenchTimer t;
+        for (auto& x : src) v.insert(v.begin() + v.size() / 2, std::move(x));
+        double ins = t.ns() / double(k);
+        t.reset();
+        for (size_t i = 0; i < k; i++) v.erase(v.begin() + v.size() / 2);
+        double era = t.ns() / double(k);
+        doNotOptimize(v.data());
+        insert = r ? std::min(insert, ins) : ins;
+        erase = r ? std::min(erase, era) : era;
+    }
+
+    std::cout << "  " << std::left << std::setw(30) << name << std::right << std::fixed
+              << std::setprecision(2) << std::setw(12) << grow << std::setw(12) << insert
+              << std::setw(12) << erase << "\n";
+}
+
+void bench_relocatable(size_t n) {
+    size_t m = std::max<size_t>(n / 50, 16), k = std::max<size_t>(m / 10, 1);
+    std::cout << "\n=== 24.3 Benchmark（grow n=" << n << "；insert / erase：m=" << m
+              << " 个元素中间插删 " << k << " 次）===\n";
+    std::cout << "  " << std::left << std::setw(30) << "container" << std::right << std::setw(12)
+              << "grow ns" << std::setw(12) << "insert ns" << std::setw(12) << "erase ns" << "\n";
+
+    auto pod = [](size_t i) { return Pod{int64_t(i), 1, 2, 3}; };
+    bench_one<std::vector<Pod>>("std::vector<Pod>", n, m, k, pod);
+    bench_one<relocatable_vector<Pod>>("relocatable_vector<Pod>", n, m, k, pod);
+
+    auto heavy = [](size_t i) { return Heavy{std::vector<int>(4, int(i)), int(i)}; };
+    bench_one<std::vector<Heavy>>("std::vector<Heavy>", n, m, k, heavy);
+    bench_one<relocatable_vector<Heavy>>("relocatable_vector<Heavy>", n, m, k, heavy);
+
+    // 32 个字符，超过 SSO，每个字符串持有一块堆内存
+    auto str = [](size_t i) { return std::string(32, char('a' + i % 26)); };
+    bench_one<std::vector<std::string>>("std::vector<string>", n, m, k, str);
+    bench_one<relocatable_vector<std::string>>("relocatable_vector<string>", n, m, k, str);
+}
+
+int main(int argc, char** argv) {
+    // push_back 的元素个数；./container_level24_relocatable_vector 10000000
+    size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    demo_relocation_count();
+    demo_realloc_growth(n);
+    bench_relocatable(std::max<size_t>(n, 1000));
+    return 0;
+}
@@ -0,0 +1,322 @@
+// Level 25: 持久化容器 —— persistent_vector 与 persistent_hash_map（HAMT）
+// 涵盖：修改返回新版本、新旧版本结构共享、O(1) 快照、transient 批量修改、
+//        多线程读者持有一致的快照，以及快照 / 单点修改 / 查找与复制 std::vector、
+//        std::unordered_map 的对比
+//
+// 实现见 persistent.h；std::vector 见 level1.cpp，std::unordered_map 见 level6.cpp
+
+#define BENCH_COUNT_ALLOCATIONS
+#include "bench_utils.h"
+#include "persistent.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+template <typename Vec>
+void print(const Vec& v, const std::string& label) {
+    std::cout << label << ":";
+    for (int x : v) std::cout << " " << x;
+    std::cout << "\n";
+}
+
+// ============================================================
+// 25.1 persistent_vector：每次修改得到新版本
+//   push_back / set / pop_back 是 const 成员，返回新版本；旧版本不变
+//   新版本只复制根到被改元素的一条路径，其余节点与旧版本共享
+// ============================================================
+void demo_persistent_vector() {
+    std::cout << "=== 25.1 persistent_vector ===\n";
+
+    persistent_vector<int> v1 = {1, 2, 3, 4, 5};
+    auto v2 = v1.push_back(6);
+    auto v3 = v2.set(0, 100);
+    auto v4 = v3.pop_back().pop_back();
+    print(v1, "v1");
+    print(v2, "v2 = v1.push_back(6)");
+    print(v3, "v3 = v2.set(0, 100)");
+    print(v4, "v4 = v3.pop_back().pop_back()");
+
+    // 大 vector 上改一个元素：std::vector 要整份复制才能保住旧版本，持久化版本只复制一条路径
+    const size_t n = 1 << 20;
+    std::vector<int> sv(n);
+    std::iota(sv.begin(), sv.end(), 0);
+    persistent_vector<int> pv(sv.begin(), sv.end());
+
+    auto before = allocSnapshot();
+    std::vector<int> copy = sv;
+    copy[n / 2] = -1;
+    auto stdCost = allocSnapshot() - before;
+    before = allocSnapshot();
+    auto pv2 = pv.set(n / 2, -1);
+    auto pCost = allocSnapshot() - before;
+    std::cout << n << " 个元素改一个并保留旧版本：std::vector 复制 " << stdCost.count
+              << " 次分配 / " << stdCost.bytes << " 字节，persistent_vector " << pCost.count
+              << " 次分配 / " << pCost.bytes << " 字节\n";
+    std::cout << "旧版本不变：pv[n/2]=" << pv[n / 2] << "，pv2[n/2]=" << pv2[n / 2] << "\n";
+}
+
+// ============================================================
+// 25.2 persistent_hash_map：HAMT
+//   set 插入或覆盖、erase 删除，同样返回新版本；find 返回指针，找不到为 nullptr
+// ============================================================
+void demo_persistent_map() {
+    std::cout << "\n=== 25.2 persistent_hash_map ===\n";
+
+    persistent_hash_map<std::string, int> m1 = {{"apple", 3}, {"banana", 5}, {"cherry", 7}};
+    auto m2 = m1.set("banana", 50).set("durian", 9).erase("apple");
+
+    auto show = [](const auto& m, const char* label) {
+        std::cout << label << " size=" << m.size() << ":";
+        for (const char* k : {"apple", "banana", "cherry", "durian"}) {
+            const int* v = m.find(k);
+            std::cout << " " << k << "=" << (v ? std::to_string(*v) : "-");
+        }
+        std::cout << "\n";
+    };
+    show(m1, "m1");
+    show(m2, "m2 = m1.set(banana, 50).set(durian, 9).erase(apple)");
+    std::cout << "m1.at(\"apple\")=" << m1.at("apple")
+              << "，m2.contains(\"apple\")=" << m2.contains("apple") << "\n";
+}
+
+// ============================================================
+// 25.3 transient：批量修改
+//   逐个 push_back 生成持久化版本，每次都复制 tail（最多 32 个元素）；
+//   transient 只有第一次碰到共享节点时复制，之后独占的节点原地修改
+// ============================================================
+void demo_transient() {
+    std::cout << "\n=== 25.3 transient 批量修改 ===\n";
+
+    const int n = 100000;
+    auto before = allocSnapshot();
+    persistent_vector<int> a;
+    for (int i = 0; i < n; i++) a = a.push_back(i);
+    auto slow = allocSnapshot() - before;
+
+    before = allocSnapshot();
+    auto t = persistent_vector<int>().transient();
+    for (int i = 0; i < n; i++) t.push_back(i);
+    persistent_vector<int> b = t.persistent();
+    auto fast = allocSnapshot() - before;
+
+    std::cout << n << " 次追加：逐个生成版本 " << slow.count << " 次分配，transient " << fast.count
+              << " 次分配；结果相等: " << (a == b) << "\n";
+
+    // 从已有版本开始的 transient：修改不影响原版本
+    auto tm = persistent_hash_map<int, int>().set(1, 1).set(2, 2).transient();
+    for (int i = 3; i <= 1000; i++) tm.set(i, i);
+    tm.erase(1);
+    auto m = tm.persistent();
+    std::cout << "transient 构建的 map size=" << m.size()
+              << "，transient 交出结果后 size=" << tm.size() << "\n";
+}
+
+// ============================================================
+// 25.4 给读者线程的快照
+//   写者每次在两个账户之间转账并发布新版本（发布只是在锁内替换一个 map 对象，O(1)）；
+//   读者拿到快照后在锁外慢慢遍历：看到的总额永远不变，也不会读到转了一半的状态
+// ============================================================
+void demo_snapshots() {
+    std::cout << "\n=== 25.4 读者快照 ===\n";
+
+    const int accounts = 1000;
+    auto t = persistent_hash_map<int, long>().transient();
+    for (int i = 0; i < accounts; i++) t.set(i, 100);
+    persistent_hash_map<int, long> published = t.persistent();
+    std::mutex mu;
+    std::atomic<bool> done{false};
+
+    auto snapshot = [&] {
+        std::lock_guard<std::mutex> lock(mu);
+        return published;  // 复制 = 根节点引用计数 +1
+    };
+
+    std::atomic<int> reads{0}, bad{0};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 2; r++) {
+        readers.emplace_back([&] {
+            while (!done.load()) {
+                auto snap = snapshot();
+                long total = 0;
+                for (const auto& [id, balance] : snap) total += balance;
+                bad += total != 100L * accounts;
+                reads++;
+            }
+        });
+    }
+
+    std::mt19937 rng(25);
+    persistent_hash_map<int, long> cur = snapshot();
+    for (int i = 0; i < 20000; i++) {
+        int from = int(rng() % accounts), to = int(rng() % accounts);
+        cur = cur.set(from, cur.at(from) - 1);
+        cur = cur.set(to, cur.at(to) + 1);
+        std::lock_guard<std::mutex> lock(mu);
+        published = cur;
+    }
+    done = true;
+    for (auto& th : readers) th.join();
+    std::cout << "20000 次转账期间读者遍历快照 " << reads << " 次，总额不一致 " << bad << " 次\n";
+}
+
+// ============================================================
+// 25.5 Benchmark（ns / 次）
+//   snapshot    ：得到一份之后不会再变的只读副本（std 容器要整份复制）
+//   upd+snapshot：改一个元素并保留旧版本（std：复制 + 改；持久化：set 返回新版本）
+//   update      ：单纯修改，不保留旧版本（std：原地改；持久化：transient 上 set）
+//   lookup      ：随机下标 / 随机 key 查找
+// ============================================================
+template <typename F>
+double ns_per_op(size_t ops, F&& f) {
+    BenchTimer t;
+    f();
+    return t.ns() / double(ops);
+}
+
+void row(const char* name, double snap, double updSnap, double update, double lookup) {
+    std::cout << "  " << std::left << std::setw(34) << name << std::right << std::fixed
+              << std::setprecision(1) << std::setw(14) << snap << std::setw(14) << updSnap
+              << std::setw(12) << update << std::setw(10) << lookup << "\n";
+}
+
+void bench_persistent(size_t n) {
+    std::cout << "\n=== 25.5 Benchmark（n=" << n << "，ns / 次）===\n";
+    std::cout << "  " << std::left << std::setw(34) << "container" << std::right << std::setw(14)
+              << "snapshot" << std::setw(14) << "upd+snapshot" << std::setw(12) << "update"
+              << std::setw(10) << "lookup" << "\n";
+
+    const size_t copies = 5;  // std 容器整份复制的次数
+    const size_t ops = 200000;
+    std::mt19937_64 rng(48);
+    std::vector<size_t> idx(ops);
+    for (auto& i : idx) i = rng() % n;
+
+    // ---------- vector ----------
+    {
+        std::vector<int> v(n);
+        std::iota(v.begin(), v.end(), 0);
+        long long sum = 0;
+        double snap = ns_per_op(copies, [&] {
+            for (size_t r = 0; r < copies; r++) {
+                std::vector<int> s = v;
+                doNotOptimize(s.data());
+            }
+        });
+        double updSnap = ns_per_op(copies, [&] {
+            for (size_t r = 0; r < copies; r++) {
+                std::vector<int> s = v;
+                s[idx[r]] = -1;
+                doNotOptimize(s.data());
+            }
+        });
+        double update = ns_per_op(ops, [&] {
+            for (size_t i : idx) v[i] = int(i);
+        });
+        double lookup = ns_per_op(ops, [&] {
+            for (size_t i : idx) sum += v[i];
+        });
+        doNotOptimize(sum);
+        row("std::vector<int>", snap, updSnap, update, lookup);
+    }
+    {
+        auto t = persistent_vector<int>().transient();
+        for (size_t i = 0; i < n; i++) t.push_back(int(i));
+        persistent_vector<int> v = t.persistent();
+        long long sum = 0;
+        double snap = ns_per_op(ops, [&] {
+            for (size_t r = 0; r < ops; r++) {
+                persistent_vector<int> s = v;
+                doNotOptimize(s);
+            }
+        });
+        double updSnap = ns_per_op(ops, [&] {
+            for (size_t i : idx) v = v.set(i, -1);
+        });
+        double update = ns_per_op(ops, [&] {
+            auto tr = v.transient();
+            for (size_t i : idx) tr.set(i, int(i));
+            v = tr.persistent();
+        });
+        double lookup = ns_per_op(ops, [&] {
+            for (size_t i : idx) sum += v[i];
+        });
+        doNotOptimize(sum);
+        row("persistent_vector<int>", snap, updSnap, update, lookup);
+    }
+
+    // ---------- hash map ----------
+    auto keys = uniqueRandomKeys(n, 48);
+    std::vector<uint64_t> probes(ops);
+    for (auto& k : probes) k = keys[rng() % n];
+    {
+        std::unordered_map<uint64_t, uint64_t> m;
+        m.reserve(n);
+        for (uint64_t k : keys) m.emplace(k, k);
+        uint64_t sum = 0;
+        double snap = ns_per_op(copies, [&] {
+            for (size_t r = 0; r < copies; r++) {
+                std::unordered_map<uint64_t, uint64_t> s = m;
+                doNotOptimize(s.size());
+            }
+        });
+        double updSnap = ns_per_op(copies, [&] {
+            for (size_t r = 0; r < copies; r++) {
+                std::unordered_map<uint64_t, uint64_t> s = m;
+                s[probes[r]] = 0;
+                doNotOptimize(s.size());
+            }
+        });
+        double update = ns_per_op(ops, [&] {
+            for (uint64_t k : probes) m[k] = k + 1;
+        });
+        double lookup = ns_per_op(ops, [&] {
+            for (uint64_t k : probes) sum += m.find(k)->second;
+        });
+        doNotOptimize(sum);
+        row("std::unordered_map<u64,u64>", snap, updSnap, update, lookup);
+    }
+    {
+        auto t = persistent_hash_map<uint64_t, uint64_t>().transient();
+        for (uint64_t k : keys) t.set(k, k);
+        auto m = t.persistent();
+        uint64_t sum = 0;
+        double snap = ns_per_op(ops, [&] {
+            for (size_t r = 0; r < ops; r++) {
+                auto s = m;
+                doNotOptimize(s);
+            }
+        });
+        double updSnap = ns_per_op(ops, [&] {
+            for (uint64_t k : probes) m = m.set(k, 0);
+        });
+        double update = ns_per_op(ops, [&] {
+            auto tr = m.transient();
+            for (uint64_t k : probes) tr.set(k, k + 1);
+            m = tr.persistent();
+        });
+        double lookup = ns_per_op(ops, [&] {
+            for (uint64_t k : probes) sum += *m.find(k);
+        });
+        doNotOptimize(sum);
+        row("persistent_hash_map<u64,u64>", snap, updSnap, update, lookup);
+    }
+}
+
+int main(int argc, char** argv) {
+    // 容器大小；./container_level25_persistent 10000000
+    size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    demo_persistent_vector();
+    demo_persistent_map();
+    demo_transient();
+    demo_snapshots();
+    bench_persistent(std::max<size_t>(n, 1000));
+    return 0;
+}
@@ -0,0 +1,255 @@
+// Level 26: 空间索引 —— 代替按字典序排序的 std::map<Point>
+// 涵盖：std::map<Point> 做矩形查询时扫描的节点数、k-d 树 / STR 打包 R 树 / Morton（Z 序）数组
+//        的矩形查询与 k 近邻、三维点、Z 序编码与 R 树的结构，
+//        以及 10^6..10^8 个点上的构建时间、内存、矩形查询和 kNN 吞吐量对比
+//
+// 实现见 spatial.h；std::map 的自定义 key 见 level5.cpp 的 demo_custom_key
+
+#define BENCH_COUNT_ALLOCATIONS
+#include "bench_utils.h"
+#include "spatial.h"
+
+#include <climits>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+// 与 level5.cpp 相同：先按 x，再按 y
+struct Point {
+    int x, y;
+    bool operator<(const Point& o) const { return x != o.x ? x < o.x : y < o.y; }
+};
+
+using P2 = spatial_point<int, 2>;
+using Box2 = spatial_box<int, 2>;
+
+// 在 std::map<Point> 里找矩形内的点：x 有序，只能先定位到 x >= lo.x，
+// 然后一直走到 x > hi.x，中间每个节点都要检查 y。visited 返回走过的节点数
+template <typename Map, typename F>
+size_t map_range(const Map& m, const Box2& b, F&& f) {
+    size_t visited = 0;
+    for (auto it = m.lower_bound(Point{b.lo[0], INT_MIN}); it != m.end() && it->first.x <= b.hi[0];
+         ++it) {
+        visited++;
+        if (b.lo[1] <= it->first.y && it->first.y <= b.hi[1]) f(it->second, it->first);
+    }
+    return visited;
+}
+
+// [0, range) 里均匀分布的 n 个点
+std::vector<P2> random_points(size_t n, int range, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<P2> pts(n);
+    for (auto& p : pts) p = {int(rng() % uint64_t(range)), int(rng() % uint64_t(range))};
+    return pts;
+}
+
+// ============================================================
+// 26.1 矩形查询
+//   字典序的 map 只能利用 x 的范围：矩形越"高"，扫描的竖带里无关的点越多
+// ============================================================
+void demo_range() {
+    std::cout << "=== 26.1 矩形查询 ===\n";
+
+    auto pts = random_points(100000, 10000, 1);
+    std::map<Point, uint32_t> m;
+    for (uint32_t i = 0; i < pts.size(); i++) m.emplace(Point{pts[i][0], pts[i][1]}, i);
+
+    Box2 b{{4000, 4000}, {4100, 4100}};
+    size_t hits = 0;
+    size_t visited = map_range(m, b, [&](uint32_t, const Point&) { hits++; });
+    std::cout << "10^5 个点，查询 [4000, 4100] x [4000, 4100]\n";
+    std::cout << "  std::map<Point>   ：命中 " << hits << " 个，扫描了 " << visited << " 个节点\n";
+
+    kd_tree<int, 2> kd(pts);
+    packed_rtree<int, 2> rt(pts);
+    morton_array<int, 2> mo(pts);
+    std::cout << "  kd_tree           ：命中 " << kd.range(b).size() << " 个\n"
+              << "  packed_rtree      ：命中 " << rt.range(b).size() << " 个\n"
+              << "  morton_array      ：命中 " << mo.range(b).size() << " 个\n";
+
+    // 回调拿到的 id 是点在输入里的下标
+    std::cout << "  前 3 个：";
+    size_t shown = 0;
+    kd.range_query(b, [&](uint32_t id, const P2& p) {
+        if (shown++ < 3) std::cout << "#" << id << "(" << p[0] << "," << p[1] << ") ";
+    });
+    std::cout << "\n";
+}
+
+// ============================================================
+// 26.2 k 近邻（三维浮点坐标）
+//   三种索引返回的距离与暴力扫描一致；距离相同的点之间顺序可能不同
+// ============================================================
+void demo_knn() {
+    std::cout << "\n=== 26.2 k 近邻（三维） ===\n";
+
+    using P3 = spatial_point<float, 3>;
+    std::mt19937_64 rng(2);
+    std::normal_distribution<float> g(0, 100);
+    std::vector<P3> pts(50000);
+    for (auto& p : pts) p = {g(rng), g(rng), g(rng)};
+
+    kd_tree<float, 3> kd(pts);
+    packed_rtree<float, 3> rt(pts);
+    morton_array<float, 3> mo(pts);
+
+    P3 q{10, -20, 5};
+    auto best = kd.knn(q, 5);
+    std::cout << "q = (10, -20, 5) 最近的 5 个点：\n";
+    for (auto& nb : best)
+        std::cout << "  #" << nb.id << " (" << pts[nb.id][0] << ", " << pts[nb.id][1] << ", "
+                  << pts[nb.id][2] << ")  距离 " << std::sqrt(nb.dist2) << "\n";
+
+    std::vector<double> brute;
+    for (auto& p : pts) brute.push_back(spatial_dist2(p, q));
+    std::sort(brute.begin(), brute.end());
+    bool same = true;
+    auto a = rt.knn(q, 5), b = mo.knn(q, 5);
+    for (size_t i = 0; i < 5; i++)
+        same = same && best[i].dist2 == brute[i] && a[i].dist2 == brute[i] &&
+               b[i].dist2 == brute[i];
+    std::cout << "kd_tree / packed_rtree / morton_array 与暴力扫描一致：" << std::boolalpha << same
+              << std::noboolalpha << "\n";
+}
+
+// ============================================================
+// 26.3 结构
+//   Z 序：坐标的二进制位交织，4x4 网格按编码排序后走出一串 "Z"；
+//   编码的每个前缀是一个方格，方格里的点在排好序的数组中连续
+//   STR 打包的 R 树：叶子和内部节点几乎全满，高度 = ceil(log_16 n)
+// ============================================================
+void demo_structure() {
+    std::cout << "\n=== 26.3 Z 序与 R 树结构 ===\n";
+
+    std::vector<P2> grid;
+    for (int y = 0; y < 4; y++)
+        for (int x = 0; x < 4; x++) grid.push_back({x, y});
+    morton_array<int, 2> mo(grid);
+    std::cout << "4x4 网格按 Z 序排列后每格的次序：\n";
+    std::vector<size_t> rank(grid.size());
+    for (size_t i = 0; i < mo.size(); i++) {
+        auto p = mo.points()[i];
+        rank[size_t(p[1] * 4 + p[0])] = i;
+    }
+    for (int y = 3; y >= 0; y--) {
+        std::cout << "  ";
+        for (int x = 0; x < 4; x++) std::cout << std::setw(3) << rank[size_t(y * 4 + x)];
+        std::cout << "\n";
+    }
+
+    for (size_t n : {1000, 100000, 1000000}) {
+        packed_rtree<int, 2> rt(random_points(n, 1 << 30, 3));
+        size_t leaves = (n + 15) / 16;
+        std::cout << "packed_rtree n=" << std::setw(7) << n << "：高度 " << rt.height() << "，节点 "
+                  << rt.node_count() << "（叶子 " << leaves << "），每点 "
+                  << double(rt.memory_usage()) / double(n) << " 字节\n";
+    }
+}
+
+// ============================================================
+// 26.4 Benchmark
+//   坐标在 [0, 2^30) 均匀分布；矩形查询框边长取平均命中约 100 个点，kNN 的 k = 10。
+//   std::map 的 kNN 只能全表扫描，只跑少量查询
+// ============================================================
+void print_row(size_t n, const char* name, double buildMs, double bytesPerPoint, double rangeNs,
+               double knnNs, size_t hits) {
+    std::cout << "  " << std::setw(11) << n << std::setw(14) << name << std::fixed
+              << std::setprecision(1) << std::setw(11) << buildMs << std::setw(9) << bytesPerPoint
+              << std::setw(12) << rangeNs << std::setw(13) << knnNs << std::setw(10) << hits
+              << "\n";
+}
+
+template <typename Index>
+void bench_index(size_t n, const char* name, const std::vector<P2>& pts,
+                 const std::vector<Box2>& boxes, const std::vector<P2>& probes) {
+    auto before = allocSnapshot();
+    BenchTimer t;
+    Index index(pts);
+    double buildMs = t.ms();
+    double bytes = double((allocSnapshot() - before).liveBytes) / double(n);
+
+    size_t hits = 0;
+    t.reset();
+    for (auto& b : boxes) index.range_query(b, [&](uint32_t, const P2&) { hits++; });
+    double rangeNs = t.ns() / double(boxes.size());
+
+    double sum = 0;
+    t.reset();
+    for (auto& q : probes) sum += index.knn(q, 10).back().dist2;
+    double knnNs = t.ns() / double(probes.size());
+    doNotOptimize(sum);
+    print_row(n, name, buildMs, bytes, rangeNs, knnNs, hits);
+}
+
+void bench_spatial(size_t maxN) {
+    std::cout << "\n=== 26.4 Benchmark：空间索引 vs std::map<Point> ===\n";
+    std::cout << "  build 为总耗时 ms，range / kNN 为 ns/次；hits 为全部矩形查询的命中总数\n";
+    std::cout << "  " << std::setw(11) << "n" << std::setw(14) << "" << std::setw(11) << "build"
+              << std::setw(9) << "B/point" << std::setw(12) << "range" << std::setw(13) << "kNN(10)"
+              << std::setw(10) << "hits" << "\n";
+
+    constexpr int kRange = 1 << 30;
+    constexpr size_t kMapLimit = 20000000;  // std::map 每个节点约 48 字节，更大时跳过
+    std::vector<size_t> sizes = decadeSizes(6, maxN);
+    if (sizes.empty()) sizes.push_back(maxN);
+    for (size_t n : sizes) {
+        auto pts = random_points(n, kRange, n);
+        int side = int(double(kRange) * std::sqrt(100.0 / double(n)));
+        std::mt19937_64 rng(4);
+        std::vector<Box2> boxes(1000);
+        for (auto& b : boxes) {
+            int x = int(rng() % uint64_t(kRange - side)), y = int(rng() % uint64_t(kRange - side));
+            b = {{x, y}, {x + side, y + side}};
+        }
+        std::vector<P2> probes(10000);
+        for (auto& q : probes) q = {int(rng() % kRange), int(rng() % kRange)};
+
+        if (n <= kMapLimit) {
+            auto before = allocSnapshot();
+            BenchTimer t;
+            std::map<Point, uint32_t> m;
+            for (uint32_t i = 0; i < n; i++) m.emplace(Point{pts[i][0], pts[i][1]}, i);
+            double buildMs = t.ms();
+            double bytes = double((allocSnapshot() - before).liveBytes) / double(n);
+
+            size_t hits = 0;
+            t.reset();
+            for (auto& b : boxes) map_range(m, b, [&](uint32_t, const Point&) { hits++; });
+            double rangeNs = t.ns() / double(boxes.size());
+
+            // 全表扫描，保留最近的 10 个
+            size_t knnQueries = std::clamp<size_t>(10000000 / n, 3, 100);
+            double sum = 0;
+            t.reset();
+            for (size_t i = 0; i < knnQueries; i++) {
+                spatial_knn_heap heap(10);
+                for (auto& [p, id] : m) heap.offer(id, spatial_dist2(P2{p.x, p.y}, probes[i]));
+                sum += std::move(heap).sorted().back().dist2;
+            }
+            double knnNs = t.ns() / double(knnQueries);
+            doNotOptimize(sum);
+            print_row(n, "std::map", buildMs, bytes, rangeNs, knnNs, hits);
+        } else {
+            std::cout << "  " << std::setw(11) << n << std::setw(14) << "std::map"
+                      << "  （跳过：约 " << n * 48 / 1000000 << " MB）\n";
+        }
+        bench_index<kd_tree<int, 2>>(n, "kd_tree", pts, boxes, probes);
+        bench_index<packed_rtree<int, 2>>(n, "packed_rtree", pts, boxes, probes);
+        bench_index<morton_array<int, 2>>(n, "morton_array", pts, boxes, probes);
+    }
+}
+
+int main(int argc, char** argv) {
+    // 默认测 10^6；./container_level26_spatial 100000000 测到 10^8（需要数 GB 内存）
+    size_t maxN = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    demo_range();
+    demo_knn();
+    demo_structure();
+    bench_spatial(std::max<size_t>(maxN, 1000));
+    return 0;
+}
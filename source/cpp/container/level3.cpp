@@ -12,6 +12,7 @@
 // 3.1 std::stack —— 后进先出（LIFO）
 //   默认底层容器：std::deque（也可选 std::vector / std::list）
 //   接口：push, pop, top, empty, size
+//   更快的 D 叉堆、单调基数堆、支持 decrease_key 的索引堆见 level17_heaps.cpp
 // ============================================================
 void demo_stack() {
     std::cout << "=== 3.1 std::stack ===\n";
@@ -98,6 +99,7 @@ void demo_queue() {
 
 // ============================================================
 // 3.4 应用：BFS 层序遍历（简化树节点）
+//   上亿条边的图上的并行 BFS（CSR + 方向优化）见 level20_graph_bfs.cpp
 // ============================================================
 struct TreeNode {
     int val;
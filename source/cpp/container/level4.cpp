@@ -9,6 +9,7 @@
 // 4.1 std::set 基础
 //   内部：红黑树（自平衡 BST）
 //   特性：元素自动排序（默认升序）、元素唯一、所有操作 O(log n)
+//   大量整数 ID 的集合（及其交并差）用压缩位图更省更快，见 level22_roaring.cpp
 // ============================================================
 void demo_set_basic() {
     std::cout << "=== 4.1 std::set 基础 ===\n";
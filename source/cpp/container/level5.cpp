@@ -158,6 +158,7 @@ void demo_multimap() {
 
 // ============================================================
 // 5.6 应用：词频统计
+//   大文本的并行版本（内存映射 + 字符串驻留 + 每线程哈希表）见 level19_word_count.cpp
 // ============================================================
 void demo_word_count() {
     std::cout << "\n=== 5.6 应用：词频统计 ===\n";
@@ -177,6 +178,7 @@ void demo_word_count() {
 // ============================================================
 // 5.7 自定义 key 类型
 //   条件：key 类型需要支持 operator< （或提供自定义比较器）
+//   按 x 再按 y 排序的 map 不适合矩形查询 / 最近邻，空间索引见 level26_spatial.cpp
 // ============================================================
 struct Point {
     int x, y;
@@ -64,6 +64,7 @@ void demo_hash_stats() {
 
 // ============================================================
 // 6.3 std::unordered_map 基础
+//   新旧版本共享节点、快照 O(1) 的持久化哈希表（HAMT）见 level25_persistent.cpp
 // ============================================================
 void demo_unordered_map() {
     std::cout << "\n=== 6.3 std::unordered_map ===\n";
@@ -0,0 +1,229 @@
+// Level 8: flat_hash_map —— 开放寻址 + SIMD 探测的哈希表
+// 涵盖：Swiss-table 控制字节、16 路 SSE2 group 探测、无墓碑删除、
+//        reserve/rehash、异构查找，以及与 std::unordered_map 的性能/内存对比
+//
+// 实现见 flat_hash_map.h；level6.cpp 的 demo 在这里换成 flat_hash_map 重写一遍
+
+#define BENCH_COUNT_ALLOCATIONS
+#include "bench_utils.h"
+#include "flat_hash_map.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// ============================================================
+// 8.1 与 std::unordered_map 相同的接口
+//   operator[] / emplace / insert / try_emplace / insert_or_assign / find
+// ============================================================
+void demo_flat_hash_map() {
+    std::cout << "=== 8.1 flat_hash_map 基本用法 ===\n";
+
+    flat_hash_map<std::string, int> m;
+
+    m["apple"]  = 3;
+    m["banana"] = 5;
+    m.emplace("cherry", 2);
+    m.insert({"date", 8});
+
+    std::cout << "遍历（无序）:\n";
+    for (const auto& [k, v] : m)
+        std::cout << "  " << k << "=" << v << "\n";
+
+    m.try_emplace("apple", 999);        // apple 已存在，不修改
+    m.insert_or_assign("apple", 100);   // 强制覆盖
+    std::cout << "apple=" << m["apple"] << "\n";
+
+    if (auto it = m.find("banana"); it != m.end())
+        std::cout << "banana=" << it->second << "\n";
+
+    m.erase("cherry");
+    std::cout << "erase(cherry) 后 size=" << m.size()
+              << "  contains(cherry)=" << m.contains("cherry") << "\n";
+
+    flat_hash_set<int> s = {1, 2, 3, 2, 1};
+    std::cout << "flat_hash_set{1,2,3,2,1} size=" << s.size() << "\n";
+}
+
+// ============================================================
+// 8.2 容量：reserve / rehash / load_factor
+//   slot 数总是 16 的倍数且是 2 的幂；最大负载因子固定为 7/8
+//   （拉链法一般是 1.0，但开放寻址太满时探测链会急剧变长）
+// ============================================================
+void demo_capacity() {
+    std::cout << "\n=== 8.2 reserve / rehash / load_factor ===\n";
+
+    flat_hash_map<int, int> m;
+    std::cout << "空表 bucket_count=" << m.bucket_count() << "（不分配内存）\n";
+
+    size_t lastCap = 0;
+    for (int i = 0; i < 200; i++) {
+        m[i] = i;
+        if (m.bucket_count() != lastCap) {
+            lastCap = m.bucket_count();
+            std::cout << "  size=" << m.size() << " 时扩容到 bucket_count=" << lastCap << "\n";
+        }
+    }
+    std::cout << "load_factor=" << m.load_factor() << "  max_load_factor=" << m.max_load_factor()
+              << "\n";
+
+    flat_hash_map<int, int> r;
+    r.reserve(1000);  // 保证插入 1000 个元素不会 rehash
+    std::cout << "reserve(1000) 后 bucket_count=" << r.bucket_count() << "\n";
+    r.rehash(5000);
+    std::cout << "rehash(5000) 后 bucket_count=" << r.bucket_count() << "\n";
+}
+
+// ============================================================
+// 8.3 删除：尽量不留墓碑
+//   被删元素所在的 16 槽 group 里只要还有空槽，就说明没有探测链"穿过"它，
+//   直接标成空槽；只有 group 曾经满过才写墓碑
+//   => 负载不高时反复插删，表不会被墓碑"堵死"，也不会因此触发 rehash
+// ============================================================
+void demo_erase() {
+    std::cout << "\n=== 8.3 插删循环不产生墓碑 ===\n";
+
+    flat_hash_map<int, int> m;
+    m.reserve(1000);
+    size_t cap = m.bucket_count();
+    for (int round = 0; round < 100; round++) {
+        for (int i = 0; i < 1000; i++) m[round * 1000 + i] = i;
+        for (int i = 0; i < 1000; i++) m.erase(round * 1000 + i);
+    }
+    std::cout << "10 万次插入 + 10 万次删除后 size=" << m.size()
+              << "  bucket_count 不变: " << (m.bucket_count() == cap) << "\n";
+
+    // 迭代中删除：erase(it) 返回下一个元素
+    for (int i = 0; i < 10; i++) m[i] = i;
+    for (auto it = m.begin(); it != m.end();) {
+        if (it->first % 2) it = m.erase(it);
+        else ++it;
+    }
+    std::cout << "删除奇数 key 后 size=" << m.size() << "\n";
+}
+
+// ============================================================
+// 8.4 异构查找（heterogeneous lookup）
+//   默认哈希 flat_hash<std::string> 和 std::equal_to<> 都声明了 is_transparent，
+//   find/contains/erase 可以直接接收 string_view / const char*，不构造临时 string
+// ============================================================
+void demo_heterogeneous() {
+    std::cout << "\n=== 8.4 异构查找 ===\n";
+
+    flat_hash_map<std::string, int> m = {{"alpha", 1}, {"beta", 2}};
+
+    std::string_view line = "beta,gamma";
+    std::string_view first = line.substr(0, line.find(','));
+    if (auto it = m.find(first); it != m.end())  // 不分配内存
+        std::cout << first << " -> " << it->second << "\n";
+
+    AllocStats before = allocSnapshot();
+    for (int i = 0; i < 1000; i++) doNotOptimize(m.contains("a key longer than SSO buffer"));
+    std::cout << "1000 次 contains(const char*) 的堆分配次数: "
+              << (allocSnapshot() - before).count << "\n";
+}
+
+// ============================================================
+// 8.5 应用：两数之和
+// ============================================================
+void demo_two_sum() {
+    std::cout << "\n=== 8.5 应用：两数之和 ===\n";
+
+    std::vector<int> nums = {2, 7, 11, 15};
+    int target = 9;
+
+    flat_hash_map<int, int> seen;  // value -> index
+    for (int i = 0; i < (int)nums.size(); i++) {
+        int complement = target - nums[i];
+        if (seen.count(complement)) {
+            std::cout << "结果: [" << seen[complement] << ", " << i << "]\n";
+            return;
+        }
+        seen[nums[i]] = i;
+    }
+}
+
+// ============================================================
+// 8.6 Benchmark：flat_hash_map vs std::unordered_map
+//   key/value 都是 uint64_t，key 为随机数
+//   insert：从空表逐个插入 n 个 key（含扩容）
+//   hit   ：按另一种随机顺序查找全部 n 个已有 key
+//   miss  ：查找 n 个不存在的 key
+//   erase ：逐个删除全部 key
+//   mem/elem：建表后堆上存活字节数 / n（含空槽、桶数组、节点开销）
+// ============================================================
+template <typename Map>
+void bench_map(const char* name, const std::vector<uint64_t>& keys,
+               const std::vector<uint64_t>& hitOrder, const std::vector<uint64_t>& missKeys) {
+    const size_t n = keys.size();
+    AllocStats before = allocSnapshot();
+    BenchTimer t;
+
+    auto* m = new Map;
+    for (uint64_t k : keys) (*m)[k] = k;
+    double insertNs = t.ns() / n;
+    // 减去 Map 对象本身（它也是 new 出来的），只统计元素存储
+    double bytesPerElem = double((allocSnapshot() - before).liveBytes - sizeof(Map)) / n;
+
+    t.reset();
+    uint64_t sum = 0;
+    for (uint64_t k : hitOrder) sum += m->find(k)->second;
+    double hitNs = t.ns() / n;
+    doNotOptimize(sum);
+
+    t.reset();
+    size_t found = 0;
+    for (uint64_t k : missKeys) found += m->count(k);
+    double missNs = t.ns() / n;
+    doNotOptimize(found);
+
+    t.reset();
+    for (uint64_t k : keys) m->erase(k);
+    double eraseNs = t.ns() / n;
+    delete m;
+
+    std::cout << "  " << std::left << std::setw(20) << name << std::right << std::fixed
+              << std::setprecision(1) << std::setw(10) << insertNs << std::setw(10) << hitNs
+              << std::setw(10) << missNs << std::setw(10) << eraseNs << std::setw(12)
+              << bytesPerElem << "\n";
+}
+
+void bench_flat_vs_unordered(size_t maxN) {
+    std::cout << "\n=== 8.6 Benchmark：flat_hash_map vs std::unordered_map ===\n";
+    std::cout << "  （单位 ns/op；mem 为每元素字节数）\n";
+
+    for (size_t n : decadeSizes(3, maxN)) {
+        // 前 n 个做 key，后 n 个保证不在表中，用作 miss
+        std::vector<uint64_t> all = uniqueRandomKeys(2 * n, n);
+        std::vector<uint64_t> keys(all.begin(), all.begin() + n);
+        std::vector<uint64_t> missKeys(all.begin() + n, all.end());
+        std::vector<uint64_t> hitOrder = keys;
+        std::shuffle(hitOrder.begin(), hitOrder.end(), std::mt19937_64(7));
+
+        std::cout << "\n  n = " << n << "\n";
+        std::cout << "  " << std::left << std::setw(20) << "container" << std::right
+                  << std::setw(10) << "insert" << std::setw(10) << "hit" << std::setw(10) << "miss"
+                  << std::setw(10) << "erase" << std::setw(12) << "mem/elem" << "\n";
+        bench_map<flat_hash_map<uint64_t, uint64_t>>("flat_hash_map", keys, hitOrder, missKeys);
+        bench_map<std::unordered_map<uint64_t, uint64_t>>("std::unordered_map", keys, hitOrder,
+                                                          missKeys);
+    }
+}
+
+int main(int argc, char** argv) {
+    // 默认测到 10^6；传参可以测更大规模，例如 ./container_level8_flat_hash_map 100000000
+    // （10^8 个 key 时两种容器合计需要约 10 GB 内存）
+    size_t maxN = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    demo_flat_hash_map();
+    demo_capacity();
+    demo_erase();
+    demo_heterogeneous();
+    demo_two_sum();
+    bench_flat_vs_unordered(maxN);
+    return 0;
+}
@@ -0,0 +1,193 @@
+// Level 9: concurrent_hash_map —— 多线程共享的哈希表
+// 涵盖：分片锁（lock striping）、无锁读 + epoch 延迟释放、insert_or_assign、
+//        compute_if_absent、弱一致遍历，以及与"一把 mutex 包住 unordered_map"的对比
+//
+// 实现见 concurrent_hash_map.h；加锁方式的基础见 multi_thread/level4.cpp
+
+#include "bench_utils.h"
+#include "concurrent_hash_map.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// ============================================================
+// 9.1 基本接口
+//   读接口返回 std::optional<Value> 的拷贝，而不是引用/迭代器：
+//   别的线程随时可能覆盖或删除这个 key，引用会悬空
+// ============================================================
+void demo_basic() {
+    std::cout << "=== 9.1 concurrent_hash_map 基本用法 ===\n";
+
+    concurrent_hash_map<std::string, int> m;
+    m.insert_or_assign("apple", 3);
+    m.insert_or_assign("banana", 5);
+    m.insert("cherry", 2);
+    m.insert("apple", 999);  // 已存在，不修改
+
+    std::cout << "apple=" << m.find("apple").value_or(-1) << "\n";
+    m.insert_or_assign("apple", 100);  // 覆盖
+    std::cout << "apple=" << m.find("apple").value_or(-1) << "\n";
+
+    m.erase("banana");
+    std::cout << "erase(banana) 后 contains(banana)=" << m.contains("banana")
+              << "  size=" << m.size() << "\n";
+
+    m.for_each([](const std::string& k, int v) { std::cout << "  " << k << "=" << v << "\n"; });
+}
+
+// ============================================================
+// 9.2 compute_if_absent：并发缓存填充
+//   多个线程同时请求同一个 key，计算函数只执行一次（在分片锁内），
+//   其余线程直接拿到结果；key 已存在时完全不加锁
+// ============================================================
+void demo_compute_if_absent() {
+    std::cout << "\n=== 9.2 compute_if_absent ===\n";
+
+    concurrent_hash_map<int, long long> cache;
+    std::atomic<int> computeCalls{0};
+
+    auto expensive = [&](const int& n) {
+        computeCalls.fetch_add(1, std::memory_order_relaxed);
+        long long sum = 0;
+        for (int i = 1; i <= n; i++) sum += (long long)i * i;
+        return sum;
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; t++) {
+        threads.emplace_back([&] {
+            for (int k = 0; k < 1000; k++) doNotOptimize(cache.compute_if_absent(k, expensive));
+        });
+    }
+    for (auto& th : threads) th.join();
+
+    std::cout << "8 个线程 × 1000 次请求，计算函数调用次数=" << computeCalls.load()
+              << "（每个 key 恰好一次）\n";
+    std::cout << "cache[100]=" << cache.find(100).value_or(0) << "\n";
+}
+
+// ============================================================
+// 9.3 弱一致遍历
+//   for_each 期间写线程不停地插删 key >= 1000；key 0..999 始终存在，
+//   它们每一个都必须被恰好看到一次，其它 key 看到与否都正常
+// ============================================================
+void demo_weak_iteration() {
+    std::cout << "\n=== 9.3 弱一致遍历 ===\n";
+
+    concurrent_hash_map<int, int> m;
+    for (int i = 0; i < 1000; i++) m.insert_or_assign(i, i);
+
+    std::atomic<bool> stop{false};
+    std::thread writer([&] {
+        for (int round = 0; !stop.load(std::memory_order_relaxed); round++) {
+            for (int i = 1000; i < 3000; i++) m.insert_or_assign(i, round);
+            for (int i = 1000; i < 3000; i++) m.erase(i);
+        }
+    });
+
+    bool ok = true;
+    for (int pass = 0; pass < 200; pass++) {
+        std::vector<int> seen(1000, 0);
+        size_t others = 0;
+        m.for_each([&](int k, int) {
+            if (k < 1000) seen[k]++;
+            else others++;
+        });
+        for (int c : seen) ok = ok && c == 1;
+    }
+    stop = true;
+    writer.join();
+    std::cout << "200 次遍历中稳定 key 全部恰好出现一次: " << (ok ? "是" : "否") << "\n";
+}
+
+// ============================================================
+// 9.4 Benchmark：concurrent_hash_map vs mutex + std::unordered_map
+//   预先插入 kKeys 个 key；每个线程随机选 key，按比例做 find / insert_or_assign
+//   总操作数固定，平均分给各线程；输出吞吐量（百万次操作/秒）
+// ============================================================
+class MutexMap {
+public:
+    std::optional<uint64_t> find(uint64_t k) const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = mMap.find(k);
+        if (it == mMap.end()) return std::nullopt;
+        return it->second;
+    }
+    void insert_or_assign(uint64_t k, uint64_t v) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mMap.insert_or_assign(k, v);
+    }
+
+private:
+    mutable std::mutex mMutex;
+    std::unordered_map<uint64_t, uint64_t> mMap;
+};
+
+template <typename Map>
+double run_mix(Map& m, size_t numThreads, size_t totalOps, unsigned writePercent, uint64_t keys) {
+    size_t opsPerThread = totalOps / numThreads;
+    std::atomic<bool> go{false};
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < numThreads; t++) {
+        threads.emplace_back([&, t] {
+            uint64_t x = 0x9E3779B97F4A7C15ull * (t + 1);  // xorshift64 状态
+            uint64_t sum = 0;
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            for (size_t i = 0; i < opsPerThread; i++) {
+                x ^= x << 13;
+                x ^= x >> 7;
+                x ^= x << 17;
+                uint64_t k = x % keys;
+                if ((x >> 40) % 100 < writePercent) m.insert_or_assign(k, i);
+                else sum += m.find(k).value_or(0);
+            }
+            doNotOptimize(sum);
+        });
+    }
+    BenchTimer timer;
+    go.store(true, std::memory_order_release);
+    for (auto& th : threads) th.join();
+    return double(opsPerThread * numThreads) / (timer.ns() / 1e3);  // Mops/s
+}
+
+void bench_read_write_mix(size_t totalOps) {
+    std::cout << "\n=== 9.4 Benchmark：concurrent_hash_map vs mutex + unordered_map ===\n";
+    constexpr uint64_t kKeys = 100000;
+    std::cout << "  " << kKeys << " 个 key，" << totalOps << " 次操作，单位 Mops/s"
+              << "（本机 " << std::thread::hardware_concurrency() << " 核）\n";
+
+    for (unsigned writePercent : {5u, 50u}) {
+        std::cout << "\n  读/写 = " << 100 - writePercent << "/" << writePercent << "\n";
+        std::cout << "  " << std::setw(8) << "threads" << std::setw(14) << "concurrent"
+                  << std::setw(14) << "mutex" << std::setw(10) << "加速比" << "\n";
+        for (size_t threads : {1, 2, 4, 8, 16, 32, 64}) {
+            concurrent_hash_map<uint64_t, uint64_t> cm;
+            MutexMap mm;
+            for (uint64_t k = 0; k < kKeys; k++) {
+                cm.insert_or_assign(k, k);
+                mm.insert_or_assign(k, k);
+            }
+            double a = run_mix(cm, threads, totalOps, writePercent, kKeys);
+            double b = run_mix(mm, threads, totalOps, writePercent, kKeys);
+            std::cout << "  " << std::setw(8) << threads << std::fixed << std::setprecision(2)
+                      << std::setw(14) << a << std::setw(14) << b << std::setw(9) << a / b
+                      << "x\n";
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t totalOps = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+
+    demo_basic();
+    demo_compute_if_absent();
+    demo_weak_iteration();
+    bench_read_write_mix(totalOps);
+    return 0;
+}
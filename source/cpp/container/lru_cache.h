@@ -0,0 +1,224 @@
+#pragma once
+
+// lru_cache.h: 侵入式链表 + 开放寻址索引的 LRU 缓存
+//
+// 经典写法是 std::list<pair<K, V>> 记录新旧顺序，再用 std::unordered_map<K, list::iterator>
+// 做索引：每个条目两次堆分配（链表节点 + 哈希节点），key 存两份，查找要经过两次指针跳转。
+//
+// 这里的结构：
+//   - 条目 Entry { hook, key, value, bytes } 从 NodePool 分配，淘汰后的内存直接复用
+//   - 新旧顺序：intrusive_list<Entry>，命中时 move_to_front 只改 4 个指针
+//   - 索引：flat_hash_set<Entry*>，按 entry->key 哈希（异构查找直接用 Key 查），
+//     每个条目只占 8 字节指针 + 1 字节控制字节；key 只存一份
+//
+// 淘汰：条目数超过 max_entries，或所有条目的估算字节数超过 max_bytes 时，从最久未用的一端淘汰。
+// 字节数由 Weigher 估算，默认是 key / value 的 sizeof 加上字符串、vector 这类容器的堆上数据。
+// 单个条目的估算大小超过 max_bytes 时不会被缓存（同 key 的旧值也一并删除），其他条目不受影响。
+// get() 返回的指针在下一次 put / erase 之前有效。非线程安全。
+
+#include "arena_allocator.h"
+#include "flat_hash_map.h"
+#include "intrusive_list.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+// 容器类成员在堆上占用的字节（粗略估算：元素个数 × 元素大小）。
+// data() 指向对象自身内部时（std::string 的 SSO）没有堆内存，记 0
+template <typename T>
+size_t lru_heap_bytes(const T& v) {
+    if constexpr (requires { v.capacity(); typename T::value_type; }) {
+        if constexpr (requires { v.data(); }) {
+            const void* p = v.data();
+            const void* self = std::addressof(v);
+            const void* selfEnd = reinterpret_cast<const char*>(self) + sizeof(T);
+            if (!std::less<const void*>()(p, self) && std::less<const void*>()(p, selfEnd)) {
+                return 0;
+            }
+        }
+        return v.capacity() * sizeof(typename T::value_type);
+    } else {
+        return 0;
+    }
+}
+
+struct lru_entry_bytes {
+    template <typename K, typename V>
+    size_t operator()(const K& key, const V& value) const {
+        return sizeof(K) + sizeof(V) + lru_heap_bytes(key) + lru_heap_bytes(value);
+    }
+};
+
+template <typename Key, typename Value, typename Hash = flat_hash<Key>,
+          typename KeyEqual = std::equal_to<>, typename Weigher = lru_entry_bytes>
+class lru_cache {
+    struct Entry : intrusive_list_hook<> {
+        template <typename K, typename V>
+        Entry(K&& k, V&& v) : key(std::forward<K>(k)), value(std::forward<V>(v)) {}
+        Key key;
+        Value value;
+        size_t bytes = 0;
+    };
+
+    // 索引里存 Entry*，哈希和比较都作用在 entry->key 上；同时接受 Key 本身做异构查找
+    struct EntryHash {
+        using is_transparent = void;
+        [[no_unique_address]] Hash hash;
+        size_t operator()(Entry* const& e) const { return hash(e->key); }
+        template <typename K>
+        size_t operator()(const K& key) const {
+            return hash(key);
+        }
+    };
+    struct EntryEq {
+        using is_transparent = void;
+        [[no_unique_address]] KeyEqual eq;
+        bool operator()(Entry* const& a, Entry* const& b) const { return eq(a->key, b->key); }
+        template <typename K>
+        bool operator()(Entry* const& a, const K& key) const {
+            return eq(a->key, key);
+        }
+    };
+
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+
+    explicit lru_cache(size_t maxEntries, size_t maxBytes = std::numeric_limits<size_t>::max(),
+                       Weigher weigher = Weigher())
+        : mMaxEntries(maxEntries), mMaxBytes(maxBytes), mWeigher(std::move(weigher)) {
+        mIndex.reserve(maxEntries < (size_t(1) << 24) ? maxEntries : 0);
+    }
+    ~lru_cache() { clear(); }
+    lru_cache(const lru_cache&) = delete;
+    lru_cache& operator=(const lru_cache&) = delete;
+
+    // ---------- 查询 ----------
+    // 命中时把条目标记为最近使用，返回 value 指针；未命中返回 nullptr
+    template <typename K = Key>
+    Value* get(const K& key) {
+        auto it = mIndex.find(key);
+        if (it == mIndex.end()) {
+            ++mMisses;
+            return nullptr;
+        }
+        Entry* e = *it;
+        mList.move_to_front(*e);
+        ++mHits;
+        return &e->value;
+    }
+
+    // 只查看，不改变新旧顺序、不计入命中统计
+    template <typename K = Key>
+    const Value* peek(const K& key) const {
+        auto it = mIndex.find(key);
+        return it == mIndex.end() ? nullptr : &(*it)->value;
+    }
+    template <typename K = Key>
+    bool contains(const K& key) const {
+        return mIndex.contains(key);
+    }
+
+    // ---------- 修改 ----------
+    // 插入或覆盖，并标记为最近使用；之后按容量 / 字节上限淘汰最久未用的条目
+    template <typename K, typename V>
+    void put(K&& key, V&& value) {
+        auto it = mIndex.find(key);
+        Entry* e;
+        if (it != mIndex.end()) {
+            e = *it;
+            e->value = std::forward<V>(value);
+            mBytes -= e->bytes;
+            mList.move_to_front(*e);
+        } else {
+            void* mem = mPool.allocate(sizeof(Entry), alignof(Entry));
+            e = ::new (mem) Entry(std::forward<K>(key), std::forward<V>(value));
+            mIndex.insert(e);
+            mList.push_front(*e);
+        }
+        e->bytes = mWeigher(e->key, e->value);
+        mBytes += e->bytes;
+        if (e->bytes > mMaxBytes) {
+            // 单个条目就超过上限：只丢弃它自己，不为它清空整个缓存
+            mIndex.erase(e);
+            destroy(e);
+            return;
+        }
+        evict();
+    }
+
+    template <typename K = Key>
+    bool erase(const K& key) {
+        auto it = mIndex.find(key);
+        if (it == mIndex.end()) return false;
+        Entry* e = *it;
+        mIndex.erase(it);
+        destroy(e);
+        return true;
+    }
+
+    void clear() {
+        while (!mList.empty()) destroy(&mList.back());
+        mIndex.clear();
+    }
+
+    // 调整上限，立即按新上限淘汰
+    void set_limits(size_t maxEntries, size_t maxBytes = std::numeric_limits<size_t>::max()) {
+        mMaxEntries = maxEntries;
+        mMaxBytes = maxBytes;
+        evict();
+    }
+
+    // 从最近使用到最久未用依次调用 f(key, value)
+    template <typename F>
+    void for_each(F&& f) const {
+        for (const Entry& e : mList) f(e.key, e.value);
+    }
+
+    // ---------- 统计 ----------
+    size_t size() const { return mList.size(); }
+    bool empty() const { return mList.empty(); }
+    size_t bytes() const { return mBytes; }
+    size_t max_entries() const { return mMaxEntries; }
+    size_t max_bytes() const { return mMaxBytes; }
+    size_t hits() const { return mHits; }
+    size_t misses() const { return mMisses; }
+    size_t evictions() const { return mEvictions; }
+
+    // 索引 + 条目池实际占用的字节（不含 key / value 自身的堆内存）
+    size_t memory_usage() const { return mIndex.memory_usage() + mPool.bytes_reserved(); }
+
+private:
+    void evict() {
+        while (!mList.empty() && (mList.size() > mMaxEntries || mBytes > mMaxBytes)) {
+            Entry* victim = &mList.back();
+            mIndex.erase(victim);
+            destroy(victim);
+            ++mEvictions;
+        }
+    }
+
+    // 从链表摘下并归还给节点池（调用前已从索引中删除）
+    void destroy(Entry* e) {
+        mList.remove(*e);
+        mBytes -= e->bytes;
+        std::destroy_at(e);
+        mPool.deallocate(e, sizeof(Entry), alignof(Entry));
+    }
+
+    NodePool mPool;
+    intrusive_list<Entry> mList;  // 表头最近使用，表尾最久未用
+    flat_hash_set<Entry*, EntryHash, EntryEq> mIndex;
+    size_t mMaxEntries;
+    size_t mMaxBytes;
+    size_t mBytes = 0;
+    size_t mHits = 0;
+    size_t mMisses = 0;
+    size_t mEvictions = 0;
+    [[no_unique_address]] Weigher mWeigher;
+};
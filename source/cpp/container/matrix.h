@@ -0,0 +1,561 @@
+#pragma once
+
+// matrix.h: 连续存储的二维矩阵 / N 维数组
+//
+// vector<vector<T>> 的每一行是一次独立的堆分配：行与行在内存里互不相邻，
+// 访问 m[r][c] 要先读行指针再读元素，跨行遍历时硬件预取器也猜不到下一行在哪。
+// 这里把全部元素放进一块对齐的连续内存，下标通过步长（stride）计算：
+//
+//   ndarray<T, N, Layout>  ：拥有数据的 N 维数组；Layout 为行主序（最后一维连续）或列主序（第一维连续）
+//   matrix<T, Layout>      ：ndarray<T, 2, Layout> 的别名
+//   matrix_view<T>         ：不拥有数据的二维视图（数据指针 + 行列数 + 行列步长），
+//                            子块（block）、转置（transposed）都只是换一组步长，不拷贝数据
+//   strided_span<T>        ：带步长的一维视图，即 matrix_view 的一行或一列；
+//                            步长为 1 时可以转成 std::span<T>
+//
+// 存储按 64 字节对齐（缓存行 / AVX-512 宽度）。构造时传入 aligned_rows，
+// 连续维度的长度会补齐到 64 字节的整数倍，于是每一"行"（行主序）或"列"（列主序）的起点都是对齐的，
+// 代价是行尾多出几个不使用的填充元素。line(i) 按内存顺序返回第 i 条连续的行 / 列。
+//
+// 遍历辅助：for_each_element 按内存顺序访问视图中的每个元素；
+// for_each_tile 把视图切成小块，matrix_transpose 用它做分块转置，避免整列跨步访问。
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+enum class matrix_layout { row_major, col_major };
+
+inline constexpr size_t kMatrixAlign = 64;
+
+// ============================================================
+// strided_span：带步长的一维视图
+// ============================================================
+template <typename T>
+class strided_span {
+public:
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using pointer = T*;
+
+    class iterator {
+    public:
+        using iterator_concept = std::random_access_iterator_tag;
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::remove_cv_t<T>;
+        using difference_type = std::ptrdiff_t;
+        using reference = T&;
+        using pointer = T*;
+
+        iterator() = default;
+        iterator(T* p, difference_type stride) : mPtr(p), mStride(stride) {}
+
+        T& operator*() const { return *mPtr; }
+        T* operator->() const { return mPtr; }
+        T& operator[](difference_type n) const { return mPtr[n * mStride]; }
+
+        iterator& operator++() {
+            mPtr += mStride;
+            return *this;
+        }
+        iterator operator++(int) {
+            auto t = *this;
+            ++*this;
+            return t;
+        }
+        iterator& operator--() {
+            mPtr -= mStride;
+            return *this;
+        }
+        iterator operator--(int) {
+            auto t = *this;
+            --*this;
+            return t;
+        }
+        iterator& operator+=(difference_type n) {
+            mPtr += n * mStride;
+            return *this;
+        }
+        iterator& operator-=(difference_type n) {
+            mPtr -= n * mStride;
+            return *this;
+        }
+        friend iterator operator+(iterator it, difference_type n) { return it += n; }
+        friend iterator operator+(difference_type n, iterator it) { return it += n; }
+        friend iterator operator-(iterator it, difference_type n) { return it -= n; }
+        friend difference_type operator-(const iterator& a, const iterator& b) {
+            return (a.mPtr - b.mPtr) / a.mStride;
+        }
+        friend bool operator==(const iterator& a, const iterator& b) { return a.mPtr == b.mPtr; }
+        // 步长可以为负（例如反转视图），比较按逻辑位置而不是地址
+        friend std::strong_ordering operator<=>(const iterator& a, const iterator& b) {
+            return (a - b) <=> 0;
+        }
+
+    private:
+        T* mPtr = nullptr;
+        difference_type mStride = 1;
+    };
+
+    strided_span() = default;
+    strided_span(T* data, size_t size, std::ptrdiff_t stride = 1)
+        : mData(data), mSize(size), mStride(stride) {}
+    strided_span(std::span<T> s) : mData(s.data()), mSize(s.size()) {}
+    template <typename U>
+        requires std::is_convertible_v<U (*)[], T (*)[]>
+    strided_span(const strided_span<U>& o) : mData(o.data()), mSize(o.size()), mStride(o.stride()) {}
+
+    T& operator[](size_t i) const {
+        assert(i < mSize);
+        return mData[std::ptrdiff_t(i) * mStride];
+    }
+    T& front() const { return (*this)[0]; }
+    T& back() const { return (*this)[mSize - 1]; }
+
+    T* data() const noexcept { return mData; }
+    size_t size() const noexcept { return mSize; }
+    bool empty() const noexcept { return mSize == 0; }
+    std::ptrdiff_t stride() const noexcept { return mStride; }
+
+    iterator begin() const { return iterator(mData, mStride); }
+    iterator end() const { return iterator(mData + std::ptrdiff_t(mSize) * mStride, mStride); }
+
+    bool is_contiguous() const noexcept { return mStride == 1 || mSize <= 1; }
+    std::span<T> as_span() const {
+        assert(is_contiguous());
+        return {mData, mSize};
+    }
+
+    strided_span subspan(size_t offset, size_t count) const {
+        assert(offset + count <= mSize);
+        return {mData + std::ptrdiff_t(offset) * mStride, count, mStride};
+    }
+    strided_span reversed() const {
+        if (mSize == 0) return *this;
+        return {mData + std::ptrdiff_t(mSize - 1) * mStride, mSize, -mStride};
+    }
+
+private:
+    T* mData = nullptr;
+    size_t mSize = 0;
+    std::ptrdiff_t mStride = 1;
+};
+
+// ============================================================
+// matrix_view：二维视图
+//   元素 (r, c) 位于 data + r * row_stride + c * col_stride
+// ============================================================
+template <typename T>
+class matrix_view {
+public:
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+
+    matrix_view() = default;
+    matrix_view(T* data, size_t rows, size_t cols, std::ptrdiff_t rowStride, std::ptrdiff_t colStride)
+        : mData(data), mRows(rows), mCols(cols), mRowStride(rowStride), mColStride(colStride) {}
+    template <typename U>
+        requires std::is_convertible_v<U (*)[], T (*)[]>
+    matrix_view(const matrix_view<U>& o)
+        : matrix_view(o.data(), o.rows(), o.cols(), o.row_stride(), o.col_stride()) {}
+
+    T& operator()(size_t r, size_t c) const {
+        assert(r < mRows && c < mCols);
+        return mData[std::ptrdiff_t(r) * mRowStride + std::ptrdiff_t(c) * mColStride];
+    }
+
+    T* data() const noexcept { return mData; }
+    size_t rows() const noexcept { return mRows; }
+    size_t cols() const noexcept { return mCols; }
+    size_t size() const noexcept { return mRows * mCols; }
+    bool empty() const noexcept { return size() == 0; }
+    std::ptrdiff_t row_stride() const noexcept { return mRowStride; }
+    std::ptrdiff_t col_stride() const noexcept { return mColStride; }
+
+    strided_span<T> row(size_t r) const {
+        assert(r < mRows);
+        return {mData + std::ptrdiff_t(r) * mRowStride, mCols, mColStride};
+    }
+    strided_span<T> col(size_t c) const {
+        assert(c < mCols);
+        return {mData + std::ptrdiff_t(c) * mColStride, mRows, mRowStride};
+    }
+
+    // 左上角 (r0, c0)、nr 行 nc 列的子块
+    matrix_view block(size_t r0, size_t c0, size_t nr, size_t nc) const {
+        assert(r0 + nr <= mRows && c0 + nc <= mCols);
+        return {mData + std::ptrdiff_t(r0) * mRowStride + std::ptrdiff_t(c0) * mColStride, nr, nc,
+                mRowStride, mColStride};
+    }
+
+    // 转置视图：交换行列数和步长，不移动数据
+    matrix_view transposed() const { return {mData, mCols, mRows, mColStride, mRowStride}; }
+
+private:
+    T* mData = nullptr;
+    size_t mRows = 0;
+    size_t mCols = 0;
+    std::ptrdiff_t mRowStride = 0;
+    std::ptrdiff_t mColStride = 1;
+};
+
+// ============================================================
+// ndarray：拥有数据的 N 维数组
+// ============================================================
+struct aligned_rows_t {
+    explicit aligned_rows_t() = default;
+};
+inline constexpr aligned_rows_t aligned_rows{};
+
+template <typename T, size_t N, matrix_layout Layout = matrix_layout::row_major>
+class ndarray {
+    static_assert(N >= 1, "ndarray 至少一维");
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using extents_type = std::array<size_t, N>;
+
+    static constexpr size_t rank = N;
+    static constexpr matrix_layout layout = Layout;
+    static constexpr size_t alignment = std::max(kMatrixAlign, alignof(T));
+
+    // ---------- 构造 ----------
+    ndarray() { init(extents_type{}, false); }
+    explicit ndarray(const extents_type& extents, const T& value = T()) {
+        init(extents, false);
+        construct(value);
+    }
+    // 连续维度补齐到 64 字节：每条行 / 列的起点都对齐
+    ndarray(const extents_type& extents, aligned_rows_t, const T& value = T()) {
+        init(extents, true);
+        construct(value);
+    }
+    // matrix<int> m(rows, cols);  ndarray<float, 3> t(2, 3, 4);
+    template <typename... Sizes>
+        requires(sizeof...(Sizes) == N && (std::is_integral_v<Sizes> && ...))
+    explicit ndarray(Sizes... extents) : ndarray(extents_type{size_t(extents)...}) {}
+
+    ndarray(const ndarray& o) : mExtents(o.mExtents), mStrides(o.mStrides), mLine(o.mLine) {
+        mStorage = o.mStorage;
+        mData = allocate(mStorage);
+        try {
+            std::uninitialized_copy_n(o.mData, mStorage, mData);
+        } catch (...) {
+            deallocate(mData);
+            throw;
+        }
+    }
+    ndarray(ndarray&& o) noexcept
+        : mData(std::exchange(o.mData, nullptr)),
+          mStorage(std::exchange(o.mStorage, 0)),
+          mExtents(std::exchange(o.mExtents, extents_type{})),
+          mStrides(o.mStrides),
+          mLine(std::exchange(o.mLine, 0)) {}
+    ndarray& operator=(const ndarray& o) {
+        if (this != &o) {
+            ndarray tmp(o);
+            swap(tmp);
+        }
+        return *this;
+    }
+    ndarray& operator=(ndarray&& o) noexcept {
+        ndarray tmp(std::move(o));
+        swap(tmp);
+        return *this;
+    }
+    ~ndarray() { destroy(); }
+
+    void swap(ndarray& o) noexcept {
+        std::swap(mData, o.mData);
+        std::swap(mStorage, o.mStorage);
+        std::swap(mExtents, o.mExtents);
+        std::swap(mStrides, o.mStrides);
+        std::swap(mLine, o.mLine);
+    }
+    friend void swap(ndarray& a, ndarray& b) noexcept { a.swap(b); }
+
+    // ---------- 形状 ----------
+    const extents_type& extents() const noexcept { return mExtents; }
+    size_t extent(size_t d) const noexcept { return mExtents[d]; }
+    // 第 d 维下标加 1 时指针前进的元素数
+    size_t stride(size_t d) const noexcept { return mStrides[d]; }
+    // 元素个数（不含填充）
+    size_t size() const noexcept {
+        size_t n = 1;
+        for (size_t e : mExtents) n *= e;
+        return n;
+    }
+    bool empty() const noexcept { return size() == 0; }
+    // 实际分配的元素个数（含填充）
+    size_t storage_size() const noexcept { return mStorage; }
+    bool is_contiguous() const noexcept { return mStorage == size(); }
+
+    // ---------- 元素访问 ----------
+    template <typename... Idx>
+        requires(sizeof...(Idx) == N)
+    T& operator()(Idx... idx) {
+        return mData[offset(idx...)];
+    }
+    template <typename... Idx>
+        requires(sizeof...(Idx) == N)
+    const T& operator()(Idx... idx) const {
+        return mData[offset(idx...)];
+    }
+    template <typename... Idx>
+        requires(sizeof...(Idx) == N)
+    T& at(Idx... idx) {
+        checkBounds(idx...);
+        return mData[offset(idx...)];
+    }
+    template <typename... Idx>
+        requires(sizeof...(Idx) == N)
+    const T& at(Idx... idx) const {
+        checkBounds(idx...);
+        return mData[offset(idx...)];
+    }
+
+    T* data() noexcept { return mData; }
+    const T* data() const noexcept { return mData; }
+
+    // 全部元素按内存顺序组成的 span（要求没有填充）
+    std::span<T> flat() noexcept {
+        assert(is_contiguous());
+        return {mData, mStorage};
+    }
+    std::span<const T> flat() const noexcept {
+        assert(is_contiguous());
+        return {mData, mStorage};
+    }
+
+    // 连续维度上的第 i 条"行"（行主序）/"列"（列主序），按内存顺序编号；
+    // 有 aligned_rows 时每条的起点都按 64 字节对齐
+    size_t line_count() const noexcept { return mLine ? mStorage / mLine : 0; }
+    std::span<T> line(size_t i) noexcept {
+        assert(i < line_count());
+        return {mData + i * mLine, mExtents[innerDim()]};
+    }
+    std::span<const T> line(size_t i) const noexcept {
+        assert(i < line_count());
+        return {mData + i * mLine, mExtents[innerDim()]};
+    }
+
+    void fill(const T& value) {
+        for (size_t i = 0; i < line_count(); i++)
+            std::fill_n(line(i).data(), mExtents[innerDim()], value);
+    }
+
+    friend bool operator==(const ndarray& a, const ndarray& b) {
+        if (a.mExtents != b.mExtents) return false;
+        for (size_t i = 0; i < a.line_count(); i++)
+            if (!std::equal(a.line(i).begin(), a.line(i).end(), b.line(i).begin())) return false;
+        return true;
+    }
+
+    // ---------- 二维：行、列、子块 ----------
+    size_t rows() const noexcept
+        requires(N == 2)
+    {
+        return mExtents[0];
+    }
+    size_t cols() const noexcept
+        requires(N == 2)
+    {
+        return mExtents[1];
+    }
+
+    matrix_view<T> view() noexcept
+        requires(N == 2)
+    {
+        return {mData, mExtents[0], mExtents[1], std::ptrdiff_t(mStrides[0]),
+                std::ptrdiff_t(mStrides[1])};
+    }
+    matrix_view<const T> view() const noexcept
+        requires(N == 2)
+    {
+        return {mData, mExtents[0], mExtents[1], std::ptrdiff_t(mStrides[0]),
+                std::ptrdiff_t(mStrides[1])};
+    }
+
+    strided_span<T> row(size_t r)
+        requires(N == 2)
+    {
+        return view().row(r);
+    }
+    strided_span<const T> row(size_t r) const
+        requires(N == 2)
+    {
+        return view().row(r);
+    }
+    strided_span<T> col(size_t c)
+        requires(N == 2)
+    {
+        return view().col(c);
+    }
+    strided_span<const T> col(size_t c) const
+        requires(N == 2)
+    {
+        return view().col(c);
+    }
+    matrix_view<T> block(size_t r0, size_t c0, size_t nr, size_t nc)
+        requires(N == 2)
+    {
+        return view().block(r0, c0, nr, nc);
+    }
+    matrix_view<const T> block(size_t r0, size_t c0, size_t nr, size_t nc) const
+        requires(N == 2)
+    {
+        return view().block(r0, c0, nr, nc);
+    }
+
+    // ---------- 三维：固定第一维下标得到一个二维切片 ----------
+    matrix_view<T> slice(size_t i)
+        requires(N == 3)
+    {
+        assert(i < mExtents[0]);
+        return {mData + i * mStrides[0], mExtents[1], mExtents[2], std::ptrdiff_t(mStrides[1]),
+                std::ptrdiff_t(mStrides[2])};
+    }
+    matrix_view<const T> slice(size_t i) const
+        requires(N == 3)
+    {
+        assert(i < mExtents[0]);
+        return {mData + i * mStrides[0], mExtents[1], mExtents[2], std::ptrdiff_t(mStrides[1]),
+                std::ptrdiff_t(mStrides[2])};
+    }
+
+private:
+    // 连续变化的那一维
+    static constexpr size_t innerDim() { return Layout == matrix_layout::row_major ? N - 1 : 0; }
+
+    // 计算步长；padded 时连续维度的长度向上取整到 alignment 字节
+    void init(const extents_type& extents, bool padded) {
+        mExtents = extents;
+        size_t inner = extents[innerDim()];
+        mLine = inner;
+        if (padded && alignment % sizeof(T) == 0) {
+            size_t per = alignment / sizeof(T);
+            mLine = (inner + per - 1) / per * per;
+        }
+        size_t s = 1;
+        for (size_t k = 0; k < N; k++) {
+            size_t d = Layout == matrix_layout::row_major ? N - 1 - k : k;
+            mStrides[d] = s;
+            s *= (k == 0 ? mLine : extents[d]);
+        }
+        mStorage = size() == 0 ? 0 : s;
+        if (mStorage == 0) mLine = 0;
+    }
+
+    void construct(const T& value) {
+        mData = allocate(mStorage);
+        try {
+            std::uninitialized_fill_n(mData, mStorage, value);
+        } catch (...) {
+            deallocate(mData);
+            throw;
+        }
+    }
+
+    void destroy() noexcept {
+        if (!mData) return;
+        std::destroy_n(mData, mStorage);
+        deallocate(mData);
+        mData = nullptr;
+    }
+
+    static T* allocate(size_t n) {
+        if (n == 0) return nullptr;
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignment)));
+    }
+    static void deallocate(T* p) noexcept {
+        if (p) ::operator delete(p, std::align_val_t(alignment));
+    }
+
+    template <typename... Idx>
+    size_t offset(Idx... idx) const {
+        std::array<size_t, N> ix{size_t(idx)...};
+        size_t off = 0;
+        for (size_t d = 0; d < N; d++) {
+            assert(ix[d] < mExtents[d]);
+            off += ix[d] * mStrides[d];
+        }
+        return off;
+    }
+
+    template <typename... Idx>
+    void checkBounds(Idx... idx) const {
+        std::array<size_t, N> ix{size_t(idx)...};
+        for (size_t d = 0; d < N; d++)
+            if (ix[d] >= mExtents[d]) throw std::out_of_range("ndarray::at: index out of range");
+    }
+
+    T* mData = nullptr;
+    size_t mStorage = 0;  // 分配的元素个数（含填充）
+    extents_type mExtents{};
+    extents_type mStrides{};
+    size_t mLine = 0;  // 相邻两条连续行 / 列的间距（元素数）
+};
+
+template <typename T, matrix_layout Layout = matrix_layout::row_major>
+using matrix = ndarray<T, 2, Layout>;
+
+// ============================================================
+// 遍历辅助
+// ============================================================
+
+// 按内存顺序访问每个元素：内层循环沿步长较小的方向
+template <typename T, typename F>
+void for_each_element(matrix_view<T> m, F&& f) {
+    if (m.empty()) return;
+    if (std::abs(m.col_stride()) <= std::abs(m.row_stride())) {
+        for (size_t r = 0; r < m.rows(); r++) {
+            T* p = &m(r, 0);
+            for (size_t c = 0; c < m.cols(); c++) f(p[std::ptrdiff_t(c) * m.col_stride()]);
+        }
+    } else {
+        for (size_t c = 0; c < m.cols(); c++) {
+            T* p = &m(0, c);
+            for (size_t r = 0; r < m.rows(); r++) f(p[std::ptrdiff_t(r) * m.row_stride()]);
+        }
+    }
+}
+
+// 把视图切成 tileRows x tileCols 的块（边缘块可能更小），依次调用 f(r0, c0, tile)
+template <typename T, typename F>
+void for_each_tile(matrix_view<T> m, size_t tileRows, size_t tileCols, F&& f) {
+    assert(tileRows > 0 && tileCols > 0);
+    for (size_t r0 = 0; r0 < m.rows(); r0 += tileRows)
+        for (size_t c0 = 0; c0 < m.cols(); c0 += tileCols)
+            f(r0, c0,
+              m.block(r0, c0, std::min(tileRows, m.rows() - r0), std::min(tileCols, m.cols() - c0)));
+}
+
+// dst = src 的转置（dst 为 cols x rows）。按 tile x tile 分块：
+// 一个块的源行和目标行都留在 L1 里，不会因为整列跨步写入而每个元素一次缓存缺失
+template <typename S, typename D>
+void matrix_transpose(matrix_view<S> src, matrix_view<D> dst, size_t tile = 32) {
+    assert(dst.rows() == src.cols() && dst.cols() == src.rows());
+    for_each_tile(src, tile, tile, [&](size_t r0, size_t c0, matrix_view<S> blk) {
+        for (size_t r = 0; r < blk.rows(); r++)
+            for (size_t c = 0; c < blk.cols(); c++) dst(c0 + c, r0 + r) = blk(r, c);
+    });
+}
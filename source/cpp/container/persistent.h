@@ -0,0 +1,966 @@
+#pragma once
+
+// persistent.h: 持久化（不可变）vector 与哈希 map —— 结构共享 + transient 批量修改
+//
+// 持久化容器的每次"修改"都返回一个新版本，旧版本保持不变且继续可用；新旧版本共享
+// 绝大部分节点，只复制从根到被改位置的一条路径（O(log32 n) 个节点）。复制一个版本只是
+// 给根节点加一次引用计数，所以给读者拍快照是 O(1)，读者拿到的快照永远不会被写者改动。
+//
+//   persistent_vector<T>   32 叉基数平衡树（radix-balanced trie）+ 尾部缓冲区（Clojure 的做法）：
+//                          下标的每 5 位选一层的孩子；最后不满 32 个的元素单独放在 tail 里，
+//                          push_back / pop_back 大多只复制 tail
+//   persistent_hash_map    HAMT（哈希数组映射树，CHAMP 布局）：64 位哈希每 5 位选一层的槽，
+//                          节点里用两个 32 位位图分别标出"存条目"和"存子节点"的槽，
+//                          条目和子节点指针各自紧凑排列，popcount 算下标；哈希全部用完仍相同
+//                          的 key 放进冲突节点线性查找
+//
+// transient（transient_vector / transient_hash_map）是批量修改用的可变构建器：
+// 节点引用计数为 1（只有自己持有）时原地修改，否则先复制再改（之后这份副本就是自己独有的）。
+// 连续修改同一片区域时只在第一次复制路径，比逐次生成持久化版本少得多的分配；
+// persistent() 把结果交回成持久化版本，transient 随即变空。持久化容器的修改操作
+// 本身就是"O(1) 复制一份 + 在副本上做 transient 修改"。
+//
+// 引用计数是原子的：不同线程可以同时持有、复制、释放同一份数据的不同版本；
+// 同一个容器对象（或同一个 transient）的并发读写仍需要外部同步。
+// 这里没有实现 RRB 的"松弛节点"（任意位置拼接 / 切分），只支持尾部增删与按下标修改。
+
+#include "hash_utils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+inline constexpr unsigned kPersistentBits = 5;
+inline constexpr unsigned kPersistentWidth = 1u << kPersistentBits;
+inline constexpr unsigned kPersistentMask = kPersistentWidth - 1;
+
+// 引用计数节点的公共部分
+struct persistent_node {
+    std::atomic<uint32_t> refs{1};
+
+    // 只有自己持有时才能原地修改；其它持有者不可能在此期间再增加引用
+    bool unique() const { return refs.load(std::memory_order_acquire) == 1; }
+    void retain() { refs.fetch_add(1, std::memory_order_relaxed); }
+    // 返回 true 表示释放的是最后一个引用，调用者负责销毁
+    bool release() { return refs.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+};
+
+template <typename T>
+class transient_vector;
+
+// ============================================================
+// persistent_vector
+// ============================================================
+template <typename T>
+class persistent_vector {
+    friend class transient_vector<T>;
+
+    struct Inner : persistent_node {
+        persistent_node* child[kPersistentWidth] = {};
+    };
+
+    struct Leaf : persistent_node {
+        uint32_t count = 0;
+        alignas(T) unsigned char storage[kPersistentWidth * sizeof(T)];
+
+        Leaf() = default;
+        Leaf(const Leaf& o) : persistent_node() {
+            try {
+                for (; count < o.count; ++count)
+                    ::new (static_cast<void*>(items() + count)) T(o.items()[count]);
+            } catch (...) {
+                std::destroy_n(items(), count);
+                throw;
+            }
+        }
+        ~Leaf() { std::destroy_n(items(), count); }
+
+        T* items() { return std::launder(reinterpret_cast<T*>(storage)); }
+        const T* items() const { return std::launder(reinterpret_cast<const T*>(storage)); }
+    };
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = const T&;
+    using const_reference = const T&;
+
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        const_iterator() = default;
+
+        reference operator*() const { return mLeaf[mIndex & kPersistentMask]; }
+        pointer operator->() const { return &**this; }
+        // 跨过 32 个元素的边界时才重新从根走到下一个叶子
+        const_iterator& operator++() {
+            if ((++mIndex & kPersistentMask) == 0 && mIndex < mVec->mSize)
+                mLeaf = mVec->leafFor(mIndex)->items();
+            return *this;
+        }
+        const_iterator operator++(int) {
+            const_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        friend bool operator==(const const_iterator& a, const const_iterator& b) {
+            return a.mIndex == b.mIndex;
+        }
+
+    private:
+        friend class persistent_vector;
+        const_iterator(const persistent_vector* v, size_t i)
+            : mVec(v), mIndex(i), mLeaf(i < v->mSize ? v->leafFor(i)->items() : nullptr) {}
+
+        const persistent_vector* mVec = nullptr;
+        size_t mIndex = 0;
+        const T* mLeaf = nullptr;
+    };
+    using iterator = const_iterator;
+
+    // ---------- 构造 / 析构 / 赋值：复制只是给根和 tail 加引用 ----------
+    persistent_vector() noexcept = default;
+    persistent_vector(std::initializer_list<T> init);
+    template <typename It, typename = std::enable_if_t<!std::is_integral_v<It>>>
+    persistent_vector(It first, It last);
+
+    persistent_vector(const persistent_vector& o) noexcept
+        : mRoot(o.mRoot), mTail(o.mTail), mSize(o.mSize), mShift(o.mShift) {
+        if (mRoot) mRoot->retain();
+        if (mTail) mTail->retain();
+    }
+    persistent_vector(persistent_vector&& o) noexcept
+        : mRoot(std::exchange(o.mRoot, nullptr)),
+          mTail(std::exchange(o.mTail, nullptr)),
+          mSize(std::exchange(o.mSize, 0)),
+          mShift(std::exchange(o.mShift, kPersistentBits)) {}
+    ~persistent_vector() {
+        releaseNode(mRoot, mShift);
+        releaseNode(mTail, 0);
+    }
+    persistent_vector& operator=(persistent_vector o) noexcept {
+        swap(o);
+        return *this;
+    }
+    void swap(persistent_vector& o) noexcept {
+        std::swap(mRoot, o.mRoot);
+        std::swap(mTail, o.mTail);
+        std::swap(mSize, o.mSize);
+        std::swap(mShift, o.mShift);
+    }
+    friend void swap(persistent_vector& a, persistent_vector& b) noexcept { a.swap(b); }
+
+    // ---------- 读取 ----------
+    size_t size() const noexcept { return mSize; }
+    bool empty() const noexcept { return mSize == 0; }
+
+    const T& operator[](size_t i) const { return leafFor(i)->items()[i & kPersistentMask]; }
+    const T& at(size_t i) const {
+        if (i >= mSize) throw std::out_of_range("persistent_vector::at");
+        return (*this)[i];
+    }
+    const T& front() const { return (*this)[0]; }
+    const T& back() const { return (*this)[mSize - 1]; }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, mSize); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    // ---------- 修改：返回新版本，*this 不变 ----------
+    [[nodiscard]] persistent_vector push_back(T value) const {
+        persistent_vector r(*this);
+        r.emplaceBack(std::move(value));
+        return r;
+    }
+    [[nodiscard]] persistent_vector set(size_t i, T value) const {
+        if (i >= mSize) throw std::out_of_range("persistent_vector::set");
+        persistent_vector r(*this);
+        r.assign(i, std::move(value));
+        return r;
+    }
+    // 前置条件：!empty()
+    [[nodiscard]] persistent_vector pop_back() const {
+        persistent_vector r(*this);
+        r.popBack();
+        return r;
+    }
+
+    transient_vector<T> transient() const& { return transient_vector<T>(*this); }
+    transient_vector<T> transient() && { return transient_vector<T>(std::move(*this)); }
+
+    friend bool operator==(const persistent_vector& a, const persistent_vector& b) {
+        if (a.mRoot == b.mRoot && a.mTail == b.mTail) return a.mSize == b.mSize;
+        return std::equal(a.begin(), a.end(), b.begin(), b.end());
+    }
+
+private:
+    // 下标 >= tailOffset 的元素在 tail 里
+    size_t tailOffset() const {
+        return mSize < kPersistentWidth ? 0 : ((mSize - 1) >> kPersistentBits) << kPersistentBits;
+    }
+
+    const Leaf* leafFor(size_t i) const {
+        if (i >= tailOffset()) return mTail;
+        const persistent_node* n = mRoot;
+        for (unsigned level = mShift; level > 0; level -= kPersistentBits)
+            n = static_cast<const Inner*>(n)->child[(i >> level) & kPersistentMask];
+        return static_cast<const Leaf*>(n);
+    }
+
+    // shift 是节点所在层：0 为叶子，否则为内部节点
+    static void releaseNode(persistent_node* n, unsigned shift) noexcept {
+        if (!n || !n->release()) return;
+        if (shift == 0) {
+            delete static_cast<Leaf*>(n);
+            return;
+        }
+        Inner* in = static_cast<Inner*>(n);
+        for (persistent_node* c : in->child) releaseNode(c, shift - kPersistentBits);
+        delete in;
+    }
+
+    // 拿到可以原地修改的节点：独占就是它自己，否则复制一份（孩子加引用）并放掉对原节点的引用
+    static Leaf* editable(Leaf* l) {
+        if (l->unique()) return l;
+        Leaf* copy = new Leaf(*l);
+        releaseNode(l, 0);
+        return copy;
+    }
+    static Inner* editable(Inner* n, unsigned shift) {
+        if (n->unique()) return n;
+        Inner* copy = new Inner;
+        for (unsigned i = 0; i < kPersistentWidth; i++)
+            if ((copy->child[i] = n->child[i])) copy->child[i]->retain();
+        releaseNode(n, shift);
+        return copy;
+    }
+
+    // 从 level 层开始、一路只有第 0 个孩子、最底下是 leaf 的新路径
+    static persistent_node* newPath(unsigned level, Leaf* leaf) {
+        persistent_node* n = leaf;
+        try {
+            for (unsigned l = 0; l < level; l += kPersistentBits) {
+                Inner* parent = new Inner;
+                parent->child[0] = n;
+                n = parent;
+            }
+        } catch (...) {
+            while (n != leaf) {
+                Inner* in = static_cast<Inner*>(n);
+                n = in->child[0];
+                delete in;
+            }
+            throw;
+        }
+        return n;
+    }
+
+    // ---------- 原地修改（独占的节点直接改，共享的先复制）----------
+    template <typename... Args>
+    void emplaceBack(Args&&... args) {
+        if (mTail && mTail->count < kPersistentWidth) {
+            mTail = editable(mTail);
+            T* slot = mTail->items() + mTail->count;
+            ::new (static_cast<void*>(slot)) T(std::forward<Args>(args)...);
+            ++mTail->count;
+            ++mSize;
+            return;
+        }
+        // tail 已满：新元素放进新 tail，旧 tail 挂进树里
+        auto fresh = std::make_unique<Leaf>();
+        ::new (static_cast<void*>(fresh->items())) T(std::forward<Args>(args)...);
+        fresh->count = 1;
+        if (mTail) pushTail();
+        mTail = fresh.release();
+        ++mSize;
+    }
+
+    // 把已满的 mTail（下标 [mSize - 32, mSize)）挂到树的最右边；树满时长高一层
+    void pushTail() {
+        if (!mRoot) {
+            mRoot = new Inner;
+            mRoot->child[0] = mTail;
+            mShift = kPersistentBits;
+            return;
+        }
+        if ((mSize >> kPersistentBits) > (size_t(1) << mShift)) {
+            auto root = std::make_unique<Inner>();
+            root->child[1] = newPath(mShift, mTail);
+            root->child[0] = mRoot;
+            mRoot = root.release();
+            mShift += kPersistentBits;
+            return;
+        }
+        size_t idx = mSize - 1;
+        mRoot = editable(mRoot, mShift);
+        Inner* node = mRoot;
+        for (unsigned level = mShift;; level -= kPersistentBits) {
+            persistent_node*& slot = node->child[(idx >> level) & kPersistentMask];
+            if (level == kPersistentBits) {
+                slot = mTail;
+                return;
+            }
+            if (!slot) {
+                slot = newPath(level - kPersistentBits, mTail);
+                return;
+            }
+            node = editable(static_cast<Inner*>(slot), level - kPersistentBits);
+            slot = node;
+        }
+    }
+
+    void assign(size_t i, T&& value) {
+        if (i >= tailOffset()) {
+            mTail = editable(mTail);
+            mTail->items()[i & kPersistentMask] = std::move(value);
+            return;
+        }
+        mRoot = editable(mRoot, mShift);
+        Inner* node = mRoot;
+        for (unsigned level = mShift; level > kPersistentBits; level -= kPersistentBits) {
+            persistent_node*& slot = node->child[(i >> level) & kPersistentMask];
+            node = editable(static_cast<Inner*>(slot), level - kPersistentBits);
+            slot = node;
+        }
+        persistent_node*& slot = node->child[(i >> kPersistentBits) & kPersistentMask];
+        Leaf* leaf = editable(static_cast<Leaf*>(slot));
+        slot = leaf;
+        leaf->items()[i & kPersistentMask] = std::move(value);
+    }
+
+    void popBack() {
+        if (mSize == 1) {
+            releaseNode(mTail, 0);
+            mTail = nullptr;
+            mSize = 0;
+            return;
+        }
+        if (mTail->count > 1) {
+            mTail = editable(mTail);
+            std::destroy_at(mTail->items() + --mTail->count);
+            --mSize;
+            return;
+        }
+        // tail 只剩一个元素：树里最后一个叶子成为新 tail，并从树中摘掉
+        Leaf* newTail = const_cast<Leaf*>(leafFor(mSize - 2));
+        newTail->retain();
+        bool emptied;
+        try {
+            mRoot = editable(mRoot, mShift);
+            emptied = popLeaf(mRoot, mShift, mSize - 2);
+        } catch (...) {
+            releaseNode(newTail, 0);
+            throw;
+        }
+        if (emptied) {
+            releaseNode(mRoot, mShift);
+            mRoot = nullptr;
+            mShift = kPersistentBits;
+        } else if (mShift > kPersistentBits && !mRoot->child[1]) {
+            // 根只剩一个孩子：树变矮一层
+            Inner* child = static_cast<Inner*>(mRoot->child[0]);
+            child->retain();
+            releaseNode(mRoot, mShift);
+            mRoot = child;
+            mShift -= kPersistentBits;
+        }
+        releaseNode(mTail, 0);
+        mTail = newTail;
+        --mSize;
+    }
+
+    // 摘掉可修改节点 node 下包含下标 idx 的（最右）叶子；返回 node 是否因此变空。
+    // 可能抛异常的复制都发生在释放叶子之前
+    static bool popLeaf(Inner* node, unsigned level, size_t idx) {
+        size_t sub = (idx >> level) & kPersistentMask;
+        persistent_node*& slot = node->child[sub];
+        if (level > kPersistentBits) {
+            Inner* child = editable(static_cast<Inner*>(slot), level - kPersistentBits);
+            slot = child;
+            if (!popLeaf(child, level - kPersistentBits, idx)) return false;
+            releaseNode(child, level - kPersistentBits);
+            slot = nullptr;
+        } else {
+            releaseNode(slot, 0);
+            slot = nullptr;
+        }
+        return sub == 0;
+    }
+
+    Inner* mRoot = nullptr;  // 下标 [0, tailOffset()) 的元素；不足 33 个元素时为空
+    Leaf* mTail = nullptr;
+    size_t mSize = 0;
+    unsigned mShift = kPersistentBits;  // 根节点所在层
+};
+
+// persistent_vector 的批量修改构建器：独占的节点原地改
+template <typename T>
+class transient_vector {
+public:
+    transient_vector() = default;
+    explicit transient_vector(persistent_vector<T> v) noexcept : mVec(std::move(v)) {}
+
+    size_t size() const noexcept { return mVec.size(); }
+    bool empty() const noexcept { return mVec.empty(); }
+    const T& operator[](size_t i) const { return mVec[i]; }
+
+    void push_back(const T& value) { mVec.emplaceBack(value); }
+    void push_back(T&& value) { mVec.emplaceBack(std::move(value)); }
+    template <typename... Args>
+    void emplace_back(Args&&... args) {
+        mVec.emplaceBack(std::forward<Args>(args)...);
+    }
+    void set(size_t i, T value) {
+        if (i >= size()) throw std::out_of_range("transient_vector::set");
+        mVec.assign(i, std::move(value));
+    }
+    void pop_back() { mVec.popBack(); }
+
+    // 交出结果；之后本 transient 为空
+    persistent_vector<T> persistent() { return std::exchange(mVec, persistent_vector<T>()); }
+
+private:
+    persistent_vector<T> mVec;
+};
+
+template <typename T>
+persistent_vector<T>::persistent_vector(std::initializer_list<T> init)
+    : persistent_vector(init.begin(), init.end()) {}
+
+template <typename T>
+template <typename It, typename>
+persistent_vector<T>::persistent_vector(It first, It last) : persistent_vector() {
+    for (; first != last; ++first) emplaceBack(*first);
+}
+
+// ============================================================
+// persistent_hash_map（HAMT / CHAMP）
+// ============================================================
+template <typename K, typename V, typename Hash, typename KeyEqual>
+class transient_hash_map;
+
+template <typename K, typename V, typename Hash = std::hash<K>,
+          typename KeyEqual = std::equal_to<K>>
+class persistent_hash_map {
+    friend class transient_hash_map<K, V, Hash, KeyEqual>;
+
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<K, V>;
+    using size_type = size_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+
+private:
+    using Entry = value_type;
+
+    // 64 位哈希按 5 位一层：第 0..12 层是位图节点，哈希用完（shift >= 64）的一层是冲突节点
+    static constexpr unsigned kHashBits = 64;
+    static constexpr unsigned kMaxDepth = kHashBits / kPersistentBits + 2;
+    static constexpr uint32_t kNone = ~uint32_t(0);
+
+    // 节点头后面紧跟 dataCount 个条目、nodeCount 个子节点指针，一次分配
+    struct Node : persistent_node {
+        uint32_t dataMap = 0;  // 第 b 位为 1：槽 b 存一个条目
+        uint32_t nodeMap = 0;  // 第 b 位为 1：槽 b 存一个子节点
+        uint32_t dataCount = 0;
+        uint32_t nodeCount = 0;
+
+        Entry* entries() {
+            return std::launder(
+                reinterpret_cast<Entry*>(reinterpret_cast<char*>(this) + kEntriesOffset));
+        }
+        const Entry* entries() const { return const_cast<Node*>(this)->entries(); }
+        Node** children() {
+            char* base = reinterpret_cast<char*>(this);
+            return reinterpret_cast<Node**>(base + childrenOffset(dataCount));
+        }
+        Node* const* children() const { return const_cast<Node*>(this)->children(); }
+    };
+
+    static constexpr size_t roundUp(size_t n, size_t a) { return (n + a - 1) / a * a; }
+    static constexpr size_t kEntriesOffset = roundUp(sizeof(Node), alignof(Entry));
+    static constexpr size_t childrenOffset(uint32_t dataCount) {
+        return roundUp(kEntriesOffset + dataCount * sizeof(Entry), alignof(Node*));
+    }
+    static constexpr std::align_val_t kNodeAlign{std::max(alignof(Node), alignof(Entry))};
+
+public:
+    // 前序遍历：先本节点的条目，再依次进入子节点
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<K, V>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        const_iterator() = default;
+
+        reference operator*() const {
+            const Frame& f = mStack[mDepth - 1];
+            return f.node->entries()[f.entry];
+        }
+        pointer operator->() const { return &**this; }
+        const_iterator& operator++() {
+            ++mStack[mDepth - 1].entry;
+            settle();
+            return *this;
+        }
+        const_iterator operator++(int) {
+            const_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        friend bool operator==(const const_iterator& a, const const_iterator& b) {
+            if (a.mDepth == 0 || b.mDepth == 0) return a.mDepth == b.mDepth;
+            return &*a == &*b;
+        }
+
+    private:
+        friend class persistent_hash_map;
+        struct Frame {
+            const Node* node;
+            uint32_t entry;
+            uint32_t child;
+        };
+
+        explicit const_iterator(const Node* root) {
+            if (!root) return;
+            mStack[mDepth++] = {root, 0, 0};
+            settle();
+        }
+
+        // 停在下一个条目上；没有了就 mDepth = 0（end）
+        void settle() {
+            while (mDepth > 0) {
+                Frame& f = mStack[mDepth - 1];
+                if (f.entry < f.node->dataCount) return;
+                if (f.child < f.node->nodeCount) {
+                    mStack[mDepth++] = {f.node->children()[f.child++], 0, 0};
+                    continue;
+                }
+                --mDepth;
+            }
+        }
+
+        Frame mStack[kMaxDepth] = {};
+        unsigned mDepth = 0;
+    };
+    using iterator = const_iterator;
+
+    // ---------- 构造 / 析构 / 赋值 ----------
+    persistent_hash_map() = default;
+    persistent_hash_map(std::initializer_list<value_type> init) : persistent_hash_map() {
+        for (const auto& [k, v] : init) setIn(k, v);
+    }
+
+    persistent_hash_map(const persistent_hash_map& o)
+        : mRoot(o.mRoot), mSize(o.mSize), mHash(o.mHash), mEq(o.mEq) {
+        if (mRoot) mRoot->retain();
+    }
+    persistent_hash_map(persistent_hash_map&& o) noexcept
+        : mRoot(std::exchange(o.mRoot, nullptr)),
+          mSize(std::exchange(o.mSize, 0)),
+          mHash(std::move(o.mHash)),
+          mEq(std::move(o.mEq)) {}
+    ~persistent_hash_map() { releaseNode(mRoot, 0); }
+    persistent_hash_map& operator=(persistent_hash_map o) noexcept {
+        swap(o);
+        return *this;
+    }
+    void swap(persistent_hash_map& o) noexcept {
+        std::swap(mRoot, o.mRoot);
+        std::swap(mSize, o.mSize);
+        std::swap(mHash, o.mHash);
+        std::swap(mEq, o.mEq);
+    }
+    friend void swap(persistent_hash_map& a, persistent_hash_map& b) noexcept { a.swap(b); }
+
+    // ---------- 读取 ----------
+    size_t size() const noexcept { return mSize; }
+    bool empty() const noexcept { return mSize == 0; }
+
+    // 找不到返回 nullptr
+    const V* find(const K& key) const { return findIn(key, hashOf(key)); }
+    bool contains(const K& key) const { return find(key) != nullptr; }
+    size_t count(const K& key) const { return contains(key) ? 1 : 0; }
+    const V& at(const K& key) const {
+        const V* v = find(key);
+        if (!v) throw std::out_of_range("persistent_hash_map::at");
+        return *v;
+    }
+
+    const_iterator begin() const { return const_iterator(mRoot); }
+    const_iterator end() const { return const_iterator(); }
+
+    // ---------- 修改：返回新版本，*this 不变 ----------
+    // 插入或覆盖
+    [[nodiscard]] persistent_hash_map set(K key, V value) const {
+        persistent_hash_map r(*this);
+        r.setIn(std::move(key), std::move(value));
+        return r;
+    }
+    // key 不存在时返回的新版本与 *this 共享根节点
+    [[nodiscard]] persistent_hash_map erase(const K& key) const {
+        persistent_hash_map r(*this);
+        r.eraseIn(key);
+        return r;
+    }
+
+    transient_hash_map<K, V, Hash, KeyEqual> transient() const& {
+        return transient_hash_map<K, V, Hash, KeyEqual>(*this);
+    }
+    transient_hash_map<K, V, Hash, KeyEqual> transient() && {
+        return transient_hash_map<K, V, Hash, KeyEqual>(std::move(*this));
+    }
+
+    friend bool operator==(const persistent_hash_map& a, const persistent_hash_map& b) {
+        if (a.mSize != b.mSize) return false;
+        if (a.mRoot == b.mRoot) return true;
+        for (const auto& [k, v] : a) {
+            const V* other = b.find(k);
+            if (!other || !(*other == v)) return false;
+        }
+        return true;
+    }
+
+private:
+    uint64_t hashOf(const K& key) const { return hash_mix(static_cast<uint64_t>(mHash(key))); }
+
+    static uint32_t slotBit(uint64_t hash, unsigned shift) {
+        return uint32_t(1) << ((hash >> shift) & kPersistentMask);
+    }
+    static uint32_t indexOf(uint32_t map, uint32_t bit) {
+        return static_cast<uint32_t>(std::popcount(map & (bit - 1)));
+    }
+
+    // 条目尚未构造
+    static Node* allocNode(uint32_t dataMap, uint32_t nodeMap, uint32_t dataCount,
+                           uint32_t nodeCount) {
+        size_t bytes = childrenOffset(dataCount) + nodeCount * sizeof(Node*);
+        Node* n = ::new (::operator new(bytes, kNodeAlign)) Node;
+        n->dataMap = dataMap;
+        n->nodeMap = nodeMap;
+        n->dataCount = dataCount;
+        n->nodeCount = nodeCount;
+        return n;
+    }
+    // 只回收内存：条目已析构或已搬走，子节点的引用已转交
+    static void freeShell(Node* n) noexcept {
+        n->~Node();
+        ::operator delete(n, kNodeAlign);
+    }
+    // shift 是节点所在层，子节点在 shift + 5 层
+    static void releaseNode(Node* n, unsigned shift) noexcept {
+        if (!n || !n->release()) return;
+        std::destroy_n(n->entries(), n->dataCount);
+        for (uint32_t i = 0; i < n->nodeCount; i++)
+            releaseNode(n->children()[i], shift + kPersistentBits);
+        freeShell(n);
+    }
+
+    // 独占且条目移动不抛异常时，可以把 old 的条目搬走、直接接管它的子节点
+    static bool canSteal(const Node* n) {
+        return n->unique() && std::is_nothrow_move_constructible_v<Entry>;
+    }
+
+    // 生成 old 的一个变形（kNone / nullptr 表示不做相应的增删）：
+    //   条目 = old 的条目去掉第 dropEntry 个后在 addAt 处插入 *add，
+    //   子节点 = old 的子节点去掉第 dropChild 个后在 childAt 处插入 addChild。
+    // 消耗调用者对 old 的引用：old 独占时搬走条目、接管子节点、放掉被去掉的子节点并回收外壳，
+    // 否则拷贝条目、给子节点加引用。into 是预先分配好的目标节点：给了它，独占时就不会再失败
+    static Node* reshape(Node* old, unsigned shift, uint32_t dataMap, uint32_t nodeMap,
+                         uint32_t dropEntry, uint32_t addAt, Entry* add, uint32_t dropChild,
+                         uint32_t childAt, Node* addChild, Node* into = nullptr) {
+        uint32_t nData = old->dataCount - (dropEntry != kNone) + (add != nullptr);
+        uint32_t nNodes = old->nodeCount - (dropChild != kNone) + (addChild != nullptr);
+        Node* n = into ? into : allocNode(dataMap, nodeMap, nData, nNodes);
+        bool steal = canSteal(old);
+
+        Entry* src = old->entries();
+        Entry* dst = n->entries();
+        uint32_t built = 0;
+        try {
+            for (uint32_t i = 0; built < nData; built++) {
+                if (add && built == addAt) {
+                    ::new (static_cast<void*>(dst + built)) Entry(std::move(*add));
+                    continue;
+                }
+                if (i == dropEntry) i++;
+                if (steal) ::new (static_cast<void*>(dst + built)) Entry(std::move(src[i++]));
+                else ::new (static_cast<void*>(dst + built)) Entry(src[i++]);
+            }
+        } catch (...) {
+            std::destroy_n(dst, built);
+            freeShell(n);
+            throw;
+        }
+
+        Node** cs = old->children();
+        Node** cd = n->children();
+        for (uint32_t i = 0, k = 0; k < nNodes; k++) {
+            if (addChild && k == childAt) {
+                cd[k] = addChild;
+                continue;
+            }
+            if (i == dropChild) i++;
+            cd[k] = cs[i++];
+            if (!steal) cd[k]->retain();
+        }
+
+        if (steal) {
+            if (dropChild != kNone) releaseNode(cs[dropChild], shift + kPersistentBits);
+            std::destroy_n(src, old->dataCount);
+            freeShell(old);
+        } else {
+            releaseNode(old, shift);
+        }
+        return n;
+    }
+
+    // 可原地修改的节点：独占就是它自己，否则复制一份并放掉对原节点的引用
+    static Node* editable(Node* n, unsigned shift) {
+        if (n->unique()) return n;
+        return reshape(n, shift, n->dataMap, n->nodeMap, kNone, kNone, nullptr, kNone, kNone,
+                       nullptr);
+    }
+
+    // 两个在 shift 之前各层都冲突的条目放进以 shift 层为根的新子树：a 是已有条目（moveA 时搬走），
+    // b 由 key / value 构造。先分配好所有节点再构造条目，a 只在不会再失败时才被搬走
+    template <typename KK, typename VV>
+    static Node* makePair(Entry& a, bool moveA, uint64_t ha, KK&& key, VV&& value, uint64_t hb,
+                          unsigned shift) {
+        unsigned bottomShift = shift;
+        while (bottomShift < kHashBits && slotBit(ha, bottomShift) == slotBit(hb, bottomShift))
+            bottomShift += kPersistentBits;
+        bool collision = bottomShift >= kHashBits;
+        uint32_t ba = collision ? 0 : slotBit(ha, bottomShift);
+        uint32_t bb = collision ? 0 : slotBit(hb, bottomShift);
+
+        Node* bottom = allocNode(ba | bb, 0, 2, 0);
+        Node* top = bottom;
+        try {
+            for (unsigned s = bottomShift; s > shift;) {
+                s -= kPersistentBits;
+                Node* parent = allocNode(0, slotBit(hb, s), 0, 1);
+                parent->children()[0] = top;
+                top = parent;
+            }
+            bool aFirst = collision || ba < bb;
+            Entry* da = bottom->entries() + (aFirst ? 0 : 1);
+            Entry* db = bottom->entries() + (aFirst ? 1 : 0);
+            ::new (static_cast<void*>(db)) Entry(std::forward<KK>(key), std::forward<VV>(value));
+            try {
+                if (moveA) ::new (static_cast<void*>(da)) Entry(std::move(a));
+                else ::new (static_cast<void*>(da)) Entry(a);
+            } catch (...) {
+                std::destroy_at(db);
+                throw;
+            }
+        } catch (...) {
+            while (top != bottom) {
+                Node* child = top->children()[0];
+                freeShell(top);
+                top = child;
+            }
+            freeShell(bottom);
+            throw;
+        }
+        return top;
+    }
+
+    // ---------- 查找 ----------
+    const V* findIn(const K& key, uint64_t hash) const {
+        const Node* node = mRoot;
+        if (!node) return nullptr;
+        for (unsigned shift = 0;; shift += kPersistentBits) {
+            if (shift >= kHashBits) {
+                for (uint32_t i = 0; i < node->dataCount; i++)
+                    if (mEq(node->entries()[i].first, key)) return &node->entries()[i].second;
+                return nullptr;
+            }
+            uint32_t bit = slotBit(hash, shift);
+            if (node->dataMap & bit) {
+                const Entry& e = node->entries()[indexOf(node->dataMap, bit)];
+                return mEq(e.first, key) ? &e.second : nullptr;
+            }
+            if (!(node->nodeMap & bit)) return nullptr;
+            node = node->children()[indexOf(node->nodeMap, bit)];
+        }
+    }
+
+    // ---------- 原地修改（独占的节点直接改，共享的先复制）----------
+    template <typename KK, typename VV>
+    void setIn(KK&& key, VV&& value) {
+        if (!mRoot) mRoot = allocNode(0, 0, 0, 0);
+        uint64_t hash = hashOf(key);
+        mSize += setAt(mRoot, 0, hash, std::forward<KK>(key), std::forward<VV>(value));
+    }
+
+    // 在 slot 指向的、位于 shift 层的子树里插入或覆盖；返回是否新增了 key
+    template <typename KK, typename VV>
+    bool setAt(Node*& slot, unsigned shift, uint64_t hash, KK&& key, VV&& value) {
+        Node* node = slot;
+        if (shift >= kHashBits) {
+            for (uint32_t i = 0; i < node->dataCount; i++) {
+                if (mEq(node->entries()[i].first, key)) {
+                    slot = node = editable(node, shift);
+                    node->entries()[i].second = std::forward<VV>(value);
+                    return false;
+                }
+            }
+            Entry add(std::forward<KK>(key), std::forward<VV>(value));
+            slot = reshape(node, shift, 0, 0, kNone, node->dataCount, &add, kNone, kNone, nullptr);
+            return true;
+        }
+
+        uint32_t bit = slotBit(hash, shift);
+        if (node->dataMap & bit) {
+            uint32_t i = indexOf(node->dataMap, bit);
+            Entry& e = node->entries()[i];
+            if (mEq(e.first, key)) {
+                slot = node = editable(node, shift);
+                node->entries()[i].second = std::forward<VV>(value);
+                return false;
+            }
+            // 槽里已有另一个 key：两个条目一起下沉到新的子节点，本层的条目槽变成子节点槽。
+            // 本层的新节点先分配好，原条目被搬走之后就不会再有失败
+            bool steal = canSteal(node);
+            uint32_t dataMap = node->dataMap & ~bit, nodeMap = node->nodeMap | bit;
+            Node* into = allocNode(dataMap, nodeMap, node->dataCount - 1, node->nodeCount + 1);
+            Node* sub;
+            try {
+                sub = makePair(e, steal, hashOf(e.first), std::forward<KK>(key),
+                               std::forward<VV>(value), hash, shift + kPersistentBits);
+            } catch (...) {
+                freeShell(into);
+                throw;
+            }
+            try {
+                slot = reshape(node, shift, dataMap, nodeMap, i, kNone, nullptr, kNone,
+                               indexOf(nodeMap, bit), sub, into);
+            } catch (...) {
+                releaseNode(sub, shift + kPersistentBits);
+                throw;
+            }
+            return true;
+        }
+        if (node->nodeMap & bit) {
+            slot = node = editable(node, shift);
+            Node*& child = node->children()[indexOf(node->nodeMap, bit)];
+            return setAt(child, shift + kPersistentBits, hash, std::forward<KK>(key),
+                         std::forward<VV>(value));
+        }
+        Entry add(std::forward<KK>(key), std::forward<VV>(value));
+        uint32_t dataMap = node->dataMap | bit;
+        slot = reshape(node, shift, dataMap, node->nodeMap, kNone, indexOf(dataMap, bit), &add,
+                       kNone, kNone, nullptr);
+        return true;
+    }
+
+    void eraseIn(const K& key) {
+        if (!mRoot) return;
+        uint64_t hash = hashOf(key);
+        // 先确认 key 存在：不存在时不做任何路径复制
+        if (!findIn(key, hash)) return;
+        eraseAt(mRoot, 0, hash, key);
+        --mSize;
+        if (mSize == 0) {
+            releaseNode(mRoot, 0);
+            mRoot = nullptr;
+        }
+    }
+
+    // 前置条件：key 在 slot 指向的子树里
+    void eraseAt(Node*& slot, unsigned shift, uint64_t hash, const K& key) {
+        Node* node = slot;
+        if (shift >= kHashBits) {
+            uint32_t i = 0;
+            while (!mEq(node->entries()[i].first, key)) i++;
+            slot = reshape(node, shift, 0, 0, i, kNone, nullptr, kNone, kNone, nullptr);
+            return;
+        }
+        uint32_t bit = slotBit(hash, shift);
+        if (node->dataMap & bit) {
+            slot = reshape(node, shift, node->dataMap & ~bit, node->nodeMap,
+                           indexOf(node->dataMap, bit), kNone, nullptr, kNone, kNone, nullptr);
+            return;
+        }
+        slot = node = editable(node, shift);
+        uint32_t j = indexOf(node->nodeMap, bit);
+        Node*& childSlot = node->children()[j];
+        eraseAt(childSlot, shift + kPersistentBits, hash, key);
+
+        // 子树只剩一个条目：把它提到本层（保持规范形式，查找路径最短）。
+        // 条目已经删掉，这一步不能再失败：分配不到内存或条目移动可能抛异常时就保留原样，
+        // 树仍然正确，只是多一层
+        Node* child = childSlot;
+        if constexpr (std::is_nothrow_move_constructible_v<Entry>) {
+            if (child->nodeCount == 0 && child->dataCount == 1 && child->unique()) {
+                uint32_t dataMap = node->dataMap | bit, nodeMap = node->nodeMap & ~bit;
+                Node* into = nullptr;
+                try {
+                    into = allocNode(dataMap, nodeMap, node->dataCount + 1, node->nodeCount - 1);
+                } catch (const std::bad_alloc&) {
+                }
+                if (into) {
+                    Entry e(std::move(child->entries()[0]));
+                    slot = reshape(node, shift, dataMap, nodeMap, kNone, indexOf(dataMap, bit), &e,
+                                   j, kNone, nullptr, into);
+                }
+            }
+        }
+    }
+
+    Node* mRoot = nullptr;
+    size_t mSize = 0;
+    [[no_unique_address]] Hash mHash;
+    [[no_unique_address]] KeyEqual mEq;
+};
+
+// persistent_hash_map 的批量修改构建器：独占的节点原地改
+template <typename K, typename V, typename Hash, typename KeyEqual>
+class transient_hash_map {
+    using Map = persistent_hash_map<K, V, Hash, KeyEqual>;
+
+public:
+    transient_hash_map() = default;
+    explicit transient_hash_map(Map m) noexcept : mMap(std::move(m)) {}
+
+    size_t size() const noexcept { return mMap.size(); }
+    bool empty() const noexcept { return mMap.empty(); }
+    const V* find(const K& key) const { return mMap.find(key); }
+    bool contains(const K& key) const { return mMap.contains(key); }
+
+    // 插入或覆盖
+    template <typename KK, typename VV>
+    void set(KK&& key, VV&& value) {
+        mMap.setIn(std::forward<KK>(key), std::forward<VV>(value));
+    }
+    void erase(const K& key) { mMap.eraseIn(key); }
+
+    // 交出结果；之后本 transient 为空
+    Map persistent() { return std::exchange(mMap, Map()); }
+
+private:
+    Map mMap;
+};
@@ -0,0 +1,474 @@
+#pragma once
+
+// relocatable_vector.h: 对"可平凡搬迁"元素按字节搬家的 vector
+//
+// std::vector 扩容时把旧缓冲区里的元素逐个移动构造到新缓冲区、再逐个析构旧对象；
+// insert / erase 中间位置时逐个移动赋值。对很多类型来说，"移动构造 + 析构原对象"
+// 的净效果恰好等于把对象的字节原样复制过去——这样的类型称为可平凡搬迁
+// （trivially relocatable）：std::unique_ptr、libstdc++ 的 std::vector、持有堆指针的句柄类……
+// 它们不是 trivially copyable（拷贝 / 析构有副作用），但搬家时只需要 memcpy。
+//
+// relocatable_vector<T> 与 std::vector 接口相同，区别在搬家方式：
+//   - is_trivially_relocatable<T> 为真：扩容用 std::realloc（分配器常能原地扩大，
+//     大块内存在 glibc 上走 mremap，不复制数据），insert / erase 用一次 memmove 平移尾部，
+//     整个过程不调用 T 的任何移动构造、移动赋值和析构
+//   - 否则：与 std::vector 相同，逐个 move_if_noexcept 搬迁、move_backward 平移
+//
+// is_trivially_relocatable<T> 默认等于 std::is_trivially_copyable<T>；其它类型由使用者特化：
+//     template <> struct is_trivially_relocatable<Heavy> : std::true_type {};
+// 特化是一个承诺："按字节搬走后，原地的旧对象不再析构也没关系"。以下类型不满足，不能特化：
+//   - 含指向自身（或自身成员）的指针：libstdc++ 的 std::string（SSO 时指向内联缓冲区）、
+//     std::list 的哨兵节点、小对象优化的 std::function 等
+//   - 对象地址登记在别处：侵入式链表节点、观察者注册表、MSVC 调试版迭代器检查下的标准容器
+// 头文件不替标准库类型做特化：它们是否满足取决于实现。
+//
+// 迭代器失效规则与 std::vector 相同；移动构造 / 移动赋值 / swap 都是 O(1) 的指针接管。
+// 可平凡搬迁且对齐不超过 alignof(std::max_align_t) 的类型用 malloc / realloc / free 管理内存
+// （operator new 没有 realloc），其余类型用 std::allocator<T>。
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// 使用者可以对自己的类型特化为 std::true_type
+template <typename T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+template <typename T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+template <typename T>
+class relocatable_vector {
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = T*;
+    using const_iterator = const T*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    // 是否走按字节搬迁的快速路径；是否能用 realloc 扩容
+    static constexpr bool trivially_relocatable = is_trivially_relocatable_v<T>;
+    static constexpr bool uses_realloc =
+        trivially_relocatable && alignof(T) <= alignof(std::max_align_t);
+
+    // ---------- 构造 / 析构 / 赋值 ----------
+    relocatable_vector() noexcept = default;
+    explicit relocatable_vector(size_t count) : relocatable_vector() { resize(count); }
+    relocatable_vector(size_t count, const T& value) : relocatable_vector() {
+        assign(count, value);
+    }
+    template <typename It, typename = std::enable_if_t<!std::is_integral_v<It>>>
+    relocatable_vector(It first, It last) : relocatable_vector() {
+        assign(first, last);
+    }
+    relocatable_vector(std::initializer_list<T> init) : relocatable_vector() {
+        assign(init.begin(), init.end());
+    }
+
+    relocatable_vector(const relocatable_vector& o) : relocatable_vector() {
+        assign(o.begin(), o.end());
+    }
+    relocatable_vector(relocatable_vector&& o) noexcept
+        : mData(std::exchange(o.mData, nullptr)),
+          mSize(std::exchange(o.mSize, 0)),
+          mCapacity(std::exchange(o.mCapacity, 0)) {}
+
+    ~relocatable_vector() {
+        std::destroy_n(mData, mSize);
+        deallocate(mData, mCapacity);
+    }
+
+    relocatable_vector& operator=(const relocatable_vector& o) {
+        if (this != &o) assign(o.begin(), o.end());
+        return *this;
+    }
+    relocatable_vector& operator=(relocatable_vector&& o) noexcept {
+        relocatable_vector(std::move(o)).swap(*this);
+        return *this;
+    }
+    relocatable_vector& operator=(std::initializer_list<T> init) {
+        assign(init.begin(), init.end());
+        return *this;
+    }
+
+    void assign(size_t count, const T& value) {
+        T tmp(value);  // value 可能就是本容器里的元素
+        clear();
+        reserve(count);
+        std::uninitialized_fill_n(mData, count, tmp);
+        mSize = count;
+    }
+    template <typename It, typename = std::enable_if_t<!std::is_integral_v<It>>>
+    void assign(It first, It last) {
+        clear();
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag,
+                                        typename std::iterator_traits<It>::iterator_category>) {
+            reserve(static_cast<size_t>(std::distance(first, last)));
+        }
+        for (; first != last; ++first) emplace_back(*first);
+    }
+
+    // ---------- 元素访问 ----------
+    T& operator[](size_t i) { return mData[i]; }
+    const T& operator[](size_t i) const { return mData[i]; }
+    T& at(size_t i) {
+        if (i >= mSize) throw std::out_of_range("relocatable_vector::at");
+        return mData[i];
+    }
+    const T& at(size_t i) const { return const_cast<relocatable_vector*>(this)->at(i); }
+    T& front() { return mData[0]; }
+    const T& front() const { return mData[0]; }
+    T& back() { return mData[mSize - 1]; }
+    const T& back() const { return mData[mSize - 1]; }
+    T* data() noexcept { return mData; }
+    const T* data() const noexcept { return mData; }
+
+    // ---------- 迭代器 ----------
+    iterator begin() noexcept { return mData; }
+    iterator end() noexcept { return mData + mSize; }
+    const_iterator begin() const noexcept { return mData; }
+    const_iterator end() const noexcept { return mData + mSize; }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend() const noexcept { return rend(); }
+
+    // ---------- 容量 ----------
+    bool empty() const noexcept { return mSize == 0; }
+    size_t size() const noexcept { return mSize; }
+    size_t capacity() const noexcept { return mCapacity; }
+    size_t max_size() const noexcept { return std::allocator_traits<std::allocator<T>>::max_size({}); }
+
+    void reserve(size_t newCap) {
+        if (newCap > mCapacity) reallocate(newCap);
+    }
+    void shrink_to_fit() {
+        if (mSize < mCapacity) reallocate(mSize);
+    }
+
+    // ---------- 修改 ----------
+    void clear() noexcept {
+        std::destroy_n(mData, mSize);
+        mSize = 0;
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        if (mSize == mCapacity) return *growAndEmplace(mSize, std::forward<Args>(args)...);
+        T* p = ::new (static_cast<void*>(mData + mSize)) T(std::forward<Args>(args)...);
+        ++mSize;
+        return *p;
+    }
+
+    void pop_back() {
+        --mSize;
+        std::destroy_at(mData + mSize);
+    }
+
+    template <typename... Args>
+    iterator emplace(const_iterator pos, Args&&... args) {
+        size_t idx = static_cast<size_t>(pos - begin());
+        if (mSize == mCapacity) return growAndEmplace(idx, std::forward<Args>(args)...);
+        if (idx == mSize) {
+            ::new (static_cast<void*>(mData + mSize)) T(std::forward<Args>(args)...);
+            ++mSize;
+            return mData + idx;
+        }
+        if constexpr (trivially_relocatable) {
+            // 新元素先在旁边构造好（参数可能引用本容器里的元素），再把尾部整体后移一格、
+            // 按字节放进空位：之后不再有可能抛异常的操作
+            RawSlot tmp(std::forward<Args>(args)...);
+            shiftTail(idx, 1);
+            tmp.relocateTo(mData + idx);
+        } else {
+            T tmp(std::forward<Args>(args)...);
+            ::new (static_cast<void*>(mData + mSize)) T(std::move(mData[mSize - 1]));
+            std::move_backward(mData + idx, mData + mSize - 1, mData + mSize);
+            mData[idx] = std::move(tmp);
+        }
+        ++mSize;
+        return mData + idx;
+    }
+
+    iterator insert(const_iterator pos, const T& value) { return emplace(pos, value); }
+    iterator insert(const_iterator pos, T&& value) { return emplace(pos, std::move(value)); }
+
+    iterator insert(const_iterator pos, size_t count, const T& value) {
+        size_t idx = static_cast<size_t>(pos - begin());
+        T tmp(value);
+        reserveForInsert(count);
+        if constexpr (trivially_relocatable) {
+            insertGap(idx, count, [&](T* p) { ::new (static_cast<void*>(p)) T(tmp); });
+        } else {
+            std::uninitialized_fill_n(mData + mSize, count, tmp);
+            mSize += count;
+            std::rotate(mData + idx, mData + mSize - count, mData + mSize);
+        }
+        return mData + idx;
+    }
+
+    // 个数已知（前向迭代器）且可平凡搬迁时原地开出空位再构造；
+    // 否则先追加到末尾，再 rotate 到插入位置（对单遍输入迭代器也成立）
+    template <typename It, typename = std::enable_if_t<!std::is_integral_v<It>>>
+    iterator insert(const_iterator pos, It first, It last) {
+        size_t idx = static_cast<size_t>(pos - begin());
+        constexpr bool forward =
+            std::is_base_of_v<std::forward_iterator_tag,
+                              typename std::iterator_traits<It>::iterator_category>;
+        if constexpr (forward) {
+            size_t count = static_cast<size_t>(std::distance(first, last));
+            reserveForInsert(count);
+            if constexpr (trivially_relocatable) {
+                insertGap(idx, count, [&](T* p) { ::new (static_cast<void*>(p)) T(*first++); });
+                return mData + idx;
+            }
+        }
+        size_t oldSize = mSize;
+        for (; first != last; ++first) emplace_back(*first);
+        std::rotate(mData + idx, mData + oldSize, mData + mSize);
+        return mData + idx;
+    }
+    iterator insert(const_iterator pos, std::initializer_list<T> init) {
+        return insert(pos, init.begin(), init.end());
+    }
+
+    iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+    iterator erase(const_iterator first, const_iterator last) {
+        T* f = mData + (first - begin());
+        T* l = mData + (last - begin());
+        if (f == l) return f;
+        if constexpr (trivially_relocatable) {
+            // 析构被删元素后，尾部按字节前移补上空洞
+            std::destroy(f, l);
+            std::memmove(static_cast<void*>(f), static_cast<const void*>(l),
+                         static_cast<size_t>(end() - l) * sizeof(T));
+            mSize -= static_cast<size_t>(l - f);
+        } else {
+            T* newEnd = std::move(l, end(), f);
+            std::destroy(newEnd, end());
+            mSize = static_cast<size_t>(newEnd - mData);
+        }
+        return f;
+    }
+
+    void resize(size_t count) {
+        if (count < mSize) {
+            std::destroy(mData + count, end());
+        } else {
+            reserve(count);
+            std::uninitialized_value_construct(mData + mSize, mData + count);
+        }
+        mSize = count;
+    }
+    void resize(size_t count, const T& value) {
+        if (count <= mSize) {
+            resize(count);
+            return;
+        }
+        T tmp(value);
+        reserve(count);
+        std::uninitialized_fill(mData + mSize, mData + count, tmp);
+        mSize = count;
+    }
+
+    void swap(relocatable_vector& o) noexcept {
+        std::swap(mData, o.mData);
+        std::swap(mSize, o.mSize);
+        std::swap(mCapacity, o.mCapacity);
+    }
+    friend void swap(relocatable_vector& a, relocatable_vector& b) noexcept { a.swap(b); }
+
+    // ---------- 比较 ----------
+    friend bool operator==(const relocatable_vector& a, const relocatable_vector& b) {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end());
+    }
+    friend auto operator<=>(const relocatable_vector& a, const relocatable_vector& b) {
+        return std::lexicographical_compare_three_way(a.begin(), a.end(), b.begin(), b.end());
+    }
+
+private:
+    // 一个 T 大小的未初始化缓冲区：在里面构造好的对象可以按字节搬到别处，之后不再析构
+    struct RawSlot {
+        template <typename... Args>
+        explicit RawSlot(Args&&... args) {
+            ::new (static_cast<void*>(bytes)) T(std::forward<Args>(args)...);
+        }
+        ~RawSlot() {
+            if (!moved) std::destroy_at(std::launder(reinterpret_cast<T*>(bytes)));
+        }
+        RawSlot(const RawSlot&) = delete;
+        RawSlot& operator=(const RawSlot&) = delete;
+
+        void relocateTo(T* dst) noexcept {
+            std::memcpy(static_cast<void*>(dst), bytes, sizeof(T));
+            moved = true;
+        }
+
+        alignas(T) unsigned char bytes[sizeof(T)];
+        bool moved = false;
+    };
+
+    static T* allocate(size_t n) {
+        if constexpr (uses_realloc) {
+            void* p = std::malloc(n * sizeof(T));
+            if (!p) throw std::bad_alloc();
+            return static_cast<T*>(p);
+        } else {
+            return std::allocator<T>().allocate(n);
+        }
+    }
+    static void deallocate(T* p, size_t n) noexcept {
+        if (!p) return;
+        if constexpr (uses_realloc) std::free(p);
+        else std::allocator<T>().deallocate(p, n);
+    }
+
+    size_t growCapacity(size_t needed) const { return std::max(needed, mCapacity * 2); }
+
+    // 插入 count 个元素前预留空间：放得下就不动，否则按 2 倍增长（保持均摊 O(1)）
+    void reserveForInsert(size_t count) {
+        if (mSize + count > mCapacity) reallocate(growCapacity(mSize + count));
+    }
+
+    // 换到容量为 newCap 的缓冲区（newCap >= mSize）
+    void reallocate(size_t newCap) {
+        if (newCap == 0) {
+            deallocate(mData, mCapacity);
+            mData = nullptr;
+            mCapacity = 0;
+            return;
+        }
+        if constexpr (uses_realloc) {
+            // realloc 能原地扩大就不复制；失败时旧缓冲区保持不变
+            void* p = std::realloc(static_cast<void*>(mData), newCap * sizeof(T));
+            if (!p) throw std::bad_alloc();
+            mData = static_cast<T*>(p);
+        } else {
+            T* fresh = allocate(newCap);
+            try {
+                relocate(mData, mSize, fresh);
+            } catch (...) {
+                deallocate(fresh, newCap);
+                throw;
+            }
+            deallocate(mData, mCapacity);
+            mData = fresh;
+        }
+        mCapacity = newCap;
+    }
+
+    // 把 count 个元素从 from 搬到未初始化的 to，原对象视为已结束生命期
+    static void relocate(T* from, size_t count, T* to) {
+        transfer(from, count, to);
+        retire(from, count);
+    }
+
+    // relocate 的前一半：在 to 构造副本，原对象不动。
+    // 可平凡搬迁时一次 memcpy；否则移动构造可能抛异常且能拷贝时退回拷贝
+    // （与 std::vector 的 move_if_noexcept 一致）。抛异常时 to 中已构造的部分
+    // 已由 uninitialized_* 析构，原对象完好
+    static void transfer(T* from, size_t count, T* to) {
+        if constexpr (trivially_relocatable) {
+            if (count) std::memcpy(static_cast<void*>(to), from, count * sizeof(T));
+        } else if constexpr (std::is_nothrow_move_constructible_v<T> ||
+                             !std::is_copy_constructible_v<T>) {
+            std::uninitialized_move_n(from, count, to);
+        } else {
+            std::uninitialized_copy_n(from, count, to);
+        }
+    }
+
+    // relocate 的后一半：析构已搬走的原对象（可平凡搬迁时什么都不做）
+    static void retire(T* from, size_t count) noexcept {
+        if constexpr (!trivially_relocatable) std::destroy_n(from, count);
+    }
+
+    // [idx, mSize) 按字节后移 by 格（调用者保证容量足够），不改变 mSize
+    void shiftTail(size_t idx, size_t by) noexcept {
+        std::memmove(static_cast<void*>(mData + idx + by), static_cast<const void*>(mData + idx),
+                     (mSize - idx) * sizeof(T));
+    }
+
+    // 可平凡搬迁时的区间插入：尾部后移开出 count 格空位，再逐个构造。
+    // 构造中途抛异常则析构已构造的部分、把尾部移回原处，容器保持原状
+    template <typename Construct>
+    void insertGap(size_t idx, size_t count, Construct construct) {
+        if (count == 0) return;
+        shiftTail(idx, count);
+        size_t done = 0;
+        try {
+            for (; done < count; ++done) construct(mData + idx + done);
+        } catch (...) {
+            std::destroy_n(mData + idx, done);
+            std::memmove(static_cast<void*>(mData + idx),
+                         static_cast<const void*>(mData + idx + count), (mSize - idx) * sizeof(T));
+            throw;
+        }
+        mSize += count;
+    }
+
+    // 扩容的同时在 idx 处构造新元素：新元素先构造（参数可能引用旧缓冲区），再搬迁两侧
+    template <typename... Args>
+    T* growAndEmplace(size_t idx, Args&&... args) {
+        size_t newCap = growCapacity(mSize + 1);
+        if constexpr (uses_realloc) {
+            // realloc 只能整体搬家，插入点之后的部分在新缓冲区里再后移一格
+            RawSlot tmp(std::forward<Args>(args)...);
+            reallocate(newCap);
+            shiftTail(idx, 1);
+            tmp.relocateTo(mData + idx);
+            ++mSize;
+            return mData + idx;
+        } else {
+            // 两侧都在新缓冲区构造成功后才析构旧元素；中途抛异常则拆掉新缓冲区里已构造的
+            // 部分，旧缓冲区原封不动（强异常保证，与 std::vector 相同）
+            T* fresh = allocate(newCap);
+            bool emplaced = false;
+            size_t front = 0;
+            try {
+                ::new (static_cast<void*>(fresh + idx)) T(std::forward<Args>(args)...);
+                emplaced = true;
+                transfer(mData, idx, fresh);
+                front = idx;
+                transfer(mData + idx, mSize - idx, fresh + idx + 1);
+            } catch (...) {
+                std::destroy_n(fresh, front);
+                if (emplaced) std::destroy_at(fresh + idx);
+                deallocate(fresh, newCap);
+                throw;
+            }
+            retire(mData, mSize);
+            deallocate(mData, mCapacity);
+            mData = fresh;
+            mCapacity = newCap;
+            ++mSize;
+            return fresh + idx;
+        }
+    }
+
+    T* mData = nullptr;
+    size_t mSize = 0;
+    size_t mCapacity = 0;
+};
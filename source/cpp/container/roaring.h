@@ -0,0 +1,896 @@
+#pragma once
+
+// roaring.h: 压缩位图（Roaring 风格）—— uint32_t 整数集合
+//
+// std::set<int> 每个元素一个红黑树节点（约 40 字节）；排好序的 vector 每个元素 4 字节，
+// 但 set_union / set_intersection 仍是逐元素归并。整数 ID 集合往往很稠密或成段出现，
+// 按值域分块、每块选最省的表示，可以同时省内存和加速集合运算：
+//
+//   - 按高 16 位分块（最多 65536 块），块内只存低 16 位；块按高 16 位升序排在 vector 里
+//   - 每块三种表示之一：
+//       array  ：升序的 uint16_t 数组，元素数 <= 4096（最多 8KB）
+//       bitmap ：1024 个 uint64_t 共 65536 位，固定 8KB，元素数 > 4096 时比 array 省
+//       run    ：[start, last] 闭区间的数组，每段 4 字节；连续 ID 段用它最省
+//   - add / remove 时 array 与 bitmap 按 4096 的阈值自动互转；run 块只在 run_optimize()、
+//     add_range() 或两个 run 块的运算中产生，段数多到不划算时自动换回 array / bitmap
+//
+// 集合运算逐块进行，高 16 位不同的块直接整块拷贝或跳过：
+//   - bitmap op bitmap：SSE2 每次处理 128 位，同一遍里用 SWAR 统计结果的元素个数
+//     （没有 POPCNT 指令时 std::popcount 是软件实现，这样更快）
+//   - array ∩ array：SSE2 一次比较 8 x 8 对 uint16_t（把一边的向量轮转 7 次），匹配的输出
+//   - array 与 bitmap：逐个元素查位；run 与其它表示先展开成 array / bitmap 再运算
+//   - intersection_cardinality 只计数，不生成结果
+// 每块的元素个数单独存在一个连续的 uint32_t 数组里：size() / rank / select 只扫这个数组，
+// 再在一个块内做二分（array）或按字 popcount（bitmap）
+//
+// 不是线程安全的；迭代器在任何修改后失效。
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ROARING_SSE2 1
+#else
+#define ROARING_SSE2 0
+#endif
+#if defined(__POPCNT__)
+#define ROARING_POPCNT 1
+#else
+#define ROARING_POPCNT 0
+#endif
+
+enum class roaring_op { And, Or, AndNot };
+
+inline constexpr size_t kRoaringWords = 1024;      // bitmap 块的字数（65536 位）
+inline constexpr uint32_t kRoaringArrayMax = 4096;  // array 块的最大元素数
+
+// ============================================================
+// bitmap 块的按字运算：out = a op b（Store 为 false 时只计数），返回结果中 1 的个数
+// ============================================================
+#if ROARING_SSE2
+// 每个字节里 1 的个数（SWAR）
+inline __m128i roaring_popcount_epi8(__m128i v) {
+    const __m128i m1 = _mm_set1_epi8(0x55);
+    const __m128i m2 = _mm_set1_epi8(0x33);
+    const __m128i m4 = _mm_set1_epi8(0x0F);
+    v = _mm_sub_epi8(v, _mm_and_si128(_mm_srli_epi16(v, 1), m1));
+    v = _mm_add_epi8(_mm_and_si128(v, m2), _mm_and_si128(_mm_srli_epi16(v, 2), m2));
+    return _mm_and_si128(_mm_add_epi8(v, _mm_srli_epi16(v, 4)), m4);
+}
+#endif
+
+template <roaring_op Op, bool Store>
+inline uint32_t roaring_words_op(const uint64_t* a, const uint64_t* b, uint64_t* out) {
+#if ROARING_SSE2 && !ROARING_POPCNT
+    const __m128i zero = _mm_setzero_si128();
+    __m128i acc = zero;
+    for (size_t i = 0; i < kRoaringWords; i += 2) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        __m128i v = Op == roaring_op::And  ? _mm_and_si128(va, vb)
+                    : Op == roaring_op::Or ? _mm_or_si128(va, vb)
+                                           : _mm_andnot_si128(vb, va);
+        if constexpr (Store) _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), v);
+        // sad_epu8 把 8 个字节的计数横向加到一个 64 位通道里
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(roaring_popcount_epi8(v), zero));
+    }
+    return uint32_t(_mm_cvtsi128_si32(acc) + _mm_cvtsi128_si32(_mm_srli_si128(acc, 8)));
+#else
+    uint32_t card = 0;
+    for (size_t i = 0; i < kRoaringWords; i++) {
+        uint64_t w = Op == roaring_op::And  ? a[i] & b[i]
+                     : Op == roaring_op::Or ? a[i] | b[i]
+                                            : a[i] & ~b[i];
+        if constexpr (Store) out[i] = w;
+        card += uint32_t(std::popcount(w));
+    }
+    return card;
+#endif
+}
+
+// ============================================================
+// 两个升序 uint16_t 数组的交集：Store 时写到 out（容量 >= min(na, nb)），返回交集大小
+//   SSE2 部分：a、b 各取 8 个，b 的向量轮转 7 次（连同原位置共比较 8 次）与 a 逐位比较，
+//   得到 a 中哪些元素命中；然后丢掉最大值较小的那一组（相等时两组都丢），和归并的推进规则一样
+// ============================================================
+template <bool Store>
+inline size_t roaring_intersect_arrays(const uint16_t* a, size_t na, const uint16_t* b, size_t nb,
+                                       uint16_t* out) {
+    size_t i = 0, j = 0, k = 0;
+#if ROARING_SSE2
+    if (na >= 8 && nb >= 8) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+        for (;;) {
+            __m128i eq = _mm_cmpeq_epi16(va, vb);
+            __m128i r = vb;
+            for (int s = 1; s < 8; s++) {
+                r = _mm_or_si128(_mm_srli_si128(r, 2), _mm_slli_si128(r, 14));
+                eq = _mm_or_si128(eq, _mm_cmpeq_epi16(va, r));
+            }
+            // 每个 16 位通道在掩码里占 2 位，只取低位
+            unsigned mask = unsigned(_mm_movemask_epi8(eq)) & 0x5555u;
+            // 命中通常很少：逐位取出比 popcount 便宜（没有 POPCNT 时 popcount 是函数调用）
+            for (; mask; mask &= mask - 1) {
+                if constexpr (Store) out[k] = a[i + (std::countr_zero(mask) >> 1)];
+                k++;
+            }
+            uint16_t amax = a[i + 7], bmax = b[j + 7];
+            if (amax <= bmax) {
+                i += 8;
+                if (i + 8 > na) break;
+                va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            }
+            if (bmax <= amax) {
+                j += 8;
+                if (j + 8 > nb) break;
+                vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+            }
+        }
+    }
+#endif
+    while (i < na && j < nb) {
+        if (a[i] < b[j]) {
+            i++;
+        } else if (b[j] < a[i]) {
+            j++;
+        } else {
+            if constexpr (Store) out[k] = a[i];
+            k++;
+            i++;
+            j++;
+        }
+    }
+    return k;
+}
+
+// 两个升序 uint16_t 数组的并（Union）或差（a - b），写到 out（容量 >= na + nb / na），返回个数
+//   无分支归并：每步都写出候选值，用比较结果推进下标，避免难预测的分支
+template <bool Union>
+inline size_t roaring_merge_arrays(const uint16_t* a, size_t na, const uint16_t* b, size_t nb,
+                                   uint16_t* out) {
+    size_t i = 0, j = 0, k = 0;
+    while (i < na && j < nb) {
+        uint16_t x = a[i], y = b[j];
+        if constexpr (Union) {
+            out[k++] = x < y ? x : y;
+        } else {
+            out[k] = x;
+            k += x < y;
+        }
+        i += x <= y;
+        j += y <= x;
+    }
+    for (; i < na; i++) out[k++] = a[i];
+    if constexpr (Union)
+        for (; j < nb; j++) out[k++] = b[j];
+    return k;
+}
+
+// chunk_stats() 的结果：三种表示各有多少块
+struct roaring_stats {
+    size_t array_chunks = 0;
+    size_t bitmap_chunks = 0;
+    size_t run_chunks = 0;
+};
+
+// ============================================================
+// roaring_bitmap
+// ============================================================
+class roaring_bitmap {
+    // 高 16 位相同的一组元素，只存低 16 位
+    struct chunk {
+        enum kind_t : uint8_t { kArray, kBitmap, kRun };
+        kind_t kind = kArray;
+        std::vector<uint16_t> values;  // kArray：升序的值；kRun：[start, last] 成对存放
+        std::vector<uint64_t> words;   // kBitmap：kRoaringWords 个字
+
+        size_t runs() const { return values.size() / 2; }
+    };
+
+public:
+    using value_type = uint32_t;
+    using size_type = size_t;
+
+    // 按升序遍历的前向迭代器
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = uint32_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = uint32_t;
+
+        const_iterator() = default;
+
+        uint32_t operator*() const { return uint32_t(mOwner->mKeys[mChunk]) << 16 | mLow; }
+
+        const_iterator& operator++() {
+            const chunk& c = mOwner->mChunks[mChunk];
+            if (c.kind == chunk::kArray) mIdx++;
+            else mLow++;
+            seek();
+            return *this;
+        }
+        const_iterator operator++(int) {
+            const_iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        friend bool operator==(const const_iterator& a, const const_iterator& b) {
+            return a.mChunk == b.mChunk && a.mLow == b.mLow;
+        }
+
+    private:
+        friend class roaring_bitmap;
+
+        const_iterator(const roaring_bitmap* owner, size_t chunkIdx)
+            : mOwner(owner), mChunk(chunkIdx) {
+            seek();
+        }
+
+        // 从 (mChunk, mIdx, mLow) 起找到第一个元素；走到末尾时停在 (块数, 0)
+        void seek() {
+            for (; mChunk < mOwner->mChunks.size(); mChunk++, mIdx = 0, mLow = 0) {
+                const chunk& c = mOwner->mChunks[mChunk];
+                if (c.kind == chunk::kArray) {
+                    if (mIdx < c.values.size()) {
+                        mLow = c.values[mIdx];
+                        return;
+                    }
+                } else if (c.kind == chunk::kBitmap) {
+                    for (size_t w = mLow >> 6; w < kRoaringWords; w++) {
+                        uint64_t bits = c.words[w];
+                        if (w == mLow >> 6) bits &= ~uint64_t(0) << (mLow & 63);
+                        if (bits) {
+                            mLow = uint32_t(w * 64 + size_t(std::countr_zero(bits)));
+                            return;
+                        }
+                    }
+                } else {
+                    for (; mIdx < c.runs(); mIdx++) {
+                        mLow = std::max<uint32_t>(mLow, c.values[2 * mIdx]);
+                        if (mLow <= c.values[2 * mIdx + 1]) return;
+                    }
+                }
+            }
+            mLow = 0;
+        }
+
+        const roaring_bitmap* mOwner = nullptr;
+        size_t mChunk = 0;
+        size_t mIdx = 0;    // kArray：数组下标；kRun：当前段
+        uint32_t mLow = 0;  // 当前元素的低 16 位（bitmap / run 从这里继续找）
+    };
+    using iterator = const_iterator;
+
+    roaring_bitmap() = default;
+    roaring_bitmap(std::initializer_list<uint32_t> init)
+        : roaring_bitmap(init.begin(), init.end()) {}
+
+    template <typename It>
+    roaring_bitmap(It first, It last) {
+        for (; first != last; ++first) add(uint32_t(*first));
+    }
+
+    // ---------- 单个元素 ----------
+    // 返回是否新插入
+    bool add(uint32_t x) {
+        size_t i = findOrCreate(uint16_t(x >> 16));
+        return chunkAdd(mChunks[i], mCards[i], uint16_t(x));
+    }
+
+    // 返回是否确实删除了
+    bool remove(uint32_t x) {
+        size_t i = find(uint16_t(x >> 16));
+        if (i == npos || !chunkRemove(mChunks[i], mCards[i], uint16_t(x))) return false;
+        if (mCards[i] == 0) eraseChunk(i);
+        return true;
+    }
+
+    bool contains(uint32_t x) const {
+        size_t i = find(uint16_t(x >> 16));
+        return i != npos && chunkContains(mChunks[i], uint16_t(x));
+    }
+
+    // 加入 [lo, hi) 内的所有整数；整块被覆盖时直接是一个 run 块
+    void add_range(uint64_t lo, uint64_t hi) {
+        hi = std::min<uint64_t>(hi, uint64_t(1) << 32);
+        if (lo >= hi) return;
+        for (uint64_t key = lo >> 16; key <= (hi - 1) >> 16; key++) {
+            uint16_t s = key == lo >> 16 ? uint16_t(lo) : 0;
+            uint16_t e = key == (hi - 1) >> 16 ? uint16_t(hi - 1) : 0xFFFF;
+            chunk run;
+            run.kind = chunk::kRun;
+            run.values = {s, e};
+            uint32_t card = uint32_t(e) - s + 1;
+            size_t i = findOrCreate(uint16_t(key));
+            if (mCards[i] == 0) {
+                mChunks[i] = std::move(run);
+                mCards[i] = card;
+            } else {
+                chunk merged;
+                mCards[i] = chunkOp(roaring_op::Or, mChunks[i], mCards[i], run, card, merged);
+                mChunks[i] = std::move(merged);
+            }
+        }
+    }
+
+    void clear() {
+        mKeys.clear();
+        mCards.clear();
+        mChunks.clear();
+    }
+
+    // ---------- 大小、rank / select ----------
+    bool empty() const { return mKeys.empty(); }
+
+    size_t size() const {
+        size_t n = 0;
+        for (uint32_t c : mCards) n += c;
+        return n;
+    }
+
+    uint32_t minimum() const {
+        if (empty()) throw std::out_of_range("roaring_bitmap::minimum: empty");
+        return *begin();
+    }
+
+    uint32_t maximum() const {
+        if (empty()) throw std::out_of_range("roaring_bitmap::maximum: empty");
+        return uint32_t(mKeys.back()) << 16 | chunkSelect(mChunks.back(), mCards.back() - 1);
+    }
+
+    // <= x 的元素个数
+    size_t rank(uint32_t x) const {
+        uint16_t key = uint16_t(x >> 16);
+        size_t i = size_t(std::lower_bound(mKeys.begin(), mKeys.end(), key) - mKeys.begin());
+        size_t r = 0;
+        for (size_t k = 0; k < i; k++) r += mCards[k];
+        if (i < mKeys.size() && mKeys[i] == key) r += chunkRank(mChunks[i], uint16_t(x));
+        return r;
+    }
+
+    // 第 k 小的元素（从 0 开始），k >= size() 时抛 std::out_of_range
+    uint32_t select(size_t k) const {
+        for (size_t i = 0; i < mCards.size(); i++) {
+            if (k < mCards[i])
+                return uint32_t(mKeys[i]) << 16 | chunkSelect(mChunks[i], uint32_t(k));
+            k -= mCards[i];
+        }
+        throw std::out_of_range("roaring_bitmap::select: k >= size()");
+    }
+
+    // ---------- 集合运算 ----------
+    friend roaring_bitmap operator|(const roaring_bitmap& a, const roaring_bitmap& b) {
+        return combine(roaring_op::Or, a, b);
+    }
+    friend roaring_bitmap operator&(const roaring_bitmap& a, const roaring_bitmap& b) {
+        return combine(roaring_op::And, a, b);
+    }
+    friend roaring_bitmap operator-(const roaring_bitmap& a, const roaring_bitmap& b) {
+        return combine(roaring_op::AndNot, a, b);
+    }
+    roaring_bitmap& operator|=(const roaring_bitmap& o) { return *this = *this | o; }
+    roaring_bitmap& operator&=(const roaring_bitmap& o) { return *this = *this & o; }
+    roaring_bitmap& operator-=(const roaring_bitmap& o) { return *this = *this - o; }
+
+    // |*this ∩ o|，不生成交集
+    size_t intersection_cardinality(const roaring_bitmap& o) const {
+        size_t n = 0;
+        for (size_t i = 0, j = 0; i < mKeys.size() && j < o.mKeys.size();) {
+            if (mKeys[i] < o.mKeys[j]) {
+                i++;
+            } else if (o.mKeys[j] < mKeys[i]) {
+                j++;
+            } else {
+                n += chunkAndCard(mChunks[i], mCards[i], o.mChunks[j], o.mCards[j]);
+                i++;
+                j++;
+            }
+        }
+        return n;
+    }
+
+    friend bool operator==(const roaring_bitmap& a, const roaring_bitmap& b) {
+        if (a.mKeys != b.mKeys || a.mCards != b.mCards) return false;
+        for (size_t i = 0; i < a.mChunks.size(); i++) {
+            const chunk& x = a.mChunks[i];
+            const chunk& y = b.mChunks[i];
+            if (x.kind == y.kind ? x.values != y.values || x.words != y.words
+                                 : toBitmap(x).words != toBitmap(y).words)
+                return false;
+        }
+        return true;
+    }
+
+    // ---------- 遍历 ----------
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, mChunks.size()); }
+
+    // 按升序对每个元素调用 f(uint32_t)；比迭代器少了逐个元素的状态判断
+    template <typename F>
+    void for_each(F&& f) const {
+        for (size_t i = 0; i < mChunks.size(); i++) {
+            uint32_t high = uint32_t(mKeys[i]) << 16;
+            chunkForEach(mChunks[i], [&](uint32_t low) { f(high | low); });
+        }
+    }
+
+    std::vector<uint32_t> to_vector() const {
+        std::vector<uint32_t> out;
+        out.reserve(size());
+        for_each([&](uint32_t x) { out.push_back(x); });
+        return out;
+    }
+
+    // ---------- 表示与内存 ----------
+    // 把连续段多的块换成 run 表示（只在确实更省时），并释放多余容量；返回是否有 run 块
+    bool run_optimize() {
+        bool any = false;
+        for (size_t i = 0; i < mChunks.size(); i++) {
+            chunk& c = mChunks[i];
+            if (c.kind != chunk::kRun && 4 * countRuns(c) < chunkBytes(c, mCards[i])) c = toRun(c);
+            c.values.shrink_to_fit();
+            any = any || c.kind == chunk::kRun;
+        }
+        return any;
+    }
+
+    roaring_stats chunk_stats() const {
+        roaring_stats s;
+        for (const chunk& c : mChunks) {
+            if (c.kind == chunk::kArray) s.array_chunks++;
+            else if (c.kind == chunk::kBitmap) s.bitmap_chunks++;
+            else s.run_chunks++;
+        }
+        return s;
+    }
+
+    size_t memory_usage() const {
+        size_t bytes = sizeof(*this) + mKeys.capacity() * sizeof(uint16_t) +
+                       mCards.capacity() * sizeof(uint32_t) + mChunks.capacity() * sizeof(chunk);
+        for (const chunk& c : mChunks)
+            bytes += c.values.capacity() * sizeof(uint16_t) + c.words.capacity() * sizeof(uint64_t);
+        return bytes;
+    }
+
+private:
+    static constexpr size_t npos = size_t(-1);
+
+    // ---------- 块的查找与增删 ----------
+    size_t find(uint16_t key) const {
+        auto it = std::lower_bound(mKeys.begin(), mKeys.end(), key);
+        return it != mKeys.end() && *it == key ? size_t(it - mKeys.begin()) : npos;
+    }
+
+    // 没有这个块时插入一个空的 array 块（元素数 0）；升序插入时直接落在末尾
+    size_t findOrCreate(uint16_t key) {
+        size_t i = !mKeys.empty() && mKeys.back() < key
+                       ? mKeys.size()
+                       : size_t(std::lower_bound(mKeys.begin(), mKeys.end(), key) - mKeys.begin());
+        if (i == mKeys.size() || mKeys[i] != key) {
+            mKeys.insert(mKeys.begin() + std::ptrdiff_t(i), key);
+            mCards.insert(mCards.begin() + std::ptrdiff_t(i), 0);
+            mChunks.insert(mChunks.begin() + std::ptrdiff_t(i), chunk{});
+        }
+        return i;
+    }
+
+    void eraseChunk(size_t i) {
+        mKeys.erase(mKeys.begin() + std::ptrdiff_t(i));
+        mCards.erase(mCards.begin() + std::ptrdiff_t(i));
+        mChunks.erase(mChunks.begin() + std::ptrdiff_t(i));
+    }
+
+    void append(uint16_t key, chunk&& c, uint32_t card) {
+        mKeys.push_back(key);
+        mCards.push_back(card);
+        mChunks.push_back(std::move(c));
+    }
+
+    // ---------- 块内操作 ----------
+    static bool testBit(const chunk& c, uint16_t x) { return c.words[x >> 6] >> (x & 63) & 1; }
+
+    // 第一个 start > x 的段
+    static size_t runUpper(const chunk& c, uint16_t x) {
+        size_t lo = 0, hi = c.runs();
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            if (c.values[2 * mid] <= x) lo = mid + 1;
+            else hi = mid;
+        }
+        return lo;
+    }
+
+    static bool chunkContains(const chunk& c, uint16_t x) {
+        if (c.kind == chunk::kArray) return std::binary_search(c.values.begin(), c.values.end(), x);
+        if (c.kind == chunk::kBitmap) return testBit(c, x);
+        size_t r = runUpper(c, x);
+        return r > 0 && x <= c.values[2 * r - 1];
+    }
+
+    static bool chunkAdd(chunk& c, uint32_t& card, uint16_t x) {
+        if (c.kind == chunk::kArray) {
+            auto it = std::lower_bound(c.values.begin(), c.values.end(), x);
+            if (it != c.values.end() && *it == x) return false;
+            if (card < kRoaringArrayMax) {
+                c.values.insert(it, x);
+                card++;
+                return true;
+            }
+            c = toBitmap(c);
+        }
+        if (c.kind == chunk::kBitmap) {
+            uint64_t& w = c.words[x >> 6];
+            uint64_t bit = uint64_t(1) << (x & 63);
+            if (w & bit) return false;
+            w |= bit;
+            card++;
+            return true;
+        }
+
+        // run：与前一段或后一段相邻时延长（可能把两段连起来），否则插入新段
+        std::vector<uint16_t>& v = c.values;
+        size_t r = runUpper(c, x);
+        if (r > 0 && x <= v[2 * r - 1]) return false;
+        bool joinPrev = r > 0 && v[2 * r - 1] + 1 == x;
+        bool joinNext = r < c.runs() && v[2 * r] == x + 1;
+        if (joinPrev && joinNext) {
+            v[2 * r - 1] = v[2 * r + 1];
+            v.erase(v.begin() + std::ptrdiff_t(2 * r), v.begin() + std::ptrdiff_t(2 * r + 2));
+        } else if (joinPrev) {
+            v[2 * r - 1] = x;
+        } else if (joinNext) {
+            v[2 * r] = x;
+        } else {
+            v.insert(v.begin() + std::ptrdiff_t(2 * r), {x, x});
+        }
+        card++;
+        shrinkRun(c, card);
+        return true;
+    }
+
+    static bool chunkRemove(chunk& c, uint32_t& card, uint16_t x) {
+        if (c.kind == chunk::kArray) {
+            auto it = std::lower_bound(c.values.begin(), c.values.end(), x);
+            if (it == c.values.end() || *it != x) return false;
+            c.values.erase(it);
+            card--;
+            return true;
+        }
+        if (c.kind == chunk::kBitmap) {
+            uint64_t& w = c.words[x >> 6];
+            uint64_t bit = uint64_t(1) << (x & 63);
+            if (!(w & bit)) return false;
+            w &= ~bit;
+            if (--card == kRoaringArrayMax) c = toArray(c, card);
+            return true;
+        }
+
+        // run：删段首 / 段尾时收缩，删中间时一分为二
+        std::vector<uint16_t>& v = c.values;
+        size_t r = runUpper(c, x);
+        if (r == 0 || x > v[2 * r - 1]) return false;
+        size_t p = r - 1;
+        uint16_t s = v[2 * p], e = v[2 * p + 1];
+        if (s == e) {
+            v.erase(v.begin() + std::ptrdiff_t(2 * p), v.begin() + std::ptrdiff_t(2 * p + 2));
+        } else if (x == s) {
+            v[2 * p]++;
+        } else if (x == e) {
+            v[2 * p + 1]--;
+        } else {
+            v[2 * p + 1] = uint16_t(x - 1);
+            v.insert(v.begin() + std::ptrdiff_t(2 * p + 2), {uint16_t(x + 1), e});
+        }
+        card--;
+        if (card > 0) shrinkRun(c, card);
+        return true;
+    }
+
+    // <= x 的元素个数
+    static uint32_t chunkRank(const chunk& c, uint16_t x) {
+        if (c.kind == chunk::kArray) {
+            auto it = std::upper_bound(c.values.begin(), c.values.end(), x);
+            return uint32_t(it - c.values.begin());
+        }
+        if (c.kind == chunk::kBitmap) {
+            uint32_t r = 0;
+            for (size_t w = 0; w < size_t(x >> 6); w++) r += uint32_t(std::popcount(c.words[w]));
+            return r + uint32_t(std::popcount(c.words[x >> 6] & (~uint64_t(0) >> (63 - (x & 63)))));
+        }
+        uint32_t r = 0;
+        for (size_t i = 0, n = runUpper(c, x); i < n; i++)
+            r += uint32_t(std::min(c.values[2 * i + 1], x)) - c.values[2 * i] + 1;
+        return r;
+    }
+
+    // 第 k 小的低 16 位（k < 块的元素数）
+    static uint16_t chunkSelect(const chunk& c, uint32_t k) {
+        if (c.kind == chunk::kArray) return c.values[k];
+        if (c.kind == chunk::kBitmap) {
+            for (size_t w = 0;; w++) {
+                uint64_t bits = c.words[w];
+                uint32_t cnt = uint32_t(std::popcount(bits));
+                if (k < cnt) {
+                    for (; k > 0; k--) bits &= bits - 1;
+                    return uint16_t(w * 64 + size_t(std::countr_zero(bits)));
+                }
+                k -= cnt;
+            }
+        }
+        for (size_t i = 0;; i++) {
+            uint32_t len = uint32_t(c.values[2 * i + 1]) - c.values[2 * i] + 1;
+            if (k < len) return uint16_t(c.values[2 * i] + k);
+            k -= len;
+        }
+    }
+
+    template <typename F>
+    static void chunkForEach(const chunk& c, F&& f) {
+        if (c.kind == chunk::kArray) {
+            for (uint16_t x : c.values) f(uint32_t(x));
+        } else if (c.kind == chunk::kBitmap) {
+            for (size_t w = 0; w < kRoaringWords; w++)
+                for (uint64_t bits = c.words[w]; bits; bits &= bits - 1)
+                    f(uint32_t(w * 64 + size_t(std::countr_zero(bits))));
+        } else {
+            for (size_t i = 0; i < c.runs(); i++)
+                for (uint32_t x = c.values[2 * i]; x <= c.values[2 * i + 1]; x++) f(x);
+        }
+    }
+
+    // ---------- 表示转换 ----------
+    static size_t chunkBytes(const chunk& c, uint32_t card) {
+        if (c.kind == chunk::kArray) return 2 * size_t(card);
+        if (c.kind == chunk::kBitmap) return kRoaringWords * sizeof(uint64_t);
+        return 4 * c.runs();
+    }
+
+    static size_t countRuns(const chunk& c) {
+        if (c.kind == chunk::kRun) return c.runs();
+        size_t n = 0;
+        if (c.kind == chunk::kArray) {
+            for (size_t i = 0; i < c.values.size(); i++)
+                n += i == 0 || c.values[i] != c.values[i - 1] + 1;
+            return n;
+        }
+        // 段的起点：本位为 1 且前一位（跨字时是上一个字的最高位）为 0
+        uint64_t carry = 0;
+        for (uint64_t w : c.words) {
+            n += size_t(std::popcount(w & ~(w << 1 | carry)));
+            carry = w >> 63;
+        }
+        return n;
+    }
+
+    static void setRange(std::vector<uint64_t>& words, uint32_t s, uint32_t e) {
+        for (uint32_t w = s >> 6; w <= e >> 6; w++) {
+            uint64_t m = ~uint64_t(0);
+            if (w == s >> 6) m &= ~uint64_t(0) << (s & 63);
+            if (w == e >> 6) m &= ~uint64_t(0) >> (63 - (e & 63));
+            words[w] |= m;
+        }
+    }
+
+    static chunk toBitmap(const chunk& c) {
+        if (c.kind == chunk::kBitmap) return c;
+        chunk out;
+        out.kind = chunk::kBitmap;
+        out.words.assign(kRoaringWords, 0);
+        if (c.kind == chunk::kArray) {
+            for (uint16_t x : c.values) out.words[x >> 6] |= uint64_t(1) << (x & 63);
+        } else {
+            for (size_t i = 0; i < c.runs(); i++)
+                setRange(out.words, c.values[2 * i], c.values[2 * i + 1]);
+        }
+        return out;
+    }
+
+    static chunk toArray(const chunk& c, uint32_t card) {
+        if (c.kind == chunk::kArray) return c;
+        chunk out;
+        out.values.reserve(card);
+        chunkForEach(c, [&](uint32_t x) { out.values.push_back(uint16_t(x)); });
+        return out;
+    }
+
+    static chunk toRun(const chunk& c) {
+        chunk out;
+        out.kind = chunk::kRun;
+        out.values.reserve(2 * countRuns(c));
+        chunkForEach(c, [&](uint32_t x) {
+            if (!out.values.empty() && out.values.back() + 1u == x) out.values.back() = uint16_t(x);
+            else out.values.insert(out.values.end(), {uint16_t(x), uint16_t(x)});
+        });
+        return out;
+    }
+
+    // run 展开成 array / bitmap 中合适的一种
+    static chunk materialize(const chunk& c, uint32_t card) {
+        return card <= kRoaringArrayMax ? toArray(c, card) : toBitmap(c);
+    }
+
+    // array / bitmap 按元素数选表示；run 段数多到比 array / bitmap 还大时展开
+    static void normalize(chunk& c, uint32_t card) {
+        if (c.kind == chunk::kBitmap && card <= kRoaringArrayMax) c = toArray(c, card);
+        else if (c.kind == chunk::kArray && card > kRoaringArrayMax) c = toBitmap(c);
+        else if (c.kind == chunk::kRun) shrinkRun(c, card);
+    }
+
+    static void shrinkRun(chunk& c, uint32_t card) {
+        size_t alt = card <= kRoaringArrayMax ? 2 * size_t(card) : kRoaringWords * sizeof(uint64_t);
+        if (4 * c.runs() > alt) c = materialize(c, card);
+    }
+
+    // ---------- 块之间的运算 ----------
+    // out = a op b，返回结果的元素个数（0 表示结果为空，out 无意义）
+    static uint32_t chunkOp(roaring_op op, const chunk& a, uint32_t ca, const chunk& b, uint32_t cb,
+                            chunk& out) {
+        using K = chunk::kind_t;
+        if (a.kind == K::kRun && b.kind == K::kRun && op != roaring_op::AndNot)
+            return runOp(op, a, b, out);
+        if (a.kind == K::kRun) return chunkOp(op, materialize(a, ca), ca, b, cb, out);
+        if (b.kind == K::kRun) return chunkOp(op, a, ca, materialize(b, cb), cb, out);
+
+        uint32_t card = 0;
+        if (a.kind == K::kBitmap && b.kind == K::kBitmap) {
+            out.kind = K::kBitmap;
+            out.words.resize(kRoaringWords);
+            const uint64_t *x = a.words.data(), *y = b.words.data();
+            uint64_t* z = out.words.data();
+            if (op == roaring_op::And) card = roaring_words_op<roaring_op::And, true>(x, y, z);
+            else if (op == roaring_op::Or) card = roaring_words_op<roaring_op::Or, true>(x, y, z);
+            else card = roaring_words_op<roaring_op::AndNot, true>(x, y, z);
+        } else if (a.kind == K::kArray && b.kind == K::kArray) {
+            out.kind = K::kArray;
+            const auto &x = a.values, &y = b.values;
+            if (op == roaring_op::And) {
+                out.values.resize(std::min(x.size(), y.size()));
+                size_t n = roaring_intersect_arrays<true>(x.data(), x.size(), y.data(), y.size(),
+                                                          out.values.data());
+                out.values.resize(n);
+            } else if (op == roaring_op::Or && ca + cb > kRoaringArrayMax) {
+                // 结果可能超过 4096 个：直接在位图上置位
+                out = toBitmap(a);
+                card = ca;
+                for (uint16_t v : y) card += setBit(out, v);
+            } else {
+                out.values.resize(op == roaring_op::Or ? ca + cb : ca);
+                uint16_t* z = out.values.data();
+                if (op == roaring_op::Or)
+                    out.values.resize(roaring_merge_arrays<true>(x.data(), ca, y.data(), cb, z));
+                else
+                    out.values.resize(roaring_merge_arrays<false>(x.data(), ca, y.data(), cb, z));
+            }
+            if (out.kind == K::kArray) card = uint32_t(out.values.size());
+        } else if (op == roaring_op::And || (op == roaring_op::AndNot && a.kind == K::kArray)) {
+            // array 里的每个元素查 bitmap 的对应位：And 留下命中的，AndNot 留下未命中的
+            const chunk& arr = a.kind == K::kArray ? a : b;
+            const chunk& bmp = a.kind == K::kArray ? b : a;
+            bool keep = op == roaring_op::And;
+            out.kind = K::kArray;
+            out.values.resize(arr.values.size());
+            for (uint16_t v : arr.values) {
+                out.values[card] = v;
+                card += testBit(bmp, v) == keep;
+            }
+            out.values.resize(card);
+        } else {
+            // bitmap | array、bitmap - array：复制位图再逐个置位 / 清位
+            const chunk& bmp = a.kind == K::kBitmap ? a : b;
+            const chunk& arr = a.kind == K::kBitmap ? b : a;
+            out = bmp;
+            card = a.kind == K::kBitmap ? ca : cb;
+            for (uint16_t v : arr.values) {
+                uint64_t& w = out.words[v >> 6];
+                uint64_t bit = uint64_t(1) << (v & 63);
+                if (op == roaring_op::Or) card += !(w & bit);
+                else card -= (w & bit) != 0;
+                w = op == roaring_op::Or ? w | bit : w & ~bit;
+            }
+        }
+        normalize(out, card);
+        return card;
+    }
+
+    static uint32_t setBit(chunk& c, uint16_t v) {
+        uint64_t& w = c.words[v >> 6];
+        uint64_t bit = uint64_t(1) << (v & 63);
+        uint32_t added = !(w & bit);
+        w |= bit;
+        return added;
+    }
+
+    // 两个 run 块的交 / 并：区间归并
+    static uint32_t runOp(roaring_op op, const chunk& a, const chunk& b, chunk& out) {
+        const auto &x = a.values, &y = b.values;
+        out.kind = chunk::kRun;
+        out.values.clear();
+        size_t i = 0, j = 0;
+        if (op == roaring_op::And) {
+            while (i < x.size() && j < y.size()) {
+                uint16_t s = std::max(x[i], y[j]), e = std::min(x[i + 1], y[j + 1]);
+                if (s <= e) out.values.insert(out.values.end(), {s, e});
+                if (x[i + 1] < y[j + 1]) i += 2;
+                else j += 2;
+            }
+        } else {
+            while (i < x.size() || j < y.size()) {
+                bool fromX = j == y.size() || (i < x.size() && x[i] <= y[j]);
+                const uint16_t* r = fromX ? &x[i] : &y[j];
+                (fromX ? i : j) += 2;
+                if (!out.values.empty() && uint32_t(out.values.back()) + 1 >= r[0])
+                    out.values.back() = std::max(out.values.back(), r[1]);
+                else out.values.insert(out.values.end(), {r[0], r[1]});
+            }
+        }
+        uint32_t card = 0;
+        for (size_t k = 0; k < out.values.size(); k += 2)
+            card += uint32_t(out.values[k + 1]) - out.values[k] + 1;
+        if (card > 0) shrinkRun(out, card);
+        return card;
+    }
+
+    static uint32_t chunkAndCard(const chunk& a, uint32_t ca, const chunk& b, uint32_t cb) {
+        using K = chunk::kind_t;
+        if (a.kind == K::kRun || b.kind == K::kRun) {
+            chunk out;
+            return chunkOp(roaring_op::And, a, ca, b, cb, out);
+        }
+        if (a.kind == K::kBitmap && b.kind == K::kBitmap) {
+            const uint64_t *x = a.words.data(), *y = b.words.data();
+            return roaring_words_op<roaring_op::And, false>(x, y, nullptr);
+        }
+        if (a.kind == K::kArray && b.kind == K::kArray) {
+            const auto &x = a.values, &y = b.values;
+            return uint32_t(
+                roaring_intersect_arrays<false>(x.data(), x.size(), y.data(), y.size(), nullptr));
+        }
+        const chunk& arr = a.kind == K::kArray ? a : b;
+        const chunk& bmp = a.kind == K::kArray ? b : a;
+        uint32_t n = 0;
+        for (uint16_t v : arr.values) n += testBit(bmp, v);
+        return n;
+    }
+
+    // 按高 16 位归并两边的块：只在一边出现的块，Or 两边都保留，AndNot 只保留左边的，And 都丢掉
+    static roaring_bitmap combine(roaring_op op, const roaring_bitmap& a, const roaring_bitmap& b) {
+        roaring_bitmap r;
+        size_t i = 0, j = 0;
+        const size_t na = a.mKeys.size(), nb = b.mKeys.size();
+        while (i < na || j < nb) {
+            if (j == nb || (i < na && a.mKeys[i] < b.mKeys[j])) {
+                if (op != roaring_op::And) r.append(a.mKeys[i], chunk(a.mChunks[i]), a.mCards[i]);
+                i++;
+            } else if (i == na || b.mKeys[j] < a.mKeys[i]) {
+                if (op == roaring_op::Or) r.append(b.mKeys[j], chunk(b.mChunks[j]), b.mCards[j]);
+                j++;
+            } else {
+                chunk c;
+                uint32_t card =
+                    chunkOp(op, a.mChunks[i], a.mCards[i], b.mChunks[j], b.mCards[j], c);
+                if (card > 0) r.append(a.mKeys[i], std::move(c), card);
+                i++;
+                j++;
+            }
+            if (op == roaring_op::And && (i == na || j == nb)) break;
+            if (op == roaring_op::AndNot && i == na) break;
+        }
+        return r;
+    }
+
+    std::vector<uint16_t> mKeys;   // 各块的高 16 位，升序
+    std::vector<uint32_t> mCards;  // 各块的元素个数（1..65536）
+    std::vector<chunk> mChunks;
+};
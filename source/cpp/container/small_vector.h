@@ -0,0 +1,355 @@
+#pragma once
+
+// small_vector.h: 带内联存储的 vector
+//
+// small_vector<T, N> 在对象内部预留 N 个元素的空间，元素个数不超过 N 时完全不分配堆内存；
+// 超过 N 后像 std::vector 一样在堆上按 2 倍扩容（之后不会再回到内联缓冲区，除非 shrink_to_fit）。
+// 适合"几乎总是很短"的临时数组：函数内的局部 vector、map 的 value、解析结果等。
+//
+// 接口与 std::vector 一致（reserve / emplace_back / insert / erase / resize / swap ...），
+// 迭代器失效规则也相同：
+//   - 不触发扩容的 push_back / insert：插入点之前的迭代器保持有效
+//   - 触发扩容（包括第一次溢出到堆）：所有迭代器、指针、引用失效
+//   - erase：被删位置及之后的迭代器失效
+// 与 std::vector 不同的一点：移动 / swap 一个使用内联存储的 small_vector 是逐个移动元素，
+// 原来指向其元素的迭代器不会"跟着"转移到新对象，且移动是 O(n) 而非 O(1)。
+//
+// 代价：sizeof(small_vector<T, N>) ≈ 3 个字长 + N * sizeof(T)，N 不宜太大。
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+template <typename T, size_t N>
+class small_vector {
+    static_assert(N > 0, "small_vector 的内联容量至少为 1");
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = T*;
+    using const_iterator = const T*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    static constexpr size_t inline_capacity = N;
+
+    // ---------- 构造 / 析构 / 赋值 ----------
+    small_vector() noexcept : mData(inlineData()) {}
+    explicit small_vector(size_t count) : small_vector() { resize(count); }
+    small_vector(size_t count, const T& value) : small_vector() { assign(count, value); }
+    template <typename It, typename = std::enable_if_t<!std::is_integral_v<It>>>
+    small_vector(It first, It last) : small_vector() {
+        assign(first, last);
+    }
+    small_vector(std::initializer_list<T> init) : small_vector() { assign(init.begin(), init.end()); }
+
+    small_vector(const small_vector& o) : small_vector() { assign(o.begin(), o.end()); }
+    small_vector(small_vector&& o) noexcept(std::is_nothrow_move_constructible_v<T>) : small_vector() {
+        takeFrom(std::move(o));
+    }
+
+    ~small_vector() {
+        destroyAll();
+        freeHeap();
+    }
+
+    small_vector& operator=(const small_vector& o) {
+        if (this != &o) assign(o.begin(), o.end());
+        return *this;
+    }
+    small_vector& operator=(small_vector&& o) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (this != &o) {
+            clear();
+            freeHeap();
+            mData = inlineData();
+            mCapacity = N;
+            takeFrom(std::move(o));
+        }
+        return *this;
+    }
+    small_vector& operator=(std::initializer_list<T> init) {
+        assign(init.begin(), init.end());
+        return *this;
+    }
+
+    void assign(size_t count, const T& value) {
+        T tmp(value);  // value 可能就是本容器里的元素
+        clear();
+        reserve(count);
+        std::uninitialized_fill_n(mData, count, tmp);
+        mSize = count;
+    }
+    template <typename It, typename = std::enable_if_t<!std::is_integral_v<It>>>
+    void assign(It first, It last) {
+        clear();
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag,
+                                        typename std::iterator_traits<It>::iterator_category>) {
+            reserve(static_cast<size_t>(std::distance(first, last)));
+        }
+        for (; first != last; ++first) emplace_back(*first);
+    }
+
+    // ---------- 元素访问 ----------
+    T& operator[](size_t i) { return mData[i]; }
+    const T& operator[](size_t i) const { return mData[i]; }
+    T& at(size_t i) {
+        if (i >= mSize) throw std::out_of_range("small_vector::at");
+        return mData[i];
+    }
+    const T& at(size_t i) const { return const_cast<small_vector*>(this)->at(i); }
+    T& front() { return mData[0]; }
+    const T& front() const { return mData[0]; }
+    T& back() { return mData[mSize - 1]; }
+    const T& back() const { return mData[mSize - 1]; }
+    T* data() noexcept { return mData; }
+    const T* data() const noexcept { return mData; }
+
+    // ---------- 迭代器 ----------
+    iterator begin() noexcept { return mData; }
+    iterator end() noexcept { return mData + mSize; }
+    const_iterator begin() const noexcept { return mData; }
+    const_iterator end() const noexcept { return mData + mSize; }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend() const noexcept { return rend(); }
+
+    // ---------- 容量 ----------
+    bool empty() const noexcept { return mSize == 0; }
+    size_t size() const noexcept { return mSize; }
+    size_t capacity() const noexcept { return mCapacity; }
+    size_t max_size() const noexcept { return std::allocator_traits<std::allocator<T>>::max_size({}); }
+    // 当前元素是否放在对象内部（没有堆分配）
+    bool is_inline() const noexcept { return mData == inlineData(); }
+
+    void reserve(size_t newCap) {
+        if (newCap > mCapacity) reallocate(newCap);
+    }
+
+    // 元素能放回内联缓冲区时搬回去并释放堆内存，否则把堆容量缩到 size()
+    void shrink_to_fit() {
+        if (is_inline() || mSize == mCapacity) return;
+        if (mSize <= N) {
+            T* old = mData;
+            size_t oldCap = mCapacity;
+            relocate(old, mSize, inlineData());
+            std::allocator<T>().deallocate(old, oldCap);
+            mData = inlineData();
+            mCapacity = N;
+        } else {
+            reallocate(mSize);
+        }
+    }
+
+    // ---------- 修改 ----------
+    void clear() noexcept {
+        std::destroy_n(mData, mSize);
+        mSize = 0;
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        if (mSize == mCapacity) return *growAndEmplace(mSize, std::forward<Args>(args)...);
+        T* p = ::new (static_cast<void*>(mData + mSize)) T(std::forward<Args>(args)...);
+        ++mSize;
+        return *p;
+    }
+
+    void pop_back() {
+        --mSize;
+        std::destroy_at(mData + mSize);
+    }
+
+    template <typename... Args>
+    iterator emplace(const_iterator pos, Args&&... args) {
+        size_t idx = static_cast<size_t>(pos - begin());
+        if (mSize == mCapacity) return growAndEmplace(idx, std::forward<Args>(args)...);
+        if (idx == mSize) {
+            ::new (static_cast<void*>(mData + mSize)) T(std::forward<Args>(args)...);
+            ++mSize;
+            return mData + idx;
+        }
+        // 先构造临时对象（参数可能引用本容器里的元素），再整体后移一格
+        T tmp(std::forward<Args>(args)...);
+        ::new (static_cast<void*>(mData + mSize)) T(std::move(mData[mSize - 1]));
+        std::move_backward(mData + idx, mData + mSize - 1, mData + mSize);
+        mData[idx] = std::move(tmp);
+        ++mSize;
+        return mData + idx;
+    }
+
+    iterator insert(const_iterator pos, const T& value) { return emplace(pos, value); }
+    iterator insert(const_iterator pos, T&& value) { return emplace(pos, std::move(value)); }
+
+    iterator insert(const_iterator pos, size_t count, const T& value) {
+        size_t idx = static_cast<size_t>(pos - begin());
+        T tmp(value);
+        reserveForInsert(count);
+        std::uninitialized_fill_n(mData + mSize, count, tmp);
+        mSize += count;
+        std::rotate(mData + idx, mData + mSize - count, mData + mSize);
+        return mData + idx;
+    }
+
+    // 先追加到末尾，再 rotate 到插入位置：对单遍输入迭代器也成立
+    template <typename It, typename = std::enable_if_t<!std::is_integral_v<It>>>
+    iterator insert(const_iterator pos, It first, It last) {
+        size_t idx = static_cast<size_t>(pos - begin());
+        size_t oldSize = mSize;
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag,
+                                        typename std::iterator_traits<It>::iterator_category>)
+            reserveForInsert(static_cast<size_t>(std::distance(first, last)));
+        for (; first != last; ++first) emplace_back(*first);
+        std::rotate(mData + idx, mData + oldSize, mData + mSize);
+        return mData + idx;
+    }
+    iterator insert(const_iterator pos, std::initializer_list<T> init) {
+        return insert(pos, init.begin(), init.end());
+    }
+
+    iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+    iterator erase(const_iterator first, const_iterator last) {
+        T* f = mData + (first - begin());
+        T* l = mData + (last - begin());
+        if (f != l) {
+            T* newEnd = std::move(l, end(), f);
+            std::destroy(newEnd, end());
+            mSize = static_cast<size_t>(newEnd - mData);
+        }
+        return f;
+    }
+
+    void resize(size_t count) {
+        if (count < mSize) {
+            std::destroy(mData + count, end());
+        } else {
+            reserve(count);
+            std::uninitialized_value_construct(mData + mSize, mData + count);
+        }
+        mSize = count;
+    }
+    void resize(size_t count, const T& value) {
+        if (count <= mSize) {
+            resize(count);
+            return;
+        }
+        T tmp(value);
+        reserve(count);
+        std::uninitialized_fill(mData + mSize, mData + count, tmp);
+        mSize = count;
+    }
+
+    void swap(small_vector& o) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (this == &o) return;
+        if (!is_inline() && !o.is_inline()) {
+            std::swap(mData, o.mData);
+            std::swap(mSize, o.mSize);
+            std::swap(mCapacity, o.mCapacity);
+            return;
+        }
+        small_vector tmp(std::move(o));
+        o = std::move(*this);
+        *this = std::move(tmp);
+    }
+    friend void swap(small_vector& a, small_vector& b) noexcept(noexcept(a.swap(b))) { a.swap(b); }
+
+    // ---------- 比较 ----------
+    friend bool operator==(const small_vector& a, const small_vector& b) {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end());
+    }
+    friend auto operator<=>(const small_vector& a, const small_vector& b) {
+        return std::lexicographical_compare_three_way(a.begin(), a.end(), b.begin(), b.end());
+    }
+
+private:
+    T* inlineData() noexcept { return std::launder(reinterpret_cast<T*>(mInline)); }
+    const T* inlineData() const noexcept { return std::launder(reinterpret_cast<const T*>(mInline)); }
+
+    size_t growCapacity(size_t needed) const { return std::max(needed, mCapacity * 2); }
+
+    // 插入 count 个元素前预留空间：放得下就不动，否则按 2 倍增长（保持均摊 O(1)）
+    void reserveForInsert(size_t count) {
+        if (mSize + count > mCapacity) reallocate(growCapacity(mSize + count));
+    }
+
+    // 把 count 个元素从 from 搬到未初始化的 to，并析构原对象。
+    // 移动构造可能抛异常且能拷贝时退回拷贝（与 std::vector 的 move_if_noexcept 一致）
+    static void relocate(T* from, size_t count, T* to) {
+        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>)
+            std::uninitialized_move_n(from, count, to);
+        else
+            std::uninitialized_copy_n(from, count, to);
+        std::destroy_n(from, count);
+    }
+
+    void reallocate(size_t newCap) {
+        T* fresh = std::allocator<T>().allocate(newCap);
+        relocate(mData, mSize, fresh);
+        freeHeap();
+        mData = fresh;
+        mCapacity = newCap;
+    }
+
+    // 扩容的同时在 idx 处构造新元素：新元素先构造（参数可能引用旧缓冲区），再搬迁两侧
+    template <typename... Args>
+    T* growAndEmplace(size_t idx, Args&&... args) {
+        size_t newCap = growCapacity(mSize + 1);
+        T* fresh = std::allocator<T>().allocate(newCap);
+        try {
+            ::new (static_cast<void*>(fresh + idx)) T(std::forward<Args>(args)...);
+        } catch (...) {
+            std::allocator<T>().deallocate(fresh, newCap);
+            throw;
+        }
+        relocate(mData, idx, fresh);
+        relocate(mData + idx, mSize - idx, fresh + idx + 1);
+        freeHeap();
+        mData = fresh;
+        mCapacity = newCap;
+        ++mSize;
+        return fresh + idx;
+    }
+
+    void takeFrom(small_vector&& o) {
+        if (!o.is_inline()) {
+            // 堆上的缓冲区直接接管，O(1)
+            mData = std::exchange(o.mData, o.inlineData());
+            mSize = std::exchange(o.mSize, 0);
+            mCapacity = std::exchange(o.mCapacity, N);
+        } else {
+            std::uninitialized_move_n(o.mData, o.mSize, mData);
+            mSize = o.mSize;
+            o.clear();
+        }
+    }
+
+    void destroyAll() noexcept { std::destroy_n(mData, mSize); }
+    void freeHeap() noexcept {
+        if (!is_inline()) std::allocator<T>().deallocate(mData, mCapacity);
+    }
+
+    T* mData;
+    size_t mSize = 0;
+    size_t mCapacity = N;
+    alignas(T) unsigned char mInline[N * sizeof(T)];
+};
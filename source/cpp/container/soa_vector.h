@@ -0,0 +1,410 @@
+#pragma once
+
+// soa_vector.h: 结构数组（SoA）存储的 vector
+//
+// std::vector<Student> 是"数组的结构"（AoS）：每个元素的所有字段挨在一起。只扫一个字段时
+// （求平均分、按年龄过滤），每条缓存行里只有一小部分是有用的，其余字段白白占带宽。
+// soa_vector<Fields...> 把每个字段放进自己的连续数组（每列一个 std::vector，和 flat_map 的
+// key / value 分开存放是同一个思路）：
+//   - field<I>() 返回第 I 列的 std::span，单字段循环是纯顺序访问，编译器可以向量化
+//   - 迭代器解引用得到代理引用 soa_ref（每个字段一个引用），value_type 是 std::tuple<Fields...>；
+//     代理支持赋值、交换、比较、get<I> 和结构化绑定，所以 std::sort / std::stable_sort /
+//     std::lower_bound 等原有的调用方式照常可用，比较器写成 const auto& 参数 + get<I>(row) 即可
+//   - 代理排序每次交换都要搬动所有列；sort() / stable_sort() 先只对下标排序，
+//     再把每列整体重排一次
+//
+// 字段用下标访问，习惯上配一个枚举起名字：enum { Name, Score, Age }; get<Score>(row)。
+// 迭代器失效规则与 std::vector 相同。各列始终等长；push_back 时某一列抛异常会撤销已加入的列。
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+template <bool Const, typename... Fields>
+class soa_iterator;
+
+// ============================================================
+// soa_ref：一行的代理引用
+//   赋值是"写穿"的（和 std::vector<bool>::reference 一样）：
+//   row = other 把 other 的各字段拷进这一行
+// ============================================================
+template <bool Const, typename... Fields>
+class soa_ref {
+    template <typename T>
+    using Ref = std::conditional_t<Const, const T&, T&>;
+
+public:
+    using value_type = std::tuple<Fields...>;
+
+    explicit soa_ref(Ref<Fields>... fields) : mRefs(fields...) {}
+
+    // 可写行可以当只读行用
+    template <bool C = Const, typename = std::enable_if_t<C>>
+    soa_ref(const soa_ref<false, Fields...>& o)
+        : soa_ref(std::apply([](auto&... f) { return soa_ref(f...); }, o.refs())) {}
+
+    soa_ref(const soa_ref&) = default;
+
+    // ---------- 写穿赋值（const 限定：代理本身是值，被赋值的是它引用的元素） ----------
+    // 从另一行赋值总是拷贝：v[0] = v[1] 里的 v[1] 也是右值代理，不能把它的字段移走
+    const soa_ref& operator=(const soa_ref& o) const
+        requires(!Const)
+    {
+        assignEach(o.mRefs, std::index_sequence_for<Fields...>{}, false);
+        return *this;
+    }
+    const soa_ref& operator=(const value_type& v) const
+        requires(!Const)
+    {
+        assignEach(v, std::index_sequence_for<Fields...>{}, false);
+        return *this;
+    }
+    const soa_ref& operator=(value_type&& v) const
+        requires(!Const)
+    {
+        assignEach(v, std::index_sequence_for<Fields...>{}, true);
+        return *this;
+    }
+
+    // ---------- 取值 ----------
+    // 拷贝出一行。同样的原因，std::move(*it) 也是拷贝：用代理排序 std::string 之类的字段时
+    // 每次移动都是一次拷贝，这种情况用 soa_vector::sort()（各列最后只移动一次）
+    operator value_type() const { return value_type(mRefs); }
+
+    template <size_t I>
+    Ref<std::tuple_element_t<I, value_type>> get() const {
+        return std::get<I>(mRefs);
+    }
+    template <size_t I>
+    friend Ref<std::tuple_element_t<I, value_type>> get(const soa_ref& r) {
+        return std::get<I>(r.mRefs);
+    }
+
+    const std::tuple<Ref<Fields>...>& refs() const { return mRefs; }
+
+    // ---------- 交换：std::sort 经 iter_swap 调用 swap(*a, *b)，两边都是临时代理 ----------
+    friend void swap(const soa_ref& a, const soa_ref& b)
+        requires(!Const)
+    {
+        swapEach(a, b, std::index_sequence_for<Fields...>{});
+    }
+
+    // ---------- 比较：按字段依次比较，与 std::tuple 的规则相同 ----------
+    friend bool operator==(const soa_ref& a, const soa_ref& b) { return a.view() == b.view(); }
+    friend bool operator==(const soa_ref& a, const value_type& b) { return a.view() == b; }
+    friend auto operator<=>(const soa_ref& a, const soa_ref& b) { return a.view() <=> b.view(); }
+    friend auto operator<=>(const soa_ref& a, const value_type& b) { return a.view() <=> b; }
+
+private:
+    std::tuple<const Fields&...> view() const {
+        return std::apply([](const auto&... f) { return std::tuple<const Fields&...>(f...); },
+                          mRefs);
+    }
+
+    template <typename Src, size_t... I>
+    void assignEach(Src& src, std::index_sequence<I...>, bool move) const {
+        if (move) {
+            ((std::get<I>(mRefs) = std::move(std::get<I>(src))), ...);
+        } else {
+            ((std::get<I>(mRefs) = std::get<I>(src)), ...);
+        }
+    }
+
+    template <size_t... I>
+    static void swapEach(const soa_ref& a, const soa_ref& b, std::index_sequence<I...>) {
+        using std::swap;
+        (swap(std::get<I>(a.mRefs), std::get<I>(b.mRefs)), ...);
+    }
+
+    std::tuple<Ref<Fields>...> mRefs;
+};
+
+// 结构化绑定：auto [name, score, age] = v[i]; 得到的是各字段的引用
+namespace std {
+template <bool Const, typename... Fields>
+struct tuple_size<soa_ref<Const, Fields...>> : integral_constant<size_t, sizeof...(Fields)> {};
+
+template <size_t I, bool Const, typename... Fields>
+struct tuple_element<I, soa_ref<Const, Fields...>> {
+    using type = conditional_t<Const, const tuple_element_t<I, tuple<Fields...>>&,
+                               tuple_element_t<I, tuple<Fields...>>&>;
+};
+}  // namespace std
+
+// ============================================================
+// soa_iterator：各列的起始指针 + 下标，只移动下标
+// ============================================================
+template <bool Const, typename... Fields>
+class soa_iterator {
+    using Bases = std::tuple<std::conditional_t<Const, const Fields*, Fields*>...>;
+
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = std::tuple<Fields...>;
+    using reference = soa_ref<Const, Fields...>;
+    using pointer = void;
+
+    soa_iterator() = default;
+    soa_iterator(Bases bases, difference_type i) : mBases(bases), mIdx(i) {}
+    template <bool C = Const, typename = std::enable_if_t<C>>
+    soa_iterator(const soa_iterator<false, Fields...>& o) : mBases(o.bases()), mIdx(o.index()) {}
+
+    reference operator*() const {
+        return std::apply([this](auto*... p) { return reference(p[mIdx]...); }, mBases);
+    }
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    soa_iterator& operator++() {
+        ++mIdx;
+        return *this;
+    }
+    soa_iterator& operator--() {
+        --mIdx;
+        return *this;
+    }
+    soa_iterator operator++(int) {
+        auto t = *this;
+        ++mIdx;
+        return t;
+    }
+    soa_iterator operator--(int) {
+        auto t = *this;
+        --mIdx;
+        return t;
+    }
+    soa_iterator& operator+=(difference_type n) {
+        mIdx += n;
+        return *this;
+    }
+    soa_iterator& operator-=(difference_type n) {
+        mIdx -= n;
+        return *this;
+    }
+    friend soa_iterator operator+(soa_iterator it, difference_type n) { return it += n; }
+    friend soa_iterator operator+(difference_type n, soa_iterator it) { return it += n; }
+    friend soa_iterator operator-(soa_iterator it, difference_type n) { return it -= n; }
+    friend difference_type operator-(const soa_iterator& a, const soa_iterator& b) {
+        return a.mIdx - b.mIdx;
+    }
+    friend bool operator==(const soa_iterator& a, const soa_iterator& b) {
+        return a.mIdx == b.mIdx;
+    }
+    friend auto operator<=>(const soa_iterator& a, const soa_iterator& b) {
+        return a.mIdx <=> b.mIdx;
+    }
+
+    const Bases& bases() const { return mBases; }
+    difference_type index() const { return mIdx; }
+
+private:
+    Bases mBases{};
+    difference_type mIdx = 0;
+};
+
+// ============================================================
+// soa_vector
+// ============================================================
+template <typename... Fields>
+class soa_vector {
+    static_assert(sizeof...(Fields) > 0, "soa_vector 至少要有一个字段");
+    static_assert(!(std::is_same_v<Fields, bool> || ...),
+                  "std::vector<bool> 没有 data()，请用 char 之类代替");
+
+    using Indices = std::index_sequence_for<Fields...>;
+
+public:
+    using value_type = std::tuple<Fields...>;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = soa_ref<false, Fields...>;
+    using const_reference = soa_ref<true, Fields...>;
+    using iterator = soa_iterator<false, Fields...>;
+    using const_iterator = soa_iterator<true, Fields...>;
+    template <size_t I>
+    using field_type = std::tuple_element_t<I, value_type>;
+    static constexpr size_t field_count = sizeof...(Fields);
+
+    soa_vector() = default;
+    explicit soa_vector(size_t n) { resize(n); }
+    soa_vector(std::initializer_list<value_type> init) {
+        reserve(init.size());
+        for (const auto& v : init) push_back(v);
+    }
+
+    // ---------- 容量 ----------
+    size_t size() const { return std::get<0>(mColumns).size(); }
+    bool empty() const { return size() == 0; }
+    size_t capacity() const {
+        return std::apply([](const auto&... c) { return std::min({c.capacity()...}); }, mColumns);
+    }
+    void reserve(size_t n) {
+        std::apply([n](auto&... c) { (c.reserve(n), ...); }, mColumns);
+    }
+    void shrink_to_fit() {
+        std::apply([](auto&... c) { (c.shrink_to_fit(), ...); }, mColumns);
+    }
+    void clear() {
+        std::apply([](auto&... c) { (c.clear(), ...); }, mColumns);
+    }
+
+    // 新元素值初始化；某一列抛异常时所有列回到原来的长度
+    void resize(size_t n) {
+        size_t old = size();
+        try {
+            std::apply([n](auto&... c) { (c.resize(n), ...); }, mColumns);
+        } catch (...) {
+            std::apply([old](auto&... c) { ((c.size() > old ? c.resize(old) : void()), ...); },
+                       mColumns);
+            throw;
+        }
+    }
+
+    // ---------- 元素访问 ----------
+    reference operator[](size_t i) { return begin()[difference_type(i)]; }
+    const_reference operator[](size_t i) const { return begin()[difference_type(i)]; }
+    reference at(size_t i) {
+        if (i >= size()) throw std::out_of_range("soa_vector::at");
+        return (*this)[i];
+    }
+    const_reference at(size_t i) const {
+        if (i >= size()) throw std::out_of_range("soa_vector::at");
+        return (*this)[i];
+    }
+    reference front() { return (*this)[0]; }
+    const_reference front() const { return (*this)[0]; }
+    reference back() { return (*this)[size() - 1]; }
+    const_reference back() const { return (*this)[size() - 1]; }
+
+    // 第 I 列
+    template <size_t I>
+    std::span<field_type<I>> field() {
+        return std::get<I>(mColumns);
+    }
+    template <size_t I>
+    std::span<const field_type<I>> field() const {
+        return std::get<I>(mColumns);
+    }
+
+    // ---------- 迭代 ----------
+    iterator begin() { return {bases(), 0}; }
+    iterator end() { return {bases(), difference_type(size())}; }
+    const_iterator begin() const { return {bases(), 0}; }
+    const_iterator end() const { return {bases(), difference_type(size())}; }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    // ---------- 修改 ----------
+    void push_back(const value_type& v) {
+        std::apply([this](const auto&... f) { emplace_back(f...); }, v);
+    }
+    void push_back(value_type&& v) {
+        std::apply([this](auto&... f) { emplace_back(std::move(f)...); }, v);
+    }
+
+    // 每个字段一个参数
+    template <typename... Args>
+    reference emplace_back(Args&&... args) {
+        static_assert(sizeof...(Args) == sizeof...(Fields), "emplace_back 需要每个字段一个参数");
+        size_t n = size();
+        if (n == capacity()) reserve(std::max<size_t>(2 * n, 8));
+        size_t done = 0;
+        try {
+            emplaceEach(done, std::forward_as_tuple(std::forward<Args>(args)...), Indices{});
+        } catch (...) {
+            std::apply([n](auto&... c) { ((c.size() > n ? c.pop_back() : void()), ...); },
+                       mColumns);
+            throw;
+        }
+        return back();
+    }
+
+    void pop_back() {
+        std::apply([](auto&... c) { (c.pop_back(), ...); }, mColumns);
+    }
+
+    iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+    iterator erase(const_iterator first, const_iterator last) {
+        difference_type i = first.index(), j = last.index();
+        std::apply([i, j](auto&... c) { (c.erase(c.begin() + i, c.begin() + j), ...); }, mColumns);
+        return begin() + i;
+    }
+
+    void swap(soa_vector& o) noexcept { mColumns.swap(o.mColumns); }
+    friend void swap(soa_vector& a, soa_vector& b) noexcept { a.swap(b); }
+
+    // ---------- 按下标排序 ----------
+    // comp(const_reference, const_reference)。先对 0..n-1 的下标排序（每次交换只动一个 size_t），
+    // 再用 permute 把每列整体重排一次
+    template <typename Compare>
+    void sort(Compare comp) {
+        sortByIndex<false>(comp);
+    }
+    template <typename Compare>
+    void stable_sort(Compare comp) {
+        sortByIndex<true>(comp);
+    }
+
+    // 重排：新的第 i 行是原来的第 order[i] 行（order 必须是 0..size()-1 的一个排列）
+    void permute(std::span<const size_t> order) {
+        if (order.size() != size())
+            throw std::invalid_argument("soa_vector::permute: size mismatch");
+        std::apply(
+            [&](auto&... c) {
+                ([&](auto& col) {
+                    std::remove_reference_t<decltype(col)> out;
+                    out.reserve(col.size());
+                    for (size_t i : order) out.push_back(std::move(col[i]));
+                    col.swap(out);
+                }(c), ...);
+            },
+            mColumns);
+    }
+
+    size_t memory_usage() const {
+        auto columnBytes = [](const auto&... c) {
+            return (size_t(0) + ... + (c.capacity() * sizeof(*c.data())));
+        };
+        return sizeof(*this) + std::apply(columnBytes, mColumns);
+    }
+
+    friend bool operator==(const soa_vector& a, const soa_vector& b) {
+        return a.mColumns == b.mColumns;
+    }
+
+private:
+    auto bases() {
+        return std::apply([](auto&... c) { return std::tuple<Fields*...>(c.data()...); }, mColumns);
+    }
+    auto bases() const {
+        auto data = [](const auto&... c) { return std::tuple<const Fields*...>(c.data()...); };
+        return std::apply(data, mColumns);
+    }
+
+    template <typename Args, size_t... I>
+    void emplaceEach(size_t& done, Args&& args, std::index_sequence<I...>) {
+        ((std::get<I>(mColumns).emplace_back(std::get<I>(std::move(args))), ++done), ...);
+    }
+
+    template <bool Stable, typename Compare>
+    void sortByIndex(Compare& comp) {
+        std::vector<size_t> order(size());
+        std::iota(order.begin(), order.end(), size_t(0));
+        const soa_vector& self = *this;
+        auto byRow = [&](size_t a, size_t b) { return comp(self[a], self[b]); };
+        if constexpr (Stable) std::stable_sort(order.begin(), order.end(), byRow);
+        else std::sort(order.begin(), order.end(), byRow);
+        permute(order);
+    }
+
+    std::tuple<std::vector<Fields>...> mColumns;
+};
@@ -0,0 +1,615 @@
+#pragma once
+
+// spatial.h: 二维 / 三维点的静态空间索引 —— k-d 树、打包 R 树、Morton（Z 序）数组
+//
+// level5 的 std::map<Point> 按 (x, y) 字典序排序：查一个矩形里的点，只能用 x 的范围缩小到
+// 一条竖带，带里的每个节点都要看一遍 y；找最近邻更是只能全表扫描。这里的三种索引都把
+// 空间上相近的点放在一起，一次批量构建，之后只读（查询是 const 的，可以多线程并发）：
+//
+//   kd_tree      ：隐式平衡 k-d 树。区间 [lo, hi) 的中点 mid 是分割点，左半在分割轴上
+//                  <= 它、右半 >= 它（nth_element 划分），轴取该区间包围盒最长的一维；
+//                  不存指针，只有点数组、id 数组和每个分割点的轴号。区间不超过 LeafSize 时直接扫描
+//   packed_rtree ：STR（Sort-Tile-Recursive）批量装载的 R 树。先按第 0 维排序切成若干竖条，
+//                  每条再按下一维排序切块……最后每 NodeSize 个点装满一个叶子；上一层对下一层节点
+//                  的包围盒中心重复同样的过程。节点几乎全满、包围盒重叠少
+//   morton_array ：把坐标量化成整数后按位交织成 Z 序编码（2 维每维 32 位、3 维每维 21 位），
+//                  点按编码排序存在数组里。Z 序上的每个前缀对应一个方格，方格里的点在数组中连续：
+//                  矩形查询从整个空间开始四分（三维八分），完全在查询框内的方格整段输出，
+//                  点数不多的方格直接扫描，其余继续细分，每一步用二分查找定位区间
+//
+// 查询接口相同：
+//   range_query(box, f) 对框内（闭区间）每个点调用 f(id, point)；range(box) 返回 id 列表
+//   knn(q, k)           返回距离最近的 k 个点，按距离升序（spatial_neighbor：id 与距离平方）
+// id 是构建时点在输入 span 里的下标，用来找回点附带的数据。
+// kNN：k-d 树按分割面剪枝的深度优先搜索；R 树按节点到 q 的最小距离做最佳优先搜索；
+// Morton 数组先取 q 的编码位置前后 k 个点估计第 k 近的距离 r，再查边长 2r 的框。
+// 距离按 double 计算；坐标类型可以是整数或浮点。
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+template <typename Coord, size_t Dim>
+using spatial_point = std::array<Coord, Dim>;
+
+// 轴对齐的包围盒，两端都是闭区间；lo > hi 的维度表示空框
+template <typename Coord, size_t Dim>
+struct spatial_box {
+    using point_type = spatial_point<Coord, Dim>;
+    point_type lo, hi;
+
+    // 不含任何点的框，expand 之后才有意义
+    static spatial_box empty() {
+        spatial_box b;
+        b.lo.fill(std::numeric_limits<Coord>::max());
+        b.hi.fill(std::numeric_limits<Coord>::lowest());
+        return b;
+    }
+
+    bool contains(const point_type& p) const {
+        for (size_t d = 0; d < Dim; d++)
+            if (p[d] < lo[d] || hi[d] < p[d]) return false;
+        return true;
+    }
+    bool contains(const spatial_box& b) const {
+        for (size_t d = 0; d < Dim; d++)
+            if (b.lo[d] < lo[d] || hi[d] < b.hi[d]) return false;
+        return true;
+    }
+    bool intersects(const spatial_box& b) const {
+        for (size_t d = 0; d < Dim; d++)
+            if (b.hi[d] < lo[d] || hi[d] < b.lo[d]) return false;
+        return true;
+    }
+    void expand(const point_type& p) {
+        for (size_t d = 0; d < Dim; d++) {
+            lo[d] = std::min(lo[d], p[d]);
+            hi[d] = std::max(hi[d], p[d]);
+        }
+    }
+    void expand(const spatial_box& b) {
+        for (size_t d = 0; d < Dim; d++) {
+            lo[d] = std::min(lo[d], b.lo[d]);
+            hi[d] = std::max(hi[d], b.hi[d]);
+        }
+    }
+    double center(size_t d) const { return (double(lo[d]) + double(hi[d])) / 2; }
+};
+
+struct spatial_neighbor {
+    uint32_t id;
+    double dist2;  // 距离的平方
+
+    bool operator<(const spatial_neighbor& o) const {
+        return dist2 != o.dist2 ? dist2 < o.dist2 : id < o.id;
+    }
+};
+
+template <typename Coord, size_t Dim>
+inline double spatial_dist2(const spatial_point<Coord, Dim>& a,
+                            const spatial_point<Coord, Dim>& b) {
+    double s = 0;
+    for (size_t d = 0; d < Dim; d++) {
+        double t = double(a[d]) - double(b[d]);
+        s += t * t;
+    }
+    return s;
+}
+
+// 点到框的最小距离平方（点在框内为 0）
+template <typename Coord, size_t Dim>
+inline double spatial_min_dist2(const spatial_box<Coord, Dim>& b,
+                                const spatial_point<Coord, Dim>& p) {
+    double s = 0;
+    for (size_t d = 0; d < Dim; d++) {
+        double t = 0;
+        if (p[d] < b.lo[d]) t = double(b.lo[d]) - double(p[d]);
+        else if (b.hi[d] < p[d]) t = double(p[d]) - double(b.hi[d]);
+        s += t * t;
+    }
+    return s;
+}
+
+// 保留当前最近的 k 个候选：大顶堆，堆顶是第 k 近的
+class spatial_knn_heap {
+public:
+    explicit spatial_knn_heap(size_t k) : mK(k) { mHeap.reserve(k); }
+
+    bool full() const { return mHeap.size() == mK; }
+    // 候选的距离平方必须小于它才有用；没满时是无穷大
+    double worst() const {
+        if (mK == 0) return -std::numeric_limits<double>::infinity();
+        return full() ? mHeap.front().dist2 : std::numeric_limits<double>::infinity();
+    }
+
+    void offer(uint32_t id, double dist2) {
+        if (mK == 0) return;
+        spatial_neighbor c{id, dist2};
+        if (!full()) {
+            mHeap.push_back(c);
+            std::push_heap(mHeap.begin(), mHeap.end());
+        } else if (c < mHeap.front()) {
+            std::pop_heap(mHeap.begin(), mHeap.end());
+            mHeap.back() = c;
+            std::push_heap(mHeap.begin(), mHeap.end());
+        }
+    }
+
+    std::vector<spatial_neighbor> sorted() && {
+        std::sort_heap(mHeap.begin(), mHeap.end());
+        return std::move(mHeap);
+    }
+
+private:
+    size_t mK;
+    std::vector<spatial_neighbor> mHeap;
+};
+
+// 构建时点和 id 一起排序 / 划分，最后再拆成两个数组
+template <typename Coord, size_t Dim>
+struct spatial_item {
+    spatial_point<Coord, Dim> p;
+    uint32_t id;
+};
+
+template <typename Coord, size_t Dim>
+inline std::vector<spatial_item<Coord, Dim>> spatial_items(
+    std::span<const spatial_point<Coord, Dim>> pts) {
+    if (pts.size() >= UINT32_MAX) throw std::length_error("spatial index: too many points");
+    std::vector<spatial_item<Coord, Dim>> items(pts.size());
+    for (size_t i = 0; i < pts.size(); i++) items[i] = {pts[i], uint32_t(i)};
+    return items;
+}
+
+// ============================================================
+// kd_tree
+// ============================================================
+template <typename Coord, size_t Dim, size_t LeafSize = 8>
+class kd_tree {
+    static_assert(Dim >= 1 && Dim <= 255);
+    static_assert(LeafSize >= 1);
+
+public:
+    using point_type = spatial_point<Coord, Dim>;
+    using box_type = spatial_box<Coord, Dim>;
+
+    kd_tree() = default;
+    explicit kd_tree(std::span<const point_type> pts) {
+        auto items = spatial_items(pts);
+        mAxis.assign(items.size(), 0);
+        build(items, 0, items.size());
+        mPoints.resize(items.size());
+        mIds.resize(items.size());
+        for (size_t i = 0; i < items.size(); i++) {
+            mPoints[i] = items[i].p;
+            mIds[i] = items[i].id;
+        }
+    }
+
+    size_t size() const noexcept { return mPoints.size(); }
+    bool empty() const noexcept { return mPoints.empty(); }
+    size_t memory_usage() const noexcept {
+        return mPoints.capacity() * sizeof(point_type) + mIds.capacity() * sizeof(uint32_t) +
+               mAxis.capacity();
+    }
+
+    template <typename F>
+    void range_query(const box_type& b, F&& f) const {
+        rangeIn(0, size(), b, f);
+    }
+    std::vector<uint32_t> range(const box_type& b) const {
+        std::vector<uint32_t> out;
+        range_query(b, [&](uint32_t id, const point_type&) { out.push_back(id); });
+        return out;
+    }
+
+    std::vector<spatial_neighbor> knn(const point_type& q, size_t k) const {
+        spatial_knn_heap heap(std::min(k, size()));
+        if (k > 0) knnIn(0, size(), q, heap);
+        return std::move(heap).sorted();
+    }
+
+private:
+    using Item = spatial_item<Coord, Dim>;
+
+    void build(std::vector<Item>& items, size_t lo, size_t hi) {
+        while (hi - lo > LeafSize) {
+            box_type b = box_type::empty();
+            for (size_t i = lo; i < hi; i++) b.expand(items[i].p);
+            size_t axis = 0;
+            double best = -1;
+            for (size_t d = 0; d < Dim; d++) {
+                double extent = double(b.hi[d]) - double(b.lo[d]);
+                if (extent > best) best = extent, axis = d;
+            }
+            size_t mid = lo + (hi - lo) / 2;
+            auto byAxis = [axis](const Item& a, const Item& c) { return a.p[axis] < c.p[axis]; };
+            std::nth_element(items.begin() + ptrdiff_t(lo), items.begin() + ptrdiff_t(mid),
+                             items.begin() + ptrdiff_t(hi), byAxis);
+            mAxis[mid] = uint8_t(axis);
+            build(items, lo, mid);
+            lo = mid + 1;
+        }
+    }
+
+    template <typename F>
+    void rangeIn(size_t lo, size_t hi, const box_type& b, F& f) const {
+        while (hi - lo > LeafSize) {
+            size_t mid = lo + (hi - lo) / 2, axis = mAxis[mid];
+            const point_type& p = mPoints[mid];
+            if (b.contains(p)) f(mIds[mid], p);
+            bool left = !(p[axis] < b.lo[axis]), right = !(b.hi[axis] < p[axis]);
+            if (left && right) {
+                rangeIn(lo, mid, b, f);
+                lo = mid + 1;
+            } else if (left) {
+                hi = mid;
+            } else if (right) {
+                lo = mid + 1;
+            } else {
+                return;  // 空框
+            }
+        }
+        for (size_t i = lo; i < hi; i++)
+            if (b.contains(mPoints[i])) f(mIds[i], mPoints[i]);
+    }
+
+    void knnIn(size_t lo, size_t hi, const point_type& q, spatial_knn_heap& heap) const {
+        while (hi - lo > LeafSize) {
+            size_t mid = lo + (hi - lo) / 2, axis = mAxis[mid];
+            const point_type& p = mPoints[mid];
+            heap.offer(mIds[mid], spatial_dist2(p, q));
+            double diff = double(q[axis]) - double(p[axis]);
+            // 先进 q 所在的一侧；另一侧只有在分割面比当前第 k 近更近时才可能有答案
+            if (diff < 0) {
+                knnIn(lo, mid, q, heap);
+                if (diff * diff >= heap.worst()) return;
+                lo = mid + 1;
+            } else {
+                knnIn(mid + 1, hi, q, heap);
+                if (diff * diff >= heap.worst()) return;
+                hi = mid;
+            }
+        }
+        for (size_t i = lo; i < hi; i++) heap.offer(mIds[i], spatial_dist2(mPoints[i], q));
+    }
+
+    std::vector<point_type> mPoints;
+    std::vector<uint32_t> mIds;
+    std::vector<uint8_t> mAxis;  // mAxis[mid]：以 mid 为分割点的区间用哪一维划分
+};
+
+// ============================================================
+// packed_rtree
+// ============================================================
+template <typename Coord, size_t Dim, size_t NodeSize = 16>
+class packed_rtree {
+    static_assert(NodeSize >= 2);
+
+public:
+    using point_type = spatial_point<Coord, Dim>;
+    using box_type = spatial_box<Coord, Dim>;
+
+    packed_rtree() = default;
+    explicit packed_rtree(std::span<const point_type> pts) {
+        auto items = spatial_items(pts);
+        strSort(items.begin(), items.end(), 0,
+                [](const Item& it, size_t d) { return double(it.p[d]); });
+        mPoints.resize(items.size());
+        mIds.resize(items.size());
+        for (size_t i = 0; i < items.size(); i++) {
+            mPoints[i] = items[i].p;
+            mIds[i] = items[i].id;
+        }
+        if (items.empty()) return;
+
+        // 叶子：每 NodeSize 个点一个
+        std::vector<Node> level;
+        for (size_t i = 0; i < mPoints.size(); i += NodeSize) {
+            auto count = uint32_t(std::min(NodeSize, mPoints.size() - i));
+            Node n{box_type::empty(), uint32_t(i), count};
+            for (size_t j = i; j < i + n.count; j++) n.box.expand(mPoints[j]);
+            level.push_back(n);
+        }
+        // 逐层向上：先对本层节点按包围盒中心做 STR 排序，再每 NodeSize 个装一个父节点
+        while (level.size() > 1) {
+            strSort(level.begin(), level.end(), 0,
+                    [](const Node& n, size_t d) { return n.box.center(d); });
+            std::vector<Node> parents;
+            for (size_t i = 0; i < level.size(); i += NodeSize) {
+                auto count = uint32_t(std::min(NodeSize, level.size() - i));
+                Node n{box_type::empty(), uint32_t(i), count};
+                for (size_t j = i; j < i + n.count; j++) n.box.expand(level[j].box);
+                parents.push_back(n);
+            }
+            mLevels.push_back(std::move(level));
+            level = std::move(parents);
+        }
+        mLevels.push_back(std::move(level));
+    }
+
+    size_t size() const noexcept { return mPoints.size(); }
+    bool empty() const noexcept { return mPoints.empty(); }
+    size_t height() const noexcept { return mLevels.size(); }  // 含叶子层
+    size_t node_count() const noexcept {
+        size_t n = 0;
+        for (auto& l : mLevels) n += l.size();
+        return n;
+    }
+    size_t memory_usage() const noexcept {
+        size_t bytes = mPoints.capacity() * sizeof(point_type) + mIds.capacity() * sizeof(uint32_t);
+        for (auto& l : mLevels) bytes += l.capacity() * sizeof(Node);
+        return bytes;
+    }
+
+    template <typename F>
+    void range_query(const box_type& b, F&& f) const {
+        if (!empty()) rangeIn(mLevels.size() - 1, 0, b, false, f);
+    }
+    std::vector<uint32_t> range(const box_type& b) const {
+        std::vector<uint32_t> out;
+        range_query(b, [&](uint32_t id, const point_type&) { out.push_back(id); });
+        return out;
+    }
+
+    std::vector<spatial_neighbor> knn(const point_type& q, size_t k) const {
+        spatial_knn_heap heap(std::min(k, size()));
+        if (empty() || k == 0) return std::move(heap).sorted();
+        // 最佳优先：总是先展开离 q 最近的节点，最近的节点都比第 k 近的候选远时结束
+        struct Pending {
+            double dist2;
+            uint32_t level, index;
+            bool operator>(const Pending& o) const { return dist2 > o.dist2; }
+        };
+        std::priority_queue<Pending, std::vector<Pending>, std::greater<>> pq;
+        pq.push({0, uint32_t(mLevels.size() - 1), 0});
+        while (!pq.empty()) {
+            auto [d2, lv, idx] = pq.top();
+            pq.pop();
+            if (d2 >= heap.worst()) break;
+            const Node& n = mLevels[lv][idx];
+            for (uint32_t i = n.first; i < n.first + n.count; i++) {
+                if (lv == 0) {
+                    heap.offer(mIds[i], spatial_dist2(mPoints[i], q));
+                } else {
+                    double cd = spatial_min_dist2(mLevels[lv - 1][i].box, q);
+                    if (cd < heap.worst()) pq.push({cd, lv - 1, i});
+                }
+            }
+        }
+        return std::move(heap).sorted();
+    }
+
+private:
+    using Item = spatial_item<Coord, Dim>;
+
+    struct Node {
+        box_type box;
+        uint32_t first, count;  // 叶子：mPoints 的区间；其它：下一层节点的区间
+    };
+
+    // 按 key(x, axis) 排序后切成 ceil(P^(1/(Dim-axis))) 条（P 为需要的节点数），
+    // 每条再对下一维递归；每条的元素个数是 NodeSize 的整数倍，节点不会跨条
+    template <typename It, typename Key>
+    static void strSort(It first, It last, size_t axis, Key key) {
+        size_t n = size_t(last - first);
+        if (n <= NodeSize) return;
+        std::sort(first, last,
+                  [&](const auto& a, const auto& b) { return key(a, axis) < key(b, axis); });
+        if (axis + 1 == Dim) return;
+        size_t nodes = (n + NodeSize - 1) / NodeSize;
+        auto slabs = size_t(std::ceil(std::pow(double(nodes), 1.0 / double(Dim - axis))));
+        size_t slab = (nodes + slabs - 1) / slabs * NodeSize;
+        for (size_t i = 0; i < n; i += slab)
+            strSort(first + ptrdiff_t(i), first + ptrdiff_t(std::min(n, i + slab)), axis + 1, key);
+    }
+
+    // inside：祖先节点已整个落在查询框内，不用再逐个检查
+    template <typename F>
+    void rangeIn(size_t lv, uint32_t idx, const box_type& b, bool inside, F& f) const {
+        const Node& n = mLevels[lv][idx];
+        if (!inside) {
+            if (!b.intersects(n.box)) return;
+            inside = b.contains(n.box);
+        }
+        for (uint32_t i = n.first; i < n.first + n.count; i++) {
+            if (lv > 0) rangeIn(lv - 1, i, b, inside, f);
+            else if (inside || b.contains(mPoints[i])) f(mIds[i], mPoints[i]);
+        }
+    }
+
+    std::vector<point_type> mPoints;
+    std::vector<uint32_t> mIds;
+    std::vector<std::vector<Node>> mLevels;  // mLevels[0] 是叶子，back() 只有根节点
+};
+
+// ============================================================
+// morton_array
+// ============================================================
+template <typename Coord, size_t Dim>
+class morton_array {
+    static_assert(Dim >= 2 && Dim <= 8);
+
+public:
+    using point_type = spatial_point<Coord, Dim>;
+    using box_type = spatial_box<Coord, Dim>;
+    static constexpr unsigned kBits = std::min<unsigned>(32, 64 / Dim);  // 每维的量化位数
+
+    morton_array() = default;
+    explicit morton_array(std::span<const point_type> pts) {
+        if (pts.size() >= UINT32_MAX) throw std::length_error("morton_array: too many points");
+        // 量化：包围盒线性映射到 [0, 2^kBits - 1]，单调，所以框查询可以先在整数坐标上剪枝
+        box_type bounds = box_type::empty();
+        for (auto& p : pts) bounds.expand(p);
+        for (size_t d = 0; d < Dim; d++) {
+            mMin[d] = pts.empty() ? 0 : double(bounds.lo[d]);
+            double extent = pts.empty() ? 0 : double(bounds.hi[d]) - mMin[d];
+            mScale[d] = extent > 0 ? double(kMaxQ) / extent : 0;
+        }
+
+        std::vector<std::pair<uint64_t, uint32_t>> order(pts.size());
+        for (size_t i = 0; i < pts.size(); i++) order[i] = {encode(pts[i]), uint32_t(i)};
+        std::sort(order.begin(), order.end());
+        mCodes.resize(pts.size());
+        mPoints.resize(pts.size());
+        mIds.resize(pts.size());
+        for (size_t i = 0; i < pts.size(); i++) {
+            mCodes[i] = order[i].first;
+            mIds[i] = order[i].second;
+            mPoints[i] = pts[order[i].second];
+        }
+    }
+
+    size_t size() const noexcept { return mPoints.size(); }
+    bool empty() const noexcept { return mPoints.empty(); }
+    size_t memory_usage() const noexcept {
+        return mCodes.capacity() * sizeof(uint64_t) + mPoints.capacity() * sizeof(point_type) +
+               mIds.capacity() * sizeof(uint32_t);
+    }
+
+    // 点的 Z 序编码：第 b 位量化坐标的第 d 维放在编码的第 b * Dim + d 位
+    uint64_t encode(const point_type& p) const {
+        uint64_t code = 0;
+        for (size_t d = 0; d < Dim; d++) code |= spread(quantize(double(p[d]), d)) << d;
+        return code;
+    }
+    std::span<const uint64_t> codes() const noexcept { return mCodes; }
+    std::span<const point_type> points() const noexcept { return mPoints; }  // 按编码排序
+
+    template <typename F>
+    void range_query(const box_type& b, F&& f) const {
+        Cell qlo, qhi;
+        for (size_t d = 0; d < Dim; d++) {
+            if (b.hi[d] < b.lo[d]) return;
+            qlo[d] = quantize(double(b.lo[d]), d);
+            qhi[d] = quantize(double(b.hi[d]), d);
+        }
+        visit(qlo, qhi, [&](size_t i, bool inside) {
+            if (inside || b.contains(mPoints[i])) f(mIds[i], mPoints[i]);
+        });
+    }
+    std::vector<uint32_t> range(const box_type& b) const {
+        std::vector<uint32_t> out;
+        range_query(b, [&](uint32_t id, const point_type&) { out.push_back(id); });
+        return out;
+    }
+
+    std::vector<spatial_neighbor> knn(const point_type& q, size_t k) const {
+        k = std::min(k, size());
+        spatial_knn_heap heap(k);
+        if (k == 0) return std::move(heap).sorted();
+        // Z 序相邻的点多半空间上也相近：用编码位置前后的 k 个点得到第 k 近距离的上界 r
+        auto pos =
+            size_t(std::lower_bound(mCodes.begin(), mCodes.end(), encode(q)) - mCodes.begin());
+        size_t lo = pos > k ? pos - k : 0, hi = std::min(size(), lo + 2 * k);
+        lo = hi > 2 * k ? hi - 2 * k : 0;
+        for (size_t i = lo; i < hi; i++) heap.offer(mIds[i], spatial_dist2(mPoints[i], q));
+        // 第 k 近的点一定在以 q 为中心、半边长 r 的框里；留一点余量抵消浮点舍入
+        double r = std::sqrt(heap.worst()) * (1 + 1e-9) + 1e-9;
+        Cell qlo, qhi;
+        for (size_t d = 0; d < Dim; d++) {
+            qlo[d] = quantize(double(q[d]) - r, d);
+            qhi[d] = quantize(double(q[d]) + r, d);
+        }
+        visit(qlo, qhi, [&](size_t i, bool) {
+            if (i < lo || i >= hi) heap.offer(mIds[i], spatial_dist2(mPoints[i], q));
+        });
+        return std::move(heap).sorted();
+    }
+
+private:
+    using Cell = std::array<uint64_t, Dim>;
+    static constexpr uint64_t kMaxQ = (uint64_t(1) << kBits) - 1;
+    static constexpr size_t kScan = 32;  // 方格里的点不超过这么多就直接扫描，不再细分
+
+    uint64_t quantize(double v, size_t d) const {
+        double t = (v - mMin[d]) * mScale[d];
+        if (!(t > 0)) return 0;  // 也处理 NaN
+        if (t >= double(kMaxQ)) return kMaxQ;
+        return uint64_t(t);
+    }
+
+    // 把低 kBits 位分散到每 Dim 位一位
+    static uint64_t spread(uint64_t v) {
+        if constexpr (Dim == 2) {
+            v &= 0xffffffffull;
+            v = (v | (v << 16)) & 0x0000ffff0000ffffull;
+            v = (v | (v << 8)) & 0x00ff00ff00ff00ffull;
+            v = (v | (v << 4)) & 0x0f0f0f0f0f0f0f0full;
+            v = (v | (v << 2)) & 0x3333333333333333ull;
+            v = (v | (v << 1)) & 0x5555555555555555ull;
+            return v;
+        } else if constexpr (Dim == 3) {
+            v &= 0x1fffffull;
+            v = (v | (v << 32)) & 0x001f00000000ffffull;
+            v = (v | (v << 16)) & 0x001f0000ff0000ffull;
+            v = (v | (v << 8)) & 0x100f00f00f00f00full;
+            v = (v | (v << 4)) & 0x10c30c30c30c30c3ull;
+            v = (v | (v << 2)) & 0x1249249249249249ull;
+            return v;
+        } else {
+            uint64_t out = 0;
+            for (unsigned b = 0; b < kBits; b++) out |= ((v >> b) & 1) << (b * Dim);
+            return out;
+        }
+    }
+
+    // 对量化框 [qlo, qhi] 可能命中的每个点调用 f(i, inside)；inside 为真表示所在方格严格位于
+    // 量化框内部，点一定在原始查询框内（量化单调：q(x) > q(lo) 蕴含 x > lo）
+    template <typename F>
+    void visit(const Cell& qlo, const Cell& qhi, F&& f) const {
+        Cell origin{};
+        visitCell(0, 0, origin, 0, size(), qlo, qhi, f);
+    }
+
+    template <typename F>
+    void visitCell(unsigned level, uint64_t prefix, const Cell& cellLo, size_t b, size_t e,
+                   const Cell& qlo, const Cell& qhi, F& f) const {
+        if (b == e) return;
+        uint64_t side = uint64_t(1) << (kBits - level);
+        bool inside = true;
+        for (size_t d = 0; d < Dim; d++) {
+            uint64_t cellHi = cellLo[d] + side - 1;
+            if (cellHi < qlo[d] || cellLo[d] > qhi[d]) return;
+            inside = inside && cellLo[d] > qlo[d] && cellHi < qhi[d];
+        }
+        if (inside || e - b <= kScan || level == kBits) {
+            for (size_t i = b; i < e; i++) f(i, inside);
+            return;
+        }
+        // 2^Dim 个子方格按编码顺序排列，各自的点在 [b, e) 中连续
+        unsigned childShift = unsigned(Dim) * (kBits - level - 1);
+        uint64_t half = side / 2;
+        size_t start = b;
+        for (uint64_t c = 0; c < (uint64_t(1) << Dim); c++) {
+            uint64_t child = (prefix << Dim) | c;
+            size_t end = e;
+            if (c + 1 < (uint64_t(1) << Dim)) {
+                auto first = mCodes.begin() + ptrdiff_t(start);
+                auto last = mCodes.begin() + ptrdiff_t(e);
+                end = size_t(std::lower_bound(first, last, (child + 1) << childShift) -
+                             mCodes.begin());
+            }
+            Cell childLo = cellLo;
+            for (size_t d = 0; d < Dim; d++)
+                if ((c >> d) & 1) childLo[d] += half;
+            visitCell(level + 1, child, childLo, start, end, qlo, qhi, f);
+            start = end;
+        }
+    }
+
+    std::array<double, Dim> mMin{}, mScale{};
+    std::vector<uint64_t> mCodes;
+    std::vector<point_type> mPoints;
+    std::vector<uint32_t> mIds;
+};
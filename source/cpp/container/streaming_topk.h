@@ -0,0 +1,419 @@
+#pragma once
+
+// streaming_topk.h: 数据流上的 Top-K 与频繁项（heavy hitters）
+//
+// level3 的 Top-K 和 level5 的词频统计都假设数据能一次放进内存。对无界的数据流，
+// 这里提供一组接口相同的统计器（add / top / merge / total / memory_usage）：
+//
+//   exact_topk<Key>        ：精确计数。flat_hash_map 计数 + 大小为 k 的最小堆选出前 k 个；
+//                            内存随不同 key 的个数增长。可合并：每个线程统计自己的一份，最后 merge
+//   space_saving<Key>      ：Space-Saving，固定 m 个计数器。新 key 到来而计数器已满时，
+//                            顶替计数最小的那个，并把它的计数记为新 key 的误差。
+//                            保证：估计值 - 误差 <= 真实值 <= 估计值，误差 <= N / m；
+//                            真实频率超过 N / m 的 key 一定在表中
+//   count_min_sketch<Key>  ：depth 行 x width 列的计数器矩阵，每行一个哈希函数，估计值取各行最小值。
+//                            只会高估，误差 <= e / width * N 的概率至少 1 - e^-depth。内存与 key 的个数无关
+//   cms_topk<Key>          ：count_min_sketch + 大小为 k 的候选堆，流式维护估计值最大的 k 个 key
+//
+// 三种近似结构都可以合并（space_saving 采用 Agarwal 等人的可合并摘要做法），
+// 所以多线程时同样是"各线程独立统计，最后合并"，线程之间没有任何共享写入。
+// 都不是线程安全的：每个线程用自己的实例。
+
+#include "flat_hash_map.h"
+#include "hash_utils.h"
+#include "heaps.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// top() 的结果：count 为估计值，真实值在 [count - error, count] 内（精确模式 error 为 0）
+template <typename Key>
+struct topk_entry {
+    Key key;
+    uint64_t count;
+    uint64_t error;
+};
+
+// 从 first..last 中选出 count 最大的 k 个，按 count 降序返回（最小堆只保留 k 个，O(n log k)）
+template <typename Key, typename It, typename Proj>
+std::vector<topk_entry<Key>> topk_select(It first, It last, size_t k, Proj proj) {
+    struct ByCount {
+        bool operator()(const topk_entry<Key>& a, const topk_entry<Key>& b) const {
+            return a.count > b.count;  // 最小堆：堆顶是当前第 k 大
+        }
+    };
+    std::vector<topk_entry<Key>> result;
+    if (k == 0) {
+        return result;
+    }
+    d_ary_heap<topk_entry<Key>, 4, ByCount> heap;
+    heap.reserve(k);
+    for (; first != last; ++first) {
+        topk_entry<Key> e = proj(*first);
+        if (heap.size() < k) {
+            heap.push(std::move(e));
+        } else if (e.count > heap.top().count) {
+            heap.replace_top(std::move(e));
+        }
+    }
+    result.reserve(heap.size());
+    while (!heap.empty()) {
+        result.push_back(heap.top());
+        heap.pop();
+    }
+    std::reverse(result.begin(), result.end());
+    return result;
+}
+
+// ============================================================
+// exact_topk：精确计数
+// ============================================================
+template <typename Key, typename Hash = flat_hash<Key>>
+class exact_topk {
+public:
+    using key_type = Key;
+
+    void add(const Key& key, uint64_t n = 1) {
+        mCounts[key] += n;
+        mTotal += n;
+    }
+
+    void merge(const exact_topk& o) {
+        for (const auto& [key, c] : o.mCounts) {
+            mCounts[key] += c;
+        }
+        mTotal += o.mTotal;
+    }
+
+    uint64_t count(const Key& key) const {
+        auto it = mCounts.find(key);
+        return it == mCounts.end() ? 0 : it->second;
+    }
+
+    std::vector<topk_entry<Key>> top(size_t k) const {
+        return topk_select<Key>(mCounts.begin(), mCounts.end(), k, [](const auto& kv) {
+            return topk_entry<Key>{kv.first, kv.second, 0};
+        });
+    }
+
+    uint64_t total() const noexcept { return mTotal; }
+    size_t distinct() const noexcept { return mCounts.size(); }
+    void reserve(size_t distinctKeys) { mCounts.reserve(distinctKeys); }
+    // 哈希表本身占用的字节（不含 key 自身的堆内存）
+    size_t memory_usage() const { return mCounts.memory_usage(); }
+
+private:
+    flat_hash_map<Key, uint64_t, Hash> mCounts;
+    uint64_t mTotal = 0;
+};
+
+// ============================================================
+// space_saving：固定 m 个计数器
+//   计数放在 indexed_heap（最小堆）里，顶替时直接取堆顶；key -> 计数器编号用 flat_hash_map
+// ============================================================
+template <typename Key, typename Hash = flat_hash<Key>>
+class space_saving {
+public:
+    using key_type = Key;
+
+    explicit space_saving(size_t capacity) : mCapacity(capacity), mHeap(capacity) {
+        if (capacity == 0) {
+            throw std::invalid_argument("space_saving: capacity must be positive");
+        }
+        mIndex.reserve(capacity);
+        mSlots.reserve(capacity);
+    }
+
+    void add(const Key& key, uint64_t n = 1) {
+        mTotal += n;
+        if (auto it = mIndex.find(key); it != mIndex.end()) {
+            uint32_t id = it->second;
+            mHeap.update(id, mHeap.priority(id) + n);
+            return;
+        }
+        if (mSlots.size() < mCapacity) {
+            auto id = static_cast<uint32_t>(mSlots.size());
+            mSlots.push_back({key, 0});
+            mIndex.try_emplace(key, id);
+            mHeap.push(id, n);
+            return;
+        }
+        // 顶替计数最小的 key：新 key 的真实计数可能是 0..min，把 min 记作误差
+        uint32_t id = mHeap.top_id();
+        uint64_t minCount = mHeap.top_priority();
+        Slot& s = mSlots[id];
+        mIndex.erase(s.key);
+        s = {key, minCount};
+        mIndex.try_emplace(key, id);
+        mHeap.update(id, minCount + n);
+    }
+
+    // 可合并摘要：一方没有的 key，按该方的最小计数（表满时）补上计数和误差，再保留前 m 个
+    void merge(const space_saving& o) {
+        uint64_t minA = min_count(), minB = o.min_count();
+        flat_hash_map<Key, std::pair<uint64_t, uint64_t>, Hash> merged;  // key -> (count, error)
+        merged.reserve(mSlots.size() + o.mSlots.size());
+        for (uint32_t id = 0; id < mSlots.size(); ++id) {
+            merged.try_emplace(mSlots[id].key, mHeap.priority(id) + minB, mSlots[id].error + minB);
+        }
+        for (uint32_t id = 0; id < o.mSlots.size(); ++id) {
+            uint64_t c = o.mHeap.priority(id), e = o.mSlots[id].error;
+            auto [it, inserted] = merged.try_emplace(o.mSlots[id].key, c + minA, e + minA);
+            if (!inserted) {
+                // 两边都有：各自的计数相加，之前补上的 minB 要扣掉
+                it->second.first += c - minB;
+                it->second.second += e - minB;
+            }
+        }
+        auto kept = topk_select<Key>(merged.begin(), merged.end(), mCapacity, [](const auto& kv) {
+            return topk_entry<Key>{kv.first, kv.second.first, kv.second.second};
+        });
+        mIndex.clear();
+        mSlots.clear();
+        mHeap.clear();
+        for (auto& e : kept) {
+            auto id = static_cast<uint32_t>(mSlots.size());
+            mIndex.try_emplace(e.key, id);
+            mSlots.push_back({std::move(e.key), e.error});
+            mHeap.push(id, e.count);
+        }
+        mTotal += o.mTotal;
+    }
+
+    // 估计值；不在表中时返回最小计数（真实值的上界）
+    uint64_t estimate(const Key& key) const {
+        auto it = mIndex.find(key);
+        return it == mIndex.end() ? min_count() : mHeap.priority(it->second);
+    }
+
+    std::vector<topk_entry<Key>> top(size_t k) const {
+        std::vector<topk_entry<Key>> all;
+        all.reserve(mSlots.size());
+        for (uint32_t id = 0; id < mSlots.size(); ++id) {
+            all.push_back({mSlots[id].key, mHeap.priority(id), mSlots[id].error});
+        }
+        return topk_select<Key>(all.begin(), all.end(), k, [](const auto& e) { return e; });
+    }
+
+    // 表满时为最小计数，否则为 0：不在表中的 key 的真实计数不超过它
+    uint64_t min_count() const { return mSlots.size() < mCapacity ? 0 : mHeap.top_priority(); }
+    uint64_t total() const noexcept { return mTotal; }
+    size_t capacity() const noexcept { return mCapacity; }
+    size_t memory_usage() const {
+        return mIndex.memory_usage() + mSlots.capacity() * sizeof(Slot) + mHeap.memory_usage();
+    }
+
+private:
+    struct Slot {
+        Key key;
+        uint64_t error;
+    };
+
+    size_t mCapacity;
+    flat_hash_map<Key, uint32_t, Hash> mIndex;
+    std::vector<Slot> mSlots;                       // 按计数器编号
+    indexed_heap<uint64_t, std::greater<>> mHeap;  // 计数器编号 -> 计数，最小堆
+    uint64_t mTotal = 0;
+};
+
+// ============================================================
+// count_min_sketch
+//   一次 64 位哈希拆成 h1 / h2，第 i 行的列号为 (h1 + i * h2) mod width（Kirsch-Mitzenmacher），
+//   不需要 depth 个独立的哈希函数。width 取 2 的幂。
+//   默认使用保守更新（conservative update）：只把各行中小于"新估计值"的计数器抬高到新估计值，
+//   估计值不变、高估明显减少；代价是不再支持减法
+// ============================================================
+template <typename Key, typename Hash = mixed_hash<Key>>
+class count_min_sketch {
+public:
+    using key_type = Key;
+
+    // depth 限制在 [1, kMaxDepth]：哈希最多算 kMaxDepth 行，多要的行既不分配也不计入误差
+    explicit count_min_sketch(size_t width, size_t depth = 4, bool conservative = true)
+        : mWidth(std::bit_ceil(std::max<size_t>(width, 2))),
+          mDepth(std::clamp<size_t>(depth, 1, kMaxDepth)),
+          mConservative(conservative),
+          mTable(mWidth * mDepth, 0) {}
+
+    // 按误差要求选尺寸：估计误差 <= eps * N 的概率至少 1 - delta
+    static count_min_sketch with_error(double eps, double delta, bool conservative = true) {
+        return count_min_sketch(static_cast<size_t>(std::ceil(std::exp(1.0) / eps)),
+                                static_cast<size_t>(std::ceil(std::log(1.0 / delta))),
+                                conservative);
+    }
+
+    void add(const Key& key, uint64_t n = 1) { add_and_estimate(key, n); }
+
+    // 计入 n 次并返回更新后的估计值
+    uint64_t add_and_estimate(const Key& key, uint64_t n = 1) {
+        mTotal += n;
+        size_t cols[kMaxDepth];
+        size_t d = columns(key, cols);
+        if (!mConservative) {
+            uint64_t est = UINT64_MAX;
+            for (size_t i = 0; i < d; ++i) {
+                est = std::min(est, mTable[i * mWidth + cols[i]] += n);
+            }
+            return est;
+        }
+        uint64_t est = UINT64_MAX;
+        for (size_t i = 0; i < d; ++i) {
+            est = std::min(est, mTable[i * mWidth + cols[i]]);
+        }
+        est += n;
+        for (size_t i = 0; i < d; ++i) {
+            uint64_t& c = mTable[i * mWidth + cols[i]];
+            c = std::max(c, est);
+        }
+        return est;
+    }
+
+    uint64_t estimate(const Key& key) const {
+        size_t cols[kMaxDepth];
+        size_t d = columns(key, cols);
+        uint64_t est = UINT64_MAX;
+        for (size_t i = 0; i < d; ++i) {
+            est = std::min(est, mTable[i * mWidth + cols[i]]);
+        }
+        return est;
+    }
+
+    // 尺寸和哈希必须相同；逐个计数器相加
+    void merge(const count_min_sketch& o) {
+        if (o.mWidth != mWidth || o.mDepth != mDepth) {
+            throw std::invalid_argument("count_min_sketch::merge: dimension mismatch");
+        }
+        for (size_t i = 0; i < mTable.size(); ++i) {
+            mTable[i] += o.mTable[i];
+        }
+        mTotal += o.mTotal;
+    }
+
+    // 单个估计值的误差上界（以 1 - e^-depth 的概率成立）
+    uint64_t error_bound() const {
+        return static_cast<uint64_t>(
+            std::ceil(std::exp(1.0) / static_cast<double>(mWidth) * static_cast<double>(mTotal)));
+    }
+
+    size_t width() const noexcept { return mWidth; }
+    size_t depth() const noexcept { return mDepth; }
+    uint64_t total() const noexcept { return mTotal; }
+    size_t memory_usage() const { return mTable.capacity() * sizeof(uint64_t); }
+
+private:
+    static constexpr size_t kMaxDepth = 16;
+
+    size_t columns(const Key& key, size_t* cols) const {
+        uint64_t h = static_cast<uint64_t>(mHash(key));
+        uint64_t h1 = h & 0xffffffffu, h2 = (h >> 32) | 1;  // h2 为奇数，各行的列号互不相同的概率更高
+        for (size_t i = 0; i < mDepth; ++i) {
+            cols[i] = static_cast<size_t>((h1 + i * h2) & (mWidth - 1));
+        }
+        return mDepth;
+    }
+
+    size_t mWidth;
+    size_t mDepth;
+    bool mConservative;
+    std::vector<uint64_t> mTable;  // 第 i 行在 [i * width, (i + 1) * width)
+    uint64_t mTotal = 0;
+    [[no_unique_address]] Hash mHash;
+};
+
+// ============================================================
+// cms_topk：count_min_sketch + 候选堆
+//   每次 add 后拿到 key 的最新估计值：已是候选则更新堆中的优先级；
+//   否则若比堆顶（第 k 大的候选）大，就顶替它
+// ============================================================
+template <typename Key, typename Hash = mixed_hash<Key>>
+class cms_topk {
+public:
+    using key_type = Key;
+
+    cms_topk(size_t k, size_t width, size_t depth = 4) : mK(k), mSketch(width, depth), mHeap(k) {
+        if (k == 0) {
+            throw std::invalid_argument("cms_topk: k must be positive");
+        }
+        mIndex.reserve(k);
+        mKeys.reserve(k);
+    }
+
+    void add(const Key& key, uint64_t n = 1) {
+        uint64_t est = mSketch.add_and_estimate(key, n);
+        if (auto it = mIndex.find(key); it != mIndex.end()) {
+            mHeap.update(it->second, est);
+            return;
+        }
+        if (mKeys.size() < mK) {
+            auto id = static_cast<uint32_t>(mKeys.size());
+            mKeys.push_back(key);
+            mIndex.try_emplace(key, id);
+            mHeap.push(id, est);
+        } else if (est > mHeap.top_priority()) {
+            uint32_t id = mHeap.top_id();
+            mIndex.erase(mKeys[id]);
+            mKeys[id] = key;
+            mIndex.try_emplace(key, id);
+            mHeap.update(id, est);
+        }
+    }
+
+    // 合并 sketch，再用合并后的估计值从双方候选中重选前 k 个
+    void merge(const cms_topk& o) {
+        mSketch.merge(o.mSketch);
+        std::vector<Key> candidates = mKeys;
+        for (const Key& key : o.mKeys) {
+            if (!mIndex.contains(key)) {
+                candidates.push_back(key);
+            }
+        }
+        auto kept = topk_select<Key>(candidates.begin(), candidates.end(), mK, [&](const Key& key) {
+            return topk_entry<Key>{key, mSketch.estimate(key), 0};
+        });
+        mIndex.clear();
+        mKeys.clear();
+        mHeap.clear();
+        for (auto& e : kept) {
+            auto id = static_cast<uint32_t>(mKeys.size());
+            mIndex.try_emplace(e.key, id);
+            mKeys.push_back(std::move(e.key));
+            mHeap.push(id, e.count);
+        }
+    }
+
+    uint64_t estimate(const Key& key) const { return mSketch.estimate(key); }
+
+    // error 为 sketch 的概率误差上界
+    std::vector<topk_entry<Key>> top(size_t k) const {
+        uint64_t err = mSketch.error_bound();
+        std::vector<topk_entry<Key>> all;
+        all.reserve(mKeys.size());
+        for (uint32_t id = 0; id < mKeys.size(); ++id) {
+            uint64_t c = mHeap.priority(id);
+            all.push_back({mKeys[id], c, std::min(c, err)});
+        }
+        return topk_select<Key>(all.begin(), all.end(), k, [](const auto& e) { return e; });
+    }
+
+    const count_min_sketch<Key, Hash>& sketch() const noexcept { return mSketch; }
+    uint64_t total() const noexcept { return mSketch.total(); }
+    size_t memory_usage() const {
+        return mSketch.memory_usage() + mIndex.memory_usage() + mKeys.capacity() * sizeof(Key) +
+               mHeap.memory_usage();
+    }
+
+private:
+    size_t mK;
+    count_min_sketch<Key, Hash> mSketch;
+    indexed_heap<uint64_t, std::greater<>> mHeap;  // 候选编号 -> 估计值，最小堆
+    flat_hash_map<Key, uint32_t, Hash> mIndex;
+    std::vector<Key> mKeys;
+};
@@ -0,0 +1,304 @@
+#pragma once
+
+// word_count.h: 大文本的并行词频统计
+//
+// level5 的 demo_word_count 用 std::map<std::string, int> 逐词计数：每个新词分配一个 string，
+// 每次查找在树的每一层比较一次字符串。文本有几个 GB 时，这几乎全是缓存缺失和 malloc。
+// 这里把流水线拆成四步，每一步都避免逐词分配：
+//
+//   mapped_file    ：只读内存映射整个文件（POSIX mmap / Windows MapViewOfFile），不拷贝、不逐行读
+//   for_each_word  ：按字节表切词（ASCII 字母数字和所有 >= 0x80 的字节算单词字符，UTF-8 词不会被拆开），
+//                    大写字母折叠成小写；不含大写的词直接以指向原文的 string_view 交给回调
+//   string_pool    ：把字符串拷进 Arena，返回的 string_view 与 pool 同寿命；intern() 相同内容只存一份
+//   word_counter   ：flat_hash_map<string_view, uint64_t> 计数，只有第一次见到的词才拷进自己的 pool，
+//                    所以结果不依赖原文的生命周期；可合并
+//
+// count_words_parallel(text, threads) 把文本按单词边界切成 threads 段，每个线程一个 word_counter，
+// 线程之间没有共享写入，最后依次合并到第一个。sorted() 按词频降序（同频按字典序）返回结果。
+
+#include "arena_allocator.h"
+#include "flat_hash_map.h"
+#include "hash_utils.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// ============================================================
+// mapped_file：只读内存映射
+//   映射建立后文件句柄即可关闭；空文件不映射，view() 为空
+// ============================================================
+class mapped_file {
+public:
+    mapped_file() = default;
+
+    explicit mapped_file(const std::string& path) {
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) throw lastError("open " + path);
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size)) {
+            auto e = lastError("stat " + path);
+            CloseHandle(file);
+            throw e;
+        }
+        if (size.QuadPart > 0) {
+            HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping) {
+                mData = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                CloseHandle(mapping);
+            }
+            if (!mData) {
+                auto e = lastError("map " + path);
+                CloseHandle(file);
+                throw e;
+            }
+            mSize = size_t(size.QuadPart);
+        }
+        CloseHandle(file);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw lastError("open " + path);
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            auto e = lastError("stat " + path);
+            ::close(fd);
+            throw e;
+        }
+        if (st.st_size > 0) {
+            void* p = ::mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                auto e = lastError("mmap " + path);
+                ::close(fd);
+                throw e;
+            }
+#ifdef MADV_SEQUENTIAL
+            ::madvise(p, size_t(st.st_size), MADV_SEQUENTIAL);  // 提示内核加大预读
+#endif
+            mData = static_cast<const char*>(p);
+            mSize = size_t(st.st_size);
+        }
+        ::close(fd);
+#endif
+    }
+
+    mapped_file(mapped_file&& o) noexcept
+        : mData(std::exchange(o.mData, nullptr)), mSize(std::exchange(o.mSize, 0)) {}
+    mapped_file& operator=(mapped_file o) noexcept {
+        std::swap(mData, o.mData);
+        std::swap(mSize, o.mSize);
+        return *this;
+    }
+    ~mapped_file() { unmap(); }
+
+    const char* data() const noexcept { return mData; }
+    size_t size() const noexcept { return mSize; }
+    bool empty() const noexcept { return mSize == 0; }
+    std::string_view view() const noexcept { return {mData, mSize}; }
+
+private:
+    void unmap() noexcept {
+        if (!mData) return;
+#ifdef _WIN32
+        UnmapViewOfFile(mData);
+#else
+        ::munmap(const_cast<char*>(mData), mSize);
+#endif
+    }
+
+    static std::system_error lastError(const std::string& what) {
+#ifdef _WIN32
+        return std::system_error(int(GetLastError()), std::system_category(), "mapped_file: " + what);
+#else
+        return std::system_error(errno, std::generic_category(), "mapped_file: " + what);
+#endif
+    }
+
+    const char* mData = nullptr;
+    size_t mSize = 0;
+};
+
+// ============================================================
+// for_each_word：切词 + 大小写折叠
+//   kWordFold[c] 为 0 表示分隔符，否则是折叠后的字节；整个切词循环只查这一张表
+// ============================================================
+inline constexpr std::array<unsigned char, 256> kWordFold = [] {
+    std::array<unsigned char, 256> t{};
+    for (int c = 0; c < 256; ++c) {
+        if (c >= 'A' && c <= 'Z') {
+            t[c] = static_cast<unsigned char>(c - 'A' + 'a');
+        } else if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c >= 0x80) {
+            t[c] = static_cast<unsigned char>(c);
+        }
+    }
+    return t;
+}();
+
+inline bool is_word_byte(char c) { return kWordFold[static_cast<unsigned char>(c)] != 0; }
+
+// f(std::string_view word)：word 只在回调期间有效（可能指向原文，也可能指向内部的折叠缓冲区）
+template <typename F>
+void for_each_word(std::string_view text, F&& f) {
+    auto p = reinterpret_cast<const unsigned char*>(text.data());
+    auto end = p + text.size();
+    std::string folded;
+    while (p < end) {
+        while (p < end && !kWordFold[*p]) ++p;
+        auto start = p;
+        bool upper = false;
+        while (p < end && kWordFold[*p]) {
+            upper |= kWordFold[*p] != *p;
+            ++p;
+        }
+        if (p == start) break;
+        std::string_view word(reinterpret_cast<const char*>(start), size_t(p - start));
+        if (!upper) {
+            f(word);
+            continue;
+        }
+        folded.assign(word);
+        for (char& c : folded) c = char(kWordFold[static_cast<unsigned char>(c)]);
+        f(std::string_view(folded));
+    }
+}
+
+// ============================================================
+// string_pool：Arena 上的字符串存储
+//   Arena 放在 unique_ptr 里，pool 移动时字符串地址不变，已返回的 string_view 继续有效
+// ============================================================
+class string_pool {
+public:
+    explicit string_pool(size_t initialChunk = 64 * 1024)
+        : mArena(std::make_unique<Arena>(initialChunk)) {}
+
+    // 拷贝一份，不查重
+    std::string_view store(std::string_view s) {
+        if (s.empty()) return {};
+        auto p = static_cast<char*>(mArena->allocate(s.size(), 1));
+        std::memcpy(p, s.data(), s.size());
+        return {p, s.size()};
+    }
+
+    // 相同内容只存一份：返回的 view 可以直接比较 data() 判断相等
+    std::string_view intern(std::string_view s) {
+        if (auto it = mInterned.find(s); it != mInterned.end()) return *it;
+        std::string_view stored = store(s);
+        mInterned.insert(stored);
+        return stored;
+    }
+
+    size_t interned() const noexcept { return mInterned.size(); }
+    size_t bytes_used() const noexcept { return mArena->bytes_used(); }
+    size_t memory_usage() const { return mArena->bytes_reserved() + mInterned.memory_usage(); }
+
+private:
+    std::unique_ptr<Arena> mArena;
+    flat_hash_set<std::string_view, mixed_hash<std::string_view>> mInterned;
+};
+
+// ============================================================
+// word_counter：单线程计数，可合并
+// ============================================================
+struct word_freq {
+    std::string_view word;  // 指向 word_counter 内部的 pool
+    uint64_t count;
+};
+
+class word_counter {
+public:
+    // word 须已折叠；第一次出现时拷进 pool
+    void add(std::string_view word, uint64_t n = 1) {
+        mTotal += n;
+        if (auto it = mCounts.find(word); it != mCounts.end()) {
+            it->second += n;
+            return;
+        }
+        mCounts.try_emplace(mPool.store(word), n);
+    }
+
+    void count_text(std::string_view text) {
+        for_each_word(text, [this](std::string_view w) { add(w); });
+    }
+
+    void merge(const word_counter& o) {
+        mCounts.reserve(mCounts.size() + o.mCounts.size());
+        for (const auto& [word, c] : o.mCounts) add(word, c);
+    }
+
+    uint64_t count(std::string_view word) const {
+        auto it = mCounts.find(word);
+        return it == mCounts.end() ? 0 : it->second;
+    }
+
+    // 按词频降序，同频按字典序
+    std::vector<word_freq> sorted() const {
+        std::vector<word_freq> result;
+        result.reserve(mCounts.size());
+        for (const auto& [word, c] : mCounts) result.push_back({word, c});
+        std::sort(result.begin(), result.end(), [](const word_freq& a, const word_freq& b) {
+            return a.count != b.count ? a.count > b.count : a.word < b.word;
+        });
+        return result;
+    }
+
+    uint64_t total() const noexcept { return mTotal; }
+    size_t distinct() const noexcept { return mCounts.size(); }
+    size_t memory_usage() const { return mCounts.memory_usage() + mPool.memory_usage(); }
+
+private:
+    string_pool mPool;
+    flat_hash_map<std::string_view, uint64_t, mixed_hash<std::string_view>> mCounts;
+    uint64_t mTotal = 0;
+};
+
+// 把 text 切成 threads 段，切点向后挪到分隔符上，保证单词不会被切开
+inline std::vector<std::string_view> split_at_words(std::string_view text, size_t parts) {
+    parts = std::max<size_t>(parts, 1);
+    std::vector<std::string_view> chunks;
+    size_t begin = 0;
+    for (size_t i = 1; i <= parts; i++) {
+        size_t end = i == parts ? text.size() : std::max(begin, text.size() / parts * i);
+        while (end < text.size() && is_word_byte(text[end])) end++;
+        chunks.push_back(text.substr(begin, end - begin));
+        begin = end;
+    }
+    return chunks;
+}
+
+inline word_counter count_words_parallel(std::string_view text, size_t threads) {
+    auto chunks = split_at_words(text, threads);
+    std::vector<word_counter> parts(chunks.size());
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < chunks.size(); i++)
+        workers.emplace_back([&, i] { parts[i].count_text(chunks[i]); });
+    parts[0].count_text(chunks[0]);  // 当前线程也干活
+    for (auto& w : workers) w.join();
+    for (size_t i = 1; i < parts.size(); i++) parts[0].merge(parts[i]);
+    return std::move(parts[0]);
+}
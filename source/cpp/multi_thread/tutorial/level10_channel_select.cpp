@@ -0,0 +1,423 @@
+/*
+ * ============================================================
+ * Level 10 — Channel 与 select：同时等待多个队列
+ * ============================================================
+ *
+ * 目标：在 Level 6 的 BoundedQueue 基础上实现类型化的 Channel<T>，
+ *       并实现 select —— 阻塞到多个 channel 中任意一个可读为止
+ *
+ * 问题：
+ *   Level 6 demo_v4 的消费者只能阻塞在"一个"队列的 cv 上。
+ *   想同时等多个队列，只能轮询：
+ *       for (auto& q : queues) q.popFor(1ms);
+ *   → 数据到达时可能正在等别的队列，延迟最高 = 超时 × 队列数
+ *   → 没有数据时也在不停醒来，白白消耗 CPU
+ *
+ * 思路：
+ *   select 把同一个 SelectWaiter（一把锁 + 一个 cv + 一个标志）
+ *   登记到所有 channel 上；任何一个 channel send/close 时
+ *   顺便通知登记在它上面的 waiter。消费者只在一个 cv 上睡眠。
+ *
+ * 防止丢失唤醒的顺序（与 Level 5 的"先检查条件再 wait"同理）：
+ *   1. 登记 waiter  2. 再检查一遍所有 channel  3. 都为空才 wait
+ *   步骤 1 之后到来的 send 一定会设置 waiter 的标志，wait 不会错过。
+ */
+
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <deque>
+#include <vector>
+#include <optional>
+#include <utility>
+#include <algorithm>
+#include <random>
+#include <iostream>
+#include <iomanip>
+#include <cassert>
+#include <chrono>
+#include <string>
+#include <memory>
+
+using namespace std::chrono_literals;
+
+// ============================================================
+// 10.1：Channel<T> —— 有界/无界、可关闭
+// ============================================================
+
+// select 用来睡眠的对象：被多个 channel 共享
+class SelectWaiter {
+public:
+    void notify() {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mSignaled = true;
+        }
+        mCV.notify_one();
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mCV.wait(lock, [this] { return mSignaled; });
+        mSignaled = false;
+    }
+
+private:
+    std::mutex mMutex;
+    std::condition_variable mCV;
+    bool mSignaled = false;
+};
+
+enum class ChannelStatus { Ok, Empty, Closed };
+
+template <typename T>
+class Channel {
+public:
+    // capacity == 0 表示无界
+    explicit Channel(size_t capacity = 0) : mCapacity(capacity) {}
+
+    Channel(const Channel&) = delete;
+    Channel& operator=(const Channel&) = delete;
+
+    // 有界且已满时阻塞；返回 false 表示 channel 已关闭
+    bool send(T val) {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mNotFull.wait(lock, [this] { return !full() || mClosed; });
+        if (mClosed) return false;
+        mItems.push_back(std::move(val));
+        notifyReceivers(lock);
+        return true;
+    }
+
+    bool trySend(T val) {
+        std::unique_lock<std::mutex> lock(mMutex);
+        if (mClosed || full()) return false;
+        mItems.push_back(std::move(val));
+        notifyReceivers(lock);
+        return true;
+    }
+
+    // 阻塞直到有数据；返回 nullopt 表示已关闭且为空
+    std::optional<T> recv() {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mNotEmpty.wait(lock, [this] { return !mItems.empty() || mClosed; });
+        return popLocked(lock);
+    }
+
+    // 非阻塞接收：Empty 表示暂时没有数据，Closed 表示已关闭且为空
+    ChannelStatus tryRecv(T& out) {
+        return recvFor(out, std::chrono::microseconds(0));
+    }
+
+    // 带超时的接收（轮询方案用它）；超时返回 Empty
+    ChannelStatus recvFor(T& out, std::chrono::microseconds timeout) {
+        std::unique_lock<std::mutex> lock(mMutex);
+        if (timeout.count() > 0) {
+            mNotEmpty.wait_for(lock, timeout, [this] { return !mItems.empty() || mClosed; });
+        }
+        if (mItems.empty()) return mClosed ? ChannelStatus::Closed : ChannelStatus::Empty;
+        out = std::move(*popLocked(lock));
+        return ChannelStatus::Ok;
+    }
+
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mClosed = true;
+            for (auto* w : mSelectWaiters) w->notify();
+        }
+        mNotFull.notify_all();
+        mNotEmpty.notify_all();
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mItems.size();
+    }
+
+    // ---- select 使用的登记接口 ----
+    void addWaiter(SelectWaiter* w) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mSelectWaiters.push_back(w);
+    }
+
+    void removeWaiter(SelectWaiter* w) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = std::find(mSelectWaiters.begin(), mSelectWaiters.end(), w);
+        if (it != mSelectWaiters.end()) {
+            *it = mSelectWaiters.back();
+            mSelectWaiters.pop_back();
+        }
+    }
+
+private:
+    bool full() const { return mCapacity != 0 && mItems.size() >= mCapacity; }
+
+    // 调用时持有 lock，返回时已解锁
+    void notifyReceivers(std::unique_lock<std::mutex>& lock) {
+        // 持 channel 锁通知 waiter：select 返回前要 removeWaiter（同样需要这把锁），
+        // 所以这里访问的 waiter 一定还活着
+        for (auto* w : mSelectWaiters) w->notify();
+        lock.unlock();
+        mNotEmpty.notify_one();
+    }
+
+    std::optional<T> popLocked(std::unique_lock<std::mutex>& lock) {
+        if (mItems.empty()) return std::nullopt;
+        T val = std::move(mItems.front());
+        mItems.pop_front();
+        lock.unlock();
+        mNotFull.notify_one();
+        return val;
+    }
+
+    const size_t mCapacity;
+    std::deque<T> mItems;
+    mutable std::mutex mMutex;
+    std::condition_variable mNotEmpty;
+    std::condition_variable mNotFull;
+    std::vector<SelectWaiter*> mSelectWaiters;
+    bool mClosed = false;
+};
+
+// ============================================================
+// 10.2：select —— 阻塞到任意一个 channel 可读
+// ============================================================
+// 返回 {channel 下标, 值}；所有 channel 都关闭且为空时返回 nullopt。
+// start 参数让调用者轮换起始位置，避免总是优先第 0 个 channel（饥饿）。
+
+template <typename T>
+std::optional<std::pair<size_t, T>> select(const std::vector<Channel<T>*>& channels,
+                                           size_t start = 0) {
+    const size_t n = channels.size();
+    T val{};
+
+    // 扫描一轮：有数据立即返回；返回 false 表示所有 channel 都已关闭
+    auto scan = [&](std::optional<std::pair<size_t, T>>& out) {
+        bool anyOpen = false;
+        for (size_t k = 0; k < n; ++k) {
+            size_t i = (start + k) % n;
+            ChannelStatus s = channels[i]->tryRecv(val);
+            if (s == ChannelStatus::Ok) {
+                out.emplace(i, std::move(val));
+                return true;
+            }
+            if (s == ChannelStatus::Empty) anyOpen = true;
+        }
+        return anyOpen;
+    };
+
+    std::optional<std::pair<size_t, T>> result;
+    // 快速路径：已有数据时不需要登记
+    if (!scan(result) || result) return result;
+
+    SelectWaiter waiter;
+    for (auto* ch : channels) ch->addWaiter(&waiter);
+    while (true) {
+        if (!scan(result) || result) break;  // 登记之后再检查，防止丢失唤醒
+        waiter.wait();
+    }
+    for (auto* ch : channels) ch->removeWaiter(&waiter);
+    return result;
+}
+
+void demo_channel() {
+    std::cout << "=== 10.1 Channel：有界 + 关闭 ===\n";
+    Channel<std::string> ch(2);
+
+    std::thread producer([&ch] {
+        for (int i = 0; i < 5; ++i) {
+            ch.send("msg-" + std::to_string(i));  // 容量 2，满了会阻塞
+        }
+        ch.close();
+    });
+
+    int received = 0;
+    while (auto msg = ch.recv()) {
+        std::cout << "  recv " << *msg << "\n";
+        received++;
+    }
+    producer.join();
+
+    assert(received == 5);
+    [[maybe_unused]] bool lateOk = ch.send("late");  // 关闭后 send 失败
+    assert(!lateOk);
+    std::cout << "  关闭后 send 返回 false ✓\n\n";
+}
+
+void demo_select() {
+    std::cout << "=== 10.2 select：同时等待 3 个 channel ===\n";
+    Channel<int> a, b, c;
+    std::vector<Channel<int>*> chans = {&a, &b, &c};
+
+    std::thread producer([&] {
+        std::this_thread::sleep_for(5ms);
+        b.send(20);
+        std::this_thread::sleep_for(5ms);
+        c.send(30);
+        a.send(10);
+        a.close();
+        b.close();
+        c.close();
+    });
+
+    int sum = 0;
+    size_t start = 0;
+    while (auto r = select(chans, start++)) {
+        std::cout << "  channel " << r->first << " -> " << r->second << "\n";
+        sum += r->second;
+    }
+    producer.join();
+
+    assert(sum == 60);
+    std::cout << "  全部关闭后 select 返回 nullopt ✓\n\n";
+}
+
+// ============================================================
+// 10.3：Benchmark —— 8 个 channel 的扇入延迟
+// ============================================================
+// 8 个生产者各自往自己的 channel 里发送"发送时刻"，间隔随机；
+// 一个消费者收集，统计 接收时刻 - 发送时刻。
+//   轮询方案：依次对每个 channel 调用 recvFor(POLL_TIMEOUT)
+//   select 方案：一次 select 等待全部 channel
+
+using Clock = std::chrono::steady_clock;
+
+struct LatencyStats {
+    std::vector<double> latUs;
+    long long wakeups = 0;  // 消费者醒来的次数（轮询方案空转也算）
+};
+
+template <typename Consume>
+LatencyStats runFanIn(int numChannels, int msgsPerChannel, Consume consume) {
+    std::vector<std::unique_ptr<Channel<Clock::time_point>>> owned;
+    std::vector<Channel<Clock::time_point>*> chans;
+    for (int i = 0; i < numChannels; ++i) {
+        owned.push_back(std::make_unique<Channel<Clock::time_point>>());
+        chans.push_back(owned.back().get());
+    }
+
+    std::vector<std::thread> producers;
+    for (int i = 0; i < numChannels; ++i) {
+        producers.emplace_back([ch = chans[i], msgsPerChannel, i] {
+            std::mt19937 rng(i);
+            std::uniform_int_distribution<int> gap(200, 2000);
+            for (int j = 0; j < msgsPerChannel; ++j) {
+                std::this_thread::sleep_for(std::chrono::microseconds(gap(rng)));
+                ch->send(Clock::now());
+            }
+            ch->close();
+        });
+    }
+
+    LatencyStats stats;
+    stats.latUs.reserve(static_cast<size_t>(numChannels) * msgsPerChannel);
+    consume(chans, stats);
+    for (auto& t : producers) t.join();
+
+    std::sort(stats.latUs.begin(), stats.latUs.end());
+    return stats;
+}
+
+void printStats(const char* name, const LatencyStats& s) {
+    if (s.latUs.empty()) {
+        std::cout << "  " << std::left << std::setw(14) << name << std::right << " 没有样本\n";
+        return;
+    }
+    auto pct = [&s](double p) {
+        return s.latUs[static_cast<size_t>(p * (s.latUs.size() - 1))];
+    };
+    double avg = 0;
+    for (double v : s.latUs) avg += v;
+    avg /= s.latUs.size();
+    std::cout << "  " << std::left << std::setw(14) << name << std::right << std::fixed
+              << std::setprecision(1)
+              << " avg=" << std::setw(7) << avg << "us"
+              << " p50=" << std::setw(7) << pct(0.50) << "us"
+              << " p99=" << std::setw(7) << pct(0.99) << "us"
+              << " wakeups=" << s.wakeups << "\n";
+}
+
+void bench_fan_in(int msgsPerChannel) {
+    const int CHANNELS = 8;
+    const auto POLL_TIMEOUT = 500us;
+    std::cout << "=== 10.3 Benchmark：" << CHANNELS << " 个 channel 扇入，每个 "
+              << msgsPerChannel << " 条消息 ===\n";
+
+    auto polling = runFanIn(CHANNELS, msgsPerChannel, [&](auto& chans, LatencyStats& st) {
+        std::vector<bool> open(chans.size(), true);
+        size_t remaining = chans.size();
+        Clock::time_point sent;
+        while (remaining > 0) {
+            for (size_t i = 0; i < chans.size(); ++i) {
+                if (!open[i]) continue;
+                st.wakeups++;
+                ChannelStatus s = chans[i]->recvFor(sent, POLL_TIMEOUT);
+                if (s == ChannelStatus::Ok) {
+                    st.latUs.push_back(
+                        std::chrono::duration<double, std::micro>(Clock::now() - sent).count());
+                } else if (s == ChannelStatus::Closed) {
+                    open[i] = false;
+                    remaining--;
+                }
+            }
+        }
+    });
+
+    auto selecting = runFanIn(CHANNELS, msgsPerChannel, [&](auto& chans, LatencyStats& st) {
+        size_t start = 0;
+        while (auto r = select(chans, start++)) {
+            st.wakeups++;
+            st.latUs.push_back(
+                std::chrono::duration<double, std::micro>(Clock::now() - r->second).count());
+        }
+    });
+
+    assert(polling.latUs.size() == selecting.latUs.size());
+    std::cout << "  轮询超时=" << POLL_TIMEOUT.count() << "us\n";
+    printStats("round-robin", polling);
+    printStats("select", selecting);
+    std::cout << "  (轮询的延迟取决于数据到达时正在等哪个 channel；"
+                 "select 醒来次数 ≈ 消息数)\n\n";
+}
+
+// ==================== 设计要点速记 ====================
+/*
+ * 1. 为什么 waiter 的标志要在 wait 之后清零？
+ *    → 多个 channel 可能同时 notify，清零后重新扫描一轮即可全部处理，
+ *      多余的唤醒只会导致一次空扫描，不会丢数据。
+ *
+ * 2. 为什么 notify waiter 时要持有 channel 的锁？
+ *    → waiter 是 select 栈上的局部变量，select 返回前 removeWaiter 需要 channel 锁，
+ *      持锁通知保证 waiter 析构后不会再被访问。
+ *    → 加锁顺序固定为 channel → waiter；select 持有 waiter 锁时从不获取
+ *      channel 锁，所以不会形成环。
+ *
+ * 3. 公平性
+ *    → select 每次从 start 开始扫描，调用者轮换 start，
+ *      否则高频的 channel 0 会让其他 channel 饿死。
+ *
+ * 练习：
+ * [练习 1] 为 select 增加发送分支：等待"任意一个 channel 可写"。
+ *
+ * [练习 2] 实现 selectFor(channels, timeout)：超时返回 nullopt。
+ *   提示：SelectWaiter::wait 改为 wait_for，并区分"超时"和"全部关闭"。
+ *
+ * [练习 3] 用 std::variant 支持不同元素类型的 channel 一起 select。
+ */
+
+int main(int argc, char** argv) {
+    int msgsPerChannel = argc > 1 ? std::stoi(argv[1]) : 500;
+
+    demo_channel();
+    demo_select();
+    bench_fan_in(msgsPerChannel);
+
+    std::cout << "Level 10 Complete!\n";
+    return 0;
+}
+
+/*
+ * 编译运行：
+ *   g++ -std=c++20 -pthread -O2 level10_channel_select.cpp -o level10 && ./level10 [msgsPerChannel]
+ */
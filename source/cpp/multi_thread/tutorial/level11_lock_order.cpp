@@ -0,0 +1,481 @@
+/*
+ * ============================================================
+ * Level 11 — 加锁顺序检测：在死锁发生之前发现它
+ * ============================================================
+ *
+ * 目标：实现一个调试用的 mutex 包装，记录全局"加锁顺序图"，
+ *       第一次观察到相反的加锁顺序时立即报告，而不用等线上真的卡死
+ *
+ * 回顾 Level 3 的 threadA_buggy / threadB_buggy：
+ *   线程 A: lock(m1) → lock(m2)
+ *   线程 B: lock(m2) → lock(m1)
+ *   只有两个线程"恰好交错"时才会死锁，测试里很难复现。
+ *
+ * 思路（与 Linux lockdep 相同）：
+ *   每个线程维护"当前持有的锁"栈。获取锁 M 时，
+ *   对每个已持有的锁 H 记录一条有向边 H → M（H 必须先于 M）。
+ *   若新边 H → M 加入前，图里已经能从 M 走到 H，就形成了环：
+ *   存在某种交错会导致死锁 —— 即使这一次两个线程并没有真的交错。
+ *
+ * 开关：
+ *   LOCK_ORDER_CHECK=1 时 CheckedMutex 是带检测的 LockOrderMutex；
+ *   否则 CheckedMutex 就是一层没有任何额外字段的 std::mutex 包装。
+ *   默认跟随 NDEBUG：Debug 构建开启，Release 构建关闭。
+ */
+
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <functional>
+#include <source_location>
+#include <sstream>
+#include <string>
+#include <atomic>
+#include <iostream>
+#include <iomanip>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+#ifndef LOCK_ORDER_CHECK
+#ifdef NDEBUG
+#define LOCK_ORDER_CHECK 0
+#else
+#define LOCK_ORDER_CHECK 1
+#endif
+#endif
+
+// ============================================================
+// 11.1：全局加锁顺序图
+// ============================================================
+
+class LockOrderGraph {
+public:
+    using Handler = std::function<void(const std::string&)>;
+
+    static LockOrderGraph& instance() {
+        static LockOrderGraph graph;
+        return graph;
+    }
+
+    // 默认打印到 stderr；测试或线上可以替换为写日志 / abort
+    void setHandler(Handler h) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mHandler = std::move(h);
+    }
+
+    uint64_t registerLock(const char* name) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        uint64_t id = mNextId++;
+        mNames.try_emplace(id, name ? name : "<unnamed>");
+        return id;
+    }
+
+    void unregisterLock(uint64_t id) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mNames.erase(id);
+        mEdges.erase(id);
+        for (auto& [from, outs] : mEdges) outs.erase(id);
+    }
+
+    // 记录边 from → to；若形成环则报告。
+    // fromSite：from 被获取的位置；toSite：to 被获取的位置
+    void addEdge(uint64_t from, const std::source_location& fromSite,
+                 uint64_t to, const std::source_location& toSite) {
+        std::string report;
+        Handler handler;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            auto& outs = mEdges[from];
+            if (outs.count(to)) return;  // 其他线程已经记录过
+
+            std::vector<uint64_t> path;
+            if (findPath(to, from, path)) {
+                report = describeCycle(from, fromSite, to, toSite, path);
+                handler = mHandler;
+            }
+            outs.emplace(to, Edge{fromSite, toSite});
+        }
+        if (!report.empty()) {
+            if (handler) handler(report);
+            else std::cerr << report;
+        }
+    }
+
+    std::string nameOf(uint64_t id) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return nameLocked(id);
+    }
+
+private:
+    // 调用方持有 mMutex；只查不插，报告环时不会给已注销的锁留下空名字
+    std::string nameLocked(uint64_t id) const {
+        auto it = mNames.find(id);
+        return it == mNames.end() ? "<destroyed>" : it->second;
+    }
+    struct Edge {
+        std::source_location fromSite;  // 持有 from 时，from 的获取位置
+        std::source_location toSite;    // 持有 from 时，获取 to 的位置
+    };
+
+    LockOrderGraph() = default;
+
+    // DFS：是否存在 src → ... → dst；path 不含 src，按顺序存放途经的节点
+    bool findPath(uint64_t src, uint64_t dst, std::vector<uint64_t>& path) {
+        std::unordered_set<uint64_t> visited;
+        std::function<bool(uint64_t)> dfs = [&](uint64_t u) {
+            if (u == dst) return true;
+            if (!visited.insert(u).second) return false;
+            auto it = mEdges.find(u);
+            if (it == mEdges.end()) return false;
+            for (auto& [v, edge] : it->second) {
+                path.push_back(v);
+                if (dfs(v)) return true;
+                path.pop_back();
+            }
+            return false;
+        };
+        return dfs(src);
+    }
+
+    static std::string site(const std::source_location& loc) {
+        std::ostringstream os;
+        os << loc.file_name() << ":" << loc.line() << " (" << loc.function_name() << ")";
+        return os.str();
+    }
+
+    std::string describeCycle(uint64_t from, const std::source_location& fromSite,
+                              uint64_t to, const std::source_location& toSite,
+                              const std::vector<uint64_t>& path) {
+        std::ostringstream os;
+        os << "[LockOrder] potential deadlock: lock order inversion detected\n";
+        os << "  now:     '" << nameLocked(to) << "' acquired at " << site(toSite) << "\n";
+        os << "           while holding '" << nameLocked(from) << "' acquired at "
+           << site(fromSite) << "\n";
+        os << "  earlier: ";
+        uint64_t u = to;
+        for (uint64_t v : path) {
+            const Edge& e = mEdges.at(u).at(v);
+            os << "'" << nameLocked(v) << "' acquired at " << site(e.toSite) << "\n"
+               << "           while holding '" << nameLocked(u) << "' acquired at "
+               << site(e.fromSite) << "\n";
+            if (v != path.back()) os << "  then:    ";
+            u = v;
+        }
+        return os.str();
+    }
+
+    std::mutex mMutex;
+    uint64_t mNextId = 1;
+    std::unordered_map<uint64_t, std::string> mNames;
+    std::unordered_map<uint64_t, std::unordered_map<uint64_t, Edge>> mEdges;
+    Handler mHandler;
+};
+
+// ============================================================
+// 11.2：LockOrderMutex —— 带检测的 mutex
+// ============================================================
+// 满足 Lockable，可以直接配合 lock_guard / unique_lock / scoped_lock。
+// 注意：经由 std::lock_guard 加锁时，source_location 记录的是标准库内部的位置；
+//       想在报告里看到业务代码的位置，直接调用 m.lock() 或使用 CheckedLockGuard。
+
+class LockOrderMutex {
+public:
+    explicit LockOrderMutex(const char* name = nullptr)
+        : mId(LockOrderGraph::instance().registerLock(name)) {}
+
+    LockOrderMutex(const LockOrderMutex&) = delete;
+    LockOrderMutex& operator=(const LockOrderMutex&) = delete;
+
+    ~LockOrderMutex() {
+        LockOrderGraph::instance().unregisterLock(mId);
+    }
+
+    void lock(std::source_location loc = std::source_location::current()) {
+        // 必须在真正阻塞之前检查：真的死锁时就没有机会报告了
+        checkBeforeLock(loc);
+        mMutex.lock();
+        heldLocks().push_back({mId, loc});
+    }
+
+    // try_lock 不会阻塞，因此不会造成死锁，不记录顺序边（与 lockdep 一致）
+    bool try_lock(std::source_location loc = std::source_location::current()) {
+        if (!mMutex.try_lock()) return false;
+        heldLocks().push_back({mId, loc});
+        return true;
+    }
+
+    void unlock() {
+        auto& held = heldLocks();
+        for (auto it = held.rbegin(); it != held.rend(); ++it) {
+            if (it->id == mId) {
+                held.erase(std::next(it).base());
+                break;
+            }
+        }
+        mMutex.unlock();
+    }
+
+private:
+    struct Held {
+        uint64_t id;
+        std::source_location site;
+    };
+
+    struct EdgeKey {
+        uint64_t from, to;
+        bool operator==(const EdgeKey& o) const { return from == o.from && to == o.to; }
+    };
+    struct EdgeKeyHash {
+        size_t operator()(const EdgeKey& k) const {
+            return std::hash<uint64_t>{}(k.from * 0x9E3779B97F4A7C15ull ^ k.to);
+        }
+    };
+
+    static std::vector<Held>& heldLocks() {
+        thread_local std::vector<Held> held;
+        return held;
+    }
+
+    // 本线程已经提交到全局图的边：热路径上只查这个缓存，不碰全局锁
+    static std::unordered_set<EdgeKey, EdgeKeyHash>& knownEdges() {
+        thread_local std::unordered_set<EdgeKey, EdgeKeyHash> known;
+        return known;
+    }
+
+    void checkBeforeLock(const std::source_location& loc) {
+        auto& held = heldLocks();
+        if (held.empty()) return;
+
+        auto& graph = LockOrderGraph::instance();
+        auto& known = knownEdges();
+        for (const Held& h : held) {
+            if (h.id == mId) {
+                std::ostringstream os;
+                os << "[LockOrder] self-deadlock: '" << graph.nameOf(mId)
+                   << "' locked again by the same thread at " << loc.file_name() << ":"
+                   << loc.line() << ", first locked at " << h.site.file_name() << ":"
+                   << h.site.line() << "\n";
+                std::cerr << os.str();
+                continue;
+            }
+            if (known.insert({h.id, mId}).second) {
+                graph.addEdge(h.id, h.site, mId, loc);
+            }
+        }
+    }
+
+    std::mutex mMutex;
+    const uint64_t mId;
+};
+
+// 与 std::lock_guard 相同，但把构造处的位置传给 lock()
+template <typename Mutex>
+class CheckedLockGuard {
+public:
+    explicit CheckedLockGuard(Mutex& m,
+                              std::source_location loc = std::source_location::current())
+        : mMutex(m) {
+        if constexpr (std::is_same_v<Mutex, LockOrderMutex>) {
+            mMutex.lock(loc);
+        } else {
+            (void)loc;
+            mMutex.lock();
+        }
+    }
+    ~CheckedLockGuard() { mMutex.unlock(); }
+
+    CheckedLockGuard(const CheckedLockGuard&) = delete;
+    CheckedLockGuard& operator=(const CheckedLockGuard&) = delete;
+
+private:
+    Mutex& mMutex;
+};
+
+// Release 构建：只是给 std::mutex 多一个名字参数的构造函数，没有任何额外成员
+class PlainMutex : public std::mutex {
+public:
+    explicit PlainMutex(const char* = nullptr) {}
+};
+
+#if LOCK_ORDER_CHECK
+using CheckedMutex = LockOrderMutex;
+#else
+using CheckedMutex = PlainMutex;
+#endif
+
+// ============================================================
+// 11.3：演示 —— Level 3 的 threadA_buggy / threadB_buggy
+// ============================================================
+// 两个线程"先后"运行，不会真的死锁，但检测器依然能发现顺序相反。
+
+void demo_detect_inversion() {
+    std::cout << "=== 11.3 检测 Level 3 的死锁模式 ===\n";
+    LockOrderMutex m1("gM1"), m2("gM2");
+
+    std::vector<std::string> reports;
+    LockOrderGraph::instance().setHandler([&reports](const std::string& r) {
+        reports.push_back(r);
+    });
+
+    std::thread a([&] {
+        m1.lock();
+        m2.lock();  // 记录 gM1 → gM2
+        m2.unlock();
+        m1.unlock();
+    });
+    a.join();  // 等 A 完全结束：本次运行不可能真的死锁
+
+    std::thread b([&] {
+        m2.lock();
+        m1.lock();  // gM2 → gM1 与已有的 gM1 → gM2 成环 → 报告
+        m1.unlock();
+        m2.unlock();
+    });
+    b.join();
+
+    // 同一顺序再来一次：边已经记录过，不会重复报告
+    std::thread c([&] {
+        CheckedLockGuard g2(m2);
+        CheckedLockGuard g1(m1);
+    });
+    c.join();
+
+    LockOrderGraph::instance().setHandler(nullptr);
+    assert(reports.size() == 1);
+    if (reports.size() != 1) {
+        std::cout << "  预期报告 1 次，实际 " << reports.size() << " 次 ✗\n\n";
+        return;
+    }
+    std::cout << reports[0];
+    std::cout << "  只报告一次 ✓\n\n";
+}
+
+void demo_three_lock_cycle() {
+    std::cout << "=== 11.4 三把锁的环：A→B, B→C, C→A ===\n";
+    LockOrderMutex a("A"), b("B"), c("C");
+
+    int reports = 0;
+    LockOrderGraph::instance().setHandler([&reports](const std::string& r) {
+        reports++;
+        std::cout << r;
+    });
+
+    auto lockPair = [](LockOrderMutex& first, LockOrderMutex& second) {
+        std::thread t([&] {
+            CheckedLockGuard g1(first);
+            CheckedLockGuard g2(second);
+        });
+        t.join();
+    };
+    lockPair(a, b);
+    lockPair(b, c);
+    assert(reports == 0);  // 目前还没有环
+    lockPair(c, a);        // 闭合成环
+
+    LockOrderGraph::instance().setHandler(nullptr);
+    assert(reports == 1);
+    std::cout << "  环路径中的每一条边都附带了两处加锁位置 ✓\n\n";
+}
+
+// ============================================================
+// 11.5：开销测量
+// ============================================================
+// 场景：
+//   单锁：lock/unlock 一把锁（持锁栈为空，不查图）
+//   嵌套：先锁 outer 再锁 inner（每次都要查本线程的边缓存）
+//   竞争：4 个线程做嵌套加锁
+
+template <typename Mutex>
+double nsPerOp(int threads, int iters, bool nested) {
+    Mutex outer("outer"), inner("inner");
+    long long counter = 0;
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> ts;
+    for (int t = 0; t < threads; ++t) {
+        ts.emplace_back([&] {
+            for (int i = 0; i < iters; ++i) {
+                if (nested) {
+                    outer.lock();
+                    inner.lock();
+                    counter++;
+                    inner.unlock();
+                    outer.unlock();
+                } else {
+                    inner.lock();
+                    counter++;
+                    inner.unlock();
+                }
+            }
+        });
+    }
+    for (auto& t : ts) t.join();
+    auto elapsed = std::chrono::steady_clock::now() - t0;
+
+    assert(counter == static_cast<long long>(threads) * iters);
+    return std::chrono::duration<double, std::nano>(elapsed).count() /
+           (static_cast<double>(threads) * iters);
+}
+
+void bench_overhead(int iters) {
+    std::cout << "=== 11.5 开销：PlainMutex vs LockOrderMutex（ns/次）===\n";
+    struct Case { const char* name; int threads; bool nested; };
+    const Case cases[] = {
+        {"单锁, 1 线程", 1, false},
+        {"嵌套, 1 线程", 1, true},
+        {"嵌套, 4 线程", 4, true},
+    };
+    for (const Case& c : cases) {
+        double plain   = nsPerOp<PlainMutex>(c.threads, iters, c.nested);
+        double checked = nsPerOp<LockOrderMutex>(c.threads, iters, c.nested);
+        std::cout << "  " << std::left << std::setw(16) << c.name << std::right << std::fixed
+                  << std::setprecision(1) << " plain=" << std::setw(7) << plain
+                  << "  checked=" << std::setw(7) << checked
+                  << "  (x" << std::setprecision(2) << checked / plain << ")\n";
+    }
+    std::cout << "  当前构建 CheckedMutex = "
+              << (LOCK_ORDER_CHECK ? "LockOrderMutex" : "PlainMutex") << "\n\n";
+}
+
+// ==================== 设计要点速记 ====================
+/*
+ * 1. 为什么在 mMutex.lock() 之前检查？
+ *    → 若顺序已经相反且两个线程恰好交错，lock() 会永远阻塞，之后的检查永远不会执行。
+ *
+ * 2. 为什么 try_lock 不加边？
+ *    → 拿不到就返回，不会因为它形成"互相等待"。scoped_lock 内部的避让算法
+ *      正是依赖 try_lock，加边会产生误报。
+ *
+ * 3. 热路径开销
+ *    → 不持有其他锁时只多一次 thread_local vector push/pop；
+ *      持有锁时查本线程的边缓存，只有"第一次见到的边"才获取全局锁做 DFS。
+ *
+ * 练习：
+ * [练习 1] 把 handler 改为"报告后 std::abort()"，在 CI 的 Debug 测试中强制失败。
+ *
+ * [练习 2] 支持"锁类"：同一类的多把锁（如每个账户一把锁）共享一个图节点。
+ *
+ * [练习 3] 为 LockOrderMutex 增加 shared_mutex 版本：读锁之间不形成依赖。
+ */
+
+int main(int argc, char** argv) {
+    int iters = argc > 1 ? std::stoi(argv[1]) : 1000000;
+
+    demo_detect_inversion();
+    demo_three_lock_cycle();
+    bench_overhead(iters);
+
+    std::cout << "Level 11 Complete!\n";
+    return 0;
+}
+
+/*
+ * 编译运行：
+ *   g++ -std=c++20 -pthread -O2 level11_lock_order.cpp -o level11 && ./level11 [iters]
+ *   （-DNDEBUG 时 CheckedMutex 退化为 PlainMutex；-DLOCK_ORDER_CHECK=1 可强制开启）
+ */
@@ -0,0 +1,427 @@
+/*
+ * ============================================================
+ * Level 12 — 锁竞争分析：找出最"热"的那把锁
+ * ============================================================
+ *
+ * 目标：实现一个可以常驻预发环境的 ProfiledMutex，按锁的名字统计
+ *       等待时间、持有时间、竞争次数，并输出最热的锁与等待时间直方图
+ *
+ * 回顾 Level 3 的 demo_granularity：
+ *   只能看到"细粒度 vs 粗粒度"的总耗时，看不出时间花在哪把锁、
+ *   是花在"等锁"还是"持锁"上。线上有几十把锁时更无从下手。
+ *
+ * 低开销的关键：
+ *   1. 无竞争时 try_lock 成功，不计等待时间，不读时钟
+ *   2. 持有时间按 1/kHoldSampleEvery 采样测量，用"样本平均 × 获取次数"估计总量
+ *   3. 统计写入每线程自己的缓冲区（thread_local），热路径没有共享写、没有原子 RMW
+ *   4. 只有生成报告时才遍历所有线程的缓冲区做汇总
+ *
+ * 统计项：
+ *   acquisitions  获取次数
+ *   contended     try_lock 失败、需要阻塞等待的次数
+ *   wait          阻塞等待的总时间 + log2 直方图
+ *   hold          从拿到锁到 unlock 的总时间（采样估计）
+ */
+
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <array>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+
+// ============================================================
+// 12.1：每线程统计缓冲区
+// ============================================================
+
+constexpr size_t kMaxProfiledLocks = 128;  // 不同名字的个数上限，超出的都记在最后一个槽位
+constexpr size_t kWaitBuckets = 24;         // 第 i 桶：等待时间 ∈ [2^i, 2^(i+1)) ns，末桶兜底
+constexpr uint64_t kHoldSampleEvery = 16;   // 每个线程对每把锁的第 0、16、32... 次加锁测持有时间
+
+// 每个字段只有所属线程写入，报告线程只读：
+// 用 relaxed 的 load/store 而不是 fetch_add，热路径上没有 lock 前缀指令
+struct LockCounters {
+    std::atomic<uint64_t> acquisitions{0};
+    std::atomic<uint64_t> contended{0};
+    std::atomic<uint64_t> waitNs{0};
+    std::atomic<uint64_t> holdNs{0};       // 仅采样到的那些次的持有时间之和
+    std::atomic<uint64_t> holdSamples{0};
+    std::atomic<uint64_t> maxWaitNs{0};
+    std::array<std::atomic<uint64_t>, kWaitBuckets> waitHist{};
+};
+
+inline void bump(std::atomic<uint64_t>& c, uint64_t delta) {
+    c.store(c.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+struct ThreadLockBuffer {
+    std::array<LockCounters, kMaxProfiledLocks> locks;
+};
+
+class LockProfiler {
+public:
+    static LockProfiler& instance() {
+        static LockProfiler profiler;
+        return profiler;
+    }
+
+    // 槽位按名字分配：同名的锁（例如每个对象一把的成员锁）共用一个槽位，
+    // 统计合并在一起，反复创建销毁也不会耗尽槽位
+    size_t registerLock(const char* name) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = std::find(mNames.begin(), mNames.end(), name);
+        if (it != mNames.end()) {
+            return static_cast<size_t>(it - mNames.begin());
+        }
+        if (mNames.size() + 1 < kMaxProfiledLocks) {
+            mNames.emplace_back(name);
+            return mNames.size() - 1;
+        }
+        if (mNames.size() + 1 == kMaxProfiledLocks) {
+            mNames.emplace_back("<overflow>");
+        }
+        return kMaxProfiledLocks - 1;
+    }
+
+    // 当前线程的缓冲区；第一次调用时登记到全局列表。
+    // 缓冲区由 shared_ptr 持有，线程退出后统计仍保留到报告里。
+    static ThreadLockBuffer& local() {
+        thread_local ThreadLockBuffer* buffer = instance().addThread();
+        return *buffer;
+    }
+
+    struct LockReport {
+        std::string name;
+        uint64_t acquisitions = 0;
+        uint64_t contended = 0;
+        uint64_t waitNs = 0;
+        uint64_t holdNs = 0;  // 估计值
+        uint64_t maxWaitNs = 0;
+        std::array<uint64_t, kWaitBuckets> waitHist{};
+    };
+
+    // 汇总所有线程，按总等待时间降序
+    std::vector<LockReport> collect() {
+        std::lock_guard<std::mutex> lock(mMutex);
+        std::vector<LockReport> reports(mNames.size());
+        for (size_t id = 0; id < mNames.size(); ++id) {
+            LockReport& r = reports[id];
+            r.name = mNames[id];
+            uint64_t sampledHold = 0, samples = 0;
+            for (auto& buf : mBuffers) {
+                const LockCounters& c = buf->locks[id];
+                r.acquisitions += c.acquisitions.load(std::memory_order_relaxed);
+                r.contended    += c.contended.load(std::memory_order_relaxed);
+                r.waitNs       += c.waitNs.load(std::memory_order_relaxed);
+                sampledHold    += c.holdNs.load(std::memory_order_relaxed);
+                samples        += c.holdSamples.load(std::memory_order_relaxed);
+                r.maxWaitNs = std::max(r.maxWaitNs, c.maxWaitNs.load(std::memory_order_relaxed));
+                for (size_t b = 0; b < kWaitBuckets; ++b) {
+                    r.waitHist[b] += c.waitHist[b].load(std::memory_order_relaxed);
+                }
+            }
+            if (samples > 0) {
+                r.holdNs = static_cast<uint64_t>(static_cast<double>(sampledHold) / samples *
+                                                 r.acquisitions);
+            }
+        }
+        std::sort(reports.begin(), reports.end(), [](const LockReport& a, const LockReport& b) {
+            return a.waitNs > b.waitNs;
+        });
+        return reports;
+    }
+
+    void printReport(size_t topN, bool histograms = true) {
+        auto reports = collect();
+        reports.erase(std::remove_if(reports.begin(), reports.end(),
+                                     [](const LockReport& r) { return r.acquisitions == 0; }),
+                      reports.end());
+        if (reports.size() > topN) reports.resize(topN);
+
+        std::cout << "  " << std::left << std::setw(20) << "lock" << std::right
+                  << std::setw(10) << "acquire" << std::setw(10) << "contend"
+                  << std::setw(8) << "cont%" << std::setw(12) << "wait(ms)"
+                  << std::setw(12) << "hold(ms)" << std::setw(12) << "maxWait(us)" << "\n";
+        for (const auto& r : reports) {
+            std::cout << "  " << std::left << std::setw(20) << r.name << std::right
+                      << std::setw(10) << r.acquisitions << std::setw(10) << r.contended
+                      << std::fixed << std::setprecision(1) << std::setw(7)
+                      << 100.0 * r.contended / r.acquisitions << "%"
+                      << std::setprecision(2) << std::setw(12) << r.waitNs / 1e6
+                      << std::setw(12) << r.holdNs / 1e6
+                      << std::setprecision(1) << std::setw(12) << r.maxWaitNs / 1e3 << "\n";
+        }
+        if (!histograms) return;
+        for (const auto& r : reports) {
+            if (r.contended == 0) continue;
+            std::cout << "  wait histogram: " << r.name << "\n";
+            printHistogram(r.waitHist);
+        }
+    }
+
+private:
+    LockProfiler() = default;
+
+    ThreadLockBuffer* addThread() {
+        auto buf = std::make_shared<ThreadLockBuffer>();
+        std::lock_guard<std::mutex> lock(mMutex);
+        mBuffers.push_back(buf);
+        return buf.get();
+    }
+
+    static void printHistogram(const std::array<uint64_t, kWaitBuckets>& hist) {
+        uint64_t peak = *std::max_element(hist.begin(), hist.end());
+        for (size_t b = 0; b < kWaitBuckets; ++b) {
+            if (hist[b] == 0) continue;
+            int bar = static_cast<int>(40 * hist[b] / peak);
+            std::cout << "    " << std::setw(10) << formatNs(1ull << b) << " ~ "
+                      << std::left << std::setw(10)
+                      << (b + 1 < kWaitBuckets ? formatNs(1ull << (b + 1)) : std::string("inf"))
+                      << std::right << std::setw(9) << hist[b] << " " << std::string(bar, '#')
+                      << "\n";
+        }
+    }
+
+    static std::string formatNs(uint64_t ns) {
+        if (ns >= 1000000) return std::to_string(ns / 1000000) + "ms";
+        if (ns >= 1000) return std::to_string(ns / 1000) + "us";
+        return std::to_string(ns) + "ns";
+    }
+
+    std::mutex mMutex;
+    std::vector<std::string> mNames;
+    std::vector<std::shared_ptr<ThreadLockBuffer>> mBuffers;
+};
+
+// ============================================================
+// 12.2：ProfiledMutex
+// ============================================================
+// 满足 Lockable，可直接用于 lock_guard / unique_lock / scoped_lock。
+
+class ProfiledMutex {
+public:
+    explicit ProfiledMutex(const char* name)
+        : mId(LockProfiler::instance().registerLock(name)) {}
+
+    ProfiledMutex(const ProfiledMutex&) = delete;
+    ProfiledMutex& operator=(const ProfiledMutex&) = delete;
+
+    void lock() {
+        LockCounters& c = LockProfiler::local().locks[mId];
+        bool sampleHold = c.acquisitions.load(std::memory_order_relaxed) % kHoldSampleEvery == 0;
+        if (mMutex.try_lock()) {
+            // 快速路径：没有竞争，不计等待
+            mAcquiredAt = sampleHold ? now() : 0;
+        } else {
+            auto t0 = now();
+            mMutex.lock();
+            auto t1 = now();
+            mAcquiredAt = sampleHold ? t1 : 0;
+            uint64_t wait = t1 - t0;
+            bump(c.contended, 1);
+            bump(c.waitNs, wait);
+            if (wait > c.maxWaitNs.load(std::memory_order_relaxed)) {
+                c.maxWaitNs.store(wait, std::memory_order_relaxed);
+            }
+            bump(c.waitHist[bucketOf(wait)], 1);
+        }
+        bump(c.acquisitions, 1);
+    }
+
+    bool try_lock() {
+        if (!mMutex.try_lock()) return false;
+        LockCounters& c = LockProfiler::local().locks[mId];
+        bool sampleHold = c.acquisitions.load(std::memory_order_relaxed) % kHoldSampleEvery == 0;
+        mAcquiredAt = sampleHold ? now() : 0;
+        bump(c.acquisitions, 1);
+        return true;
+    }
+
+    void unlock() {
+        // mAcquiredAt 只在持锁期间被当前持有者读写，不需要同步；0 表示本次未采样
+        if (mAcquiredAt == 0) {
+            mMutex.unlock();
+            return;
+        }
+        uint64_t hold = now() - mAcquiredAt;
+        mMutex.unlock();
+        LockCounters& c = LockProfiler::local().locks[mId];
+        bump(c.holdNs, hold);
+        bump(c.holdSamples, 1);
+    }
+
+private:
+    static uint64_t now() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    static size_t bucketOf(uint64_t ns) {
+        size_t b = 0;
+        while (ns > 1 && b + 1 < kWaitBuckets) {
+            ns >>= 1;
+            ++b;
+        }
+        return b;
+    }
+
+    std::mutex mMutex;
+    const size_t mId;
+    uint64_t mAcquiredAt = 0;
+};
+
+// ============================================================
+// 12.3：演示 —— 带分析的 demo_granularity
+// ============================================================
+
+void demo_granularity_profiled() {
+    std::cout << "=== 12.3 Level 3 粒度对比（带锁分析）===\n";
+    const int N = 1000000;
+    ProfiledMutex perOp("counter.per_op");
+    ProfiledMutex batch("counter.batch");
+    int counter = 0;
+
+    auto incrementSafe = [&](int n) {
+        for (int i = 0; i < n; ++i) {
+            std::lock_guard<ProfiledMutex> lock(perOp);
+            counter++;
+        }
+    };
+    auto incrementBatch = [&](int n) {
+        std::lock_guard<ProfiledMutex> lock(batch);
+        for (int i = 0; i < n; ++i) counter++;
+    };
+
+    std::thread t1(incrementSafe, N / 2), t2(incrementSafe, N / 2);
+    t1.join(); t2.join();
+    std::thread t3(incrementBatch, N / 2), t4(incrementBatch, N / 2);
+    t3.join(); t4.join();
+    assert(counter == 2 * N);
+    std::cout << "  (两把锁的统计在 12.4 的报告里一起输出)\n\n";
+}
+
+// ============================================================
+// 12.4：演示 —— 哪把锁最热？
+// ============================================================
+// 模拟一个服务：
+//   config  读多、临界区极短
+//   cache   每个请求都要拿，临界区较长 → 最热
+//   stats   每 16 个请求拿一次
+
+void demo_hot_locks() {
+    std::cout << "=== 12.4 Top 竞争锁报告 ===\n";
+    ProfiledMutex config("service.config");
+    ProfiledMutex cache("service.cache");
+    ProfiledMutex stats("service.stats");
+    std::atomic<unsigned> sink{0};
+
+    // 模拟 n 步计算；结果写回 sink 防止被优化掉
+    auto spin = [](unsigned x, int n) {
+        for (int i = 0; i < n; ++i) x = x * 1664525u + 1013904223u;
+        return x;
+    };
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&, t] {
+            unsigned x = static_cast<unsigned>(t);
+            for (int req = 0; req < 20000; ++req) {
+                { std::lock_guard<ProfiledMutex> g(config); x = spin(x, 5); }
+                { std::lock_guard<ProfiledMutex> g(cache); x = spin(x, 200); }
+                if (req % 16 == 0) { std::lock_guard<ProfiledMutex> g(stats); x = spin(x, 50); }
+                x = spin(x, 100);  // 锁外的业务逻辑
+            }
+            sink += x;
+        });
+    }
+    for (auto& w : workers) w.join();
+
+    LockProfiler::instance().printReport(5);
+    std::cout << "\n";
+}
+
+// ============================================================
+// 12.5：开销测量
+// ============================================================
+
+template <typename Mutex>
+double nsPerLock(Mutex& m, int threads, int iters) {
+    long long counter = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> ts;
+    for (int t = 0; t < threads; ++t) {
+        ts.emplace_back([&] {
+            for (int i = 0; i < iters; ++i) {
+                std::lock_guard<Mutex> lock(m);
+                counter++;
+            }
+        });
+    }
+    for (auto& t : ts) t.join();
+    auto elapsed = std::chrono::steady_clock::now() - t0;
+    assert(counter == static_cast<long long>(threads) * iters);
+    return std::chrono::duration<double, std::nano>(elapsed).count() /
+           (static_cast<double>(threads) * iters);
+}
+
+void bench_overhead(int iters) {
+    std::cout << "=== 12.5 开销：std::mutex vs ProfiledMutex（ns/次）===\n";
+    for (int threads : {1, 4}) {
+        std::mutex plain;
+        ProfiledMutex profiled("bench.overhead");
+        double a = nsPerLock(plain, threads, iters);
+        double b = nsPerLock(profiled, threads, iters);
+        std::cout << "  " << threads << " 线程: std::mutex=" << std::fixed << std::setprecision(1)
+                  << std::setw(6) << a << "  ProfiledMutex=" << std::setw(6) << b
+                  << "  (+" << std::setw(5) << b - a << "ns)\n";
+    }
+    std::cout << "  (无竞争时只有 thread_local 计数；读时钟只发生在竞争和 1/"
+              << kHoldSampleEvery << " 的持有时间采样上)\n\n";
+}
+
+// ==================== 设计要点速记 ====================
+/*
+ * 1. 为什么先 try_lock？
+ *    → 绝大多数加锁没有竞争，成功时不需要测等待时间，省掉读时钟。
+ *      失败才说明"发生了竞争"，这也正是 contended 计数的定义。
+ *    → 一次 steady_clock::now() 就有几十 ns，和一次无竞争 lock/unlock 同量级，
+ *      所以持有时间只采样测量。
+ *
+ * 2. 为什么每线程一个缓冲区？
+ *    → 若所有线程 fetch_add 同一组计数器，统计本身就会成为新的热点
+ *      （cache line 在核间来回跳），测量会显著改变被测对象。
+ *
+ * 3. 持有时间存在 mutex 里安全吗？
+ *    → mAcquiredAt 只被"当前持有锁的线程"读写，互斥本身保证了顺序。
+ *
+ * 练习：
+ * [练习 1] 增加 reset()：用每个缓冲区的"上次快照"做差，输出最近 N 秒的统计。
+ *
+ * [练习 2] 记录等待最久的 K 次的调用位置（std::source_location）。
+ *
+ * [练习 3] 把 ProfiledMutex 与 Level 11 的 LockOrderMutex 组合成一个模板：
+ *   template <typename Base, typename... Policies> class InstrumentedMutex;
+ */
+
+int main(int argc, char** argv) {
+    int iters = argc > 1 ? std::stoi(argv[1]) : 1000000;
+
+    demo_granularity_profiled();
+    demo_hot_locks();
+    bench_overhead(iters);
+
+    std::cout << "Level 12 Complete!\n";
+    return 0;
+}
+
+/*
+ * 编译运行：
+ *   g++ -std=c++20 -pthread -O2 level12_lock_profiler.cpp -o level12 && ./level12 [iters]
+ */
@@ -0,0 +1,491 @@
+/*
+ * ============================================================
+ * Level 13 — Fork-Join：工作窃取 + 不阻塞的 join
+ * ============================================================
+ *
+ * 目标：为递归分治（divide-and-conquer）实现一个固定线程数的
+ *       ForkJoinPool，提供 invokeParallel(f, g)
+ *
+ * 问题 1：Level 1 的 accumulate 每切一块就开一个 std::thread
+ *   → 递归切分时线程数按 2^depth 增长，远超核数（oversubscription）
+ *
+ * 问题 2：直接用 Level 8 的 ThreadPool 做递归
+ *   → 父任务 submitWithResult(子任务) 后 future.get() 阻塞，
+ *     递归深度超过线程数时，所有线程都在等子任务，子任务却没有线程执行 → 死锁
+ *
+ * 方案：
+ *   1. 每个工作线程一个双端队列（deque）：
+ *        自己从尾部 push/pop（LIFO，缓存友好，先做最新拆出来的小任务）
+ *        空闲线程从别人的头部"窃取"（steal，拿走最老、通常最大的任务）
+ *   2. invokeParallel(f, g)：把 g 压入本线程队列，当场执行 f，
+ *      然后尝试把 g 弹回来自己执行；若 g 已被窃取，
+ *      在等待期间继续执行其他任务（helping），join 永不阻塞线程
+ *   → 线程数固定（不超订），递归多深都不会死锁
+ *
+ * 说明：这里窃取的是"子任务"（child stealing）。TBB / Cilk 的"续体窃取"
+ *       （continuation stealing）需要编译器或协程把父函数的剩余部分打包，
+ *       helping join 在普通函数上就能做到"join 时不阻塞、不超订"。
+ */
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <atomic>
+#include <future>
+#include <memory>
+#include <functional>
+#include <exception>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <iostream>
+#include <iomanip>
+#include <cassert>
+#include <chrono>
+#include <type_traits>
+#include <utility>
+
+using namespace std::chrono_literals;
+
+// ============================================================
+// 13.1：任务对象
+// ============================================================
+// invokeParallel 里的任务分配在调用者的栈上：join 返回前它一定已执行完，
+// 所以不需要堆分配，也不需要 shared_ptr。
+
+class Job {
+public:
+    virtual ~Job() = default;
+
+    void execute() {
+        try {
+            run();
+        } catch (...) {
+            mException = std::current_exception();
+        }
+        complete();
+    }
+
+    bool done() const { return mDone.load(std::memory_order_acquire); }
+
+    void rethrowIfFailed() const {
+        if (mException) std::rethrow_exception(mException);
+    }
+
+protected:
+    virtual void run() = 0;
+
+    // 完成后的最后一个动作：之后等待者可能立刻销毁本对象，不能再访问任何成员
+    virtual void complete() { mDone.store(true, std::memory_order_release); }
+
+private:
+    std::atomic<bool> mDone{false};
+    std::exception_ptr mException;
+};
+
+template <typename F>
+class StackJob : public Job {
+public:
+    explicit StackJob(F& f) : mFunc(f) {}
+
+protected:
+    void run() override { mFunc(); }
+
+private:
+    F& mFunc;
+};
+
+// 外部线程提交的根任务：外部线程要睡眠等待，而不是像工作线程那样边等边干活
+template <typename F>
+class RootJob : public StackJob<F> {
+public:
+    using StackJob<F>::StackJob;
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mCV.wait(lock, [this] { return mFinished; });
+        this->rethrowIfFailed();
+    }
+
+protected:
+    // 持锁 notify：wait 返回后调用者会立刻销毁本对象
+    void complete() override {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mFinished = true;
+        mCV.notify_one();
+    }
+
+private:
+    std::mutex mMutex;
+    std::condition_variable mCV;
+    bool mFinished = false;
+};
+
+// ============================================================
+// 13.2：ForkJoinPool
+// ============================================================
+
+class ForkJoinPool {
+public:
+    explicit ForkJoinPool(size_t numThreads = std::max(1u, std::thread::hardware_concurrency()))
+        : mQueues(numThreads) {
+        for (size_t i = 0; i < numThreads; ++i) {
+            mWorkers.emplace_back([this, i] { workerLoop(i); });
+        }
+    }
+
+    ForkJoinPool(const ForkJoinPool&) = delete;
+    ForkJoinPool& operator=(const ForkJoinPool&) = delete;
+
+    ~ForkJoinPool() {
+        {
+            std::lock_guard<std::mutex> lock(mSleepMutex);
+            mStop = true;
+        }
+        mSleepCV.notify_all();
+        for (auto& t : mWorkers) t.join();
+    }
+
+    size_t size() const { return mWorkers.size(); }
+    uint64_t steals() const { return mSteals.load(std::memory_order_relaxed); }
+
+    // 从外部线程（如 main）提交根任务并阻塞等待结果
+    template <typename F>
+    auto run(F&& f) -> std::invoke_result_t<F> {
+        using R = std::invoke_result_t<F>;
+        if (currentPool() == this) return f();  // 已在工作线程中，直接执行
+
+        std::packaged_task<R()> task(std::forward<F>(f));
+        auto future = task.get_future();
+        RootJob<std::packaged_task<R()>> job(task);
+        {
+            std::lock_guard<std::mutex> lock(mInjectMutex);
+            mInjected.push_back(&job);
+        }
+        wakeOne();
+        job.wait();  // 外部线程可以阻塞：它不是池里的线程
+        return future.get();
+    }
+
+    // 并行执行 f 和 g，二者都完成后返回；异常在这里重新抛出
+    template <typename F, typename G>
+    void invokeParallel(F&& f, G&& g) {
+        if (currentPool() != this) {
+            run([&] { invokeParallel(f, g); });
+            return;
+        }
+        size_t self = currentIndex();
+        StackJob<std::remove_reference_t<G>> jobG(g);
+        push(self, &jobG);
+
+        std::exception_ptr fError;
+        try {
+            f();
+        } catch (...) {
+            fError = std::current_exception();  // 仍要等 jobG：它在本函数的栈上
+        }
+
+        if (popIf(self, &jobG)) {
+            jobG.execute();  // 没被偷走：自己执行，相当于顺序调用 g()
+        } else {
+            join(self, jobG);  // 被偷走了：边等边干别的活
+        }
+
+        if (fError) std::rethrow_exception(fError);
+        jobG.rethrowIfFailed();
+    }
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Job*> jobs;
+    };
+
+    struct WorkerContext {
+        ForkJoinPool* pool = nullptr;
+        size_t index = 0;
+    };
+
+    static WorkerContext& context() {
+        thread_local WorkerContext ctx;
+        return ctx;
+    }
+    static ForkJoinPool* currentPool() { return context().pool; }
+    static size_t currentIndex() { return context().index; }
+
+    void push(size_t self, Job* job) {
+        {
+            std::lock_guard<std::mutex> lock(mQueues[self].mutex);
+            mQueues[self].jobs.push_back(job);
+        }
+        wakeOne();
+    }
+
+    // 队尾是 job 才弹出：若 job 已被窃取，队尾是别的任务（或为空），不能动
+    bool popIf(size_t self, Job* job) {
+        std::lock_guard<std::mutex> lock(mQueues[self].mutex);
+        auto& q = mQueues[self].jobs;
+        if (q.empty() || q.back() != job) return false;
+        q.pop_back();
+        return true;
+    }
+
+    Job* findWork(size_t self) {
+        // 1. 自己的队尾（LIFO）
+        {
+            std::lock_guard<std::mutex> lock(mQueues[self].mutex);
+            auto& q = mQueues[self].jobs;
+            if (!q.empty()) {
+                Job* job = q.back();
+                q.pop_back();
+                return job;
+            }
+        }
+        // 2. 外部提交的根任务
+        {
+            std::lock_guard<std::mutex> lock(mInjectMutex);
+            if (!mInjected.empty()) {
+                Job* job = mInjected.front();
+                mInjected.pop_front();
+                return job;
+            }
+        }
+        // 3. 从其他线程的队头窃取（FIFO，偷最大的那块）
+        const size_t n = mQueues.size();
+        for (size_t k = 1; k < n; ++k) {
+            auto& victim = mQueues[(self + k) % n];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.jobs.empty()) {
+                Job* job = victim.jobs.front();
+                victim.jobs.pop_front();
+                mSteals.fetch_add(1, std::memory_order_relaxed);
+                return job;
+            }
+        }
+        return nullptr;
+    }
+
+    // helping join：等待被窃取的 job 时执行其他任务，而不是阻塞
+    void join(size_t self, const Job& job) {
+        while (!job.done()) {
+            if (Job* other = findWork(self)) {
+                other->execute();
+            } else {
+                std::this_thread::yield();  // 被等的任务正在别的线程上执行
+            }
+        }
+    }
+
+    void wakeOne() {
+        if (mSleepers.load() == 0) return;  // 热路径：没人睡就不碰锁
+        std::lock_guard<std::mutex> lock(mSleepMutex);
+        mSleepCV.notify_one();
+    }
+
+    void workerLoop(size_t self) {
+        context() = {this, self};
+        while (true) {
+            if (Job* job = findWork(self)) {
+                job->execute();
+                continue;
+            }
+            // 没活干：先登记为睡眠者，再检查一遍，避免丢失唤醒
+            std::unique_lock<std::mutex> lock(mSleepMutex);
+            if (mStop) return;
+            mSleepers.fetch_add(1);
+            if (!hasWork()) {
+                mSleepCV.wait_for(lock, 10ms);
+            }
+            mSleepers.fetch_sub(1);
+        }
+    }
+
+    bool hasWork() {
+        {
+            std::lock_guard<std::mutex> lock(mInjectMutex);
+            if (!mInjected.empty()) return true;
+        }
+        for (auto& q : mQueues) {
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (!q.jobs.empty()) return true;
+        }
+        return false;
+    }
+
+    std::vector<WorkQueue> mQueues;
+    std::vector<std::thread> mWorkers;
+
+    std::mutex mInjectMutex;
+    std::deque<Job*> mInjected;
+
+    std::mutex mSleepMutex;
+    std::condition_variable mSleepCV;
+    std::atomic<int> mSleepers{0};
+    bool mStop = false;
+
+    std::atomic<uint64_t> mSteals{0};
+};
+
+// ============================================================
+// 13.3：演示 —— 用 invokeParallel 改写 Level 1 的 accumulate
+// ============================================================
+
+long long accumulate(ForkJoinPool& pool, const std::vector<int>& data,
+                     size_t begin, size_t end, size_t cutoff) {
+    if (end - begin <= cutoff) {
+        return std::accumulate(data.begin() + begin, data.begin() + end, 0LL);
+    }
+    size_t mid = begin + (end - begin) / 2;
+    long long left = 0, right = 0;
+    pool.invokeParallel([&] { left = accumulate(pool, data, begin, mid, cutoff); },
+                        [&] { right = accumulate(pool, data, mid, end, cutoff); });
+    return left + right;
+}
+
+void demo_accumulate() {
+    std::cout << "=== 13.3 递归 accumulate（2 个工作线程，递归深度 16）===\n";
+    ForkJoinPool pool(2);
+    std::vector<int> data(1 << 20, 1);
+
+    // cutoff=16 → 递归深度 16，同时"等待中"的父任务远多于 2 个线程
+    long long sum = pool.run([&] { return accumulate(pool, data, 0, data.size(), 16); });
+    assert(sum == static_cast<long long>(data.size()));
+    std::cout << "  sum = " << sum << "，没有死锁，只用了 " << pool.size() << " 个线程 ✓\n";
+
+    try {
+        pool.invokeParallel([] {}, [] { throw std::runtime_error("child failed"); });
+        assert(false);
+    } catch (const std::runtime_error& e) {
+        std::cout << "  子任务异常在 join 处重新抛出: " << e.what() << " ✓\n";
+    }
+    std::cout << "\n";
+}
+
+// ============================================================
+// 13.4：Benchmark —— 递归 Fibonacci 与并行快排，不同 cutoff
+// ============================================================
+
+long long fibSeq(int n) {
+    return n < 2 ? n : fibSeq(n - 1) + fibSeq(n - 2);
+}
+
+long long fibPar(ForkJoinPool& pool, int n, int cutoff) {
+    if (n <= cutoff) return fibSeq(n);
+    long long a = 0, b = 0;
+    pool.invokeParallel([&] { a = fibPar(pool, n - 1, cutoff); },
+                        [&] { b = fibPar(pool, n - 2, cutoff); });
+    return a + b;
+}
+
+template <typename It>
+void quicksortPar(ForkJoinPool& pool, It first, It last, std::ptrdiff_t cutoff) {
+    if (last - first <= cutoff) {
+        std::sort(first, last);
+        return;
+    }
+    // 三数取中作为枢轴，三路划分避免重复元素导致的退化
+    auto a = *first, b = *(first + (last - first) / 2), c = *(last - 1);
+    auto pivot = std::max(std::min(a, b), std::min(std::max(a, b), c));
+    It mid1 = std::partition(first, last, [pivot](const auto& x) { return x < pivot; });
+    It mid2 = std::partition(mid1, last, [pivot](const auto& x) { return !(pivot < x); });
+    pool.invokeParallel([&] { quicksortPar(pool, first, mid1, cutoff); },
+                        [&] { quicksortPar(pool, mid2, last, cutoff); });
+}
+
+template <typename F>
+double timeMs(F&& f) {
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0)
+        .count();
+}
+
+void bench_fib(ForkJoinPool& pool, int n) {
+    std::cout << "=== 13.4 fib(" << n << ")，" << pool.size() << " 个工作线程 ===\n";
+    long long expect = 0;
+    double seq = timeMs([&] { expect = fibSeq(n); });
+    std::cout << "  sequential        " << std::fixed << std::setprecision(1) << std::setw(8)
+              << seq << "ms\n";
+
+    for (int cutoff : {10, 15, 20, 25, 30}) {
+        if (cutoff >= n) continue;
+        uint64_t steals0 = pool.steals();
+        long long got = 0;
+        double ms = timeMs([&] { got = pool.run([&] { return fibPar(pool, n, cutoff); }); });
+        assert(got == expect);
+        std::cout << "  cutoff=" << std::left << std::setw(10) << cutoff << std::right
+                  << std::setw(8) << ms << "ms  speedup=" << std::setprecision(2)
+                  << seq / ms << "x  steals=" << pool.steals() - steals0
+                  << std::setprecision(1) << "\n";
+    }
+    std::cout << "\n";
+}
+
+void bench_quicksort(ForkJoinPool& pool, size_t n) {
+    std::cout << "=== 13.4 并行快排 " << n << " 个 int，" << pool.size() << " 个工作线程 ===\n";
+    std::mt19937 rng(42);
+    std::vector<int> input(n);
+    for (auto& x : input) x = static_cast<int>(rng());
+
+    auto data = input;
+    double seq = timeMs([&] { std::sort(data.begin(), data.end()); });
+    const auto expect = data;
+    std::cout << "  std::sort         " << std::fixed << std::setprecision(1) << std::setw(8)
+              << seq << "ms\n";
+
+    for (std::ptrdiff_t cutoff : {1000, 10000, 100000, 1000000}) {
+        data = input;
+        uint64_t steals0 = pool.steals();
+        double ms = timeMs([&] {
+            pool.run([&] { quicksortPar(pool, data.begin(), data.end(), cutoff); });
+        });
+        assert(data == expect);
+        std::cout << "  cutoff=" << std::left << std::setw(10) << cutoff << std::right
+                  << std::setw(8) << ms << "ms  speedup=" << std::setprecision(2)
+                  << seq / ms << "x  steals=" << pool.steals() - steals0
+                  << std::setprecision(1) << "\n";
+    }
+    std::cout << "  (cutoff 太小：任务调度开销淹没收益；太大：并行度不够、负载不均)\n\n";
+}
+
+// ==================== 设计要点速记 ====================
+/*
+ * 1. 为什么本线程 LIFO、窃取者 FIFO？
+ *    → 本线程先做最新拆出的任务，数据还在缓存里；
+ *      窃取者拿最老的任务，递归分治中它最大，一次窃取能分到最多的活，窃取次数最少。
+ *
+ * 2. 为什么 join 不会死锁？
+ *    → 等待中的线程不睡眠，而是继续执行队列里的任务；
+ *      被等待的任务要么还在队列里（会被某个线程执行），要么正在执行，总会完成。
+ *
+ * 3. 为什么任务可以放在栈上？
+ *    → invokeParallel 返回前一定等到 jobG 完成，栈帧的生命周期覆盖任务的执行。
+ *
+ * 练习：
+ * [练习 1] 用 Chase-Lev 无锁双端队列替换 WorkQueue 里的 mutex + deque。
+ *
+ * [练习 2] 实现 TaskGroup：spawn 任意多个子任务，sync() 以 helping 的方式等待全部完成。
+ *
+ * [练习 3] 实现 parallelFor(pool, begin, end, grain, body)，按 grain 递归二分。
+ */
+
+int main(int argc, char** argv) {
+    int fibN = argc > 1 ? std::stoi(argv[1]) : 35;
+    size_t sortN = argc > 2 ? std::stoul(argv[2]) : 5000000;
+
+    demo_accumulate();
+
+    ForkJoinPool pool;
+    bench_fib(pool, fibN);
+    bench_quicksort(pool, sortN);
+
+    std::cout << "Level 13 Complete!\n";
+    return 0;
+}
+
+/*
+ * 编译运行：
+ *   g++ -std=c++20 -pthread -O2 level13_fork_join.cpp -o level13 && ./level13 [fibN] [sortN]
+ */
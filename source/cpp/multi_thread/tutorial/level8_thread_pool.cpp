@@ -374,6 +374,7 @@ int main() {
     std::cout << "  L6: 生产者消费者（无界→有界→MPMC）\n";
     std::cout << "  L7: atomic（无锁计数/标志/CAS）\n";
     std::cout << "  L8: 线程池（综合应用）\n";
+    std::cout << "\n进阶 → level9_coroutine.cpp：在线程池上跑 C++20 协程\n";
     return 0;
 }
 
@@ -0,0 +1,756 @@
+/*
+ * ============================================================
+ * Level 9 — C++20 协程：在线程池上跑异步任务
+ * ============================================================
+ *
+ * 目标：把 Level 8 的 ThreadPool 变成协程的执行器（executor），
+ *       让"等 I/O"的任务不再占着工作线程
+ *
+ * 为什么需要协程？
+ *   Level 8 的任务一旦 sleep / 阻塞读写，就把一个工作线程整个占住。
+ *   I/O 密集型任务只能靠"把线程池开大"来提高并发，线程越多切换越贵。
+ *   协程在等待时 suspend（挂起），把线程还给线程池；
+ *   等待结束后再把 resume 作为一个普通任务提交回线程池。
+ *
+ * 本文件的组成：
+ *   9.1 Task<T>：惰性协程任务，co_await 另一个 Task 时使用对称转移
+ *   9.2 schedule(pool)：co_await 它即切换到线程池上执行
+ *   9.3 TimerQueue：co_await timers.sleepFor(d)，不阻塞工作线程
+ *   9.4 AsyncQueue<T>：协程版生产者-消费者队列（Level 6 的 ClosableQueue）
+ *   9.5 Benchmark：10 万个并发协程 vs 同样工作量的阻塞任务
+ *
+ * 对称转移（symmetric transfer）：
+ *   await_suspend 返回 coroutine_handle<> 时，编译器以尾调用的方式
+ *   直接跳到目标协程，而不是在当前栈帧里嵌套调用 resume()。
+ *   因此 co_await 一长串同步完成的 Task 也不会让栈无限增长。
+ */
+
+#include <coroutine>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <queue>
+#include <deque>
+#include <functional>
+#include <vector>
+#include <atomic>
+#include <latch>
+#include <optional>
+#include <exception>
+#include <iostream>
+#include <cassert>
+#include <stdexcept>
+#include <chrono>
+#include <string>
+#include <type_traits>
+#include <algorithm>
+#include <utility>
+
+using namespace std::chrono_literals;
+
+// ============================================================
+// 线程池：与 level8_thread_pool.cpp 的 ThreadPool 相同
+// ============================================================
+
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t numThreads) : mStop(false) {
+        if (numThreads == 0) throw std::invalid_argument("numThreads must be > 0");
+        for (size_t i = 0; i < numThreads; ++i) {
+            mWorkers.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        shutdown();
+    }
+
+    void submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mStop) throw std::runtime_error("ThreadPool is shut down");
+            mTasks.push(std::move(task));
+        }
+        mCV.notify_one();
+    }
+
+    void shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mStop) return;
+            mStop = true;
+        }
+        mCV.notify_all();
+        for (auto& t : mWorkers) {
+            if (t.joinable()) t.join();
+        }
+    }
+
+    size_t size() const { return mWorkers.size(); }
+
+private:
+    void workerLoop() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mCV.wait(lock, [this] {
+                    return !mTasks.empty() || mStop;
+                });
+                if (mStop && mTasks.empty()) return;
+                task = std::move(mTasks.front());
+                mTasks.pop();
+            }
+            try {
+                task();
+            } catch (const std::exception& e) {
+                std::cerr << "[Pool] uncaught exception: " << e.what() << "\n";
+            } catch (...) {
+                std::cerr << "[Pool] unknown exception\n";
+            }
+        }
+    }
+
+    std::vector<std::thread> mWorkers;
+    std::queue<std::function<void()>> mTasks;
+    mutable std::mutex mMutex;
+    std::condition_variable mCV;
+    bool mStop;
+};
+
+// ============================================================
+// 9.1：Task<T> —— 惰性启动、可 co_await 的协程任务
+// ============================================================
+//
+// 生命周期：
+//   1. 调用协程函数 → 创建协程帧，initial_suspend 挂起（惰性）
+//   2. 调用方 co_await task → 记录 continuation，对称转移进入 task
+//   3. task 执行到 co_return → final_suspend 对称转移回 continuation
+//   4. Task 对象析构时销毁协程帧
+
+template <typename T = void>
+class Task;
+
+class TaskPromiseBase {
+public:
+    // final_suspend 的 awaiter：把控制权直接交还给等待者
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> h) noexcept {
+            return h.promise().mContinuation;  // 对称转移，不增长调用栈
+        }
+
+        void await_resume() noexcept {}
+    };
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    FinalAwaiter final_suspend() noexcept { return {}; }
+    void unhandled_exception() noexcept { mException = std::current_exception(); }
+
+    void setContinuation(std::coroutine_handle<> h) noexcept { mContinuation = h; }
+
+protected:
+    void rethrowIfFailed() const {
+        if (mException) std::rethrow_exception(mException);
+    }
+
+private:
+    // 默认值 noop：没有等待者时 final_suspend 直接返回
+    std::coroutine_handle<> mContinuation = std::noop_coroutine();
+    std::exception_ptr mException;
+};
+
+template <typename T>
+class TaskPromise : public TaskPromiseBase {
+public:
+    Task<T> get_return_object() noexcept;
+
+    template <typename U>
+    void return_value(U&& value) { mValue.emplace(std::forward<U>(value)); }
+
+    T result() {
+        rethrowIfFailed();
+        return std::move(*mValue);
+    }
+
+private:
+    std::optional<T> mValue;
+};
+
+template <>
+class TaskPromise<void> : public TaskPromiseBase {
+public:
+    Task<void> get_return_object() noexcept;
+
+    void return_void() noexcept {}
+
+    void result() { rethrowIfFailed(); }
+};
+
+template <typename T>
+class Task {
+public:
+    using promise_type = TaskPromise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    explicit Task(Handle h) noexcept : mHandle(h) {}
+    Task(Task&& other) noexcept : mHandle(std::exchange(other.mHandle, {})) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (mHandle) mHandle.destroy();
+            mHandle = std::exchange(other.mHandle, {});
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() {
+        if (mHandle) mHandle.destroy();
+    }
+
+    // co_await task：挂起调用者，对称转移到 task 的协程体
+    auto operator co_await() && noexcept {
+        struct Awaiter {
+            Handle handle;
+
+            bool await_ready() noexcept { return !handle || handle.done(); }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept {
+                handle.promise().setContinuation(caller);
+                return handle;
+            }
+
+            T await_resume() { return handle.promise().result(); }
+        };
+        return Awaiter{mHandle};
+    }
+
+private:
+    Handle mHandle;
+};
+
+template <typename T>
+Task<T> TaskPromise<T>::get_return_object() noexcept {
+    return Task<T>{std::coroutine_handle<TaskPromise<T>>::from_promise(*this)};
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() noexcept {
+    return Task<void>{std::coroutine_handle<TaskPromise<void>>::from_promise(*this)};
+}
+
+// ------------------------------------------------------------
+// 启动方式：spawn（即发即弃）与 syncWait（阻塞等待结果）
+// ------------------------------------------------------------
+
+// 立即启动、结束时自动销毁协程帧
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+inline DetachedTask runDetached(Task<void> task) {
+    co_await std::move(task);
+}
+
+// 在当前线程启动 task（直到它第一次挂起），之后由线程池/定时器接力
+inline void spawn(Task<void> task) {
+    runDetached(std::move(task));
+}
+
+template <typename T>
+struct SyncWaitState {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool done = false;
+    std::optional<std::conditional_t<std::is_void_v<T>, char, T>> value;
+    std::exception_ptr exception;
+};
+
+template <typename T>
+DetachedTask syncWaitImpl(Task<T>& task, SyncWaitState<T>& state) {
+    try {
+        if constexpr (std::is_void_v<T>) {
+            co_await std::move(task);
+        } else {
+            state.value.emplace(co_await std::move(task));
+        }
+    } catch (...) {
+        state.exception = std::current_exception();
+    }
+    // 持锁 notify：syncWait 一旦看到 done 就会销毁 state
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.done = true;
+    state.cv.notify_one();
+}
+
+// 阻塞调用线程直到 task 完成（只应在 main 等非池线程中使用）
+template <typename T>
+T syncWait(Task<T> task) {
+    SyncWaitState<T> state;
+    syncWaitImpl(task, state);
+    std::unique_lock<std::mutex> lock(state.mutex);
+    state.cv.wait(lock, [&state] { return state.done; });
+    if (state.exception) std::rethrow_exception(state.exception);
+    if constexpr (!std::is_void_v<T>) return std::move(*state.value);
+}
+
+// ============================================================
+// 9.2：schedule(pool) —— co_await 即切换到线程池
+// ============================================================
+// await_suspend 把 h.resume() 作为普通任务提交给线程池，
+// 协程剩下的部分就在某个工作线程上继续执行。
+
+class ScheduleAwaiter {
+public:
+    explicit ScheduleAwaiter(ThreadPool& pool) : mPool(pool) {}
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h) {
+        mPool.submit([h] { h.resume(); });
+    }
+    void await_resume() const noexcept {}
+
+private:
+    ThreadPool& mPool;
+};
+
+inline ScheduleAwaiter schedule(ThreadPool& pool) {
+    return ScheduleAwaiter(pool);
+}
+
+// 把一个普通函数放到线程池上执行，co_await 它的返回值
+template <typename F>
+auto offload(ThreadPool& pool, F f) -> Task<std::invoke_result_t<F>> {
+    co_await schedule(pool);
+    co_return f();
+}
+
+Task<int> square(ThreadPool& pool, int x) {
+    co_await schedule(pool);
+    co_return x * x;
+}
+
+Task<int> sumOfSquares(ThreadPool& pool, int n) {
+    int sum = 0;
+    for (int i = 1; i <= n; ++i) {
+        sum += co_await square(pool, i);
+    }
+    co_return sum;
+}
+
+Task<void> failing(ThreadPool& pool) {
+    co_await schedule(pool);
+    throw std::runtime_error("boom");
+}
+
+void demo_task() {
+    std::cout << "=== 9.1/9.2 Task<T> + schedule(pool) ===\n";
+    ThreadPool pool(4);
+
+    int sum = syncWait(sumOfSquares(pool, 5));
+    assert(sum == 55);
+    std::cout << "  sumOfSquares(5) = " << sum << " ✓\n";
+
+    auto id = syncWait(offload(pool, [] { return std::this_thread::get_id(); }));
+    if (id != std::this_thread::get_id()) {
+        std::cout << "  offload 在工作线程上执行 ✓\n";
+    } else {
+        std::cout << "  offload 却在调用线程上执行 ✗\n";
+    }
+
+    try {
+        syncWait(failing(pool));
+        assert(false);
+    } catch (const std::runtime_error& e) {
+        std::cout << "  异常沿 co_await 链传播: " << e.what() << " ✓\n";
+    }
+    std::cout << "\n";
+}
+
+// ------------------------------------------------------------
+// 对称转移：连续 co_await 大量同步完成的 Task
+// ------------------------------------------------------------
+// 若 final_suspend 里写 continuation.resume()，每层都会压一个栈帧，
+// 一百万层必然栈溢出；返回 handle 则允许编译器做尾调用，栈深度恒定。
+// 但标准只要求"不无限增长"的效果，尾调用是否真正生成取决于优化级别和
+// 插桩（-O0、ASan 下 GCC 都可能生成普通调用），所以这里只用一个
+// 即使每层压栈也安全的规模。
+
+Task<int> immediate(int x) {
+    co_return x;
+}
+
+Task<long long> sumImmediate(int n) {
+    long long sum = 0;
+    for (int i = 0; i < n; ++i) {
+        sum += co_await immediate(1);
+    }
+    co_return sum;
+}
+
+void demo_symmetric_transfer() {
+    const int N = 10000;
+    std::cout << "=== 9.1 对称转移：" << N << " 次同步 co_await ===\n";
+    long long sum = syncWait(sumImmediate(N));
+    assert(sum == N);
+    std::cout << "  sum = " << sum << "，栈未溢出 ✓\n\n";
+}
+
+// ============================================================
+// 9.3：TimerQueue —— 不占用工作线程的 sleep
+// ============================================================
+// 一个后台线程维护按到期时间排序的最小堆（Level 5 的 wait_until），
+// 到期后把 resume 提交回线程池。所有定时器必须在 TimerQueue 析构前到期。
+
+class TimerQueue {
+public:
+    explicit TimerQueue(ThreadPool& pool) : mPool(pool) {
+        mThread = std::thread([this] { timerLoop(); });
+    }
+
+    TimerQueue(const TimerQueue&) = delete;
+    TimerQueue& operator=(const TimerQueue&) = delete;
+
+    ~TimerQueue() {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStop = true;
+        }
+        mCV.notify_one();
+        mThread.join();
+    }
+
+    auto sleepFor(std::chrono::steady_clock::duration d) {
+        struct Awaiter {
+            TimerQueue& timers;
+            std::chrono::steady_clock::time_point deadline;
+
+            bool await_ready() const noexcept {
+                return deadline <= std::chrono::steady_clock::now();
+            }
+            void await_suspend(std::coroutine_handle<> h) {
+                timers.add(deadline, h);
+            }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{*this, std::chrono::steady_clock::now() + d};
+    }
+
+private:
+    struct Entry {
+        std::chrono::steady_clock::time_point deadline;
+        std::coroutine_handle<> handle;
+        bool operator>(const Entry& other) const { return deadline > other.deadline; }
+    };
+
+    void add(std::chrono::steady_clock::time_point deadline, std::coroutine_handle<> h) {
+        bool earliest;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            earliest = mHeap.empty() || deadline < mHeap.top().deadline;
+            mHeap.push({deadline, h});
+        }
+        if (earliest) mCV.notify_one();  // 新的最早到期时间，唤醒后台线程重新计时
+    }
+
+    void timerLoop() {
+        std::unique_lock<std::mutex> lock(mMutex);
+        while (!mStop) {
+            if (mHeap.empty()) {
+                mCV.wait(lock);
+                continue;
+            }
+            auto deadline = mHeap.top().deadline;
+            if (std::chrono::steady_clock::now() < deadline) {
+                mCV.wait_until(lock, deadline);
+                continue;
+            }
+            // 一次取走所有已到期的定时器，在锁外提交
+            std::vector<std::coroutine_handle<>> expired;
+            auto now = std::chrono::steady_clock::now();
+            while (!mHeap.empty() && mHeap.top().deadline <= now) {
+                expired.push_back(mHeap.top().handle);
+                mHeap.pop();
+            }
+            lock.unlock();
+            for (auto h : expired) {
+                mPool.submit([h] { h.resume(); });
+            }
+            lock.lock();
+        }
+    }
+
+    ThreadPool& mPool;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> mHeap;
+    std::mutex mMutex;
+    std::condition_variable mCV;
+    bool mStop = false;
+    std::thread mThread;
+};
+
+Task<void> delayedPrint(ThreadPool& pool, TimerQueue& timers, std::string msg,
+                        std::chrono::milliseconds delay) {
+    co_await schedule(pool);
+    co_await timers.sleepFor(delay);
+    std::cout << "  [" << delay.count() << "ms] " << msg << "\n";
+}
+
+void demo_timer() {
+    std::cout << "=== 9.3 TimerQueue：1 个工作线程上的 3 个 sleep ===\n";
+    std::latch done(3);  // 先于线程池构造、后于线程池析构
+    ThreadPool pool(1);
+    TimerQueue timers(pool);
+
+    auto t0 = std::chrono::steady_clock::now();
+    auto job = [&](std::string msg, std::chrono::milliseconds d) -> Task<void> {
+        co_await delayedPrint(pool, timers, std::move(msg), d);
+        done.count_down();
+    };
+    // 注意：lambda 协程的捕获存放在 lambda 对象里，
+    // 这里 job 活到 done.wait() 之后，所以引用捕获是安全的。
+    // 三个协程只用一个工作线程，总耗时 ≈ 最长的 30ms 而不是 60ms
+    spawn(job("first", 10ms));
+    spawn(job("second", 20ms));
+    spawn(job("third", 30ms));
+    done.wait();
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - t0).count();
+    std::cout << "  总耗时 " << ms << "ms（串行阻塞需要 60ms）\n\n";
+}
+
+// ============================================================
+// 9.4：AsyncQueue<T> —— 协程版可关闭队列
+// ============================================================
+// 对应 Level 6 的 ClosableQueue：
+//   pop 时队列为空 → 不是 cv.wait 阻塞线程，而是挂起协程、登记为等待者
+//   push 时有等待者 → 直接把值交给它，并把它的 resume 提交到线程池
+//   close → 唤醒所有等待者，pop 返回 nullopt
+
+template <typename T>
+class AsyncQueue {
+public:
+    explicit AsyncQueue(ThreadPool& pool) : mPool(pool) {}
+
+    void push(T val) {
+        std::unique_lock<std::mutex> lock(mMutex);
+        if (mClosed) return;
+        if (!mWaiters.empty()) {
+            PopAwaiter* waiter = mWaiters.front();
+            mWaiters.pop_front();
+            lock.unlock();
+            waiter->mResult.emplace(std::move(val));
+            mPool.submit([h = waiter->mHandle] { h.resume(); });
+            return;
+        }
+        mItems.push_back(std::move(val));
+    }
+
+    void close() {
+        std::deque<PopAwaiter*> waiters;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mClosed = true;
+            waiters.swap(mWaiters);
+        }
+        for (auto* w : waiters) {
+            mPool.submit([h = w->mHandle] { h.resume(); });
+        }
+    }
+
+    class PopAwaiter {
+    public:
+        explicit PopAwaiter(AsyncQueue& q) : mQueue(q) {}
+
+        bool await_ready() const noexcept { return false; }
+
+        // 返回 false 表示不挂起（已有数据或已关闭）
+        bool await_suspend(std::coroutine_handle<> h) {
+            std::lock_guard<std::mutex> lock(mQueue.mMutex);
+            if (!mQueue.mItems.empty()) {
+                mResult.emplace(std::move(mQueue.mItems.front()));
+                mQueue.mItems.pop_front();
+                return false;
+            }
+            if (mQueue.mClosed) return false;
+            mHandle = h;
+            mQueue.mWaiters.push_back(this);
+            return true;
+        }
+
+        std::optional<T> await_resume() { return std::move(mResult); }
+
+    private:
+        friend class AsyncQueue;
+        AsyncQueue& mQueue;
+        std::coroutine_handle<> mHandle;
+        std::optional<T> mResult;
+    };
+
+    // co_await q.pop()：返回 nullopt 表示队列已关闭且为空
+    PopAwaiter pop() { return PopAwaiter(*this); }
+
+private:
+    ThreadPool& mPool;
+    std::mutex mMutex;
+    std::deque<T> mItems;
+    std::deque<PopAwaiter*> mWaiters;
+    bool mClosed = false;
+};
+
+Task<void> producer(ThreadPool& pool, TimerQueue& timers, AsyncQueue<int>& q, int n) {
+    co_await schedule(pool);
+    for (int i = 0; i < n; ++i) {
+        q.push(i);
+        co_await timers.sleepFor(2ms);
+    }
+    q.close();
+}
+
+Task<int> consumer(ThreadPool& pool, AsyncQueue<int>& q) {
+    co_await schedule(pool);
+    int sum = 0;
+    while (auto val = co_await q.pop()) {
+        sum += *val;
+    }
+    co_return sum;
+}
+
+Task<int> runProducerConsumer(ThreadPool& pool, TimerQueue& timers, AsyncQueue<int>& q) {
+    spawn(producer(pool, timers, q, 10));
+    co_return co_await consumer(pool, q);
+}
+
+void demo_async_queue() {
+    std::cout << "=== 9.4 AsyncQueue：协程生产者-消费者 ===\n";
+    ThreadPool pool(2);
+    TimerQueue timers(pool);
+    AsyncQueue<int> q(pool);
+
+    int sum = syncWait(runProducerConsumer(pool, timers, q));
+    assert(sum == 45);
+    std::cout << "  consumer sum = " << sum << " ✓\n\n";
+}
+
+// ============================================================
+// 9.5：Benchmark —— 10 万个并发任务，每个"等 I/O"一次
+// ============================================================
+// 每个任务：计算 → 等待 IO_LATENCY（模拟一次 I/O）→ 计算
+//   阻塞版：线程池任务里 sleep_for，等待期间工作线程被占住
+//   协程版：co_await timers.sleepFor，等待期间工作线程去跑别的协程
+
+unsigned spin(unsigned x) {
+    for (int i = 0; i < 200; ++i) x = x * 1664525u + 1013904223u;
+    return x;
+}
+
+Task<void> ioJob(ThreadPool& pool, TimerQueue& timers, std::chrono::microseconds latency,
+                 unsigned seed, std::atomic<unsigned>& sink, std::latch& done) {
+    co_await schedule(pool);
+    unsigned x = spin(seed);
+    co_await timers.sleepFor(latency);
+    sink.fetch_add(spin(x), std::memory_order_relaxed);
+    done.count_down();
+}
+
+void bench_coroutine_vs_blocking(int numTasks) {
+    std::cout << "=== 9.5 Benchmark：" << numTasks << " 个并发任务 ===\n";
+    const size_t THREADS = 8;
+    const auto IO_LATENCY = 100us;
+    std::atomic<unsigned> sink{0};
+
+    // 阻塞版：每个任务在工作线程里 sleep
+    auto t0 = std::chrono::steady_clock::now();
+    {
+        std::latch done(numTasks);
+        ThreadPool pool(THREADS);
+        for (int i = 0; i < numTasks; ++i) {
+            pool.submit([&sink, &done, IO_LATENCY, i] {
+                unsigned x = spin(static_cast<unsigned>(i));
+                std::this_thread::sleep_for(IO_LATENCY);
+                sink.fetch_add(spin(x), std::memory_order_relaxed);
+                done.count_down();
+            });
+        }
+        done.wait();
+    }
+    auto blocking = std::chrono::steady_clock::now() - t0;
+
+    // 协程版：所有任务同时挂在定时器上
+    t0 = std::chrono::steady_clock::now();
+    {
+        std::latch done(numTasks);
+        ThreadPool pool(THREADS);
+        TimerQueue timers(pool);
+        for (int i = 0; i < numTasks; ++i) {
+            spawn(ioJob(pool, timers, IO_LATENCY, static_cast<unsigned>(i), sink, done));
+        }
+        done.wait();
+    }
+    auto coroutine = std::chrono::steady_clock::now() - t0;
+
+    auto ms = [](auto d) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(d).count();
+    };
+    std::cout << "  线程数=" << THREADS << "，每任务 I/O 等待="
+              << IO_LATENCY.count() << "us\n";
+    std::cout << "  阻塞任务:   " << ms(blocking) << "ms\n";
+    std::cout << "  协程任务:   " << ms(coroutine) << "ms\n";
+    std::cout << "  加速比:     "
+              << static_cast<double>(ms(blocking)) / std::max<long long>(1, ms(coroutine))
+              << "x\n";
+    std::cout << "  (阻塞版受限于 任务数 × I/O 延迟 / 线程数；协程版只受 CPU 计算量限制)\n\n";
+}
+
+// ==================== 设计要点速记 ====================
+/*
+ * 1. 惰性启动（initial_suspend = suspend_always）
+ *    → 保证 co_await 之前 continuation 已设置好，没有"先完成后等待"的竞争。
+ *
+ * 2. 对称转移
+ *    → FinalAwaiter::await_suspend 返回 continuation；
+ *      Task::Awaiter::await_suspend 返回被等待的 handle。
+ *
+ * 3. 协程帧的所有权
+ *    → Task 对象拥有帧；spawn 把 Task 移进一个自销毁的 DetachedTask。
+ *    → 引用参数（pool、timers、queue）必须活得比协程久。
+ *
+ * 4. 何时会"跑在哪个线程上"
+ *    → co_await schedule(pool) 之后在工作线程；
+ *      定时器 / 队列唤醒后也是通过 pool.submit 回到工作线程。
+ *
+ * 练习：
+ * [练习 1] 为 AsyncQueue 增加容量上限：co_await q.push(v) 在队满时挂起。
+ *
+ * [练习 2] 实现 whenAll(Task<A>, Task<B>)：并发启动两个任务，都完成后恢复。
+ *
+ * [练习 3] 给 sleepFor 加上取消：close() 时让所有等待中的协程立刻恢复。
+ */
+
+int main(int argc, char** argv) {
+    int numTasks = argc > 1 ? std::stoi(argv[1]) : 100000;
+
+    demo_task();
+    demo_symmetric_transfer();
+    demo_timer();
+    demo_async_queue();
+    bench_coroutine_vs_blocking(numTasks);
+
+    std::cout << "Level 9 Complete!\n";
+    return 0;
+}
+
+/*
+ * 编译运行：
+ *   g++ -std=c++20 -pthread -O2 level9_coroutine.cpp -o level9 && ./level9 [numTasks]
+ */